@@ -0,0 +1,79 @@
+#ifndef ADC_DMA_SAMPLER_H
+#define ADC_DMA_SAMPLER_H
+
+#include <Arduino.h>
+
+#include "AudioSampleRing.h"
+#include "hardware/sync.h"
+
+/**
+ * @brief Konstansok az ADC DMA mintavételezőhöz
+ */
+namespace AdcDmaSamplerConstants {
+
+constexpr float ADC_CLOCK_HZ = 48000000.0f;  // ADC órajel (USB PLL)
+constexpr float ADC_MIN_CLKDIV = 95.0f;      // Egy konverzió 96 órajel -> max. 500kSPS
+constexpr uint8_t ADC_FIRST_PIN = 26;        // GPIO26 = ADC0
+
+};  // namespace AdcDmaSamplerConstants
+
+/**
+ * @brief Szabadon futó ADC mintavételezés DMA-val egy gyűrűpufferbe
+ *
+ * Az ADC saját órajel osztóval pontos ütemben konvertál, a DMA a FIFO-ból a gyűrűbe ír
+ * (write ring wrap), a lánc végén egy vezérlő csatorna újraindítja az adat csatornát.
+ * A CPU-t csak a körbefordulás számláló IRQ terheli. Az írási index mindkét magról
+ * lekérdezhető: a körszámlálót és a DMA állapotát hardveres spinlock védi.
+ */
+class AdcDmaSampler : public AudioSampleRing {
+   public:
+    AdcDmaSampler();
+    ~AdcDmaSampler() override;
+
+    /**
+     * @brief Mintavételezés indítása (ha már fut más beállítással, újraindul)
+     * @param audioPin Az audio bemenet pin száma (A0..A2)
+     * @param sampleRateHz Kért mintavételezési frekvencia Hz-ben
+     * @return true ha sikeres
+     */
+    bool start(int audioPin, float sampleRateHz) override;
+
+    /**
+     * @brief Mintavételezés leállítása, a DMA csatornák felszabadítása
+     */
+    void stop() override;
+
+    /**
+     * @brief Az eddig beírt minták száma (monoton növekvő abszolút írási index)
+     */
+    uint32_t getWriteIndex() override;
+
+    /**
+     * @brief Mintavételezés ideiglenes szüneteltetése (pl. más ADC csatorna olvasásához)
+     * @return true ha a mintavételezés futott (ezt kell a resumeCapture()-nek átadni)
+     */
+    bool pauseCapture();
+
+    /**
+     * @brief Szüneteltetett mintavételezés folytatása
+     * @param wasRunning A pauseCapture() visszatérési értéke
+     */
+    void resumeCapture(bool wasRunning);
+
+   private:
+    static void dmaIrqHandler();
+
+    static volatile uint32_t wrapCount_;  // Gyűrű körbefordulások száma (IRQ növeli)
+    static int dataChannel_;              // ADC FIFO -> gyűrű DMA csatorna
+    static int controlChannel_;           // Az adat csatornát újraindító DMA csatorna
+    static spin_lock_t *wrapLock_;        // A körszámláló és az IRQ nyugtázás közös zárja (magok között)
+
+    uint32_t stoppedWriteIndex_;  // Leállítás után ezt adjuk vissza
+    uint32_t ringTransferCount_;  // A vezérlő csatorna innen tölti újra a transfer count-ot
+    uint8_t adcInput_;            // Használt ADC bemenet (0..3)
+};
+
+// Globális mintavételező példány (main.cpp)
+extern AdcDmaSampler adcDmaSampler;
+
+#endif  // ADC_DMA_SAMPLER_H
@@ -28,25 +28,32 @@ class AmDisplay : public DisplayBase {
     static constexpr uint8_t DECODER_LINE_GAP = 2;                      // Sorköz a dekódolt szöveg sorai között (pixel)
     static constexpr uint8_t DECODER_MODE_BTN_W = SCRN_BTN_W / 2 + 10;  // Kicsit szélesebb mini gombok
     static constexpr uint8_t DECODER_MODE_BTN_H = SCRN_BTN_H / 2;
-    static constexpr uint8_t DECODER_MODE_BTN_GAP_X = 5;  // Rés a szövegterület és a gombok között
-    static constexpr uint8_t DECODER_MODE_BTN_GAP_Y = 3;  // Függőleges rés a módváltó gombok között    // Dekódolt szöveg tárolása (CW és RTTY)
+    static constexpr uint8_t DECODER_MODE_BTN_GAP_X = 5;        // Rés a szövegterület és a gombok között
+    static constexpr uint8_t DECODED_TEXT_DRAIN_MAX = 16;       // Egy loop-ban a szöveg gyűrűből kivett karakterek maximuma
+    static constexpr uint8_t DECODED_TEXT_LOW_CONFIDENCE = 50;  // Ennél kisebb megbízhatóságú karakterek halványan jelennek meg
+    static constexpr uint8_t DECODER_MODE_BTN_GAP_Y = 3;        // Függőleges rés a módváltó gombok között    // Dekódolt szöveg tárolása (CW és RTTY)
     String decodedTextDisplayLines[RTTY_MAX_TEXT_LINES];
+    uint64_t decodedTextDisplayDimMasks[RTTY_MAX_TEXT_LINES];  // Soronként a halvány (bizonytalan) karakterek bitjei
     uint8_t decodedTextCurrentLineIndex = 0;
     String decodedTextCurrentLineBuffer = "";
+    uint64_t decodedTextCurrentLineDimMask = 0;
+    static_assert(RTTY_LINE_BUFFER_SIZE <= 64, "A halvány karakterek maszkja legfeljebb 64 karakteres sort tud jelölni");
     uint16_t decoderCharHeight_ = 0;  // Karakter magasság a dekóder szöveghez
 
     // Dekódolási módválasztó rádiógomb csoport
     RadioButtonGroup decoderModeGroup;
-    enum class DecodeMode { OFF, RTTY, MORSE };
+    enum class DecodeMode { OFF, RTTY, MORSE, CW_SKIMMER };
     DecodeMode currentDecodeMode = DecodeMode::OFF;  // Kezdetben kikapcsolva
     uint8_t decoderModeStartId_ = 0;                 // Dekóder gombok kezdő ID-ja
+    uint16_t lastSkimmerOffsetHz_ = 0;               // A CW skimmer utoljára kiírt állomásának hangfrekvenciája
     void setDecodeModeBasedOnButtonId(uint8_t buttonId);
 
     uint16_t decodedTextAreaX, decodedTextAreaY, decodedTextAreaW, decodedTextAreaH;
     uint16_t decodeModeButtonsX;  // A módváltó gombok oszlopának X pozíciója    // Segédfüggvények
     void drawDecodedTextAreaBackground();
-    void appendDecodedCharacter(char c);
-    void redrawCurrentInputLine();  // Csak az aktuális sort rajzolja újra
+    void appendDecodedCharacter(char c, bool dimmed = false);
+    void drawDecodedTextLine(const String &line, uint64_t dimMask, uint16_t y);  // Egy sor kirajzolása, a halvány karakterek szürkén
+    void redrawCurrentInputLine();                                               // Csak az aktuális sort rajzolja újra
     void updateDecodedTextDisplay();
     void clearDecodedTextBufferOnly();        // Csak a puffert törli
     void clearDecodedTextBufferAndDisplay();  // Törli a puffert és frissíti a kijelzőt
@@ -0,0 +1,35 @@
+#ifndef ARDUINO_FFT_BACKEND_H
+#define ARDUINO_FFT_BACKEND_H
+
+#include <ArduinoFFT.h>
+
+#include "IFftBackend.h"
+
+/**
+ * @brief ArduinoFFT<double> alapú referencia backend
+ *
+ * FPU nélküli M0+ magon lassú (szoftveres double műveletek), de pontos:
+ * összehasonlításra és hibakereséshez tartjuk meg a fixpontos backend mellett.
+ */
+class ArduinoFftBackend : public IFftBackend {
+   public:
+    ArduinoFftBackend();
+    ~ArduinoFftBackend() override;
+
+    bool setSize(uint16_t size) override;
+    uint16_t getSize() const override { return size_; }
+    void setWindowType(FftWindowType type) override;
+    void computeMagnitudes(const int16_t *samples, float *magnitudes) override;
+
+   private:
+    double *vReal_;
+    double *vImag_;
+    uint16_t size_;
+    ArduinoFFT<double> fft_;
+    FFTWindow windowType_;        // ArduinoFFT ablak típus
+    float windowGainCorrection_;  // Koherens erősítés korrekció a Hamming ablakhoz
+
+    void deallocate();
+};
+
+#endif  // ARDUINO_FFT_BACKEND_H
@@ -0,0 +1,85 @@
+#ifndef ARRAY_SAMPLE_SOURCE_H
+#define ARRAY_SAMPLE_SOURCE_H
+
+#include "AudioSampleRing.h"
+
+/**
+ * @brief Tömbből (pl. betöltött WAV adatból) táplált minta gyűrű
+ *
+ * Az AdcDmaSampler hardverfüggetlen megfelelője: ugyanazt a gyűrű interfészt adja,
+ * de a mintákat a pump() hívások írják be determinisztikusan, így a feldolgozó lánc
+ * Linuxon, hardver nélkül is futtatható.
+ */
+class ArraySampleSource : public AudioSampleRing {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param samples Előjeles audio minták (a 12 bites ADC skálán, +/-2047)
+     * @param length A minták száma
+     * @param loop true esetén a forrás végén elölről kezdi
+     */
+    ArraySampleSource(const int16_t *samples, uint32_t length, bool loop = true)
+        : AudioSampleRing(buffer_), samples_(samples), length_(length), loop_(loop), sourcePos_(0), writeIndex_(0) {}
+
+    /**
+     * @brief Indítás - a kért frekvencia változtatás nélkül a tényleges frekvencia is
+     */
+    bool start(int audioPin, float sampleRateHz) override {
+        (void)audioPin;
+        if (sampleRateHz <= 0.0f || samples_ == nullptr || length_ == 0) {
+            return false;
+        }
+        requestedSampleRateHz_ = sampleRateHz;
+        actualSampleRateHz_ = sampleRateHz;
+        running_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Leállítás
+     */
+    void stop() override { running_ = false; }
+
+    /**
+     * @brief Az eddig beírt minták száma
+     */
+    uint32_t getWriteIndex() override { return writeIndex_; }
+
+    /**
+     * @brief Minták beírása a gyűrűbe (a DMA működését szimulálja)
+     * @param count A beírandó minták száma
+     * @return A ténylegesen beírt minták száma (loop nélkül a forrás végén kevesebb)
+     */
+    uint32_t pump(uint32_t count) {
+        using namespace AudioSampleRingConstants;
+
+        if (!running_) {
+            return 0;
+        }
+        uint32_t written = 0;
+        while (written < count) {
+            if (sourcePos_ >= length_) {
+                if (!loop_) {
+                    break;
+                }
+                sourcePos_ = 0;
+            }
+            int32_t value = samples_[sourcePos_++] + ADC_MID_LEVEL;
+            value = value < 0 ? 0 : (value > 4095 ? 4095 : value);  // ADC tartományra vágás
+            buffer_[writeIndex_ & RING_MASK] = static_cast<uint16_t>(value);
+            writeIndex_++;
+            written++;
+        }
+        return written;
+    }
+
+   private:
+    uint16_t buffer_[AudioSampleRingConstants::RING_SIZE];
+    const int16_t *samples_;
+    uint32_t length_;
+    bool loop_;
+    uint32_t sourcePos_;
+    uint32_t writeIndex_;
+};
+
+#endif  // ARRAY_SAMPLE_SOURCE_H
@@ -3,6 +3,8 @@
 
 #include "AudioProcessor.h"
 #include "DisplayBase.h"
+#include "TftWaterfallPanel.h"
+#include "WaterfallScroller.h"
 
 // Konstansok a képernyőhöz és az FFT-hez
 namespace AudioAnalyzerConstants {
@@ -10,6 +12,7 @@ namespace AudioAnalyzerConstants {
 constexpr float ANALYZER_MIN_FREQ_HZ = 300.0f;
 constexpr float ANALYZER_MAX_FREQ_HZ = 15000.0f;
 constexpr float AMPLITUDE_SCALE = 1500.0f;  // Skálázási faktor a vizuális megjelenítéshez (AudioProcessor után)
+constexpr uint8_t COLOR_PROFILE = 0;        // A vízesés színprofilja (0: Cold, 1: Hot)
 
 // Vízesés elrendezési konstansok
 constexpr uint16_t WATERFALL_TOP_Y = 20;         // A vízesés diagram tetejének Y koordinátája (a státuszsor alatt)
@@ -42,12 +45,13 @@ class AudioAnalyzerDisplay : public DisplayBase {
     float& audioAnalyzerGainConfigRef_;  // Referencia a gain configra
 
     // Vízesés/Analizátor Kijelző Változók
-    int current_y_analyzer;  // Az aktuális Y pozíció a vízesés vonalának rajzolásához
+    TftWaterfallPanel waterfallPanel_;  // A vízesés sorai a TFT-re (DMA), a görgetés regiszterei
+    WaterfallScroller scroller_;        // A vízesés sávja: hardveres görgetés, ha a panel és a forgatás engedi, különben szoftveres gyűrű
 
     // Segédfüggvények
     void FFTSampleAnalyzer();
+    void addWaterfallLine();
     void audioScaleAnalyzer(uint16_t occupiedBottomHeight);  // Paraméter hozzáadva
-    uint16_t valueToWaterfallColorAnalyzer(float val, float min_val, float max_val, byte colorProfileIndex);
 };
 
 #endif  // AUDIO_ANALYZER_DISPLAY_H
@@ -2,7 +2,10 @@
 #define AUDIO_PROCESSOR_H
 
 #include <Arduino.h>
-#include <ArduinoFFT.h>
+
+#include "AudioSampleReader.h"
+#include "IFftBackend.h"
+#include "core_communication.h"
 
 /**
  * @brief Konstansok az AudioProcessor osztályhoz - mintavételezési frekvenciától függetlenek
@@ -34,6 +37,13 @@ constexpr int MAX_INTERNAL_WIDTH = 86;  // Oszcilloszkóp és magas felbontású
 
 constexpr int OSCI_SAMPLE_DECIMATION_FACTOR = 2;  // Oszcilloszkóp mintavételi decimációs faktora
 
+constexpr bool USE_FIXED_POINT_FFT = true;  // true: Q15 fixpontos FFT, false: ArduinoFFT<double> referencia
+
+// A kijelzők spektruma a Core1-en (startCore1Processing())
+constexpr bool USE_CORE1_SPECTRUM = true;         // true: a mintavétel és az FFT a Core1-en fut, false: minden a Core0-n
+constexpr uint16_t CORE1_FRAME_INTERVAL_MS = 25;  // Két Core1 spektrum képkocka közötti legkisebb idő (max. 40 képkocka/mp)
+constexpr uint32_t CORE1_START_TIMEOUT_MS = 500;  // Ha eddig nem jön képkocka a Core1-ről, helyben számolunk tovább
+
 };  // namespace AudioProcessorConstants
 
 /**
@@ -45,10 +55,12 @@ class AudioProcessor {
      * @brief AudioProcessor konstruktor
      * @param gainConfigRef Referencia a gain konfigurációs értékre
      * @param audioPin Az audio bemenet pin száma
-     * @param targetSamplingFrequency Cél mintavételezési frekvencia Hz-ben
+     * @param targetSamplingFrequency Cél (minimális) mintavételezési frekvencia Hz-ben, ehhez választjuk a busz decimációját
      * @param fftSize FFT méret (alapértelmezett: DEFAULT_FFT_SAMPLES)
+     * @param sampleSource Minta forrás (nullptr esetén a globális ADC DMA mintavételező busz)
      */
-    AudioProcessor(float& gainConfigRef, int audioPin, double targetSamplingFrequency, uint16_t fftSize = AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
+    AudioProcessor(float& gainConfigRef, int audioPin, double targetSamplingFrequency, uint16_t fftSize = AudioProcessorConstants::DEFAULT_FFT_SAMPLES,
+                   AudioSampleRing* sampleSource = nullptr);
 
     /**
      * @brief AudioProcessor destruktor
@@ -56,22 +68,43 @@ class AudioProcessor {
     ~AudioProcessor();
 
     /**
-     * @brief Fő audio feldolgozó függvény - mintavételezés, FFT számítás és spektrum analízis
+     * @brief Fő audio feldolgozó függvény - a legfrissebb minták FFT számítása és spektrum analízis
      * @param collectOsciSamples true ha oszcilloszkóp mintákat is gyűjteni kell
+     * @return true ha új spektrum készült (Core1 módban: új képkocka érkezett), false ha a régi adatok maradtak
+     * @note Nem blokkol: a mintákat a háttérben futó mintavételező gyűrűjéből, Core1 módban a kész képkockából veszi
+     */
+    bool process(bool collectOsciSamples);
+
+    /**
+     * @brief A számítás átadása a Core1-nek (csak a Core0 példányán, USE_CORE1_SPECTRUM esetén)
+     *
+     * A Core1 egy saját AudioProcessor-ral számol, a process() innentől a legfrissebb kész
+     * képkockát veszi át. Ha a Core1 nem küld képkockát, a process() visszaáll a helyi számításra.
+     * @return true ha a kérés elment a Core1-nek
+     */
+    bool startCore1Processing();
+
+    /**
+     * @brief A Core1 számítás leállítása, visszatérés a helyi számításra
+     */
+    void stopCore1Processing();
+
+    /**
+     * @brief A Core1 számolja-e a spektrumot
      */
-    void process(bool collectOsciSamples);
+    bool isCore1Processing() const { return core1Session_ != 0; }
 
     /**
      * @brief Magnitúdó adatok lekérdezése
-     * @return Pointer a magnitúdó adatokra
+     * @return Pointer a magnitúdó adatokra (Core1 módban a legutóbb átvett képkocka adataira)
      */
-    const double* getMagnitudeData() const { return RvReal; }
+    const float* getMagnitudeData() const { return core1Magnitudes_ != nullptr ? core1Magnitudes_ : magnitudes; }
 
     /**
      * @brief Oszcilloszkóp adatok lekérdezése
-     * @return Pointer az oszcilloszkóp adatokra
+     * @return Pointer az oszcilloszkóp adatokra (Core1 módban a legutóbb átvett képkocka adataira)
      */
-    const int* getOscilloscopeData() const { return osciSamples; }
+    const int* getOscilloscopeData() const { return core1OsciSamples_ != nullptr ? core1OsciSamples_ : osciSamples; }
 
     /**
      * @brief Frekvencia bin szélesség lekérdezése Hz-ben
@@ -81,11 +114,23 @@ class AudioProcessor {
 
     /**
      * @brief FFT méret beállítása futásidőben
-     * @param newFftSize Az új FFT méret
-     * @return true ha sikeres, false ha hiba történt
+     * @param newFftSize Az új FFT méret (2 hatványa, legfeljebb a mintaolvasó getMaxLatestCount() értéke)
+     * @return true ha sikeres, false ha a méret érvénytelen vagy hiba történt
      */
     bool setFftSize(uint16_t newFftSize);
 
+    /**
+     * @brief Ablakfüggvény beállítása (pl. kijelző módonként)
+     * @param type Az ablak típusa
+     */
+    void setWindowType(FftWindowType type);
+
+    /**
+     * @brief Aktuális ablakfüggvény lekérdezése
+     * @return Az ablak típusa
+     */
+    FftWindowType getWindowType() const { return windowType_; }
+
     /**
      * @brief Aktuális FFT méret lekérdezése
      * @return Az aktuális FFT méret
@@ -106,14 +151,23 @@ class AudioProcessor {
 
    private:
     // Dinamikus memória az FFT tömbökhez
-    double* vReal;
-    double* vImag;
-    double* RvReal;                                                // Magnitúdók tárolására
+    uint16_t* rawSamples;                                          // A gyűrűből kimásolt nyers ADC minták (helyben int16-ra alakítva)
+    float* magnitudes;                                             // Magnitúdók tárolására (N/2 elem)
     int osciSamples[AudioProcessorConstants::MAX_INTERNAL_WIDTH];  // Oszcilloszkóp buffer (fix méret)
 
     // FFT konfiguráció
-    uint16_t currentFftSize_;  // Aktuális FFT méret
-    ArduinoFFT<double> FFT;    // FFT objektum
+    uint16_t currentFftSize_;   // Aktuális FFT méret
+    IFftBackend* fftBackend;    // FFT számítás (fixpontos vagy double referencia)
+    FftWindowType windowType_;  // Kiválasztott ablakfüggvény
+
+    // Core1 spektrum (csak a Core0 példányán)
+    uint16_t core1Session_;         // A Core1 kérés azonosítója (a START üzenet sorszáma), 0: helyi számítás
+    bool core1ConfigDirty_;         // A beállítás változott, a Core1-nek még el kell küldeni
+    bool core1CollectOsci_;         // A Core1-nek elküldött oszcilloszkóp igény
+    uint32_t core1WaitStartMs_;     // Mióta várunk a beállításnak megfelelő képkockára
+    uint32_t core1FrameSequence_;   // Az utoljára átvett képkocka sorszáma
+    const float* core1Magnitudes_;  // Az átvett képkocka magnitúdói, nullptr ha nincs érvényes képkocka
+    const int* core1OsciSamples_;   // Az átvett képkocka oszcilloszkóp mintái, nullptr ha nincsenek
 
     /**
      * @brief Segédfüggvény FFT tömbök allokálásához/újrallokálásához
@@ -134,13 +188,37 @@ class AudioProcessor {
      */
     bool validateFftSize(uint16_t size) const;
 
+    /**
+     * @brief A minta busz ellenőrzése (ha még nem fut, elindítja a busz frekvenciáján)
+     * @return true ha a mintavételező fut
+     */
+    bool ensureSamplingRunning();
+
+    /**
+     * @brief Bin szélesség frissítése a tényleges mintavételezési frekvencia alapján
+     */
+    void updateBinWidth();
+
+    /**
+     * @brief Spektrum üzenet küldése a Core1-nek az aktuális beállításokkal
+     * @return Az üzenet sorszáma, 0 ha a postafiók tele
+     */
+    uint16_t postCore1Spectrum(Core1Command command, bool collectOsciSamples);
+
+    /**
+     * @brief A legfrissebb Core1 képkocka átvétele
+     * @return true ha új, a beállításoknak megfelelő képkocka érkezett
+     */
+    bool acquireCore1Frame(bool collectOsciSamples);
+
    protected:
     float& activeFftGainConfigRef;  // Referencia a Config_t gain mezőjére
     int audioInputPin;              // Audio bemenet pin száma
 
+    AudioSampleRing* sampleSource_;    // Minta forrás (DMA gyűrű vagy teszt forrás)
+    AudioSampleReader sampleReader_;   // Saját olvasó a közös buszon (decimálással)
     double targetSamplingFrequency_;   // Cél mintavételezési frekvencia
-    uint32_t sampleIntervalMicros_;    // Egy mintára jutó időköz mikroszekundumban
-    float binWidthHz_;                 // Cél frekvencia alapján számolt bin szélesség
+    float binWidthHz_;                 // Tényleges mintavételezési frekvencia alapján számolt bin szélesség
     float smoothed_auto_gain_factor_;  // Simított erősítési faktor az auto gain-hez
 };
 
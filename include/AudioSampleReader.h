@@ -0,0 +1,135 @@
+#ifndef AUDIO_SAMPLE_READER_H
+#define AUDIO_SAMPLE_READER_H
+
+#include "AudioSampleRing.h"
+#include "HalfBandDecimator.h"
+
+/**
+ * @brief A közös audio minta busz konstansai
+ */
+namespace AudioSampleBusConstants {
+
+// A busz egyetlen, fix mintavételezési frekvenciája. A 2 hatvány osztók lefedik az összes fogyasztót:
+//  /2 = 33.6kHz (FM spektrum, 15kHz), /4 = 16.8kHz (AM spektrum, 6kHz), /8 = 8400Hz (CW/RTTY dekóderek)
+constexpr float SAMPLE_RATE_HZ = 67200.0f;
+
+// Half-band fokozatok (tap szám, Kaiser béta * 10): minden fokozat 2-vel oszt, a záró sáv
+// a kisebb frekvencián dolgozó fokozatoknál szigorúbb, mert ott kevesebb a számítás
+using DecimatorChainType = DecimatorChain<HalfBandDecimator<23, 50>,   // 67.2k -> 33.6k, 12kHz-ig sík, >= 45dB zárás
+                                          HalfBandDecimator<27, 50>,   // 33.6k -> 16.8k, 6kHz-ig sík, >= 54dB zárás
+                                          HalfBandDecimator<31, 60>>;  // 16.8k -> 8.4k, 3kHz-ig sík, >= 60dB zárás
+
+constexpr uint8_t MAX_DECIMATION = 1u << DecimatorChainType::STAGE_COUNT;  // A legnagyobb decimációs faktor
+
+constexpr uint16_t DECIMATION_CHUNK_SAMPLES = 64;  // Egyszerre a gyűrűből másolt nyers minták száma (stack puffer, MAX_DECIMATION többszöröse)
+constexpr uint16_t LATEST_WARMUP_SAMPLES = 16;     // readLatest(): a szűrők feltöltésére eldobott kimeneti minták száma
+
+};  // namespace AudioSampleBusConstants
+
+/**
+ * @brief Egy fogyasztó olvasó kurzora a közös audio minta buszon
+ *
+ * Minden fogyasztó (spektrum, dekóderek, oszcilloszkóp, szintmérő) saját olvasót kap,
+ * így a mintavételezés egyszer történik, és mindenki ugyanazt a koherens jelet látja.
+ * Az olvasó csak a saját kurzorát írja, ezért zár nélkül használható bármelyik magon.
+ * Ha egy fogyasztó lemarad (a kurzort az író körbeérné), a kimaradt mintákat eldobja
+ * és a jelenhez közel folytatja. Opcionálisan 2 hatvány decimációt végez fixpontos half-band
+ * FIR kaszkáddal, így a kimenet a kisebb frekvencián is sávkorlátozott (nincs átlapolás).
+ */
+class AudioSampleReader {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param ring A közös minta gyűrű
+     * @param decimation Decimációs faktor (1, 2, 4 vagy 8)
+     */
+    AudioSampleReader(AudioSampleRing &ring, uint8_t decimation = 1);
+
+    /**
+     * @brief Decimációs faktor beállítása egy cél frekvenciához (a legnagyobb faktor, ami még >= cél)
+     * @param targetSampleRateHz A fogyasztó által igényelt minimális mintavételezési frekvencia
+     */
+    void setTargetSampleRate(float targetSampleRateHz);
+
+    /**
+     * @brief Decimációs faktor beállítása (a szűrők állapota törlődik)
+     * @param decimation Decimációs faktor, lefelé kerekítve 2 hatványra (1..MAX_DECIMATION)
+     */
+    void setDecimation(uint8_t decimation);
+
+    /**
+     * @brief Decimációs faktor lekérdezése
+     */
+    uint8_t getDecimation() const { return decimation_; }
+
+    /**
+     * @brief Az olvasó kimeneti mintavételezési frekvenciája
+     */
+    float getSampleRateHz() const { return ring_.getSampleRateHz() / decimation_; }
+
+    /**
+     * @brief A readLatest() egy hívással kérhető legtöbb mintája az aktuális decimációnál
+     */
+    uint16_t getMaxLatestCount() const;
+
+    /**
+     * @brief Fut-e a busz
+     */
+    bool isRunning() const { return ring_.isRunning(); }
+
+    /**
+     * @brief A kurzor áthelyezése a jelenre (a felgyűlt minták eldobása)
+     */
+    void sync();
+
+    /**
+     * @brief Olvasásra kész (decimált) minták száma
+     */
+    uint32_t available();
+
+    /**
+     * @brief Mennyi idő múlva lesz olvasható legalább count (decimált) minta
+     * @param count A szükséges minták száma
+     * @return Mikroszekundum, 0 ha már most olvasható, UINT32_MAX ha a busz nem fut
+     */
+    uint32_t getMicrosUntilAvailable(uint32_t count);
+
+    /**
+     * @brief Minták olvasása a kurzortól, a kurzor léptetésével
+     * @param dst Cél puffer: középre igazított (előjeles) minták
+     * @param count Kért minták száma
+     * @param blockStartTimeUs Ha nem nullptr, ide kerül a blokk első mintájának időbélyege
+     * @return A ténylegesen olvasott minták száma (legfeljebb az elérhető mennyiség)
+     */
+    uint16_t read(int16_t *dst, uint16_t count, uint32_t *blockStartTimeUs = nullptr);
+
+    /**
+     * @brief A legfrissebb minták olvasása a kurzor módosítása nélkül (kijelzők számára)
+     * @note Decimálásnál a szűrőket minden hívásnál újra feltölti, ezért ugyanazon az olvasón ne keverjük a read()-del
+     * @param dst Cél puffer: nyers skálájú (0..4095) minták
+     * @param count Kért minták száma
+     * @return A másolt minták száma (0, ha még nincs elég minta)
+     */
+    uint16_t readLatest(uint16_t *dst, uint16_t count);
+
+    /**
+     * @brief Lemaradás miatt eldobott nyers minták száma
+     */
+    uint32_t getDroppedSamples() const { return droppedSamples_; }
+
+   private:
+    AudioSampleRing &ring_;
+    AudioSampleBusConstants::DecimatorChainType decimator_;  // Half-band decimátor kaszkád (saját állapot olvasónként)
+    uint32_t cursor_;                                        // Következő olvasandó nyers minta abszolút indexe
+    uint32_t droppedSamples_;                                // Eldobott nyers minták száma
+    uint8_t decimation_;                                     // Decimációs faktor (2 hatvány)
+    uint8_t activeStages_;                                   // Használt half-band fokozatok száma (log2(decimation_))
+
+    /**
+     * @brief Decimált, középre igazított minták előállítása egy adott nyers indextől (a szűrő állapotát folytatja)
+     * @return A ténylegesen előállított minták száma
+     */
+    uint16_t decimate(uint32_t startIndex, int16_t *dst, uint16_t count);
+};
+
+#endif  // AUDIO_SAMPLE_READER_H
@@ -0,0 +1,113 @@
+#ifndef AUDIO_SAMPLE_RING_H
+#define AUDIO_SAMPLE_RING_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * @brief Konstansok az audio minta gyűrűpufferhez
+ */
+namespace AudioSampleRingConstants {
+
+constexpr uint8_t RING_SIZE_BITS = 13;                             // A gyűrű mérete 2 hatványként (8192 minta, ~120ms a busz frekvencián)
+constexpr uint16_t RING_SIZE = 1u << RING_SIZE_BITS;               // Minták száma a gyűrűben (>= MAX_FFT_SAMPLES * 2)
+constexpr uint16_t RING_MASK = RING_SIZE - 1;                      // Index maszk a körbefordításhoz
+constexpr uint32_t RING_SIZE_BYTES = RING_SIZE * sizeof(uint16_t);  // A DMA ring wrap ehhez a mérethez igazított puffert igényel
+
+constexpr uint16_t ADC_MID_LEVEL = 2048;  // 12 bites ADC nulla szintje
+
+};  // namespace AudioSampleRingConstants
+
+/**
+ * @brief Audio minta gyűrűpuffer közös alaposztálya
+ *
+ * A minták nyers 12 bites ADC értékek (0..4095). Minden beírt minta egy monoton növekvő
+ * abszolút indexet kap, így az olvasók blokkolás nélkül kérhetik le a legfrissebb N mintát,
+ * és a mintaindexből az időbélyeg is számolható. Egy író (DMA vagy teszt forrás), tetszőleges
+ * számú olvasó mindkét magon (lásd AudioSampleReader).
+ */
+class AudioSampleRing {
+   public:
+    virtual ~AudioSampleRing() = default;
+
+    /**
+     * @brief Mintavételezés indítása
+     * @param audioPin Az audio bemenet pin száma
+     * @param sampleRateHz Kért mintavételezési frekvencia Hz-ben
+     * @return true ha sikeres
+     */
+    virtual bool start(int audioPin, float sampleRateHz) = 0;
+
+    /**
+     * @brief Mintavételezés leállítása
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Az eddig beírt minták száma (monoton növekvő abszolút írási index)
+     */
+    virtual uint32_t getWriteIndex() = 0;
+
+    /**
+     * @brief Fut-e a mintavételezés
+     */
+    bool isRunning() const { return running_; }
+
+    /**
+     * @brief A ténylegesen beállított mintavételezési frekvencia (az osztó kerekítése után)
+     */
+    float getSampleRateHz() const { return actualSampleRateHz_; }
+
+    /**
+     * @brief A kért mintavételezési frekvencia
+     */
+    float getRequestedSampleRateHz() const { return requestedSampleRateHz_; }
+
+    /**
+     * @brief Egy minta időbélyege
+     * @param sampleIndex A minta abszolút indexe
+     * @return Az indítás (szüneteltetés után a folytatás) óta eltelt idő alapján számolt időbélyeg mikroszekundumban (micros() skála)
+     */
+    uint32_t getSampleTimeUs(uint32_t sampleIndex) const { return startTimeUs_ + getElapsedUs(sampleIndex); }
+
+    /**
+     * @brief A 0. indexű mintától egy mintáig eltelt idő
+     * @param sampleIndex A minta abszolút indexe
+     * @return Mikroszekundum, a micros()-hoz hasonlóan 2^32-n körbefordulva (67.2kHz-en ~71.6 perc után)
+     */
+    uint32_t getElapsedUs(uint32_t sampleIndex) const {
+        if (actualSampleRateHz_ <= 0.0f) {
+            return 0;
+        }
+        // A 2^32 fölötti double -> uint32 konverzió nem definiált (az M0+ telít): előbb modulo 2^32
+        return static_cast<uint32_t>(fmod(static_cast<double>(sampleIndex) * 1000000.0 / actualSampleRateHz_, 4294967296.0));
+    }
+
+    /**
+     * @brief A legfrissebb minták másolása
+     * @param dst Cél puffer
+     * @param count Kért minták száma (max. RING_SIZE / 2)
+     * @return A másolt minták száma (0, ha még nincs elég minta)
+     */
+    uint16_t copyLatest(uint16_t *dst, uint16_t count);
+
+    /**
+     * @brief Minták másolása egy adott abszolút indextől
+     * @param startIndex Az első minta abszolút indexe
+     * @param dst Cél puffer
+     * @param count Kért minták száma
+     * @return A másolt minták száma (0, ha a kért tartomány már felülíródott vagy még nem létezik)
+     */
+    uint16_t copyFrom(uint32_t startIndex, uint16_t *dst, uint16_t count);
+
+   protected:
+    AudioSampleRing(uint16_t *ringBuffer) : ring_(ringBuffer), running_(false), actualSampleRateHz_(0.0f), requestedSampleRateHz_(0.0f), startTimeUs_(0) {}
+
+    uint16_t *ring_;                 // RING_SIZE elemű minta puffer
+    volatile bool running_;          // Fut-e a mintavételezés
+    float actualSampleRateHz_;       // Ténylegesen beállított mintavételezési frekvencia
+    float requestedSampleRateHz_;    // Kért mintavételezési frekvencia
+    volatile uint32_t startTimeUs_;  // A 0. indexű minta időpontja (szüneteltetés után a folytatásból visszaszámolva)
+};
+
+#endif  // AUDIO_SAMPLE_RING_H
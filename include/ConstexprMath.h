@@ -0,0 +1,80 @@
+#ifndef CONSTEXPR_MATH_H
+#define CONSTEXPR_MATH_H
+
+#include <stdint.h>
+
+/**
+ * @brief Fordítási idejű matematikai segédfüggvények a flash-ben tárolt DSP táblákhoz
+ *
+ * A <cmath> függvényei nem constexpr-ek, ezért a táblák (twiddle, ablak, FIR együtthatók)
+ * generálásához saját, double pontosságú sorfejtéseket használunk. Futásidőben nem hívandók.
+ */
+namespace ConstexprMath {
+
+constexpr double PI = 3.14159265358979323846;
+
+constexpr uint8_t COS_TAYLOR_TERMS = 14;     // |x| <= pi esetén a hiba < 1e-15
+constexpr uint8_t BESSEL_SERIES_TERMS = 32;  // x <= 20 esetén (Kaiser béta) bőven elég
+constexpr uint8_t SQRT_ITERATIONS = 40;      // Newton lépések száma
+
+/**
+ * @brief Koszinusz (Taylor sor a [-pi, pi] tartományra redukálva)
+ */
+constexpr double cos(double x) {
+    while (x > PI) x -= 2.0 * PI;
+    while (x < -PI) x += 2.0 * PI;
+
+    const double x2 = x * x;
+    double term = 1.0;
+    double sum = 1.0;
+    for (uint8_t n = 1; n < COS_TAYLOR_TERMS; n++) {
+        term *= -x2 / static_cast<double>((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * @brief Szinusz
+ */
+constexpr double sin(double x) { return cos(x - PI / 2.0); }
+
+/**
+ * @brief Négyzetgyök (Newton iteráció), negatív bemenetre 0
+ */
+constexpr double sqrt(double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    double y = x > 1.0 ? x : 1.0;
+    for (uint8_t i = 0; i < SQRT_ITERATIONS; i++) {
+        y = 0.5 * (y + x / y);
+    }
+    return y;
+}
+
+/**
+ * @brief Nulladrendű módosított Bessel függvény (a Kaiser ablakhoz)
+ */
+constexpr double besselI0(double x) {
+    const double halfX = x / 2.0;
+    double term = 1.0;
+    double sum = 1.0;
+    for (uint8_t k = 1; k < BESSEL_SERIES_TERMS; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * @brief Kerekítés Q15 formátumra
+ */
+constexpr int16_t toQ15(double value) {
+    const double scaled = value * 32767.0;
+    return static_cast<int16_t>(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+};  // namespace ConstexprMath
+
+#endif  // CONSTEXPR_MATH_H
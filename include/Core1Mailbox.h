@@ -0,0 +1,80 @@
+#ifndef CORE1_MAILBOX_H
+#define CORE1_MAILBOX_H
+
+#include <stdint.h>
+
+#include "core_communication.h"
+
+/**
+ * @brief Konstansok a Core0 <-> Core1 postafiókhoz
+ */
+namespace Core1MailboxConstants {
+
+constexpr uint8_t QUEUE_SIZE = 8;  // Üzenetek / válaszok száma irányonként (2 hatvány, a FIFO mélységével azonos)
+constexpr uint8_t QUEUE_MASK = QUEUE_SIZE - 1;
+
+};  // namespace Core1MailboxConstants
+
+/**
+ * @brief Típusos üzenetek a két mag között, közös memóriában
+ *
+ * Két zár nélküli, egy író - egy olvasó sor: Core0 -> Core1 üzenetek (Core1Message) és
+ * Core1 -> Core0 válaszok (Core1Reply). A Core0 az üzenet beírása után a sorszámát a
+ * multicore FIFO-ba teszi: a FIFO csak csengő, a Core1 egy csengetésre az összes várakozó
+ * üzenetet kiolvassa. Ha a FIFO tele, a csengetés elmaradhat, az üzenet akkor sem vész el,
+ * mert a Core1 a még bent lévő csengetések valamelyikénél kiolvassa.
+ */
+class Core1Mailbox {
+   public:
+    Core1Mailbox();
+
+    /**
+     * @brief Üzenet küldése a Core1-nek (csak a Core0 hívja)
+     * @param message Az üzenet, a sorszámát ez a függvény tölti ki
+     * @return Az üzenet sorszáma, 0 ha a postafiók tele
+     */
+    uint16_t post(Core1Message &message);
+
+    /**
+     * @brief Egy válasz kivétele (csak a Core0 hívja)
+     * @return true ha volt válasz
+     */
+    bool pollReply(Core1Reply &reply);
+
+    /**
+     * @brief Egy üzenet kivétele (csak a Core1 hívja)
+     * @return true ha volt üzenet
+     */
+    bool receive(Core1Message &message);
+
+    /**
+     * @brief Válasz egy üzenetre (csak a Core1 hívja)
+     * @return false ha a válasz sor tele (a válasz eldobódott)
+     */
+    bool reply(const Core1Message &message, Core1ReplyStatus status);
+
+    /**
+     * @brief Mindkét sor ürítése (csak leállított Core1 mellett, pl. alvás előtt)
+     */
+    void reset();
+
+    /**
+     * @brief Tele válasz sor miatt eldobott válaszok száma
+     */
+    uint32_t getDroppedReplyCount() const { return droppedReplyCount_; }
+
+   private:
+    Core1Message messages_[Core1MailboxConstants::QUEUE_SIZE];
+    Core1Reply replies_[Core1MailboxConstants::QUEUE_SIZE];
+    volatile uint32_t messageHead_;        // Csak a Core0 módosítja
+    volatile uint32_t messageTail_;        // Csak a Core1 módosítja
+    volatile uint32_t replyHead_;          // Csak a Core1 módosítja
+    volatile uint32_t replyTail_;          // Csak a Core0 módosítja
+    volatile uint32_t droppedReplyCount_;  // Csak a Core1 módosítja
+    uint16_t nextSequence_;                // Csak a Core0 használja
+};
+
+// A két mag közös példánya
+extern Core1Mailbox core1Mailbox;
+
+#endif  // CORE1_MAILBOX_H
@@ -5,116 +5,139 @@
 
 #include <cmath>  // round, sin, cos, sqrt, abs, min, max - szükséges a constexpr számításokhoz
 
-#include "Config.h"
+#include "AudioSampleReader.h"
+#include "CwTimingModel.h"
+#include "IDspTask.h"
+#include "MorseCode.h"
 #include "defines.h"  // AUDIO_INPUT_PIN, DEBUG
 
-class CwDecoder {
+class CwDecoder : public IDspTask {
    public:
-    CwDecoder(int audioPin);
+    /**
+     * @brief Konstruktor
+     * @param audioPin Az audio bemenet pin száma
+     * @param sampleSource Minta forrás (a firmware-ben a globális ADC DMA mintavételező busz, hoston pl. ArraySampleSource)
+     */
+    CwDecoder(int audioPin, AudioSampleRing &sampleSource);
     ~CwDecoder();
 
-    void updateDecoder();           // Core1 hívja ciklikusan a CW dekódoláshoz
-    char getCharacterFromBuffer();  // Core0 kéri le a dekódolt karaktert a pufferből
-    void resetDecoderState();       // Hívandó a CW módra váltáskor az állapot visszaállításáhozprivate:
+    void updateDecoder();      // Core1 hívja ciklikusan a CW dekódoláshoz
+    void resetDecoderState();  // Hívandó a CW módra váltáskor az állapot visszaállításához
 
-    // Goertzel szűrő paraméterek TARGET_FREQ-hez (automatikus számítás)
-    static constexpr float SAMPLING_FREQ = 8400.0f;
-    static constexpr short N_SAMPLES = 45;
-
-    static inline short K_CONSTANT() { return static_cast<short>((N_SAMPLES * config.data.cwReceiverOffsetHz / SAMPLING_FREQ) + 0.5f); }
-
-    static inline float OMEGA() { return (2.0f * M_PI * static_cast<float>(K_CONSTANT())) / static_cast<float>(N_SAMPLES); }
-
-    static inline float COEFF() { return 2.0f * cos(OMEGA()); }
-
-    static const unsigned long SAMPLING_PERIOD_US;  // Definiálva a .cpp fájlban
-
-    float q0, q1, q2;
-    short testData[N_SAMPLES];  // Beállított méret
+    /**
+     * @brief A vételi hangfrekvencia beállítása újrapéldányosítás nélkül (Core1 üzenetből)
+     * @param offsetHz A CW hang frekvenciája
+     */
+    void setTargetFrequency(uint16_t offsetHz);
 
-    // Morse időzítés és állapot
-    static constexpr float THRESHOLD = 250.0f;  // Beállított küszöb, kísérletezzen ezzel az értékkel (pl. 200-400)
-    static constexpr unsigned long MIN_MORSE_ELEMENT_DURATION_MS =
-        25;  // Minimum időtartam egy érvényes Morse elemhez (ms) - Ezt lehet, hogy a DOT_MIN_MS-re kellene cserélni vagy összehangolni
-    // Szünetek időzítéséhez konstansok
-    static constexpr float CHAR_GAP_DOT_MULTIPLIER = 3.0f;
-    static constexpr float WORD_GAP_DOT_MULTIPLIER = 6.5f;  // Kb. 7 dit, de a char gap-nél biztosan nagyobb
-    static constexpr unsigned long MIN_CHAR_GAP_MS_FALLBACK = 180;
-    static constexpr unsigned long MIN_WORD_GAP_MS_FALLBACK = 400;
-    static constexpr unsigned long DOT_MIN_MS = 5;                // Minimum pont hossz (ms) - 50+ WPM támogatásához
-    static constexpr unsigned long DOT_MAX_MS = 250;              // Maximum pont hossz (ms) - 7 WPM támogatásához
-    static constexpr unsigned long DASH_MAX_MS = DOT_MAX_MS * 4;  // Maximum vonás hossz (ms) - reálisabb arány
+    // IDspTask: az éleket a mintaóra időzíti, a késés csak a szöveg megjelenését halasztja
+    const char *getTaskName() const override { return "CW"; }
+    uint32_t getDeadlineUs() const override { return TASK_DEADLINE_US; }
+    uint32_t getMicrosUntilReady() override { return sampleReader_.getMicrosUntilAvailable(EDGE_CONFIRM_SAMPLES); }
+    void runTask() override { updateDecoder(); }
 
-    // Dinamikus zaj szűrés - aggresívebb beállítások 25 WPM-hez
-    static constexpr unsigned long NOISE_THRESHOLD_FACTOR = 5;  // Zaj küszöb szorzó: min_duration / 5 (toleránsabb)
-    static constexpr unsigned long MIN_ADAPTIVE_DOT_MS = 15;    // Adaptív minimum - 15ms (~40 WPM alsó határ)
-
-    short noiseBlankerLoops_;  // Megerősítések száma hang/nincs hang állapothoz
-
-    unsigned long startReferenceMs_;
-    unsigned long currentReferenceMs_;
-    unsigned long leadingEdgeTimeMs_;
-    unsigned long trailingEdgeTimeMs_;
-    unsigned long rawToneDurations_[6];  // Morse karakterek maximum 6 elem hosszúak
+   private:
+    // Csúszó Goertzel (sliding DFT) paraméterek: minden új mintánál frissül az utolsó N_SAMPLES minta energiája a célfrekvencián
+    static constexpr float SAMPLING_FREQ = 8400.0f;
+    static constexpr short N_SAMPLES = 45;               // Az ablak hossza (~5.4ms), ez határozza meg a szűrő sávszélességét
+    static constexpr float SDFT_DAMPING = 0.9999f;       // Csillapítás mintánként: a lebegőpontos kerekítési hibák nem halmozódnak fel
+    static constexpr uint16_t BLOCK_SAMPLES = 64;        // Egyszerre a buszról olvasott minták száma (stack puffer)
+    static constexpr uint8_t EDGE_CONFIRM_SAMPLES = 8;   // Ennyi egymást követő mintának kell megerősítenie egy élt (~1ms)
+    static constexpr uint32_t TASK_DEADLINE_US = 20000;  // Ennyit várhat a kész blokk (a busz olvasó ~60ms után dob el mintát)
+
+    // Adaptív hang detektor: külön követi a hang csúcsát és a zajszintet, a küszöb a kettő között van (hiszterézissel)
+    static constexpr float PEAK_ATTACK_MS = 4.0f;      // A csúcs gyors emelkedése (a leggyorsabb pont töredéke)
+    static constexpr float PEAK_DECAY_MS = 1500.0f;    // A csúcs lassú csökkenése (QSB, szóközök alatt is megmarad)
+    static constexpr float NOISE_FALL_MS = 100.0f;     // A zajszint csökkenése (csak kulcs felengedett állapotban)
+    static constexpr float NOISE_RISE_MS = 1000.0f;    // A zajszint emelkedése (csak kulcs felengedett állapotban)
+    static constexpr float KEY_DOWN_FRACTION = 0.5f;   // Lenyomott kulcs: zaj + 0.5 * (csúcs - zaj) felett
+    static constexpr float KEY_UP_FRACTION = 0.3f;     // Felengedett kulcs: zaj + 0.3 * (csúcs - zaj) alatt
+    static constexpr float MIN_PEAK_TO_NOISE = 4.0f;   // Ennél kisebb csúcs/zaj arány mellett nincs jel (a zaj nem billentyűz)
+    static constexpr float MIN_TONE_AMPLITUDE = 2.5f;  // Ennél gyengébb csúcsra (a minta skáláján) nem döntünk
+    static constexpr float PEAK_ATTACK_COEFF = 1000.0f / (PEAK_ATTACK_MS * SAMPLING_FREQ);
+    static constexpr float PEAK_DECAY_COEFF = 1000.0f / (PEAK_DECAY_MS * SAMPLING_FREQ);
+    static constexpr float NOISE_FALL_COEFF = 1000.0f / (NOISE_FALL_MS * SAMPLING_FREQ);
+    static constexpr float NOISE_RISE_COEFF = 1000.0f / (NOISE_RISE_MS * SAMPLING_FREQ);
+
+    // Karakterenkénti megbízhatóság a lenyomott és a felengedett kulcs átlagos amplitúdójának arányából (SNR)
+    static constexpr float CONFIDENCE_MIN_SNR_DB = 10.0f;   // Ezen az SNR-en 0
+    static constexpr float CONFIDENCE_FULL_SNR_DB = 20.0f;  // Ezen az SNR-en 100
+    static constexpr uint8_t MIN_LEARN_CONFIDENCE = 25;     // Ennél kisebb megbízhatóságú (zajból billentyűzött) karakter nem tanítja az időzítést
+
+    float sdftRe_, sdftIm_;           // A csúszó DFT aktuális értéke
+    float rotatorRe_, rotatorIm_;     // r * e^(jw): a mintánkénti forgatás
+    float combRe_, combIm_;           // r^N * e^(jwN): a kilépő minta együtthatója
+    int16_t sdftHistory_[N_SAMPLES];  // Az ablakban lévő minták (körkörös)
+    uint8_t sdftHistoryPos_;          // A legrégebbi minta indexe
+    uint16_t targetOffsetHz_;         // A keresett hang frekvenciája (a CORE1_CMD_SET_CW_PARAMS állítja)
+    uint16_t cachedOffsetHz_;         // Az együtthatók ehhez a targetOffsetHz_ értékhez készültek
+    uint8_t sdftWarmupSamples_;       // Ennyi minta hiányzik még a teli ablakhoz (addig a követők nem indulnak)
+
+    float peakLevel_;   // A hang követett csúcs amplitúdója (a DFT skáláján)
+    float noiseLevel_;  // A követett zajszint (a DFT skáláján)
+    bool rawKeyDown_;   // A küszöb döntés (hiszterézissel, él megerősítés előtt)
+
+    float keyDownSum_;         // Az aktuális karakter alatt: lenyomott kulcs amplitúdóinak összege
+    float keyUpSum_;           // ... felengedett kulcs amplitúdóinak összege
+    uint32_t keyDownSamples_;  // ... lenyomott kulcs minták száma
+    uint32_t keyUpSamples_;    // ... felengedett kulcs minták száma
+
+    uint8_t pendingStateSamples_;      // Ennyi minta óta tér el a nyers állapot a megerősítettől
+    unsigned long pendingEdgeTimeMs_;  // A megerősítésre váró él időpontja (mintaóra szerint)
+    bool streamClockValid_;            // Van-e már időbélyeg az olvasott folyamhoz
+    uint32_t lastBlockStartUs_;        // Az előző blokk első mintájának időbélyege
+    uint64_t streamTimeUs_;            // A mintaóra (túlcsordulás nélkül)
+
+    // Morse időzítés (a küszöböket a CwTimingModel a mért elem és szünet hosszakból adja)
+    static constexpr float INITIAL_DOT_MS = 60.0f;          // Kezdeti pont hossz (20 WPM), az első karakterek után már a mért
+    static constexpr float GLITCH_DOT_FRACTION = 0.3f;      // Ennél rövidebb (pont hosszhoz mért) jel zaj tüske, szünet a jelen belüli kimaradás
+    static constexpr unsigned long MIN_ELEMENT_MS = 12;     // A zaj tüske küszöbe legalább ennyi
+    static constexpr unsigned long MAX_NOISE_MARK_MS = 20;  // ... de legfeljebb ennyi (60 WPM-es pont), így gyorsulásnál is befog
+    static constexpr unsigned long MAX_GLITCH_MS = 10;      // A kimaradás küszöbe legfeljebb ennyi (50 WPM-es elemköz: 24ms)
+    static constexpr unsigned long MAX_ELEMENT_MS = 1000;   // Ennél hosszabb jel vivő, nem elem (5 WPM-es vonás: 720ms)
+    static constexpr unsigned long MAX_SILENCE_MS = 4000;   // Ennyi csend után a karakter állapot törlődik (a tanult sebesség marad)
+
+    CwTimingModel timing_;                                     // Pont/vonás és elemköz/karakterköz/szóköz klaszterek
+    unsigned long markStartMs_;                                // Az aktuális (vagy utolsó) jel kezdete
+    unsigned long markEndMs_;                                  // Az utolsó jel vége
+    bool markPending_;                                         // Az utolsó jel még nem végleges (egy rövid kimaradás után folytatódhat)
+    unsigned long rawToneDurations_[MorseCode::MAX_ELEMENTS];  // A karakter jelei (a leghosszabb Morse kód is belefér)
+    unsigned long rawGapDurations_[MorseCode::MAX_ELEMENTS];   // Az elemek előtti szünetek (0: a karakter előtt nem mért)
+    unsigned long pendingGapMs_;                               // Az aktuális jel előtti szünet (a jel rögzítésekor kerül a tömbbe)
     short toneIndex_;
-    unsigned long toneMaxDurationMs_;
-    unsigned long toneMinDurationMs_;
 
-    unsigned long lastActivityMs_;  // Korábban static volt a decodeNextCharacter-ben
-    unsigned long currentLetterStartTimeMs_;
-    short symbolCountForWpm_;
+    unsigned long lastActivityMs_;  // Az utolsó hang időpontja (tétlenség figyelés)
+    bool decoderStarted_;           // Volt már jel a tétlenség óta (a szünetek hossza tanítható)
+    bool measuringTone_;            // Igaz, ha éppen hangot mér (felfutó és lefutó él között)
+    bool toneDetectedState_;        // Igaz, ha a Goertzel szűrő kimenete a (megerősített) adaptív küszöb felett van
 
-    bool decoderStarted_;     // Igaz, ha egy karakter első felfutó éle észlelésre került
-    bool measuringTone_;      // Igaz, ha éppen hangot mér (felfutó és lefutó él között)
-    bool toneDetectedState_;  // Igaz, ha a Goertzel szűrő kimenete a küszöb felett van
-
-    bool inInactiveState;      // Ha inaktív állapotban vagyunk    // Szóköz dekódoláshoz
-    char lastDecodedChar_;     // Utoljára dekódolt karakter
-    bool wordSpaceProcessed_;  // Jelzi, ha egy adott csendperiódusért már adtunk szóközt
+    bool inInactiveState;   // Ha inaktív állapotban vagyunk
+    char lastDecodedChar_;  // Utoljára kiadott karakter (szóköz után ' ': a következő szünet már nem ad szóközt)
 
     // Debug kimenet optimalizálásához
     unsigned long lastSpaceDebugMs_;                                // Utolsó "Szóköz ellenőrzés" debug üzenet időpontja
     static constexpr unsigned long SPACE_DEBUG_INTERVAL_MS = 1000;  // Debug üzenetek közötti minimum idő (ms)
 
-    // Karakter puffer a folyamatos dekódoláshoz
-    static constexpr short DECODED_CHAR_BUFFER_SIZE = 3;
-    char decodedCharBuffer_[DECODED_CHAR_BUFFER_SIZE];
-    short charBufferReadPos_;
-    short charBufferWritePos_;
-    short charBufferCount_;  // Morse fa
-    static const char MORSE_TREE_SYMBOLS[];
-    static const short MORSE_TREE_ROOT_INDEX = 63;
-    static const short MORSE_TREE_INITIAL_OFFSET = 32;
-    static const short MORSE_TREE_MAX_DEPTH = 6;
-
-    short treeIndex_;
-    short treeOffset_;
-    short treeCount_;
-
     // Audio bemenet
     int audioInputPin_;
+    AudioSampleReader sampleReader_;  // Olvasó a közös minta buszon (SAMPLING_FREQ-re decimálva)
 
     // Privát metódusok
-    bool goertzelProcess();
-    bool sampleWithNoiseBlanking();
-    void processDot();
-    void processDash();
-    char getCharFromTree();
-    void resetMorseTree();
-    void updateReferenceTimings(unsigned long duration);
-    void initialize();                // Közös inicializálási logika
-    char processCollectedElements();  // Összegyűjtött Morse elemek feldolgozása
-    void addToBuffer(char c);         // Karakter hozzáadása a pufferhez
-
-    // WPM sebesség becslés az aktuális pont hossz alapján
-    uint8_t estimateWpm() const {
-        if (toneMinDurationMs_ == 9999L || toneMinDurationMs_ == 0) {
-            return 15;  // Alapértelmezett érték
-        }
-        // WPM = 1200 / (pont hossz ms-ban)
-        int wpm = 1200 / toneMinDurationMs_;
-        return constrain(wpm, 5, 30);  // Biztonságos tartomány
-    }
+    void updateGoertzelCoefficients();                                          // Együtthatók újraszámolása, ha a vételi eltolás változott
+    void resetToneDetector();                                                   // A csúszó DFT és a mintaóra alaphelyzetbe
+    float goertzelProcessSample(int16_t sample);                                // Egy minta feldolgozása, a célfrekvencia amplitúdója
+    bool detectKeyState(float magnitude);                                       // Csúcs és zajszint követés, adaptív küszöb döntés
+    uint8_t characterConfidence() const;                                        // Az aktuális karakter megbízhatósága (0..100)
+    void processToneState(bool currentToneState, unsigned long currentTimeMs);  // Az állapotgép léptetése egy (megerősített) állapottal
+    void initialize();                                                          // Közös inicializálási logika
+    unsigned long glitchMarkMs() const;                                         // Ennél rövidebb jel zaj tüske
+    unsigned long glitchGapMs() const;                                          // Ennél rövidebb szünet a jelen belüli kimaradás
+    bool isErrorSignal(unsigned long durationMs) const;                         // A teli elem tömb és az új jel is csupa pont (hosszan adott hiba jel)
+    void commitMark();                                                          // A függő jel elemként rögzítése
+    void checkSilence(unsigned long currentTimeMs);                             // Karakter/szó határ és tétlenség a szünet hossza szerint
+    void finishCharacter();                                                     // Az összegyűjtött elemek kiadása karakterként
+    char processCollectedElements();                                            // Összegyűjtött Morse elemek feldolgozása
+    void addToBuffer(char c);                                                   // Karakter átadása a Core0-nak (közös szöveg gyűrű)
 };
 
 #endif  // CWDECODER_H
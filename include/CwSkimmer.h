@@ -0,0 +1,120 @@
+#ifndef CW_SKIMMER_H
+#define CW_SKIMMER_H
+
+#include "AudioSampleReader.h"
+#include "FixedPointFftBackend.h"
+#include "IDspTask.h"
+
+/**
+ * @brief Konstansok a több csatornás CW dekóderhez
+ */
+namespace CwSkimmerConstants {
+
+constexpr float SAMPLE_RATE_HZ = 8400.0f;  // A busz olvasó cél frekvenciája (a CW dekóderrel azonos)
+constexpr uint16_t FFT_SIZE = 128;         // A közös szűrőbank: 65.6Hz-es csatornák
+constexpr uint16_t HOP_SAMPLES = 32;       // Ennyi új mintánként készül spektrum (~3.8ms időfelbontás)
+constexpr uint8_t MAX_CHANNELS = 8;        // Egyszerre dekódolt állomások maximális száma
+constexpr float MIN_TONE_HZ = 300.0f;      // A keresett hangok alsó határa
+constexpr float MAX_TONE_HZ = 2700.0f;     // A keresett hangok felső határa (SSB szűrő)
+
+constexpr float SPECTRUM_AVERAGE_ALPHA = 0.02f;  // A csúcskereső átlag spektrum együtthatója (~190ms időállandó)
+constexpr uint8_t PEAK_SCAN_HOPS = 32;           // Ennyi spektrumonként keresünk új csúcsokat (~120ms)
+constexpr float PEAK_MIN_SNR = 4.0f;             // Az átlagolt csúcs ennyiszer legyen a zajszint felett
+constexpr float NOISE_FLOOR_PERCENTILE = 0.25f;  // A zajszint a sáv bin-jeinek ennyiedik kvantilise
+constexpr uint32_t CHANNEL_TIMEOUT_HOPS = 2600;  // Ennyi spektrum után (~10s) szabadul fel a csendes csatorna
+constexpr float ENVELOPE_NOISE_ALPHA = 0.05f;    // A csatorna zajszint követése (csak kulcsolatlan állapotban)
+constexpr float ENVELOPE_PEAK_DECAY = 0.01f;     // A csatorna csúcsszint lassú csökkenése spektrumonként
+constexpr float KEY_DOWN_RATIO = 0.5f;           // Lenyomás küszöb a zaj és a csúcs között
+constexpr float KEY_UP_RATIO = 0.35f;            // Felengedés küszöb (hiszterézis)
+constexpr float MIN_KEYING_SNR = 3.0f;           // Ennél kisebb csúcs/zaj aránynál nem kulcsolunk
+constexpr float INITIAL_DOT_HOPS = 16.0f;        // Kezdeti pont hossz (~60ms, 20 WPM)
+constexpr float MIN_DOT_HOPS = 4.0f;             // ~15ms, kb. 80 WPM
+constexpr float MAX_DOT_HOPS = 64.0f;            // ~240ms, kb. 5 WPM
+constexpr uint8_t WORD_BUFFER_SIZE = 16;         // Egy csatorna szó puffere (szavanként adjuk ki)
+constexpr uint32_t TASK_DEADLINE_US = 20000;     // Ennyit várhat a kész lépés (az időzítés spektrumokban számolt)
+
+};  // namespace CwSkimmerConstants
+
+/**
+ * @brief Több csatornás CW dekóder (skimmer) a teljes hangsávra
+ *
+ * Egyetlen közös szűrőbank (128 pontos valós FFT, 32 mintás lépéssel) látja el az összes
+ * csatornát, így a költség nagy része nem nő a csatornák számával. Az átlagolt spektrum
+ * csúcsaihoz egy-egy könnyű dekóder állapot tartozik (burkoló, küszöb, időzítés, Morse kód),
+ * a csatorna a saját bin-jének magnitúdóját kapja burkolóként. A dekódolt szöveget szavanként,
+ * a csatorna hangfrekvenciájával megjelölve a közös szöveg gyűrűbe (DecodedTextRing) írja.
+ */
+class CwSkimmer : public IDspTask {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param source A közös minta busz
+     */
+    CwSkimmer(AudioSampleRing &source);
+
+    /**
+     * @brief Sikeres volt-e az FFT előkészítése
+     */
+    bool isReady() const { return ready_; }
+
+    /**
+     * @brief Az összes csatorna törlése
+     */
+    void reset();
+
+    /**
+     * @brief Az új minták feldolgozása (Core1 hívja ciklikusan)
+     */
+    void process();
+
+    // IDspTask: egy lépésnyi (HOP_SAMPLES) új mintánként fut
+    const char *getTaskName() const override { return "CW skimmer"; }
+    uint32_t getDeadlineUs() const override { return CwSkimmerConstants::TASK_DEADLINE_US; }
+    uint32_t getMicrosUntilReady() override { return ready_ ? reader_.getMicrosUntilAvailable(CwSkimmerConstants::HOP_SAMPLES) : UINT32_MAX; }
+    void runTask() override { process(); }
+
+    /**
+     * @brief Az aktív csatornák száma
+     */
+    uint8_t getActiveChannelCount() const;
+
+   private:
+    /**
+     * @brief Egy állomás dekóder állapota
+     */
+    struct Channel {
+        bool active;           // Használatban van-e
+        bool keyDown;          // A kulcs lenyomott állapota
+        uint8_t bin;           // A követett FFT bin
+        uint8_t codeBits;      // Az aktuális karakter elemei (0 = pont, 1 = vonás)
+        uint8_t codeLength;    // Az elemek száma (MorseCode::MAX_ELEMENTS felett érvénytelen)
+        uint8_t wordLength;    // A szó pufferben lévő karakterek száma
+        float noiseLevel;      // A csatorna zajszintje
+        float peakLevel;       // A csatorna csúcsszintje
+        float dotHops;         // A becsült pont hossz spektrumokban
+        uint32_t edgeHop;      // Az utolsó él időpontja
+        uint32_t lastSeenHop;  // Mikor volt utoljára csúcs a csatornán
+        char word[CwSkimmerConstants::WORD_BUFFER_SIZE];
+    };
+
+    AudioSampleReader reader_;                                 // Olvasó a közös buszon (SAMPLE_RATE_HZ)
+    FixedPointFftBackend fft_;                                 // A közös szűrőbank
+    int16_t frame_[CwSkimmerConstants::FFT_SIZE];              // Az utolsó FFT_SIZE minta
+    float magnitudes_[CwSkimmerConstants::FFT_SIZE / 2];       // Az aktuális spektrum
+    float averageSpectrum_[CwSkimmerConstants::FFT_SIZE / 2];  // Átlag spektrum a csúcskereséshez
+    Channel channels_[CwSkimmerConstants::MAX_CHANNELS];       // A csatornák
+    uint32_t hopCount_;                                        // Feldolgozott spektrumok száma
+    float binWidthHz_;                                         // Egy csatorna (bin) szélessége
+    uint8_t minBin_;                                           // MIN_TONE_HZ bin-je
+    uint8_t maxBin_;                                           // MAX_TONE_HZ bin-je
+    bool ready_;                                               // Az FFT előkészítése sikeres volt
+
+    void processHop();
+    void scanPeaks();
+    void updateChannel(Channel &channel);
+    void finishCharacter(Channel &channel);
+    void flushWord(Channel &channel);
+    uint16_t binToHz(uint8_t bin) const;
+};
+
+#endif  // CW_SKIMMER_H
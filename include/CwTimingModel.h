@@ -0,0 +1,144 @@
+#ifndef CW_TIMING_MODEL_H
+#define CW_TIMING_MODEL_H
+
+#include <stdint.h>
+
+/**
+ * @brief Konstansok a CW időzítés becsléséhez
+ */
+namespace CwTimingModelConstants {
+
+constexpr float ADAPT_RATE = 0.3f;                   // Egy új mérés súlya a betanult klaszterben (új sebességre pár karakter alatt áll át)
+constexpr float DASH_TO_DOT = 3.0f;                  // Névleges vonás/pont arány (egy összeomlott klasztert ebből pótolunk)
+constexpr float CHAR_TO_ELEMENT_GAP = 3.0f;          // Névleges karakterköz/elemköz arány
+constexpr float WORD_TO_CHAR_GAP = 7.0f / 3.0f;      // Névleges szóköz/karakterköz arány
+constexpr float MIN_DASH_TO_DOT = 2.0f;              // A vonás/pont arány alsó határa (kézi adásnál 3 körül szór)
+constexpr float MAX_DASH_TO_DOT = 5.0f;              // A vonás/pont arány felső határa
+constexpr float MIN_ELEMENT_GAP_TO_DOT = 0.4f;       // Az elemköz/pont arány alsó határa (nehéz, "súlyozott" adás)
+constexpr float MAX_ELEMENT_GAP_TO_DOT = 2.5f;       // Az elemköz/pont arány felső határa (e kívül a szünetek a jelekhez igazodnak)
+constexpr float MIN_CHAR_GAP_TO_DOT = 2.0f;          // A karakterköz/pont arány alsó határa
+constexpr float MIN_CHAR_TO_ELEMENT_GAP = 1.8f;      // A karakterköz/elemköz arány alsó határa
+constexpr float MAX_CHAR_TO_ELEMENT_GAP = 30.0f;     // A karakterköz/elemköz arány felső határa (Farnsworth adásnál sokszoros: 18/5 WPM-nél 23.5)
+constexpr float MIN_WORD_TO_CHAR_GAP = 1.6f;         // A szóköz/karakterköz arány alsó határa
+constexpr float MAX_WORD_TO_CHAR_GAP = 5.0f;         // A szóköz/karakterköz arány felső határa
+constexpr uint8_t SPLIT_RUN_LENGTH = 4;              // Ennyi, ugyanabba a klaszterbe sorolt mérés után vizsgáljuk a futam szétesését
+constexpr float SPLIT_RUN_RATIO = 2.0f;              // A futam két klaszterre esik szét, ha a leghosszabb mérése legalább ennyiszerese a legrövidebbnek
+constexpr float SPLIT_GAP_TO_WORD_GAP = 2.0f;        // Ennél hosszabb szünetnél a szóköz klaszter valójában karakterköz volt
+constexpr float MAX_LEARNED_GAP_TO_WORD_GAP = 4.0f;  // Ennél hosszabb szünet (adásszünet) nem tanít
+constexpr uint8_t MARK_UNITS_PER_WORD = 31;          // PARIS: a jelek és az elemközök hossza egységben
+constexpr uint8_t CHAR_GAPS_PER_WORD = 4;            // PARIS: a karakterközök száma (és egy szóköz)
+
+};  // namespace CwTimingModelConstants
+
+/**
+ * @brief CW időzítés becslése az elem és szünet hosszak online klaszterezésével
+ *
+ * A jelek (kulcs lenyomva) hosszát két klaszterbe (pont, vonás), a szünetekét háromba
+ * (elemköz, karakterköz, szóköz) sorolja online k-közép módszerrel: minden mérés a hozzá
+ * (logaritmikusan) legközelebbi klaszter középpontját húzza magához. A döntési küszöbök a
+ * szomszédos középpontok mértani közepei, így nem rögzített szorzókból, hanem a mért
+ * eloszlásból adódnak: kézi adás eltérő pont/vonás aránya, vagy a Farnsworth adás nyújtott
+ * karakterközei is a helyükre kerülnek. Ha két szomszédos klaszter aránya kiesik az érvényes
+ * tartományból (pl. csak pontokból álló szöveg, vagy sebességváltás), a nem frissített
+ * klasztert a névleges arányból pótolja, és a következő mérés teljes súllyal tanítja, így egy
+ * új sebességre pár karakter alatt áll át. A szünet klaszterek a pont klaszterhez vannak
+ * kötve, így a jel előtti zajból tanult szünetek sem ragadnak be; a szóköznél jóval hosszabb
+ * szünet pedig szétválasztja a szóköz klasztert (Farnsworth adásnál a nyújtott karakterköz
+ * előbb a szóköz klaszterbe kerül). Az időegység tetszőleges, de egységes (a
+ * CwDecoder-ben ms).
+ */
+class CwTimingModel {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param initialDot A kezdeti pont hossz (a névleges arányokkal ebből indul minden klaszter)
+     */
+    CwTimingModel(float initialDot);
+
+    /**
+     * @brief Vissza a kezdeti pont hosszra, a betanult klaszterek törlődnek
+     */
+    void reset();
+
+    /**
+     * @brief Egy jel (kulcs lenyomva) hosszának tanítása
+     * @return true ha a jel vonás
+     */
+    bool addMark(float duration);
+
+    /**
+     * @brief Egy szünet (két jel között) hosszának tanítása
+     */
+    void addSpace(float duration);
+
+    /**
+     * @brief Vonás-e a jel az aktuális küszöb szerint
+     */
+    bool isDash(float duration) const { return duration > dashThreshold_; }
+
+    /**
+     * @brief A pont hossz becslése
+     */
+    float getDot() const { return dot_.center; }
+
+    /**
+     * @brief A pont/vonás döntési küszöb
+     */
+    float getDashThreshold() const { return dashThreshold_; }
+
+    /**
+     * @brief Ennél hosszabb szünet karakterhatár
+     */
+    float getCharGapThreshold() const { return charGapThreshold_; }
+
+    /**
+     * @brief Ennél hosszabb szünet szóhatár
+     */
+    float getWordGapThreshold() const { return wordGapThreshold_; }
+
+    /**
+     * @brief A karakter sebesség WPM-ben (az egység a pont és a vonás átlagából, ms időegységnél)
+     */
+    uint8_t getWpm() const;
+
+    /**
+     * @brief A tényleges (Farnsworth) sebesség WPM-ben: a mért karakter- és szóközökkel számolt PARIS szó (ms időegységnél)
+     */
+    uint8_t getEffectiveWpm() const;
+
+   private:
+    /**
+     * @brief Egy klaszter középpontja és a tanító mérések száma (a kezdeti súlyhoz)
+     */
+    struct Cluster {
+        float center;
+        uint16_t count;
+    };
+
+    /**
+     * @brief Az egymás után ugyanabba a klaszterbe sorolt mérések szélsőértékei
+     */
+    struct Run {
+        float shortest;
+        float longest;
+        uint8_t cluster;  // Jeleknél 0: pont, 1: vonás; szüneteknél 0: elemköz, 1: karakterköz, 2: szóköz
+        uint8_t count;
+    };
+
+    float initialDot_;
+    Cluster dot_, dash_;                      // Jel klaszterek
+    Cluster elementGap_, charGap_, wordGap_;  // Szünet klaszterek
+    float dashThreshold_;                     // sqrt(pont * vonás)
+    float charGapThreshold_;                  // sqrt(elemköz * karakterköz)
+    float wordGapThreshold_;                  // sqrt(karakterköz * szóköz)
+    Run markRun_, gapRun_;                    // Az utolsó azonos klaszterbe sorolt mérések (a sebességváltás felismeréséhez)
+
+    static void learn(Cluster &cluster, float duration);
+    static bool trackRun(Run &run, uint8_t cluster, float duration);
+    static void splitRun(Cluster &lower, Cluster &upper, Run &run);
+    static void enforceRatio(Cluster &lower, Cluster &upper, bool keepLower, float nominalRatio, float minRatio, float maxRatio);
+    void anchorGapsToDot();
+    void updateThresholds();
+};
+
+#endif  // CW_TIMING_MODEL_H
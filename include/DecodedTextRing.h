@@ -0,0 +1,101 @@
+#ifndef DECODED_TEXT_RING_H
+#define DECODED_TEXT_RING_H
+
+#include <stdint.h>
+
+/**
+ * @brief Konstansok a dekódolt szöveg gyűrűjéhez
+ */
+namespace DecodedTextRingConstants {
+
+constexpr uint16_t RING_SIZE = 128;  // Bejegyzések száma (2 hatvány), kb. 20mp 60 WPM-es CW
+constexpr uint16_t RING_MASK = RING_SIZE - 1;
+constexpr uint8_t CONFIDENCE_UNKNOWN = 0xFF;  // A dekóder nem becsül megbízhatóságot
+
+};  // namespace DecodedTextRingConstants
+
+/**
+ * @brief A karaktert előállító dekóder
+ */
+enum class DecodedTextSource : uint8_t {
+    Cw,        // Egy csatornás CW dekóder
+    Rtty,      // RTTY dekóder
+    CwSkimmer  // Több csatornás CW dekóder
+};
+
+/**
+ * @brief Egy dekódolt karakter a metaadataival
+ */
+struct DecodedTextEntry {
+    uint32_t timestampMs;      // A dekódolás időpontja (millis)
+    uint16_t channelHz;        // CW: hangfrekvencia, RTTY: mark frekvencia, skimmer: a csatorna frekvenciája
+    uint8_t confidence;        // Megbízhatóság 0..100 (vagy CONFIDENCE_UNKNOWN)
+    uint8_t speed;             // CW: WPM, RTTY: baud
+    DecodedTextSource source;  // A dekóder
+    char character;            // A dekódolt karakter
+};
+
+/**
+ * @brief Zár nélküli, egy író - egy olvasó gyűrű a dekódolt szövegnek (Core1 -> Core0)
+ *
+ * A Core1 dekóderei közvetlenül ide írják a karaktereket, a Core0 kérés-válasz nélkül,
+ * egyszerre üríti. Az író csak a head_-et, az olvasó csak a tail_-t módosítja; a bejegyzés
+ * írása és az index közzététele között memória gát van, így a másik mag mindig kész
+ * bejegyzést lát. Tele gyűrűnél az új karakter eldobódik (az olvasó állapotához az író nem nyúl).
+ */
+class DecodedTextRing {
+   public:
+    DecodedTextRing();
+
+    /**
+     * @brief Egy bejegyzés beírása (csak az író, Core1)
+     * @return false, ha a gyűrű tele volt (a bejegyzés eldobódott)
+     */
+    bool push(const DecodedTextEntry &entry);
+
+    /**
+     * @brief Egy karakter beírása az aktuális időbélyeggel (csak az író, Core1)
+     * @return false, ha a gyűrű tele volt
+     */
+    bool push(DecodedTextSource source, char character, uint16_t channelHz, uint8_t speed, uint8_t confidence = DecodedTextRingConstants::CONFIDENCE_UNKNOWN);
+
+    /**
+     * @brief Egy bejegyzés kivétele (csak az olvasó, Core0)
+     * @return true ha volt bejegyzés
+     */
+    bool pop(DecodedTextEntry &entry);
+
+    /**
+     * @brief Több bejegyzés kivétele egyszerre (csak az olvasó, Core0)
+     * @param entries Cél tömb
+     * @param maxCount A cél tömb mérete
+     * @return A kivett bejegyzések száma
+     */
+    uint16_t popMany(DecodedTextEntry *entries, uint16_t maxCount);
+
+    /**
+     * @brief Az összes várakozó bejegyzés eldobása (csak az olvasó, pl. módváltáskor)
+     */
+    void clear();
+
+    /**
+     * @brief Várakozó bejegyzések száma
+     */
+    uint16_t available() const { return static_cast<uint16_t>(head_ - tail_); }
+
+    /**
+     * @brief Tele gyűrű miatt eldobott bejegyzések száma
+     */
+    uint32_t getDroppedCount() const { return droppedCount_; }
+
+   private:
+    DecodedTextEntry entries_[DecodedTextRingConstants::RING_SIZE];
+    volatile uint32_t head_;          // Következő írási pozíció (csak az író módosítja)
+    volatile uint32_t tail_;          // Következő olvasási pozíció (csak az olvasó módosítja)
+    volatile uint32_t droppedCount_;  // Eldobott bejegyzések (csak az író módosítja)
+};
+
+// A két mag közös példánya
+extern DecodedTextRing decodedTextRing;
+
+#endif  // DECODED_TEXT_RING_H
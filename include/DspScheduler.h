@@ -0,0 +1,94 @@
+#ifndef DSP_SCHEDULER_H
+#define DSP_SCHEDULER_H
+
+#include "IDspTask.h"
+
+/**
+ * @brief Konstansok a Core1 DSP ütemezőjéhez
+ */
+namespace DspSchedulerConstants {
+
+constexpr uint8_t MAX_TASKS = 4;           // Egyszerre futtatható feladatok száma
+constexpr uint8_t RUN_TIME_EMA_SHIFT = 3;  // A futási idő átlag együtthatója: 1/8
+
+};  // namespace DspSchedulerConstants
+
+/**
+ * @brief Egy feladat terhelés statisztikája (a Core1 írja mérési ablakonként, a Core0 olvassa)
+ */
+struct DspTaskStats {
+    const char *volatile name;         // A feladat neve, nullptr ha a hely üres
+    volatile uint16_t loadPermille;    // A feladat CPU ideje ezrelékben az utolsó ablakban
+    volatile uint32_t averageRunUs;    // Egy futás átlagos ideje
+    volatile uint32_t maxRunUs;        // A leghosszabb futás az utolsó ablakban
+    volatile uint32_t maxLatenessUs;   // A legnagyobb késés a bemenet elkészülte és a futás között az utolsó ablakban
+    volatile uint32_t shedCount;       // Kihagyott futások (háttér feladat, összesen)
+    volatile uint32_t deadlineMisses;  // Határidőn túli futások (összesen)
+};
+
+/**
+ * @brief Kooperatív, prioritásos ütemező a Core1 DSP feladatainak
+ *
+ * Minden körben először a kész Realtime feladatok (dekóderek) futnak. Egy Background feladat
+ * (pl. a kijelző FFT) csak akkor fut, ha a mért átlagos futási ideje belefér abba a tartalékba,
+ * ami a legközelebbi Realtime határidőig hátra van; különben kimarad (shed). Feladatonként
+ * méri a futási időt és a késést, az eredményt mérési ablakonként a Core0 számára közzéteszi.
+ */
+class DspScheduler {
+   public:
+    DspScheduler();
+
+    /**
+     * @brief Feladat hozzáadása (csak a Core1 hívja)
+     * @return false ha nincs szabad hely
+     */
+    bool addTask(IDspTask *task);
+
+    /**
+     * @brief Feladat eltávolítása (csak a Core1 hívja, a feladat törlése előtt)
+     */
+    void removeTask(IDspTask *task);
+
+    /**
+     * @brief Egy ütemezési kör: a kész feladatok futtatása
+     * @return Mikroszekundum a következő kész bemenetig (ennyit alhat a Core1), UINT32_MAX ha nincs feladat
+     */
+    uint32_t runReadyTasks();
+
+    /**
+     * @brief A mérési ablak lezárása, a statisztika közzététele
+     * @param windowUs Az ablak hossza
+     */
+    void publishStats(uint32_t windowUs);
+
+    /**
+     * @brief Egy feladathely statisztikája (a Core0 is olvashatja)
+     * @param index 0..MAX_TASKS-1
+     */
+    const DspTaskStats &getTaskStats(uint8_t index) const { return stats_[index]; }
+
+   private:
+    /**
+     * @brief Egy feladathely belső állapota (csak a Core1 használja)
+     */
+    struct TaskSlot {
+        IDspTask *task;
+        uint32_t readyAtUs;        // Mikorra vártuk a bemenet elkészültét (a késés méréséhez)
+        bool readyAtValid;         // Van-e érvényes readyAtUs
+        uint32_t averageRunUs;     // A futási idő mozgó átlaga
+        uint32_t windowBusyUs;     // Az ablakban futással töltött idő
+        uint32_t windowMaxRunUs;   // A leghosszabb futás az ablakban
+        uint32_t windowMaxLateUs;  // A legnagyobb késés az ablakban
+    };
+
+    TaskSlot slots_[DspSchedulerConstants::MAX_TASKS];
+    DspTaskStats stats_[DspSchedulerConstants::MAX_TASKS];
+
+    uint32_t pollSlot(TaskSlot &slot, uint32_t nowUs);
+    void runSlot(TaskSlot &slot, DspTaskStats &stats);
+};
+
+// A Core1 ütemezője, a statisztikáját a Core0 is olvassa
+extern DspScheduler dspScheduler;
+
+#endif  // DSP_SCHEDULER_H
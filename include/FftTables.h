@@ -0,0 +1,56 @@
+#ifndef FFT_TABLES_H
+#define FFT_TABLES_H
+
+#include <stdint.h>
+
+#include "IFftBackend.h"  // FftWindowType
+
+/**
+ * @brief Fordítási időben generált (constexpr) FFT táblák a flash-ben
+ *
+ * A twiddle tábla egyetlen, a legnagyobb FFT méretre szóló cos/sin fél periódus,
+ * kisebb méreteknél lépésközzel olvasandó. Az ablak táblák méretenként és típusonként
+ * külön készülnek (a szimmetria miatt csak az első fél), így méret- vagy ablakváltáskor
+ * csak egy pointert kell cserélni, futásidőben egyetlen cos() hívás sincs.
+ */
+namespace FftTables {
+
+constexpr uint16_t MIN_TABLE_FFT_SIZE = 64;                       // A legkisebb méret, amihez ablak tábla készül
+constexpr uint16_t MAX_TABLE_FFT_SIZE = 2048;                     // A twiddle tábla erre a méretre szól
+constexpr uint16_t TWIDDLE_TABLE_SIZE = MAX_TABLE_FFT_SIZE / 2;   // cos/sin(2*pi*k/MAX), k < MAX/2
+
+/**
+ * @brief cos(2*pi*k/MAX_TABLE_FFT_SIZE) Q15-ben (TWIDDLE_TABLE_SIZE elem)
+ */
+const int16_t *getTwiddleCos();
+
+/**
+ * @brief sin(2*pi*k/MAX_TABLE_FFT_SIZE) Q15-ben (TWIDDLE_TABLE_SIZE elem)
+ */
+const int16_t *getTwiddleSin();
+
+/**
+ * @brief Twiddle lépésköz egy adott FFT mérethez
+ * @param fftSize FFT méret
+ * @return A k. twiddle faktor indexe: k * lépésköz
+ */
+inline uint16_t getTwiddleStride(uint16_t fftSize) { return MAX_TABLE_FFT_SIZE / fftSize; }
+
+/**
+ * @brief Ablak tábla lekérdezése
+ * @param type Ablak típusa
+ * @param fftSize FFT méret (MIN_TABLE_FFT_SIZE..MAX_TABLE_FFT_SIZE, 2 hatványa)
+ * @return Az ablak első fele Q15-ben (fftSize/2 elem), vagy nullptr, ha nincs ilyen méret
+ */
+const int16_t *getWindow(FftWindowType type, uint16_t fftSize);
+
+/**
+ * @brief Koherens erősítés korrekció a Hamming ablakhoz képest
+ * @param type Ablak típusa
+ * @return Szorzó, amivel a magnitúdók a Hamming ablak szintjére hozhatók
+ */
+float getWindowGainCorrection(FftWindowType type);
+
+};  // namespace FftTables
+
+#endif  // FFT_TABLES_H
@@ -0,0 +1,84 @@
+#ifndef FIXED_POINT_FFT_BACKEND_H
+#define FIXED_POINT_FFT_BACKEND_H
+
+#include "IFftBackend.h"
+
+/**
+ * @brief Konstansok a fixpontos FFT-hez
+ */
+namespace FixedPointFftConstants {
+
+constexpr int32_t Q15_ONE = 32767;  // 1.0 Q15 formátumban
+constexpr uint8_t Q15_SHIFT = 15;
+
+// Egy radix-2 pillangó legfeljebb (1 + sqrt(2))-szeresére növelheti a komponenseket,
+// ezért minden fokozat előtt legfeljebb ekkora abszolút értéket engedünk
+constexpr int32_t BUTTERFLY_INPUT_LIMIT = Q15_ONE / 3;
+
+};  // namespace FixedPointFftConstants
+
+/**
+ * @brief Fixpontos (Q15) radix-2 FFT blokk lebegőpontos skálázással
+ *
+ * A teljes adatblokk egy közös kitevőt kap: minden fokozat előtt annyi bittel toljuk
+ * jobbra (vagy a legelején balra) az értékeket, hogy a pillangók ne csorduljanak túl,
+ * és a kis jelek se veszítsenek pontosságot. A négyzetösszegek 32 bitesek, a
+ * magnitúdó a kitevővel visszaskálázva kerül a float kimenetbe.
+ *
+ * Valós bemenetnél (alapértelmezés) az N valós mintát N/2 komplex mintába csomagoljuk
+ * (páros -> valós, páratlan -> képzetes rész), N/2 pontos komplex FFT-t számolunk,
+ * majd egy szétválasztó lépés állítja elő az N pontos spektrum első felét. Ez kb.
+ * felezi a számítást és a munkaterületet.
+ */
+class FixedPointFftBackend : public IFftBackend {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param realInputPacking true: N/2 pontos csomagolt transzformáció, false: teljes N pontos komplex FFT
+     */
+    FixedPointFftBackend(bool realInputPacking = true);
+    ~FixedPointFftBackend() override;
+
+    bool setSize(uint16_t size) override;
+    uint16_t getSize() const override { return size_; }
+    void setWindowType(FftWindowType type) override;
+    void computeMagnitudes(const int16_t *samples, float *magnitudes) override;
+
+    /**
+     * @brief Komplex bemenet ablakozása, FFT és magnitúdó számítás (pl. zoom FFT alapsávi jeléhez)
+     * @param re N darab valós rész
+     * @param im N darab képzetes rész
+     * @param magnitudes N elemű kimenet FFT sorrendben (0..N/2-1: pozitív, N/2..N-1: negatív frekvenciák)
+     * @return false, ha a backend csomagolt (valós bemenetű) módban van vagy nincs méret beállítva
+     */
+    bool computeComplexMagnitudes(const int16_t *re, const int16_t *im, float *magnitudes);
+
+    /**
+     * @brief Az utolsó transzformáció blokk kitevője (2 hatványa, amivel a kimenetet szorozni kell)
+     */
+    int8_t getBlockExponent() const { return blockExponent_; }
+
+   private:
+    int16_t *re_;                 // Valós rész munkaterület (workSize_ elem)
+    int16_t *im_;                 // Képzetes rész munkaterület (workSize_ elem)
+    const int16_t *twiddleCos_;   // Flash tábla: cos(2*pi*k/MAX) Q15-ben
+    const int16_t *twiddleSin_;   // Flash tábla: sin(2*pi*k/MAX) Q15-ben
+    const int16_t *window_;       // Flash tábla: az ablak első fele Q15-ben (N/2 elem, szimmetrikus)
+    uint16_t size_;               // FFT méret (N valós minta)
+    uint16_t workSize_;           // A komplex transzformáció mérete (N/2 csomagolva, különben N)
+    uint16_t twiddleStride_;      // Twiddle lépésköz az N pontos mérethez
+    FftWindowType windowType_;    // Kiválasztott ablak
+    float windowGainCorrection_;  // Koherens erősítés korrekció a Hamming ablakhoz
+    bool realInputPacking_;       // Valós bemenet csomagolása N/2 komplex mintába
+    int8_t blockExponent_;        // Az aktuális blokk kitevője
+
+    void deallocate();
+    void loadWindowed(const int16_t *samples);
+    void loadWindowedComplex(const int16_t *re, const int16_t *im);
+    void bitReverse();
+    void transform();
+    void rescaleBlock();
+    void computePackedMagnitudes(float *magnitudes);
+};
+
+#endif  // FIXED_POINT_FFT_BACKEND_H
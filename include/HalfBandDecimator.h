@@ -0,0 +1,188 @@
+#ifndef HALF_BAND_DECIMATOR_H
+#define HALF_BAND_DECIMATOR_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ConstexprMath.h"
+
+/**
+ * @brief Fordítási idejű half-band FIR tervezés (Kaiser ablakos sinc)
+ *
+ * A half-band szűrő minden második együtthatója (a középső kivételével) nulla, a középső 0.5,
+ * így N tap esetén csak (N+1)/4 különböző együtthatót kell tárolni és szorozni.
+ */
+namespace HalfBandDesign {
+
+// Az átviteli sáv széle a bemeneti mintavételi frekvencia arányában (a záró sáv 0.5 - ennyinél kezdődik).
+// Minden fokozatnál ugyanez: 67.2k->33.6k: 12kHz, 33.6k->16.8k: 6kHz, 16.8k->8.4k: 3kHz
+constexpr double PASSBAND_EDGE = 0.18;
+
+/**
+ * @brief A középponttól n távolságra lévő (páratlan n) együttható
+ * @param taps A szűrő hossza (4k+3)
+ * @param kaiserBetaX10 A Kaiser ablak béta paraméterének tízszerese
+ * @param n Távolság a középponttól
+ */
+constexpr double coefficient(uint8_t taps, uint8_t kaiserBetaX10, int16_t n) {
+    const double halfLength = (taps - 1) / 2;
+    const double beta = kaiserBetaX10 / 10.0;
+    const double ratio = n / halfLength;
+    const double sinc = ConstexprMath::sin(ConstexprMath::PI * n / 2.0) / (ConstexprMath::PI * n);
+    return sinc * ConstexprMath::besselI0(beta * ConstexprMath::sqrt(1.0 - ratio * ratio)) / ConstexprMath::besselI0(beta);
+}
+
+/**
+ * @brief A nem nulla, nem középső együtthatók Q15-ben (h[1], h[3], ... a középponttól kifelé)
+ */
+template <uint8_t Taps, uint8_t KaiserBetaX10>
+struct Coefficients {
+    static constexpr uint8_t COUNT = (Taps + 1) / 4;
+    int16_t values[COUNT];
+
+    constexpr Coefficients() : values() {
+        for (uint8_t j = 0; j < COUNT; j++) {
+            values[j] = ConstexprMath::toQ15(coefficient(Taps, KaiserBetaX10, 2 * j + 1));
+        }
+    }
+};
+
+/**
+ * @brief A kerekített (Q15) szűrő amplitúdó átvitele
+ * @param f Frekvencia a bemeneti mintavételi frekvencia arányában (0..0.5)
+ */
+template <uint8_t Taps, uint8_t KaiserBetaX10>
+constexpr double magnitude(double f) {
+    const Coefficients<Taps, KaiserBetaX10> coeffs{};
+    double sum = 0.5;
+    for (uint8_t j = 0; j < coeffs.COUNT; j++) {
+        sum += 2.0 * (coeffs.values[j] / 32767.0) * ConstexprMath::cos(2.0 * ConstexprMath::PI * f * (2 * j + 1));
+    }
+    return sum < 0.0 ? -sum : sum;
+}
+
+};  // namespace HalfBandDesign
+
+/**
+ * @brief Fixpontos half-band FIR decimátor (2-vel osztás)
+ *
+ * Polifázis formában: csak a megtartott (minden második) kimeneti mintát számolja,
+ * a szimmetria miatt minden szorzás két mintára vonatkozik. A késleltető vonal duplázott,
+ * így a szűrő ablak mindig folytonos. Helyben is hívható (out == in).
+ * A bemenet abszolút értéke 2^14 alatt maradjon (int32 akkumulátor).
+ * @tparam Taps A szűrő hossza (4k+3)
+ * @tparam KaiserBetaX10 A Kaiser ablak béta paraméterének tízszerese (nagyobb = jobb zárás, szélesebb átmenet)
+ */
+template <uint8_t Taps, uint8_t KaiserBetaX10>
+class HalfBandDecimator {
+    static_assert(Taps % 4 == 3, "A half-band szuro hossza 4k+3 kell legyen");
+
+   public:
+    HalfBandDecimator() { reset(); }
+
+    /**
+     * @brief A szűrő állapotának törlése
+     */
+    void reset() {
+        memset(history_, 0, sizeof(history_));
+        position_ = 0;
+        phase_ = 0;
+    }
+
+    /**
+     * @brief Minták decimálása
+     * @param in Bemeneti minták
+     * @param count Bemeneti minták száma
+     * @param out Kimeneti minták (lehet azonos az in-nel)
+     * @return A kimeneti minták száma (páros bemenetnél pontosan count / 2)
+     */
+    uint16_t process(const int16_t *in, uint16_t count, int16_t *out) {
+        uint16_t produced = 0;
+        for (uint16_t i = 0; i < count; i++) {
+            history_[position_] = in[i];
+            history_[position_ + Taps] = in[i];
+            position_ = position_ + 1 == Taps ? 0 : position_ + 1;
+
+            phase_ ^= 1;
+            if (phase_ == 0) {
+                out[produced++] = computeOutput();
+            }
+        }
+        return produced;
+    }
+
+   private:
+    static constexpr uint8_t CENTER = (Taps - 1) / 2;
+    static constexpr HalfBandDesign::Coefficients<Taps, KaiserBetaX10> COEFFS{};
+
+    int16_t history_[2 * Taps];  // Duplázott késleltető vonal
+    uint8_t position_;           // A legrégebbi minta indexe
+    uint8_t phase_;              // 0: a következő minta után nincs kimenet, 1: van
+
+    /**
+     * @brief Egy kimeneti minta a késleltető vonal aktuális tartalmából
+     */
+    int16_t computeOutput() const {
+        const int16_t *x = &history_[position_];  // x[0] a legrégebbi, x[Taps - 1] a legújabb
+        int32_t acc = static_cast<int32_t>(x[CENTER]) * 16384;  // 0.5 Q15-ben
+        for (uint8_t j = 0; j < COEFFS.COUNT; j++) {
+            const uint8_t k = 2 * j + 1;
+            acc += static_cast<int32_t>(COEFFS.values[j]) * (static_cast<int32_t>(x[CENTER - k]) + x[CENTER + k]);
+        }
+        acc = (acc + (1 << 14)) >> 15;
+        return static_cast<int16_t>(acc > 32767 ? 32767 : (acc < -32768 ? -32768 : acc));
+    }
+};
+
+/**
+ * @brief Decimátor fokozatok kaszkádja, futásidőben választható aktív fokozatszámmal
+ *
+ * Pl. DecimatorChain<HalfBandDecimator<23, 50>, HalfBandDecimator<31, 60>>: 1, 2 vagy 4-gyel oszt.
+ * Minden fokozat helyben dolgozik, így nincs szükség köztes pufferre.
+ */
+template <typename... Stages>
+class DecimatorChain;
+
+template <>
+class DecimatorChain<> {
+   public:
+    static constexpr uint8_t STAGE_COUNT = 0;
+
+    void reset() {}
+    uint16_t process(int16_t *, uint16_t count, uint8_t) { return count; }
+};
+
+template <typename First, typename... Rest>
+class DecimatorChain<First, Rest...> {
+   public:
+    static constexpr uint8_t STAGE_COUNT = 1 + sizeof...(Rest);
+
+    /**
+     * @brief Az összes fokozat állapotának törlése
+     */
+    void reset() {
+        first_.reset();
+        rest_.reset();
+    }
+
+    /**
+     * @brief Minták decimálása helyben
+     * @param samples Bemeneti, majd kimeneti minták
+     * @param count Bemeneti minták száma (2^activeStages többszöröse a pontos kimenethez)
+     * @param activeStages Használt fokozatok száma (0 = nincs decimálás)
+     * @return A kimeneti minták száma
+     */
+    uint16_t process(int16_t *samples, uint16_t count, uint8_t activeStages) {
+        if (activeStages == 0) {
+            return count;
+        }
+        count = first_.process(samples, count, samples);
+        return rest_.process(samples, count, activeStages - 1);
+    }
+
+   private:
+    First first_;
+    DecimatorChain<Rest...> rest_;
+};
+
+#endif  // HALF_BAND_DECIMATOR_H
@@ -0,0 +1,52 @@
+#ifndef __IDSP_TASK_H
+#define __IDSP_TASK_H
+
+#include <stdint.h>
+
+/**
+ * @brief A DSP feladatok prioritása a Core1 ütemezőjében
+ */
+enum class DspTaskPriority : uint8_t {
+    Realtime,   // Dekóderek: a bemenetüket a határidőn belül fel kell dolgozni
+    Background  // Kijelzés (pl. spektrum): kimaradhat, ha egy dekóder lekésné a határidejét
+};
+
+/**
+ * @brief A Core1 ütemezőjében (DspScheduler) futó DSP feladat interfésze
+ *
+ * A feladat a saját minta olvasójából dolgozik. Az ütemező megkérdezi, mikor lesz kész a
+ * következő bemeneti blokkja, és ha kész, meghívja a runTask()-ot. A runTask() nem várakozhat:
+ * a kész blokkokat feldolgozza és visszatér.
+ */
+class IDspTask {
+   public:
+    virtual ~IDspTask() = default;
+
+    /**
+     * @brief A feladat neve (a terhelés statisztikához, statikus szöveg)
+     */
+    virtual const char *getTaskName() const = 0;
+
+    /**
+     * @brief A feladat prioritása
+     */
+    virtual DspTaskPriority getTaskPriority() const { return DspTaskPriority::Realtime; }
+
+    /**
+     * @brief Legfeljebb ennyi ideig várhat a kész bemeneti blokk a feldolgozásra
+     */
+    virtual uint32_t getDeadlineUs() const = 0;
+
+    /**
+     * @brief Mennyi idő múlva lesz kész a következő bemeneti blokk
+     * @return Mikroszekundum, 0 ha már most kész, UINT32_MAX ha nincs bemenet
+     */
+    virtual uint32_t getMicrosUntilReady() = 0;
+
+    /**
+     * @brief A kész bemeneti blokkok feldolgozása (várakozás nélkül)
+     */
+    virtual void runTask() = 0;
+};
+
+#endif  // __IDSP_TASK_H
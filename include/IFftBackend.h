@@ -0,0 +1,56 @@
+#ifndef __IFFT_BACKEND_H
+#define __IFFT_BACKEND_H
+
+#include <stdint.h>
+
+/**
+ * @brief Választható ablakfüggvények
+ */
+enum class FftWindowType : uint8_t {
+    Hamming,         // Általános célú (alapértelmezett)
+    Hann,            // Jobb oldalsáv lecsengés
+    BlackmanHarris,  // Nagyon alacsony oldalsávok (vízesés, hangolássegéd)
+    FlatTop          // Pontos amplitúdó (szintmérés)
+};
+
+/**
+ * @brief FFT számítási backend interfész
+ *
+ * A bemenet N darab előjeles, középre igazított (és erősített) 16 bites minta,
+ * a kimenet N/2 darab magnitúdó, ablakozás után, skálázatlan DFT egységekben
+ * (Hamming ablaknál ugyanaz a skála, amit az ArduinoFFT complexToMagnitude() ad).
+ */
+class IFftBackend {
+   public:
+    virtual ~IFftBackend() = default;
+
+    /**
+     * @brief FFT méret beállítása (2 hatványa)
+     * @param size Az új FFT méret
+     * @return true ha sikeres
+     */
+    virtual bool setSize(uint16_t size) = 0;
+
+    /**
+     * @brief Aktuális FFT méret
+     */
+    virtual uint16_t getSize() const = 0;
+
+    /**
+     * @brief Ablakfüggvény kiválasztása
+     *
+     * A magnitúdók a Hamming ablak koherens erősítésére vannak normálva, így
+     * ablakváltáskor a kijelzett szintek nem ugranak.
+     * @param type Az ablak típusa
+     */
+    virtual void setWindowType(FftWindowType type) = 0;
+
+    /**
+     * @brief Ablakozás, FFT és magnitúdó számítás
+     * @param samples N darab bemeneti minta
+     * @param magnitudes N/2 elemű kimeneti tömb
+     */
+    virtual void computeMagnitudes(const int16_t *samples, float *magnitudes) = 0;
+};
+
+#endif  // __IFFT_BACKEND_H
@@ -0,0 +1,60 @@
+#ifndef __IWATERFALL_PANEL_H
+#define __IWATERFALL_PANEL_H
+
+#include <stdint.h>
+
+/**
+ * @brief A kijelző, amire a WaterfallScroller a vízesés sorait írja
+ *
+ * A firmware-ben a TftWaterfallPanel (TFT_eSPI, a sorok a TftDmaPipeline-on át), hoston egy
+ * memória modell, ami a vezérlő görgetés regisztereit (VSCRDEF/VSCRSADD) is utánozza. A sor
+ * címe mindig memória sor: görgetés nélkül ez a képernyő sora, hardveres görgetésnél a
+ * görgetett sávban a VSCRSADD szerint tolva látszik.
+ */
+class IWaterfallPanel {
+   public:
+    virtual ~IWaterfallPanel() = default;
+
+    /**
+     * @brief A képernyő magassága sorokban (az aktuális forgatással)
+     */
+    virtual uint16_t getHeight() const = 0;
+
+    /**
+     * @brief Görgethető-e a képernyő függőlegesen a vezérlő regisztereivel (az aktuális forgatással)
+     */
+    virtual bool hasHardwareScroll() const = 0;
+
+    /**
+     * @brief VSCRDEF: felső fix sáv, görgetett sáv, alsó fix sáv (sorokban, az összeg a képernyő magassága)
+     */
+    virtual void setScrollArea(uint16_t topFixedRows, uint16_t scrollRows, uint16_t bottomFixedRows) = 0;
+
+    /**
+     * @brief VSCRSADD: a görgetett sáv tetején megjelenő memória sor
+     *
+     * A korábban kiküldött sorok a görgetés előtt a kijelzőre kerülnek.
+     */
+    virtual void setScrollStart(uint16_t memoryRow) = 0;
+
+    /**
+     * @brief A görgetés kikapcsolása: a memória ismét egy az egyben látszik
+     */
+    virtual void resetScroll() = 0;
+
+    /**
+     * @brief A sor puffer (legalább WaterfallScrollerConstants::MAX_WIDTH elem, natív RGB565)
+     *
+     * Minden pushRow() előtt újra kérendő (a korábbi sor még használhatja).
+     */
+    virtual uint16_t *getRowBuffer() = 0;
+
+    /**
+     * @brief A sor puffer kiküldése egy memória sorba, a 0. oszloptól
+     * @param memoryRow A memória sor
+     * @param width A pixelek száma
+     */
+    virtual void pushRow(uint16_t memoryRow, uint16_t width) = 0;
+};
+
+#endif  // __IWATERFALL_PANEL_H
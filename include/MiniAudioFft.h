@@ -4,9 +4,9 @@
 #include <ArduinoFFT.h>
 #include <TFT_eSPI.h>
 
-#include <vector>  // std::vector használatához
-
 #include "AudioProcessor.h"
+#include "WaterfallHistory.h"
+#include "ZoomFft.h"
 #include "defines.h"  // AUDIO_INPUT_PIN és színek eléréséhez
 
 // Konstansok a MiniAudioFft komponenshez
@@ -50,7 +50,7 @@ constexpr int TUNING_AID_INTERNAL_WIDTH = MiniAudioFftConstants::MAX_INTERNAL_WI
 // Vízesés
 constexpr int WF_GRADIENT = 100;  // Vízesés színátmenetének erőssége
 // Színek a vízeséshez
-const uint16_t WATERFALL_COLORS[16] = {
+constexpr uint16_t WATERFALL_COLORS[16] = {
     0x0000,                         // TFT_BLACK (index 0)
     0x0000,                         // TFT_BLACK (index 1)
     0x0000,                         // TFT_BLACK (index 2)
@@ -66,6 +66,7 @@ const uint16_t WATERFALL_COLORS[16] = {
     0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF  // Fehér a csúcsokhoz
 };  // A színek változatlanok
 constexpr int MAX_WATERFALL_COLOR_INPUT_VALUE = 20000;  // Maximális bemeneti érték a vízesés színkonverziójához
+constexpr uint8_t WATERFALL_PALETTE_FULL_SCALE = MAX_WATERFALL_COLOR_INPUT_VALUE / WF_GRADIENT;  // A wabuf bájt, ahol a paletta telítődik
 
 }  // namespace MiniAudioFftConstants
 
@@ -133,10 +134,12 @@ class MiniAudioFft {
     float currentConfiguredMaxDisplayAudioFreqHz;  // Az AM/FM módnak megfelelő maximális frekvencia
     float& activeFftGainConfigRef;                 // Referencia az aktív FFT erősítés konfigurációra (AM vagy FM)
     AudioProcessor* pAudioProcessor;               // Pointer az audio feldolgozó osztályra (dinamikus FFT mérettel)
+    ZoomFft* pZoomFft;                             // Zoom FFT a hangolássegédhez (csak TuningAid módban létezik)
 
     // Pufferek a különböző módokhoz
     int Rpeak[MiniAudioFftConstants::LOW_RES_BANDS + 1];  // Csúcsértékek az alacsony felbontású spektrumhoz
-    std::vector<std::vector<uint8_t>> wabuf;              // Vízeséshez és burkológörbéhez, méretezése a konstruktorban történik
+    WaterfallHistory wabuf;                               // Vízesés/burkológörbe/hangolássegéd előzmény (egy foglalás, a konstruktorban)
+    uint16_t* lineBuf_;                                   // Egy vízesés oszlop/hangolássegéd sor RGB565 színei (max(width, height) elem)
     // Az osciSamples mostantól az AudioProcessor része
     TFT_eSprite sprGraph;  // Sprite a grafikonokhoz (Waterfall, TuningAid)
     bool spriteCreated;    // Jelzi, hogy a sprGraph létre van-e hozva
@@ -155,6 +158,10 @@ class MiniAudioFft {
      * @brief Vált a következő megjelenítési módra.
      */
     void cycleMode();
+    /**
+     * @brief Az előzmény (wabuf) alakjának beállítása és törlése a módhoz.
+     */
+    void resetHistoryForMode(DisplayMode mode);
     /**
      * @brief Kirajzolja az aktuális mód nevét a komponens aljára.
      */
@@ -170,15 +177,13 @@ class MiniAudioFft {
     void drawOscilloscope();
     void drawWaterfall();
     void drawTuningAid();  // Hangolást segítő mód kirajzolása
+    void updateZoomFft();  // Zoom FFT létrehozása/hangolása a TuningAid sávjára, más módban felszabadítása
     void drawEnvelope();
 
     // Segédfüggvények az alacsony felbontású spektrumhoz
     uint8_t getBandVal(int fft_bin_index, int min_bin_low_res, int num_bins_low_res_range);
     void drawSpectrumBar(int band_idx, double magnitude, int actual_start_x_on_screen, int peak_max_height_for_mode, int current_bar_width_pixels);
 
-    // Segédfüggvény a vízesés/burkológörbe színeihez
-    uint16_t valueToWaterfallColor(int scaled_value);
-
     // Segédfüggvények a grafikon és a módkijelző területének meghatározásához
     /**
      * @brief Visszaadja a módkijelző területének magasságát pixelekben.
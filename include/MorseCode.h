@@ -0,0 +1,58 @@
+#ifndef MORSE_CODE_H
+#define MORSE_CODE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Fordítási időben generált (constexpr) Morse kód tábla a flash-ben
+ *
+ * A kód az elemek száma és a bitmintája (0 = pont, 1 = vonás, az első elem a legmagasabb
+ * használt biten); a tábla indexe a kód egy vezető 1-es bittel (1 << hossz | minta), így a
+ * különböző hosszú kódok nem ütköznek, és egy karakter dekódolása egyetlen táblaolvasás.
+ * A tábla a MorseCode.cpp jelkészletéből készül: új jel (pl. ékezetes betű) egy sor ott.
+ */
+namespace MorseCode {
+
+constexpr uint8_t MAX_ELEMENTS = 8;                   // A leghosszabb kód (a hiba jel 8 pont)
+constexpr uint16_t TABLE_SIZE = 2u << MAX_ELEMENTS;   // Az 1..MAX_ELEMENTS hosszú kódok indexe ez alatt van
+
+// Prosignok: nem nyomtatható, egy bájtos jelek a szöveg gyűrűben, a kijelző a getProsignText() szövegét írja ki
+constexpr char PROSIGN_AR = '\x01';     // .-.-.  üzenet vége (a '+' kódja)
+constexpr char PROSIGN_SK = '\x02';     // ...-.- összeköttetés vége
+constexpr char PROSIGN_BT = '\x03';     // -...-  elválasztó (a '=' kódja)
+constexpr char PROSIGN_KN = '\x04';     // -.--.  csak a hívott állomás adjon (a '(' kódja)
+constexpr char PROSIGN_ERROR = '\x05';  // ........ hiba, javítás
+
+// Ékezetes betűk a HA operátoroknak: a kijelző GLCD fontjának (CP437) kódjai
+constexpr char LETTER_A_ACUTE = '\xA0';   // .--.-  (a CP437-ben csak kis 'á' van)
+constexpr char LETTER_E_ACUTE = '\x90';   // ..-..  'É'
+constexpr char LETTER_O_UMLAUT = '\x99';  // ---.   'Ö'
+constexpr char LETTER_U_UMLAUT = '\x9A';  // ..--   'Ü' (és 'Ű')
+
+/**
+ * @brief Egy teljes elem sorozat dekódolása
+ * @param codeBits Az elemek, az első elem a legmagasabb használt biten (0 = pont, 1 = vonás)
+ * @param codeLength Az elemek száma (1..MAX_ELEMENTS)
+ * @return A karakter vagy prosign, vagy '\0' ha a sorozat érvénytelen
+ */
+char decode(uint8_t codeBits, uint8_t codeLength);
+
+/**
+ * @brief Egy karakter (vagy prosign) kódja (pl. jelgeneráláshoz)
+ * @param symbol A karakter (a kisbetű a nagybetű kódját kapja)
+ * @param codeBits Ide kerülnek az elemek, az első elem a legmagasabb használt biten
+ * @param codeLength Ide kerül az elemek száma
+ * @return false ha a jel nincs a jelkészletben
+ */
+bool encode(char symbol, uint8_t &codeBits, uint8_t &codeLength);
+
+/**
+ * @brief A prosign kiírandó szövege
+ * @param symbol A dekódolt jel
+ * @return Pl. "<AR>", vagy nullptr ha a jel nem prosign
+ */
+const char *getProsignText(char symbol);
+
+};  // namespace MorseCode
+
+#endif  // MORSE_CODE_H
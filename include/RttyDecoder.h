@@ -5,110 +5,166 @@
 
 #include <cmath>
 
+#include "AudioSampleReader.h"
+#include "IDspTask.h"
+#include "RttyToneTracker.h"
 #include "defines.h"
 
-class RttyDecoder {
+class RttyDecoder : public IDspTask {
    public:
-    RttyDecoder(int audioPin);
+    /**
+     * @brief Konstruktor
+     * @param audioPin Az audio bemenet pin száma
+     * @param sampleSource Minta forrás (a firmware-ben a globális ADC DMA mintavételező busz, hoston pl. ArraySampleSource)
+     */
+    RttyDecoder(int audioPin, AudioSampleRing &sampleSource);
     ~RttyDecoder();
-    void updateDecoder();           // Core1 hívja ciklikusan az RTTY dekódoláshoz
-    char getCharacterFromBuffer();  // Core0 kéri le a dekódolt karaktert a pufferből
-    void resetDecoderState();       // Hívandó az RTTY módra váltáskor az állapot visszaállításához   private:
-    // Goertzel szűrő paraméterek Mark/Space frekvenciákhoz (automatikus számítás)
+    void updateDecoder();      // Core1 hívja ciklikusan az RTTY dekódoláshoz
+    void resetDecoderState();  // Hívandó az RTTY módra váltáskor az állapot visszaállításához
+
+    /**
+     * @brief Mark/shift/baud beállítása újrapéldányosítás nélkül (Core1 üzenetből)
+     * @param markHz Mark frekvencia
+     * @param shiftHz Shift (a space a mark alatt van)
+     * @param baudRate Baud, 0 = automatikus detektálás (45 = 45.45 baud)
+     */
+    void setParameters(float markHz, float shiftHz, uint16_t baudRate);
+
+    // IDspTask: a bit órát a minták száma lépteti, a késés csak a szöveg megjelenését halasztja
+    const char *getTaskName() const override { return "RTTY"; }
+    uint32_t getDeadlineUs() const override { return TASK_DEADLINE_US; }
+    uint32_t getMicrosUntilReady() override { return sampleReader_.getMicrosUntilAvailable(BLOCK_SAMPLES); }
+    void runTask() override { updateDecoder(); }
+
+    /**
+     * @brief Érvénytelen (space) stop bit miatt eldobott karakterek száma a legutóbbi alaphelyzet óta
+     */
+    uint32_t getFramingErrorCount() const { return framingErrors_; }
+
+    /**
+     * @brief Egy Baudot (ITA2) kód karaktere
+     * @param baudotCode Az 5 bites kód
+     * @param figsShift true = FIGS, false = LTRS tábla
+     * @return A karakter, '\0' a váltó kódoknál (LTRS/FIGS) és a nem használt kódnál
+     */
+    static char getBaudotCharacter(uint8_t baudotCode, bool figsShift) { return figsShift ? BAUDOT_FIGS_TABLE[baudotCode & 0x1F] : BAUDOT_LTRS_TABLE[baudotCode & 0x1F]; }
+
+   private:
+    // Folyamatos demodulátor: mark/space keverés, bit hosszú illesztett szűrő (mozgó összeg), ATC döntés mintánként
     static constexpr float SAMPLING_FREQ = 8400.0f;
-    static constexpr short N_SAMPLES = 84;  // 10ms ablak
-
-    static inline short K_MARK(float markFreq) { return static_cast<short>((N_SAMPLES * markFreq / SAMPLING_FREQ) + 0.5f); }
-
-    static inline float OMEGA_MARK(float markFreq) { return (2.0f * M_PI * static_cast<float>(K_MARK(markFreq))) / static_cast<float>(N_SAMPLES); }
-
-    static inline float COEFF_MARK(float markFreq) { return 2.0f * cos(OMEGA_MARK(markFreq)); }
-
-    static inline short K_SPACE(float spaceFreq) { return static_cast<short>((N_SAMPLES * spaceFreq / SAMPLING_FREQ) + 0.5f); }
-
-    static inline float OMEGA_SPACE(float spaceFreq) { return (2.0f * M_PI * static_cast<float>(K_SPACE(spaceFreq))) / static_cast<float>(N_SAMPLES); }
-
-    static inline float COEFF_SPACE(float spaceFreq) { return 2.0f * cos(OMEGA_SPACE(spaceFreq)); }
-
-    static const unsigned long SAMPLING_PERIOD_US;
-
-    // Goertzel szűrő változók Mark-hoz
-    float q0_mark, q1_mark, q2_mark;
-    // Goertzel szűrő változók Space-hez
-    float q0_space, q1_space, q2_space;
-
-    short testData[N_SAMPLES];
-
-    // RTTY detektálási paraméterek
-    static constexpr float SIGNAL_THRESHOLD = 100.0f;          // Minimális jelerősség küszöb
-    static constexpr float MARK_SPACE_RATIO_THRESHOLD = 1.5f;  // Mark/Space vagy Space/Mark arány küszöb
-
-    // RTTY időzítés és állapot
-    static constexpr unsigned long MIN_BAUD_RATE = 45;                          // 45 baud (22ms/bit)
-    static constexpr unsigned long MAX_BAUD_RATE = 100;                         // 100 baud (10ms/bit)
-    static constexpr unsigned long MIN_BIT_DURATION_MS = 1000 / MAX_BAUD_RATE;  // 10ms
-    static constexpr unsigned long MAX_BIT_DURATION_MS = 1000 / MIN_BAUD_RATE;  // 22ms
-    static constexpr unsigned long DEFAULT_BIT_DURATION_MS = 22;                // 45.45 baud alapértelmezett
-
-    // Timing toleranciák
-    static constexpr unsigned long BIT_TIMING_TOLERANCE_MS = 3;        // ±3ms tolerancia bit időzítéshez
-    static constexpr unsigned long START_BIT_CONFIRM_DELAY_RATIO = 3;  // Start bit megerősítés: bit_duration / 3
-
-    // Shift frekvencia detektálás
-    static constexpr float TARGET_SHIFT_850HZ = 850.0f;  // 850Hz shift
-    static constexpr float TARGET_SHIFT_170HZ = 170.0f;  // 170Hz shift (defines.h-ban megadott)
-    static constexpr float SHIFT_TOLERANCE = 25.0f;      // ±25Hz tolerancia
+    static constexpr uint16_t BLOCK_SAMPLES = 42;        // Egyszerre a buszról olvasott minták száma (5ms, stack puffer)
+    static constexpr uint32_t TASK_DEADLINE_US = 20000;  // Ennyit várhat a kész blokk (a busz olvasó ~60ms után dob el mintát)
+    static constexpr uint16_t MAX_BIT_SAMPLES = 186;     // A leghosszabb bit (45.45 baud: 184.8 minta), az illesztett szűrő puffere
+    static constexpr uint8_t NCO_PHASE_SHIFT = 21;       // 32 bites fázis -> 11 bites index a 2048 pontos twiddle táblában
+
+    // RTTY detektálási paraméterek (amplitúdó a minta skáláján)
+    static constexpr float MIN_SIGNAL_AMPLITUDE = 2.5f;     // Ennél gyengébb (ATC csúcs) jelre nem döntünk
+    static constexpr float SQUELCH_OPEN_CONTRAST = 0.5f;    // |mark - space| / (mark + space) átlaga e fölött: van jel
+    static constexpr float SQUELCH_CLOSE_CONTRAST = 0.35f;  // ... e alatt: nincs jel (hiszterézis)
+    static constexpr float SQUELCH_BITS = 4.0f;             // A kontraszt átlagolási ideje bitekben
+
+    // ATC (automatikus küszöb korrekció) időállandói bitekben
+    static constexpr float ATC_FAST_BITS = 0.25f;     // Csúcs felfelé, zajszint lefelé (gyors követés)
+    static constexpr float ATC_PEAK_BITS = 16.0f;     // A csúcs lassú csökkenése (QSB alatt a küszöb lassan követ)
+    static constexpr float ATC_PEAK_MAX_MS = 180.0f;  // Rögzített baudnál legfeljebb ennyi: lassú baudnál a mély szelektív fadinget is kövesse
+    static constexpr float ATC_NOISE_BITS = 48.0f;    // A zajszint lassú emelkedése
+
+    // Bit óra
+    static constexpr uint8_t EARLY_LATE_GAIN_SHIFT = 2;  // Egy váltás fázishibájának 1/4-ét javítjuk (zajos váltásokra se ugrik)
+    static constexpr float BAUD_RATES[] = {45.45f, 50.0f, 75.0f, 100.0f};
+    static constexpr uint8_t BAUD_RATE_COUNT = sizeof(BAUD_RATES) / sizeof(BAUD_RATES[0]);
+    static constexpr float DEFAULT_BAUD_RATE = 45.45f;
+
+    // Baud detektálás a space futamok hosszából
+    static constexpr uint8_t RUN_HISTORY_SIZE = 24;       // Utolsó ennyi space futam hossza
+    static constexpr uint8_t MIN_RUNS_FOR_ESTIMATE = 12;  // Ennyi futam után becsülünk
+    static constexpr float MIN_RUN_BITS = 0.5f;           // A leggyorsabb baud fél bitjénél rövidebb futam zaj
+    static constexpr uint8_t MAX_RUN_BITS = 6;            // Start bit + 5 adat bit; ennél hosszabb futam (pl. szünet) nem számít
+    static constexpr float RUN_FIT_TOLERANCE = 0.25f;     // Ennyi bitnél közelebb legyen a futam egy egész bit számhoz
+    static constexpr float BAUD_SWITCH_MARGIN = 1.1f;     // A másik baud rate pontja ennyiszer legyen jobb a váltáshoz
+
+    // Hang követés (RttyToneTracker)
+    static constexpr float TONE_JUMP_HZ = 25.0f;  // Ennél nagyobb áthangolás új jel: az ATC és a baud detektálás újraindul
+
+    /**
+     * @brief Egy hang (mark vagy space) illesztett szűrője és ATC szintjei
+     */
+    struct ToneFilter {
+        uint32_t phase;                     // A keverő NCO fázisa
+        uint32_t phaseStep;                 // Fázis lépés mintánként (frekvencia)
+        int32_t sumI, sumQ;                 // Az utolsó bitnyi kevert minta összege (illesztett szűrő)
+        int16_t historyI[MAX_BIT_SAMPLES];  // Az ablakban lévő kevert minták (körkörös)
+        int16_t historyQ[MAX_BIT_SAMPLES];
+        float peak;   // ATC: a hang csúcs amplitúdója
+        float noise;  // ATC: a hang zajszintje (amikor nem szól)
+    };
 
     // RTTY állapotgép
     enum RttyState { IDLE, WAITING_FOR_START_BIT, RECEIVING_DATA_BITS, RECEIVING_STOP_BIT };
 
+    ToneFilter mark_;
+    ToneFilter space_;
+    uint16_t windowSamples_;  // Az illesztett szűrő hossza (egy bit mintákban)
+    uint16_t windowPos_;      // A legrégebbi minta indexe a szűrő pufferében
+    uint16_t windowFill_;     // A szűrőbe került minták (amíg nem telt meg: nincs döntés)
+    float amplitudeScale_;    // Összeg -> amplitúdó (2 / windowSamples_)
+    float atcFastCoeff_;      // Az ATC együtthatói a bit hosszhoz
+    float atcPeakCoeff_;
+    float atcNoiseCoeff_;
+    float squelchCoeff_;  // A kontraszt átlagolás együtthatója a bit hosszhoz
+    float contrast_;      // A mark/space burkolók átlagos kontrasztja (squelch)
+
     RttyState currentState_;
-    unsigned long bitDurationMs_;
-    unsigned long lastBitTimeMs_;
-    unsigned long startBitTimeMs_;
+    int32_t bitSamplesQ8_;     // Egy bit hossza mintákban, Q8 (a 45.45 baud nem egész)
+    int32_t nextBitSampleQ8_;  // Ennyi minta múlva mintavételezzük a következő bitet (Q8)
     short bitsReceived_;
     uint8_t currentByte_;
-    bool currentToneState_;  // true = Mark, false = Space
+    bool currentToneState_;  // true = Mark, false = Space (az ATC döntés)
     bool lastToneState_;
+    bool signalPresent_;  // A squelch nyitva
 
     // Automatikus detektálás
     bool autoDetectActive_;
-    unsigned long autoDetectStartMs_;
-    static constexpr unsigned long AUTO_DETECT_TIMEOUT_MS = 10000;  // 10 sec
     float detectedMarkFreq_;
     float detectedSpaceFreq_;
     float detectedShiftFreq_;
-    unsigned long detectedBaudRate_;
+    float detectedBaudRate_;
 
     // Baudrate detektálás
-    unsigned long transitionTimes_[10];  // Utolsó 10 állapotváltás időpontja
-    short transitionIndex_;
-    unsigned long lastTransitionMs_;
+    uint16_t runLengths_[RUN_HISTORY_SIZE];  // Space futamok hossza mintákban
+    uint8_t runIndex_;
+    uint8_t runCount_;
+    uint32_t samplesSinceTransition_;
 
-    // Karakter puffer
-    static constexpr short DECODED_CHAR_BUFFER_SIZE = 5;
-    char decodedCharBuffer_[DECODED_CHAR_BUFFER_SIZE];
-    short charBufferReadPos_;
-    short charBufferWritePos_;
-    short charBufferCount_;
+    // Statisztika
+    uint32_t framingErrors_;  // Érvénytelen stop bit miatt eldobott karakterek
 
     // Baudot kód tábla
     static const char BAUDOT_LTRS_TABLE[32];
     static const char BAUDOT_FIGS_TABLE[32];
-    bool figsShift_;  // true = FIGS mód, false = LTRS mód    // Audio bemenet
+    bool figsShift_;  // true = FIGS mód, false = LTRS mód
+
+    // Audio bemenet
     int audioInputPin_;
+    AudioSampleReader sampleReader_;  // Olvasó a közös minta buszon (SAMPLING_FREQ-re decimálva)
+    RttyToneTracker toneTracker_;     // A mark/space hangok keresése és követése
 
     // Privát metódusok
     void initialize();
-    bool processGoertzelFilters(bool& isMarkStronger);
-    bool detectToneState();
-    void updateBaudRateDetection();
-    bool detectShiftFrequency();
+    void configureTones();
+    void configureBitTiming(float baudRate);
+    void processSamples(const int16_t *samples, uint16_t count);
+    void sliceSample(int16_t sample);
+    void updateAtc(float markAmplitude, float spaceAmplitude);
+    void runBitClock(bool transition);
+    void updateBaudRateDetection(bool transition);
+    float scoreBaudRate(float baudRate) const;
+    float estimateBaudRate() const;
+    void updateToneTracking();
     char decodeBaudotCharacter(uint8_t baudotCode);
-    void addToBuffer(char c);
+    void addToBuffer(char c);  // Karakter átadása a Core0-nak (közös szöveg gyűrű)
     void resetRttyStateMachine();
-    unsigned long estimateBaudRate();
-    void autoTuneFrequencies();
+    static void mixTone(ToneFilter &tone, int32_t x, uint16_t pos, const int16_t *cosTable, const int16_t *sinTable);  // Keverés és illesztett szűrő léptetés
 };
 
 #endif  // RTTYDECODER_H
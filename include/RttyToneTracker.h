@@ -0,0 +1,107 @@
+#ifndef RTTY_TONE_TRACKER_H
+#define RTTY_TONE_TRACKER_H
+
+#include <stdint.h>
+
+#include "FixedPointFftBackend.h"
+
+/**
+ * @brief Konstansok az RTTY mark/space hang követőhöz
+ */
+namespace RttyToneTrackerConstants {
+
+constexpr uint16_t FFT_SIZE = 512;                       // 8400Hz-nél 16.4Hz-es bin, 61ms-os keret
+constexpr float AVERAGE_COEFF = 0.125f;                  // A spektrum exponenciális átlaga (~8 keret: a mark és a space is benne legyen)
+constexpr float SEARCH_RANGE_HZ = 250.0f;                // A mark keresése a beállított mark körül (+/-)
+constexpr float SHIFTS_HZ[] = {170.0f, 425.0f, 850.0f};  // A felismert shift-ek
+constexpr uint8_t SHIFT_COUNT = sizeof(SHIFTS_HZ) / sizeof(SHIFTS_HZ[0]);
+constexpr float MIN_PEAK_TO_FLOOR = 3.0f;  // Mindkét hang átlagos csúcsa legalább ennyiszerese legyen a sáv átlagának
+constexpr float LOOP_GAIN = 0.25f;         // A követő hurok erősítése keretenként (a mért hiba ennyied része)
+constexpr float MAX_LOOP_STEP_HZ = 4.0f;   // Keretenként legfeljebb ennyit mozdul a követés
+constexpr float PULL_IN_HZ = 40.0f;        // Ennél messzebbi csúcs már nem sodródás, hanem új jel (újra befogás)
+constexpr uint8_t CONFIRM_FRAMES = 3;      // Ennyi egyező keret kell a befogáshoz vagy shift váltáshoz
+
+};  // namespace RttyToneTrackerConstants
+
+/**
+ * @brief RTTY mark/space hang követő átlagolt spektrumból
+ *
+ * A dekóder mintáiból 512 pontos fixpontos FFT-t számol (Hann ablak), a magnitúdókat
+ * exponenciálisan átlagolja, így egy RTTY jelnél a mark és a space is csúcsot ad. A beállított
+ * mark körül mindhárom szabványos shift-tel megkeresi a legjobb hang párt (a két csúcs
+ * közül a gyengébb számít, így egy vivő nem téveszthető RTTY-nak), a csúcsokat parabolikus
+ * interpolációval bin alatti pontossággal becsüli. Egy új jelet (vagy shift-et) néhány egyező
+ * keret után fog be, utána kis erősítésű hurokkal követi a sodródást. Kb. 60ms-onként egy FFT,
+ * a keresés pár száz összehasonlítás.
+ */
+class RttyToneTracker {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param sampleRateHz A bemeneti minták frekvenciája
+     */
+    RttyToneTracker(float sampleRateHz);
+
+    /**
+     * @brief Sikeres volt-e az FFT munkaterület foglalása
+     */
+    bool isReady() const { return fft_.getSize() != 0; }
+
+    /**
+     * @brief Új keresés a beállított hangok körül (a befogás és az átlag törlődik)
+     * @param markHz A beállított mark frekvencia (a keresés közepe)
+     * @param shiftHz A beállított shift (befogásig ezt jelenti a getShiftHz())
+     */
+    void reset(float markHz, float shiftHz);
+
+    /**
+     * @brief Minták hozzáadása; egy teljes keretnél új spektrum és becslés
+     * @return true ha a követett frekvenciák frissültek
+     */
+    bool addSamples(const int16_t *samples, uint16_t count);
+
+    /**
+     * @brief Befogott-e már egy RTTY jelet
+     */
+    bool isLocked() const { return locked_; }
+
+    /**
+     * @brief A követett mark frekvencia (befogás előtt a beállított)
+     */
+    float getMarkHz() const { return markHz_; }
+
+    /**
+     * @brief A követett space frekvencia (befogás előtt a beállított)
+     */
+    float getSpaceHz() const { return spaceHz_; }
+
+    /**
+     * @brief A felismert névleges shift (170/425/850Hz; befogás előtt a beállított)
+     */
+    float getShiftHz() const { return shiftHz_; }
+
+   private:
+    FixedPointFftBackend fft_;
+    int16_t frame_[RttyToneTrackerConstants::FFT_SIZE];  // A gyűlő keret
+    uint16_t frameFill_;
+    float magnitudes_[RttyToneTrackerConstants::FFT_SIZE / 2];  // Az utolsó keret spektruma
+    float average_[RttyToneTrackerConstants::FFT_SIZE / 2];     // Az átlagolt spektrum
+    bool averagePrimed_;
+    float binWidthHz_;
+
+    float anchorMarkHz_;  // A keresés közepe (a beállított mark)
+    float markHz_;
+    float spaceHz_;
+    float shiftHz_;
+    bool locked_;
+
+    // Befogás / shift váltás megerősítése
+    float candidateMarkHz_;
+    float candidateShiftHz_;
+    uint8_t candidateFrames_;
+
+    bool analyzeFrame();
+    float refinePeakHz(uint16_t bin) const;
+};
+
+#endif  // RTTY_TONE_TRACKER_H
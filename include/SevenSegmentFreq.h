@@ -22,23 +22,47 @@ struct SegmentColors {
 class SevenSegmentFreq {
 
    private:
+    static constexpr uint8_t MAX_CELLS = 9;  // A leghosszabb maszk ("88 888.88") karaktereinek száma
+
     TFT_eSPI& tft;
-    TFT_eSprite spr;
+    TFT_eSprite spr;  // Elrendezésenként (maszkonként) egyszer foglalt, a kijelzett frekvenciát tartja
     Band& band;
 
     uint16_t freqDispX, freqDispY;
     bool screenSaverActive;
     bool simpleMode = false;  // Egyszerű mód, csak a frekvenciát mutatja
 
+    // A sprite aktuális tartalma: csak a megváltozott cellákat rajzoljuk újra és küldjük ki
+    const char* layoutMask = nullptr;            // A sprite elrendezése (nullptr: nincs sprite)
+    uint8_t cellCount = 0;                       // A maszk karaktereinek száma
+    int16_t cellX[MAX_CELLS] = {};               // A cellák origója a sprite-ban
+    char shownText[MAX_CELLS + 1] = {};          // A cellákban lévő aktív karakterek
+    const SegmentColors* shownColors = nullptr;  // A sprite színei
+    bool shownDigitLight = false;                // Az inaktív szegmensek látszanak-e a sprite-ban
+    uint16_t pushedX = 0, pushedY = 0;           // Ahova a sprite utoljára kiment
+    bool screenValid = false;                    // A képernyőn a sprite teljes tartalma látszik-e
+
+    /**
+     * @brief A sprite és a cellák beállítása egy maszkhoz (csak ha változott a maszk)
+     * @param mask A maszk
+     * @return false, ha nem sikerült a sprite-ot lefoglalni
+     */
+    bool setupLayout(const char* mask);
+
     /**
      * @brief Kirajzolja a frekvenciát a megadott formátumban.
      *
+     * A sprite-ban csak a megváltozott karakterek cellái rajzolódnak újra, és csak ezek
+     * oszlopai mennek ki a kijelzőre. Teljes kirajzolás elrendezés, szín vagy pozíció
+     * váltáskor, illetve az invalidate() után van.
+     *
      * @param freq A megjelenítendő frekvencia.
      * @param mask A nem aktív szegmensek maszkja.
      * @param colors A szegmensek színei.
      * @param unit A mértékegység.
+     * @return true, ha teljes kirajzolás volt (a kiegészítő feliratokat is rajzolni kell)
      */
-    void drawFrequency(const String& freq, const char* mask, const SegmentColors& colors, const char* unit = nullptr);
+    bool drawFrequency(const String& freq, const char* mask, const SegmentColors& colors, const char* unit = nullptr);
 
     /**
      * @brief Kiválasztja a megfelelő szegmens színeket az aktuális mód alapján.
@@ -98,6 +122,11 @@ class SevenSegmentFreq {
      */
     void freqDispl(uint16_t freq);
 
+    /**
+     * @brief A kijelzett frekvencia érvénytelenítése (a képernyő törlése után): a következő freqDispl() mindent újrarajzol
+     */
+    inline void invalidate() { screenValid = false; }
+
     /**
      * Pozíció beállítása (pl.: a ScreenSaver számára)
      */
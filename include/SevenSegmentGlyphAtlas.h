@@ -0,0 +1,84 @@
+#ifndef SEVEN_SEGMENT_GLYPH_ATLAS_H
+#define SEVEN_SEGMENT_GLYPH_ATLAS_H
+
+#include <TFT_eSPI.h>
+
+/**
+ * @brief Előre raszterizált 7 szegmenses karakterek (számjegyek, '-', '.', ' ') egy GFX fontból
+ *
+ * A font bitfolyamát egyszer, induláskor bontjuk soronkénti bitmaszkokra, így egy karakter
+ * kirajzolása a sprite pufferébe soronként egy maszk végigolvasása: nincs font értelmezés,
+ * nincs pixelenkénti TFT_eSPI hívás. A karakterek helye ugyanaz, mint a TFT_eSPI drawString()
+ * rajzolásánál (origó = a szöveg kurzor X, alapvonal = a BR_DATUM alapvonala).
+ */
+class SevenSegmentGlyphAtlas {
+   public:
+    static constexpr const char *CHARS = " -.0123456789";  // Az atlaszban lévő karakterek
+    static constexpr uint8_t CHAR_COUNT = 13;
+    static constexpr uint8_t MAX_GLYPH_HEIGHT = 40;  // Sorok karakterenként (a szélesség legfeljebb 32)
+
+    /**
+     * @brief Egy raszterizált karakter
+     */
+    struct Glyph {
+        int8_t xOffset;                   // A bal szél az origóhoz képest
+        int8_t yOffset;                   // A felső sor az alapvonalhoz képest
+        uint8_t width;                    // Szélesség pixelben
+        uint8_t height;                   // Magasság pixelben
+        uint8_t xAdvance;                 // A kurzor léptetése
+        uint32_t rows[MAX_GLYPH_HEIGHT];  // Soronként egy bitmaszk, a legfelső bit a bal szél
+    };
+
+    /**
+     * @brief Az atlasz felépítése
+     * @param font A 7 szegmenses GFX font
+     */
+    explicit SevenSegmentGlyphAtlas(const GFXfont &font);
+
+    /**
+     * @brief Egy karakter az atlaszból
+     * @return nullptr, ha a karakter nincs az atlaszban
+     */
+    const Glyph *getGlyph(char c) const;
+
+    /**
+     * @brief A karakter utáni kurzor léptetés (0, ha nincs az atlaszban)
+     */
+    uint8_t getAdvance(char c) const;
+
+    /**
+     * @brief A font legnagyobb alapvonal alatti kiterjedése (mint a TFT_eSPI setFreeFont()-ban)
+     *
+     * BR_DATUM esetén a szöveg alapvonala a megadott Y fölött ennyivel van.
+     */
+    uint8_t getDescent() const { return descent_; }
+
+    /**
+     * @brief A karakter oszlop tartományának hozzáadása egy [left, right) tartományhoz
+     * @param c A karakter
+     * @param originX A karakter origója
+     * @param left A tartomány bal széle (bővül)
+     * @param right A tartomány jobb széle, kizárólagos (bővül)
+     */
+    void addGlyphSpan(char c, int16_t originX, int16_t &left, int16_t &right) const;
+
+    /**
+     * @brief Egy karakter kirajzolása átlátszó háttérrel egy 16 bites sprite pufferébe
+     * @param pixels A sprite puffere (a kijelző bájtsorrendjében, mint a TFT_eSprite)
+     * @param bufWidth A puffer szélessége
+     * @param bufHeight A puffer magassága
+     * @param originX A karakter origója
+     * @param baselineY Az alapvonal
+     * @param c A karakter (ha nincs az atlaszban, nem rajzol semmit)
+     * @param color A szín (natív RGB565)
+     */
+    void drawGlyph(uint16_t *pixels, int16_t bufWidth, int16_t bufHeight, int16_t originX, int16_t baselineY, char c, uint16_t color) const;
+
+   private:
+    Glyph glyphs_[CHAR_COUNT];
+    uint8_t descent_;
+
+    static int8_t indexOf(char c);
+};
+
+#endif  // SEVEN_SEGMENT_GLYPH_ATLAS_H
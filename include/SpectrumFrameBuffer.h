@@ -0,0 +1,101 @@
+#ifndef SPECTRUM_FRAME_BUFFER_H
+#define SPECTRUM_FRAME_BUFFER_H
+
+#include <stdint.h>
+
+#include "AudioProcessor.h"
+
+/**
+ * @brief Konstansok a spektrum képkockák hármas pufferéhez
+ */
+namespace SpectrumFrameBufferConstants {
+
+constexpr uint8_t FRAME_COUNT = 3;                                           // Író, legfrissebb és olvasó képkocka
+constexpr uint16_t MAX_BINS = AudioProcessorConstants::MAX_FFT_SAMPLES / 2;  // Legfeljebb ennyi magnitúdó fér egy képkockába
+constexpr uint8_t NO_FRAME = 0xFF;                                           // Nincs (még) közzétett / olvasott képkocka
+
+// Minden FFT méret, amit az AudioProcessor::setFftSize() elfogad, a Core1-en is számolható legyen
+// (különben a kijelző a CORE1_START_TIMEOUT_MS után csendben a Core0-ra esne vissza)
+static_assert(MAX_BINS * 2 >= AudioProcessorConstants::MAX_FFT_SAMPLES, "A spektrum kepkocka nem fer el a legnagyobb FFT meret magnitudoit");
+
+};  // namespace SpectrumFrameBufferConstants
+
+/**
+ * @brief Egy kész spektrum képkocka (a Core1 AudioProcessor-ának eredménye)
+ */
+struct SpectrumFrame {
+    uint32_t sequence;                                             // Közzétételi sorszám (1-től)
+    uint16_t session;                                              // A Core0 kérésének azonosítója (a START üzenet sorszáma)
+    uint16_t fftSize;                                              // Az FFT mérete (a magnitúdók száma ennek fele)
+    FftWindowType windowType;                                      // A számításnál használt ablakfüggvény
+    bool hasOsci;                                                  // Az oszcilloszkóp minták érvényesek
+    float magnitudes[SpectrumFrameBufferConstants::MAX_BINS];      // Magnitúdók
+    int osciSamples[AudioProcessorConstants::MAX_INTERNAL_WIDTH];  // Oszcilloszkóp minták
+};
+
+/**
+ * @brief Zár nélküli hármas puffer a spektrum képkockáknak (Core1 -> Core0)
+ *
+ * A Core1 mindig egy olyan képkockába ír, ami se nem a legfrissebb közzétett, se nem az,
+ * amit a Core0 éppen olvas, így egyik mag sem vár a másikra: a Core0 rajzolás előtt elveszi
+ * a legfrissebbet, a közbenső képkockák egyszerűen felülíródnak. Az olvasó a választott
+ * indexet közzéteszi, majd ellenőrzi, hogy közben nem jött-e újabb; az író a közzététel után
+ * olvassa az olvasó indexét (mindkettő memória gáttal), így a kettő közül legalább az egyik
+ * látja a másik lépését.
+ */
+class SpectrumFrameBuffer {
+   public:
+    SpectrumFrameBuffer();
+
+    /**
+     * @brief Az írható képkocka (csak a Core1)
+     */
+    SpectrumFrame &beginWrite() { return frames_[writeIndex_]; }
+
+    /**
+     * @brief A beginWrite() képkockájának közzététele (csak a Core1)
+     */
+    void publish();
+
+    /**
+     * @brief A közzétett képkockák eldobása, pl. új kérés előtt (csak a Core1)
+     */
+    void reset();
+
+    /**
+     * @brief A Core0 elvette-e már a legfrissebb képkockát (csak a Core1)
+     */
+    bool isLatestConsumed() const;
+
+    /**
+     * @brief A legfrissebb képkocka elvétele (csak a Core0)
+     * @return A képkocka, ami a következő hívásig nem íródik felül; nullptr ha nincs közzétett képkocka
+     */
+    const SpectrumFrame *acquireLatest();
+
+    /**
+     * @brief Eddig közzétett képkockák száma (a képkocka sebesség méréséhez)
+     */
+    uint32_t getPublishedCount() const { return publishedCount_; }
+
+    /**
+     * @brief A Core0 által elvett új képkockák száma (a kirajzolt képkocka sebesség méréséhez)
+     */
+    uint32_t getAcquiredCount() const { return acquiredCount_; }
+
+   private:
+    SpectrumFrame frames_[SpectrumFrameBufferConstants::FRAME_COUNT];
+    volatile uint8_t latestIndex_;        // Csak a Core1 módosítja
+    volatile uint8_t readIndex_;          // Csak a Core0 módosítja
+    uint8_t writeIndex_;                  // Csak a Core1 használja
+    volatile uint32_t publishedCount_;    // Csak a Core1 módosítja
+    volatile uint32_t acquiredSequence_;  // Az utoljára elvett képkocka sorszáma, csak a Core0 módosítja
+    volatile uint32_t acquiredCount_;     // Csak a Core0 módosítja
+
+    void selectWriteIndex();
+};
+
+// A két mag közös példánya
+extern SpectrumFrameBuffer spectrumFrameBuffer;
+
+#endif  // SPECTRUM_FRAME_BUFFER_H
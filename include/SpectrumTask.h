@@ -0,0 +1,66 @@
+#ifndef SPECTRUM_TASK_H
+#define SPECTRUM_TASK_H
+
+#include "AudioProcessor.h"
+#include "IDspTask.h"
+#include "SpectrumFrameBuffer.h"
+#include "core_communication.h"
+
+/**
+ * @brief Konstansok a Core1 spektrum feladatához
+ */
+namespace SpectrumTaskConstants {
+
+constexpr uint32_t CONSUMER_POLL_US = 2000;  // Ennyi idő múlva nézünk újra, ha a Core0 még nem vette el az előző képkockát
+
+};  // namespace SpectrumTaskConstants
+
+/**
+ * @brief A kijelző spektrumának számítása a Core1-en (DspScheduler háttér feladat)
+ *
+ * Saját AudioProcessor-ral számol, az eredményt a közös hármas pufferbe (SpectrumFrameBuffer)
+ * teszi. Új képkockát csak akkor számol, ha a képkocka idő letelt és a Core0 az előzőt már
+ * elvette, így a lassan rajzoló kijelző nem pazarolja a Core1 idejét. Háttér feladatként kimarad,
+ * ha egy dekóder lekésné a határidejét.
+ */
+class SpectrumTask : public IDspTask {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param params A CORE1_CMD_SPECTRUM_START paraméterei
+     * @param session A START üzenet sorszáma (a képkockák ezzel jelöltek)
+     */
+    SpectrumTask(const Core1SpectrumParams &params, uint16_t session);
+
+    /**
+     * @brief Sikeres volt-e az AudioProcessor előkészítése (és az eredmény elfér-e egy képkockában)
+     */
+    bool isReady() const { return processor_.getFftSize() != 0 && processor_.getMagnitudeDataSize() <= SpectrumFrameBufferConstants::MAX_BINS; }
+
+    /**
+     * @brief A kérés azonosítója
+     */
+    uint16_t getSession() const { return session_; }
+
+    /**
+     * @brief A futó számítás beállítása (CORE1_CMD_SPECTRUM_CONFIG)
+     * @return false ha az FFT méret nem fér a képkockába vagy nem állítható be
+     */
+    bool configure(const Core1SpectrumParams &params);
+
+    // IDspTask: képkocka időnként fut, háttér prioritással
+    const char *getTaskName() const override { return "Spectrum"; }
+    DspTaskPriority getTaskPriority() const override { return DspTaskPriority::Background; }
+    uint32_t getDeadlineUs() const override { return frameIntervalUs_; }
+    uint32_t getMicrosUntilReady() override;
+    void runTask() override;
+
+   private:
+    AudioProcessor processor_;
+    uint16_t session_;
+    bool collectOsci_;
+    uint32_t frameIntervalUs_;
+    uint32_t lastFrameUs_;
+};
+
+#endif  // SPECTRUM_TASK_H
@@ -0,0 +1,100 @@
+#ifndef TFT_DMA_PIPELINE_H
+#define TFT_DMA_PIPELINE_H
+
+#include <TFT_eSPI.h>
+
+/**
+ * @brief Konstansok a TFT DMA csővezetékhez
+ */
+namespace TftDmaPipelineConstants {
+
+constexpr uint16_t MAX_LINE_PIXELS = 480;  // A leghosszabb sor (a kijelző szélessége fekvő helyzetben)
+
+};  // namespace TftDmaPipelineConstants
+
+/**
+ * @brief Aszinkron (DMA) kiküldés a TFT-re, egy képkocka a levegőben
+ *
+ * A komponensek a kész sprite-ot vagy sort beküldik (submitSprite/submitLine), a DMA viszont
+ * csak a képernyő loop végén indul (startPendingFrame), amikor az adott UI körben már nincs több
+ * szinkron TFT írás. Amíg a képkocka megy, a CPU a fő loop nem kijelző munkáját végzi (rotary,
+ * I2C lekérdezések, Core1 válaszok); a következő TFT hozzáférés előtt a waitForFrame() a
+ * kerítés: megvárja a DMA végét és elengedi a CS-t. A DisplayBase::loop minden kör elején
+ * hívja, így a komponensek sosem írnak a levegőben lévő pufferbe, és a touch olvasás (közös
+ * SPI busz) sem ütközik a DMA-val. Ha a DMA nem indítható, a beküldés szinkron kiküldés.
+ */
+class TftDmaPipeline {
+   public:
+    explicit TftDmaPipeline(TFT_eSPI &tft);
+
+    /**
+     * @brief A DMA csatorna lefoglalása (a tft.init() után)
+     * @return false ha nincs DMA: minden beküldés szinkron marad
+     */
+    bool begin();
+
+    /**
+     * @brief Egy sprite kiküldése a képernyő loop végén
+     * @param sprite A 16 bites sprite (a waitForFrame()-ig nem módosítható, nem törölhető)
+     * @param x A bal felső sarok X koordinátája a képernyőn
+     * @param y A bal felső sarok Y koordinátája a képernyőn
+     */
+    void submitSprite(TFT_eSprite &sprite, int32_t x, int32_t y);
+
+    /**
+     * @brief A sor puffer (MAX_LINE_PIXELS elem), natív RGB565 színekkel töltendő
+     *
+     * Ha egy korábban beküldött sor még a pufferben vár vagy megy, előbb kiküldi (kerítés),
+     * így egy UI körben több sor is beküldhető. Minden submitLine() előtt újra kérendő.
+     */
+    uint16_t *getLineBuffer();
+
+    /**
+     * @brief A sor puffer kiküldése a képernyő loop végén
+     * @param x A sor kezdete
+     * @param y A sor Y koordinátája
+     * @param length A pixelek száma (legfeljebb MAX_LINE_PIXELS)
+     */
+    void submitLine(int32_t x, int32_t y, uint16_t length);
+
+    /**
+     * @brief A beküldött képkocka DMA indítása (a képernyő loop végén)
+     */
+    void startPendingFrame();
+
+    /**
+     * @brief Megy-e még képkocka (a puffere nem írható)
+     */
+    bool isFrameInFlight();
+
+    /**
+     * @brief Kerítés: a levegőben lévő képkocka megvárása, a még el nem indított kiküldése
+     *
+     * Minden szinkron TFT hozzáférés és a beküldött sprite törlése előtt hívandó.
+     */
+    void waitForFrame();
+
+   private:
+    /**
+     * @brief Egy beküldött, még el nem indított kiküldés (a puffer a kijelző bájtsorrendjében)
+     */
+    struct PendingFrame {
+        uint16_t *pixels;  // nullptr: nincs beküldött képkocka
+        int32_t x, y, w, h;
+    };
+
+    TFT_eSPI &tft_;
+    bool dmaEnabled_;
+    bool frameInFlight_;
+    PendingFrame pending_;
+    uint16_t lineBuffer_[TftDmaPipelineConstants::MAX_LINE_PIXELS];
+
+    void submit(uint16_t *pixels, int32_t x, int32_t y, int32_t w, int32_t h);
+    void waitForDma();
+    void pushBlocking(const PendingFrame &frame);
+};
+
+// Globális TFT DMA csővezeték (main.cpp)
+extern TftDmaPipeline tftDma;
+
+#endif  // TFT_DMA_PIPELINE_H
@@ -0,0 +1,51 @@
+#ifndef TFT_WATERFALL_PANEL_H
+#define TFT_WATERFALL_PANEL_H
+
+#include <TFT_eSPI.h>
+
+#include "IWaterfallPanel.h"
+
+/**
+ * @brief Konstansok a TFT vízesés panelhez
+ */
+namespace TftWaterfallPanelConstants {
+
+constexpr uint8_t CMD_VSCRDEF = 0x33;   // Vertical Scrolling Definition: felső fix sáv, görgetett sáv, alsó fix sáv (sorokban)
+constexpr uint8_t CMD_VSCRSADD = 0x37;  // Vertical Scrolling Start Address: a görgetett sáv tetején megjelenő memória sor
+
+};  // namespace TftWaterfallPanelConstants
+
+/**
+ * @brief A WaterfallScroller kijelzője a TFT_eSPI-n
+ *
+ * A sorok a TftDmaPipeline sor pufferén át, DMA-val mennek ki (a képernyő loop végén), a
+ * görgetés parancsai előtt a kerítés kiviszi a még váró sort. A VSCRDEF/VSCRSADD a vezérlő
+ * álló (natív) sor irányában görget: csak ILI9341/ILI9488/ST7789 osztályú panelen, 0-s
+ * forgatásnál esik egybe a képernyő függőleges irányával. Ez a rádió fekvő (1-es) forgatással
+ * fut, ott a görgetés oszlopokat mozgatna (a státuszsort és a gombokat is), ezért a
+ * WaterfallScroller a szoftveres gyűrűt használja.
+ */
+class TftWaterfallPanel : public IWaterfallPanel {
+   public:
+    explicit TftWaterfallPanel(TFT_eSPI &tft) : tft_(tft) {}
+
+    uint16_t getHeight() const override { return tft_.height(); }
+    bool hasHardwareScroll() const override;
+    void setScrollArea(uint16_t topFixedRows, uint16_t scrollRows, uint16_t bottomFixedRows) override;
+    void setScrollStart(uint16_t memoryRow) override;
+    void resetScroll() override { resetPanelScroll(tft_); }
+    uint16_t *getRowBuffer() override;
+    void pushRow(uint16_t memoryRow, uint16_t width) override;
+
+    /**
+     * @brief A panel görgetésének alaphelyzetbe állítása (képernyőváltáskor, pl. a képernyővédő előtt)
+     */
+    static void resetPanelScroll(TFT_eSPI &tft);
+
+   private:
+    TFT_eSPI &tft_;
+
+    static void writeScrollDefinition(TFT_eSPI &tft, uint16_t topFixedRows, uint16_t scrollRows, uint16_t bottomFixedRows);
+};
+
+#endif  // TFT_WATERFALL_PANEL_H
@@ -0,0 +1,102 @@
+#ifndef WATERFALL_HISTORY_H
+#define WATERFALL_HISTORY_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <new>
+
+/**
+ * @brief Vízesés előzmény: egyetlen összefüggő 2D gyűrű
+ *
+ * Az előzmény időszeletekből áll (egy szelet = egy spektrum a kijelzett bin-ekkel), a
+ * legújabb szelet helyét a head_ index jelöli. Új szelet felvétele a legrégebbi felülírása
+ * és a head_ léptetése, így egy kijelzett sor/oszlop hozzáadása a szelet hosszával arányos,
+ * nem a teljes előzménnyel (nincs soronkénti eltolás). A szeletek egy foglalásban, egymás után
+ * vannak (egy szelet összefüggő, a spektrum bejárása cache barát). Módváltáskor az alak
+ * (szelet hossz x szeletszám) a meglévő tárban változik, új foglalás csak nagyobb igénynél kell.
+ */
+class WaterfallHistory {
+   public:
+    WaterfallHistory() : data_(nullptr), capacity_(0), sliceLength_(0), sliceCount_(0), head_(0) {}
+    ~WaterfallHistory() { delete[] data_; }
+
+    WaterfallHistory(const WaterfallHistory &) = delete;
+    WaterfallHistory &operator=(const WaterfallHistory &) = delete;
+
+    /**
+     * @brief Az előzmény alakjának beállítása, törléssel
+     * @param sliceLength Egy szelet hossza (a kijelzett bin-ek száma)
+     * @param sliceCount A megőrzött szeletek száma
+     * @return false ha a tár nem foglalható le (az előzmény üres marad)
+     */
+    bool reshape(uint16_t sliceLength, uint16_t sliceCount) {
+        const uint32_t required = static_cast<uint32_t>(sliceLength) * sliceCount;
+        if (required > capacity_) {
+            delete[] data_;
+            data_ = new (std::nothrow) uint8_t[required];
+            capacity_ = data_ != nullptr ? required : 0;
+        }
+        if (data_ == nullptr || required == 0) {
+            sliceLength_ = 0;
+            sliceCount_ = 0;
+            return false;
+        }
+        sliceLength_ = sliceLength;
+        sliceCount_ = sliceCount;
+        clear();
+        return true;
+    }
+
+    /**
+     * @brief Az összes szelet nullázása
+     */
+    void clear() {
+        if (data_ != nullptr) {
+            memset(data_, 0, static_cast<uint32_t>(sliceLength_) * sliceCount_);
+        }
+        head_ = 0;
+    }
+
+    /**
+     * @brief Van-e használható tár
+     */
+    bool isEmpty() const { return sliceCount_ == 0; }
+
+    /**
+     * @brief Egy szelet hossza
+     */
+    uint16_t getSliceLength() const { return sliceLength_; }
+
+    /**
+     * @brief A megőrzött szeletek száma
+     */
+    uint16_t getSliceCount() const { return sliceCount_; }
+
+    /**
+     * @brief Új szelet: a legrégebbi helyére lép, a hívó tölti ki
+     * @return Az új (legújabb) szelet
+     */
+    uint8_t *push() {
+        head_ = (head_ + 1 == sliceCount_) ? 0 : head_ + 1;
+        return &data_[static_cast<uint32_t>(head_) * sliceLength_];
+    }
+
+    /**
+     * @brief Egy szelet a kora szerint
+     * @param age 0: a legújabb, getSliceCount() - 1: a legrégebbi
+     */
+    const uint8_t *getSlice(uint16_t age) const {
+        const uint16_t index = (age <= head_) ? head_ - age : head_ + sliceCount_ - age;
+        return &data_[static_cast<uint32_t>(index) * sliceLength_];
+    }
+
+   private:
+    uint8_t *data_;
+    uint32_t capacity_;     // A lefoglalt tár bájtokban
+    uint16_t sliceLength_;  // Egy szelet hossza
+    uint16_t sliceCount_;   // A szeletek száma
+    uint16_t head_;         // A legújabb szelet indexe
+};
+
+#endif  // WATERFALL_HISTORY_H
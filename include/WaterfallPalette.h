@@ -0,0 +1,55 @@
+#ifndef WATERFALL_PALETTE_H
+#define WATERFALL_PALETTE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Fordítási időben generált 256 elemes RGB565 paletta (LUT) a vízesés bájtjaihoz
+ *
+ * A vízesés minden pixele egy 0..255 közé skálázott bájt; a paletta ezt egyetlen tábla-
+ * olvasással alakítja színné, a színátmenet lépcsőit (gradient) és a telítési szintet
+ * (fullScaleValue, e fölött a legutolsó szín) a fordító számolja ki. A rajzolás így pixelenként
+ * nem normalizál lebegőpontosan és nem vág (constrain), egy sort a mapLine() tölt egy
+ * sor pufferbe, amit egyetlen pushImage() visz ki.
+ *
+ * @tparam GradientSize A színátmenet lépcsőinek száma
+ */
+template <uint8_t GradientSize>
+class WaterfallPalette {
+   public:
+    static constexpr uint16_t SIZE = 256;  // Egy bájt minden értékének van színe
+
+    /**
+     * @brief A tábla kiszámítása (constexpr)
+     * @param gradient A színátmenet lépcsői RGB565-ben (az első a leggyengébb jelé)
+     * @param fullScaleValue A bájt érték, ahol a színátmenet eléri az utolsó lépcsőt (1..255)
+     */
+    constexpr WaterfallPalette(const uint16_t (&gradient)[GradientSize], uint8_t fullScaleValue) : colors_() {
+        for (uint16_t value = 0; value < SIZE; value++) {
+            const uint16_t clipped = value < fullScaleValue ? value : fullScaleValue;
+            colors_[value] = gradient[clipped * (GradientSize - 1) / fullScaleValue];
+        }
+    }
+
+    /**
+     * @brief Egy érték színe
+     */
+    constexpr uint16_t operator[](uint8_t value) const { return colors_[value]; }
+
+    /**
+     * @brief Egy sor (vagy oszlop) színei egy sor pufferbe
+     * @param values A bájt értékek
+     * @param pixels Ide kerülnek az RGB565 színek
+     * @param count Az értékek száma
+     */
+    void mapLine(const uint8_t *values, uint16_t *pixels, uint16_t count) const {
+        for (uint16_t i = 0; i < count; i++) {
+            pixels[i] = colors_[values[i]];
+        }
+    }
+
+   private:
+    uint16_t colors_[SIZE];
+};
+
+#endif  // WATERFALL_PALETTE_H
@@ -0,0 +1,112 @@
+#ifndef WATERFALL_SCROLLER_H
+#define WATERFALL_SCROLLER_H
+
+#include <stdint.h>
+
+#include "IWaterfallPanel.h"
+#include "WaterfallHistory.h"
+#include "WaterfallPalette.h"
+
+/**
+ * @brief Konstansok a vízesés görgetőhöz
+ */
+namespace WaterfallScrollerConstants {
+
+constexpr uint16_t MAX_WIDTH = 480;              // A leghosszabb sor pixelben (a kijelző szélessége fekvő helyzetben)
+constexpr uint16_t SOFTWARE_ROWS_PER_PASS = 24;  // Szoftveres görgetésnél egy update() ennyi sort rajzol újra (ILI9488, 27MHz SPI: ~10ms)
+constexpr uint16_t SOFTWARE_SWEEP_SLACK = 16;    // Az előzmény ennyi sorral hosszabb a sávnál: az újrarajzolás közben érkező sorok nem írják felül a még rajzolandókat
+
+};  // namespace WaterfallScrollerConstants
+
+/**
+ * @brief A görgetés módja
+ */
+enum class WaterfallScrollMode : uint8_t {
+    Hardware,  // VSCRDEF/VSCRSADD: egy új sor pontosan egy sor írás, az előzmény ingyen csúszik
+    Software,  // Gyűrű a memóriában, a sáv az előzményből, kor szerint rajzolódik újra (a kép valóban görget)
+    Wrap       // Végső tartalék (nincs tár az előzménynek): a sor a sávban körbe ír, a következő sort előre töröljük
+};
+
+/**
+ * @brief Lefelé görgetett vízesés egy képernyő sávban
+ *
+ * A sor a paletta bájtjaiból áll (0: leggyengébb jel), a hossza lehet kisebb a sáv
+ * szélességénél (pl. a kijelzett FFT bin-ek száma): rajzoláskor a legközelebbi elem
+ * nyúlik a pixelekre. A legújabb sor mindig a sáv tetején van.
+ *
+ * Hardveres görgetésnél az új sor a sáv legrégebbi memória sorába kerül (a sorok a sávban
+ * felfelé lépnek, körbefordulva), a VSCRSADD ezt teszi a sáv tetejére; a sáv fölött és
+ * alatt a VSCRDEF fix sávjai (státuszsor, skála, gombok) állnak. A vezérlő a saját (álló)
+ * sor irányában görget, ezért ez csak ott megy, ahol a panel ezt jelzi (0-s forgatás).
+ *
+ * Szoftveres görgetésnél a sorok a WaterfallHistory gyűrűbe kerülnek, az update() pedig
+ * körönként SOFTWARE_ROWS_PER_PASS sort rajzol újra fentről lefelé, a legújabbtól kezdve.
+ * Egy végigrajzolás a kezdetekori állapotot mutatja (az közben érkező sorok a következőben
+ * jelennek meg), így a kép nem szakad el, és egy UI kör sem blokkol a teljes sáv idejéig.
+ */
+class WaterfallScroller {
+   public:
+    WaterfallScroller();
+
+    /**
+     * @brief A görgetett sáv beállítása (a sáv törlése a hívóé)
+     * @param panel A kijelző
+     * @param palette A sor bájtjainak színei (a 0. a sáv háttere)
+     * @param areaTop A sáv első képernyő sora
+     * @param areaHeight A sáv magassága sorokban
+     * @param width A sáv szélessége pixelben (legfeljebb MAX_WIDTH)
+     * @return true ha hardveres görgetés megy
+     */
+    bool begin(IWaterfallPanel &panel, const WaterfallPalette<16> &palette, uint16_t areaTop, uint16_t areaHeight, uint16_t width);
+
+    /**
+     * @brief A görgetés kikapcsolása (a memória ismét egy az egyben látszik), a képernyő elhagyásakor
+     */
+    void end();
+
+    /**
+     * @brief Új sor a sáv tetejére
+     * @param levels A sor paletta bájtjai
+     * @param length Az elemek száma (1..MAX_WIDTH; ha változik, az előzmény törlődik)
+     */
+    void addLine(const uint8_t *levels, uint16_t length);
+
+    /**
+     * @brief Szoftveres görgetésnél a sáv következő sorainak újrarajzolása (minden UI körben hívandó)
+     */
+    void update();
+
+    /**
+     * @brief A görgetés módja
+     */
+    WaterfallScrollMode getMode() const { return mode_; }
+
+    /**
+     * @brief Van-e még újrarajzolandó sor (szoftveres görgetés)
+     */
+    bool isRedrawPending() const { return sweepRow_ < areaHeight_; }
+
+   private:
+    IWaterfallPanel *panel_;
+    const WaterfallPalette<16> *palette_;
+    uint16_t areaTop_;
+    uint16_t areaHeight_;
+    uint16_t width_;
+    WaterfallScrollMode mode_;
+
+    uint16_t lineLength_;                                        // Egy sor elemeinek száma (0: még nincs sor)
+    uint16_t columnMap_[WaterfallScrollerConstants::MAX_WIDTH];  // Pixel -> a sor eleme (legközelebbi)
+    uint16_t headOffset_;                                        // Hardveres és Wrap mód: a legújabb sor helye a sávban
+
+    WaterfallHistory history_;  // Szoftveres mód: a sorok, a legújabb a push() helyén
+    uint16_t sweepRow_;         // A következő újrarajzolandó sor a sávban (areaHeight_: nincs rajzolás)
+    uint16_t sweepAge_;         // A rajzolás kezdete óta érkezett sorok (a sáv i. sora az i + sweepAge_ korú sor)
+    bool sweepDirty_;           // A rajzolás kezdete óta új sor jött: utána újra kell kezdeni
+
+    void setLineLength(uint16_t length);
+    void drawLine(uint16_t memoryRow, const uint8_t *levels);
+    void drawBackgroundLine(uint16_t memoryRow);
+    void startSweep();
+};
+
+#endif  // WATERFALL_SCROLLER_H
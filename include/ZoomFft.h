@@ -0,0 +1,105 @@
+#ifndef ZOOM_FFT_H
+#define ZOOM_FFT_H
+
+#include "AudioSampleReader.h"
+#include "FixedPointFftBackend.h"
+
+/**
+ * @brief Konstansok a zoom FFT-hez
+ */
+namespace ZoomFftConstants {
+
+constexpr uint16_t FFT_SIZE = 256;               // Komplex FFT pontok száma (ennyi bin fedi le a kiválasztott sávot)
+constexpr float INPUT_SAMPLE_RATE_HZ = 8400.0f;  // A busz olvasó cél frekvenciája (a dekóderekkel azonos, 3kHz-ig sík)
+constexpr uint16_t BLOCK_SAMPLES = 64;           // Egyszerre feldolgozott bemeneti minták (stack puffer)
+constexpr uint8_t MIXER_SHIFT = 13;              // A keverő Q15 szorzatának tolása: +/-2048 bemenetből +/-8192 (a half-band határ alatt)
+constexpr float PASSBAND_RATIO = 0.36f;          // A decimált alapsáv sík része a kimeneti frekvencia arányában (2 * PASSBAND_EDGE)
+constexpr float MAGNITUDE_SCALE = 0.5f;          // Skálázás a valós, 512 pontos spektrum szintjére (1.0 erősítésnél)
+
+};  // namespace ZoomFftConstants
+
+/**
+ * @brief Zoom FFT egy szűk hangfrekvenciás sávra (CW/RTTY hangolássegéd)
+ *
+ * A busz 8400Hz-es olvasójának mintáit egy NCO a sáv közepére keveri (komplex alapsáv),
+ * a half-band kaszkád a sávszélességhez illően decimálja, majd egy kis komplex FFT
+ * adja a spektrumot. 600Hz-es sávnál ~4Hz a felbontás, töredék számítással
+ * egy teljes sávú 2048 pontos FFT-hez képest. Folyamatos (streaming) feldolgozás:
+ * minden hívás csak az új mintákat keveri és decimálja, az FFT a legutolsó FFT_SIZE alapsávi mintán fut.
+ */
+class ZoomFft {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param source A közös minta busz
+     */
+    ZoomFft(AudioSampleRing &source);
+    ~ZoomFft();
+
+    /**
+     * @brief Sikeres volt-e a pufferek foglalása
+     */
+    bool isReady() const { return magnitudes_ != nullptr; }
+
+    /**
+     * @brief A megjelenítendő sáv beállítása
+     * @param centerFreqHz A sáv közepe (a keverő frekvenciája)
+     * @param spanHz A sáv szélessége (ehhez választjuk a decimációt)
+     */
+    void configure(float centerFreqHz, float spanHz);
+
+    /**
+     * @brief Az új minták feldolgozása, és ha van elég alapsávi minta, új spektrum számítása
+     * @return true ha új spektrum készült
+     */
+    bool process();
+
+    /**
+     * @brief A legnagyobb magnitúdó egy frekvencia tartományban (legalább a legközelebbi bin)
+     * @param lowHz Tartomány alja (abszolút hangfrekvencia)
+     * @param highHz Tartomány teteje
+     * @return Magnitúdó (a valós spektrum skáláján)
+     */
+    float getPeakMagnitude(float lowHz, float highHz) const;
+
+    /**
+     * @brief A beállított sáv közepe
+     */
+    float getCenterFreqHz() const { return centerFreqHz_; }
+
+    /**
+     * @brief A beállított sáv szélessége
+     */
+    float getSpanHz() const { return spanHz_; }
+
+    /**
+     * @brief Bin szélesség Hz-ben
+     */
+    float getBinWidthHz() const { return outputRateHz_ / ZoomFftConstants::FFT_SIZE; }
+
+   private:
+    AudioSampleReader reader_;                                // Olvasó a közös buszon (INPUT_SAMPLE_RATE_HZ)
+    FixedPointFftBackend fft_;                                // Komplex FFT (csomagolás nélkül)
+    AudioSampleBusConstants::DecimatorChainType decimatorI_;  // Alapsávi decimátor, valós ág
+    AudioSampleBusConstants::DecimatorChainType decimatorQ_;  // Alapsávi decimátor, képzetes ág
+    int16_t *historyRe_;                                      // Alapsávi minták gyűrűje, valós rész (FFT_SIZE)
+    int16_t *historyIm_;                                      // Alapsávi minták gyűrűje, képzetes rész
+    int16_t *fftRe_;                                          // Az FFT bemenete időrendben, valós rész (FFT_SIZE)
+    int16_t *fftIm_;                                          // Az FFT bemenete időrendben, képzetes rész
+    float *magnitudes_;                                       // Spektrum a legkisebb frekvenciától (FFT_SIZE)
+    uint16_t historyPos_;                                     // Következő írási pozíció a gyűrűben
+    uint16_t historyCount_;                                   // Érvényes minták száma a gyűrűben
+    uint32_t ncoPhase_;                                       // NCO fázis (teljes kör = 2^32)
+    uint32_t ncoStep_;                                        // NCO fázis lépés mintánként
+    float centerFreqHz_;                                      // A keverő frekvenciája
+    float spanHz_;                                            // A megjelenítendő sáv szélessége
+    float outputRateHz_;                                      // Az alapsáv mintavételi frekvenciája
+    uint8_t activeStages_;                                    // Használt half-band fokozatok
+    uint8_t decimation_;                                      // 2^activeStages_
+
+    void deallocate();
+    void mixAndDecimate(const int16_t *samples, uint16_t count);
+    void computeSpectrum();
+};
+
+#endif  // ZOOM_FFT_H
@@ -3,21 +3,80 @@
 
 #include <stdint.h>
 
-// Parancsok Core0-ról Core1-nek
-// Egyszerű uint32_t értékeket használunk az első lépésben.
-// Egy összetettebb structot később is bevezethetünk, ha szükséges.
+// Parancsok Core0-ról Core1-nek (a Core1Message típusa)
+// Az üzenetek a közös Core1Mailbox-ban utaznak, a FIFO csak csengő (lásd Core1Mailbox.h).
 enum Core1Command : uint32_t {
     CORE1_CMD_NONE = 0,
     CORE1_CMD_SET_MODE_OFF = 0x10,
     CORE1_CMD_SET_MODE_RTTY = 0x11,
     CORE1_CMD_SET_MODE_CW = 0x12,
-    CORE1_CMD_GET_RTTY_CHAR = 0x21,
-    CORE1_CMD_GET_CW_CHAR = 0x22
+    CORE1_CMD_SET_MODE_CW_SKIMMER = 0x13,
+    CORE1_CMD_SET_CW_PARAMS = 0x20,    // A futó CW dekóder hangolása (params.cw)
+    CORE1_CMD_SET_RTTY_PARAMS = 0x21,  // A futó RTTY dekóder hangolása (params.rtty)
+    CORE1_CMD_SPECTRUM_START = 0x30,   // Kijelző spektrum számítás indítása a Core1-en (params.spectrum)
+    CORE1_CMD_SPECTRUM_CONFIG = 0x31,  // A futó spektrum számítás beállítása (params.spectrum)
+    CORE1_CMD_SPECTRUM_STOP = 0x32     // A spektrum számítás leállítása (params.spectrum.session)
     // Később bővíthető pl. MUTE paranccsal, stb.
 };
 
-// Válaszok Core1-ről Core0-nak (egyelőre csak egy karakter)
-// Ha nincs dekódolt karakter, '\0'-t küldünk.
-// Ezt is uint32_t-ként küldjük át a FIFO-n.
+// A Core1 válasza egy üzenetre
+enum class Core1ReplyStatus : uint8_t {
+    Ok,             // Végrehajtva
+    NotApplicable,  // Paraméter egy éppen nem futó dekódernek
+    Failed,         // Nem sikerült (pl. nincs elég memória a dekóderhez)
+    UnknownCommand  // Ismeretlen parancs
+};
+
+// CORE1_CMD_SET_CW_PARAMS paraméterei
+struct Core1CwParams {
+    uint16_t offsetHz;  // CW vételi hangfrekvencia
+};
+
+// CORE1_CMD_SET_RTTY_PARAMS paraméterei
+struct Core1RttyParams {
+    float markHz;       // Mark frekvencia
+    float shiftHz;      // Shift (pozitív, a space a mark alatt van)
+    uint16_t baudRate;  // Baud, 0 = automatikus detektálás
+};
+
+// CORE1_CMD_SPECTRUM_* paraméterei
+struct Core1SpectrumParams {
+    float *gainConfig;         // START: az FFT erősítés beállítása (Config mező, a Core1 is olvassa)
+    float targetSamplingHz;    // START: cél mintavételezési frekvencia
+    uint16_t session;          // CONFIG/STOP: a START üzenet sorszáma (egy korábbi kijelző parancsa nem érvényes)
+    uint16_t fftSize;          // FFT méret
+    uint16_t frameIntervalMs;  // Két spektrum képkocka közötti legkisebb idő
+    uint8_t windowType;        // Ablakfüggvény (FftWindowType)
+    bool collectOsci;          // Oszcilloszkóp minták is kellenek
+};
+
+// Egy üzenet Core0-ról Core1-nek
+struct Core1Message {
+    uint16_t sequence;     // Sorszám (a Core1Mailbox::post() tölti ki), a válasz ezzel hivatkozik rá
+    Core1Command command;  // Az üzenet típusa
+    union {
+        Core1CwParams cw;
+        Core1RttyParams rtty;
+        Core1SpectrumParams spectrum;
+    } params;  // A típustól függő paraméterek
+};
+
+// A Core1 válasza Core0-nak
+struct Core1Reply {
+    uint16_t sequence;        // A megválaszolt üzenet sorszáma
+    Core1Command command;     // A megválaszolt üzenet típusa
+    Core1ReplyStatus status;  // Az eredmény
+};
+
+// A Core1 terhelése, a Core1 írja mérési ablakonként, a Core0 bármikor olvashatja (main1.cpp)
+struct Core1LoadStats {
+    volatile uint16_t dutyPermille;      // Aktív (nem alvó) idő ezrelékben az utolsó ablakban
+    volatile uint16_t wakeupsPerSecond;  // Ébredések száma másodpercenként
+    volatile uint32_t maxWakeLatencyUs;  // Az ébredés legnagyobb késése a kért időponthoz képest (a ciklus saját késleltetése)
+};
+extern Core1LoadStats core1LoadStats;
+
+// A dekódolt karakterek nem a FIFO-n jönnek vissza: a Core1 dekóderei a közös
+// DecodedTextRing-be írják őket, a Core0 kérés nélkül üríti (lásd DecodedTextRing.h).
 
 #endif  // CORE_COMMUNICATION_H
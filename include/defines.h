@@ -70,6 +70,8 @@
 #ifdef __DEBUG
 // #define SHOW_MEMORY_INFO
 #define MEMORY_INFO_INTERVAL 20 * 1000  // 20mp
+// #define SHOW_CORE1_LOAD
+#define CORE1_LOAD_INFO_INTERVAL 5 * 1000  // 5mp
 
 // Soros portra várakozás a debug üzenetek előtt
 // #define DEBUG_WAIT_FOR_SERIAL
@@ -3,7 +3,8 @@
 
 #include <Arduino.h>
 
-#include "defines.h"  // PIN_VBUS
+#include "AdcDmaSampler.h"  // A háttér audio mintavételezés szüneteltetéséhez
+#include "defines.h"        // PIN_VBUS
 
 namespace PicoSensorUtils {
 
@@ -24,12 +25,15 @@ inline void init() { analogReadResolution(AD_RESOLUTION); }
 
 /**
  * ADC olvasás és VBUS feszültség kiszámítása külső osztóval
+ * (a DMA audio mintavételezést a csatornaváltás idejére szüneteltetjük)
  * @return A VBUS mért feszültsége Voltban.
  */
 inline float readVBus() {
 
     // ADC érték átalakítása feszültséggé
+    bool wasCapturing = adcDmaSampler.pauseCapture();
     float voltageOut = (analogRead(PIN_VBUS_INPUT) * V_REFERENCE) / CONVERSION_FACTOR;
+    adcDmaSampler.resumeCapture(wasCapturing);
 
     // Eredeti feszültség számítása a feszültségosztó alapján
     return voltageOut * DIVIDER_RATIO;
@@ -37,9 +41,15 @@ inline float readVBus() {
 
 /**
  * Kiolvassa a processzor hőmérsékletét
+ * (a DMA audio mintavételezést a csatornaváltás idejére szüneteltetjük)
  * @return processzor hőmérséklete Celsius fokban
  */
-inline float readCoreTemperature() { return analogReadTemp(); }
+inline float readCoreTemperature() {
+    bool wasCapturing = adcDmaSampler.pauseCapture();
+    float temperature = analogReadTemp();
+    adcDmaSampler.resumeCapture(wasCapturing);
+    return temperature;
+}
 
 };  // namespace PicoSensorUtils
 
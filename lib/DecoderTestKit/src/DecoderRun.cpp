@@ -0,0 +1,155 @@
+#include "DecoderRun.h"
+
+#include <NativeHost.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Egy dekóder futtatása
+ * @param task A dekóder (a source-ra kötve)
+ * @param source A minta forrás (elindítva, az elejéről)
+ * @param textSource A mért dekóder forrás jelzése a szöveg gyűrűben
+ * @param reference Az adott szöveg
+ * @param signalStartSample A jel első mintája (a befogási időhöz)
+ * @return Az eredmény
+ */
+DecoderRunResult DecoderRun::run(IDspTask &task, ArraySampleSource &source, DecodedTextSource textSource, const char *reference, uint32_t signalStartSample) {
+    using namespace DecoderRunConstants;
+
+    DecoderRunResult result{};
+    result.lockMs = -1.0f;
+    const float sampleRateHz = source.getSampleRateHz();
+    const std::string normalizedReference = normalize(reference);
+    const uint64_t startUs = NativeHost::getMicros();
+
+    decodedTextRing.clear();
+    double cpuUs = 0.0;
+    uint32_t fed = 0;
+    std::string text;
+    uint32_t written;
+    while ((written = source.pump(PUMP_SAMPLES)) > 0) {
+        fed += written;
+        NativeHost::setMicros(startUs + static_cast<uint64_t>(fed * 1000000.0 / sampleRateHz));
+
+        const auto t0 = std::chrono::steady_clock::now();
+        task.runTask();
+        cpuUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+        DecodedTextEntry entries[DecodedTextRingConstants::RING_SIZE];
+        const uint16_t count = decodedTextRing.popMany(entries, DecodedTextRingConstants::RING_SIZE);
+        for (uint16_t i = 0; i < count; i++) {
+            result.entries.push_back(entries[i]);
+            if (entries[i].source != textSource || result.lockMs >= 0.0f) {
+                continue;
+            }
+            text += entries[i].character;
+            const std::string normalized = normalize(text);
+            if (normalized.size() >= LOCK_MATCH_CHARS && normalizedReference.find(normalized.substr(normalized.size() - LOCK_MATCH_CHARS)) != std::string::npos) {
+                result.lockMs = (entries[i].timestampMs - startUs / 1000.0f) - signalStartSample * 1000.0f / sampleRateHz;
+            }
+        }
+    }
+
+    result.audioSeconds = fed / sampleRateHz;
+    result.cpuUsPerSecond = result.audioSeconds > 0.0f ? cpuUs / result.audioSeconds : 0.0f;
+    result.decoded = collectText(result.entries, textSource);
+    result.cerPercent = characterErrorRate(normalizedReference, result.decoded);
+    return result;
+}
+
+/**
+ * @brief Egy forrás (és skimmernél egy csatorna) szövege a dekódolt karakterekből, normalizálva
+ * @param entries A dekódolt karakterek
+ * @param textSource A forrás
+ * @param channelHz A csatorna frekvenciája (0: mind)
+ * @param toleranceHz A csatorna frekvencia tűrése
+ */
+std::string DecoderRun::collectText(const std::vector<DecodedTextEntry> &entries, DecodedTextSource textSource, uint16_t channelHz, uint16_t toleranceHz) {
+    std::string text;
+    for (const DecodedTextEntry &entry : entries) {
+        if (entry.source == textSource && (channelHz == 0 || abs(static_cast<int>(entry.channelHz) - channelHz) <= toleranceHz)) {
+            text += entry.character;
+        }
+    }
+    return normalize(text);
+}
+
+/**
+ * @brief Szöveg normalizálása az összehasonlításhoz
+ */
+std::string DecoderRun::normalize(const std::string &text) {
+    std::string normalized;
+    for (char c : text) {
+        if (c == '\r' || c == '\n' || c == '\t') {
+            c = ' ';
+        }
+        if (c == ' ' && (normalized.empty() || normalized.back() == ' ')) {
+            continue;
+        }
+        normalized += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    while (!normalized.empty() && normalized.back() == ' ') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+/**
+ * @brief Karakter hibaarány százalékban (Levenshtein távolság a normalizált szövegek között)
+ */
+float DecoderRun::characterErrorRate(const std::string &reference, const std::string &decoded) {
+    const std::string a = normalize(reference);
+    const std::string b = normalize(decoded);
+    if (a.empty()) {
+        return b.empty() ? 0.0f : 100.0f;
+    }
+
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            const size_t above = row[j];
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] != b[j - 1])});
+            diagonal = above;
+        }
+    }
+    return 100.0f * row[b.size()] / a.size();
+}
+
+/**
+ * @brief Egy mérés kiírása egy JSON sorként (stdout és a DECODER_REPORT fájl)
+ * @param caseName A mérés neve
+ * @param result Az eredmény
+ */
+void DecoderRun::report(const char *caseName, const DecoderRunResult &result) {
+    std::string escaped;
+    for (char c : result.decoded) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += (static_cast<unsigned char>(c) < 0x20 || static_cast<unsigned char>(c) >= 0x7F) ? '?' : c;
+    }
+
+    char fields[256];
+    snprintf(fields, sizeof(fields), "{\"case\":\"%s\",\"cer\":%.1f,\"lock_ms\":%.0f,\"cpu_us_per_s\":%.0f,\"audio_s\":%.1f,\"decoded\":\"", caseName, result.cerPercent, result.lockMs,
+             result.cpuUsPerSecond, result.audioSeconds);
+    const std::string line = fields + escaped + "\"}\n";
+    fputs(line.c_str(), stdout);
+
+    const char *path = getenv(DecoderRunConstants::REPORT_PATH_ENV);
+    if (path != nullptr && *path != '\0') {
+        FILE *file = fopen(path, "a");
+        if (file != nullptr) {
+            fputs(line.c_str(), file);
+            fclose(file);
+        }
+    }
+}
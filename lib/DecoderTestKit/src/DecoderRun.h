@@ -0,0 +1,85 @@
+#ifndef DECODER_RUN_H
+#define DECODER_RUN_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "ArraySampleSource.h"
+#include "DecodedTextRing.h"
+#include "IDspTask.h"
+
+/**
+ * @brief Konstansok a dekóder mérésekhez
+ */
+namespace DecoderRunConstants {
+
+constexpr uint16_t PUMP_SAMPLES = 672;                     // Egy lépésben a buszra írt minták (10ms a busz frekvencián, mint a DMA blokkok)
+constexpr uint8_t LOCK_MATCH_CHARS = 3;                    // Ennyi helyes egymás utáni karakter után tekintjük befogottnak a dekódert
+constexpr const char *REPORT_PATH_ENV = "DECODER_REPORT";  // Ha be van állítva, a riport ide is kiíródik (JSON lines)
+
+};  // namespace DecoderRunConstants
+
+/**
+ * @brief Egy dekóder futás eredménye
+ */
+struct DecoderRunResult {
+    std::vector<DecodedTextEntry> entries;  // Az összes dekódolt karakter, a forrásuktól függetlenül
+    std::string decoded;                    // A mért forrás normalizált szövege
+    float cerPercent;                       // Karakter hibaarány a referenciához képest (szerkesztési távolság / hossz)
+    float lockMs;                           // A jel kezdetétől az első LOCK_MATCH_CHARS helyes karakterig (-1: nem fogott be)
+    float cpuUsPerSecond;                   // A runTask() futási ideje hangmásodpercenként (ezen a gépen)
+    float audioSeconds;                     // A betáplált jel hossza
+};
+
+/**
+ * @brief Egy dekóder lefuttatása egy előre generált (vagy WAV-ból olvasott) jelen
+ *
+ * A mintákat DMA blokkonként teszi a buszra, a szimulált órát a betáplált minták szerint
+ * lépteti (így a dekóderek időbélyegei a jel idejét mutatják), minden blokk után lefuttatja
+ * a feladatot, és kiüríti a közös szöveg gyűrűt. A karakter hibaarányhoz a szöveget
+ * normalizálja: sorvégek szóközzé, ismételt szóközök egyre, nagybetűsítve.
+ */
+namespace DecoderRun {
+
+/**
+ * @brief Egy dekóder futtatása
+ * @param task A dekóder (a source-ra kötve)
+ * @param source A minta forrás (elindítva, az elejéről)
+ * @param textSource A mért dekóder forrás jelzése a szöveg gyűrűben
+ * @param reference Az adott szöveg
+ * @param signalStartSample A jel első mintája (a befogási időhöz)
+ * @return Az eredmény
+ */
+DecoderRunResult run(IDspTask &task, ArraySampleSource &source, DecodedTextSource textSource, const char *reference, uint32_t signalStartSample);
+
+/**
+ * @brief Egy forrás (és skimmernél egy csatorna) szövege a dekódolt karakterekből, normalizálva
+ * @param entries A dekódolt karakterek
+ * @param textSource A forrás
+ * @param channelHz A csatorna frekvenciája (0: mind)
+ * @param toleranceHz A csatorna frekvencia tűrése
+ */
+std::string collectText(const std::vector<DecodedTextEntry> &entries, DecodedTextSource textSource, uint16_t channelHz = 0, uint16_t toleranceHz = 0);
+
+/**
+ * @brief Szöveg normalizálása az összehasonlításhoz
+ */
+std::string normalize(const std::string &text);
+
+/**
+ * @brief Karakter hibaarány százalékban (Levenshtein távolság a normalizált szövegek között)
+ */
+float characterErrorRate(const std::string &reference, const std::string &decoded);
+
+/**
+ * @brief Egy mérés kiírása egy JSON sorként (stdout és a DECODER_REPORT fájl)
+ * @param caseName A mérés neve
+ * @param result Az eredmény
+ */
+void report(const char *caseName, const DecoderRunResult &result);
+
+};  // namespace DecoderRun
+
+#endif  // DECODER_RUN_H
@@ -0,0 +1,326 @@
+#include "TestSignalGenerator.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include <cmath>
+
+#include "MorseCode.h"
+#include "RttyDecoder.h"  // Baudot kódok
+
+/**
+ * @brief Konstruktor
+ * @param buffer A cél puffer
+ * @param capacity A puffer mérete mintákban
+ * @param sampleRateHz A minták frekvenciája
+ * @param seed A zaj kezdőértéke
+ */
+TestSignalGenerator::TestSignalGenerator(int16_t *buffer, uint32_t capacity, float sampleRateHz, uint32_t seed)
+    : buffer_(buffer),
+      capacity_(capacity),
+      length_(0),
+      sampleRateHz_(sampleRateHz),
+      seed_(seed != 0 ? seed : TestSignalGeneratorConstants::DEFAULT_SEED),
+      fadingPeriodSamples_(0.0f),
+      fadingDepthDb_(0.0f),
+      fadingSpacePhase_(0.0f) {
+    clear();
+}
+
+/**
+ * @brief A puffer törlése, a kurzor és a zaj generátor az elejére
+ */
+void TestSignalGenerator::clear() {
+    memset(buffer_, 0, capacity_ * sizeof(int16_t));
+    length_ = 0;
+    noiseState_ = seed_;
+    phase_ = 0.0;
+}
+
+/**
+ * @brief Egy érték hozzáadása a meglévő mintához, a skálára vágva
+ */
+void TestSignalGenerator::mixSample(uint32_t index, float value) {
+    using TestSignalGeneratorConstants::FULL_SCALE;
+
+    const float mixed = buffer_[index] + value;
+    buffer_[index] = static_cast<int16_t>(lrintf(mixed > FULL_SCALE ? FULL_SCALE : (mixed < -FULL_SCALE ? -FULL_SCALE : mixed)));
+}
+
+/**
+ * @brief Csend a kurzortól
+ * @param durationMs A csend hossza
+ */
+void TestSignalGenerator::addSilence(float durationMs) {
+    const uint32_t end = length_ + msToSamples(durationMs);
+    length_ = end < capacity_ ? end : capacity_;
+}
+
+/**
+ * @brief Egy lenyomott (emelt koszinusz fel- és lefutású) vagy felengedett kulcs szakasz
+ * @param toneHz A hang frekvenciája
+ * @param amplitude A hang amplitúdója
+ * @param durationMs A szakasz hossza
+ * @param keyDown true: hang, false: csend
+ */
+void TestSignalGenerator::addKeyed(float toneHz, float amplitude, float durationMs, bool keyDown) {
+    const uint32_t count = msToSamples(durationMs);
+    const uint32_t rampSamples = min(msToSamples(TestSignalGeneratorConstants::CW_RAMP_MS), count / 2);
+    const double phaseStep = toneHz / sampleRateHz_;
+
+    for (uint32_t n = 0; n < count && length_ < capacity_; n++, length_++) {
+        phase_ += phaseStep;
+        if (!keyDown) {
+            continue;
+        }
+        float envelope = 1.0f;
+        const uint32_t edgeDistance = min(n, count - 1 - n);
+        if (edgeDistance < rampSamples) {
+            envelope = 0.5f - 0.5f * cosf(static_cast<float>(M_PI) * edgeDistance / rampSamples);
+        }
+        mixSample(length_, amplitude * envelope * fadingGain(length_, 0.0f) * sinf(static_cast<float>(2.0 * M_PI * (phase_ - floor(phase_)))));
+    }
+}
+
+/**
+ * @brief CW szöveg a kurzortól
+ * @param text A szöveg
+ * @param toneHz A hang frekvenciája
+ * @param wpm A karakter sebesség (PARIS)
+ * @param amplitude A hang amplitúdója
+ * @param effectiveWpm Farnsworth sebesség (0: nincs nyújtott karakterköz)
+ * @return A hozzáadott minták száma
+ *
+ * Egység = 1200 / WPM ms. Farnsworth adásnál a jelek a karakter sebességgel mennek, a karakter-
+ * és szóközök úgy nyúlnak meg (3:7 arányban), hogy a PARIS szó a tényleges sebességet adja.
+ */
+uint32_t TestSignalGenerator::addCw(const char *text, float toneHz, float wpm, float amplitude, float effectiveWpm) {
+    const uint32_t start = length_;
+    const float unitMs = 1200.0f / wpm;
+    float charGapMs = 3.0f * unitMs;
+    float wordGapMs = 7.0f * unitMs;
+    if (effectiveWpm > 0.0f && effectiveWpm < wpm) {
+        const float delayMs = (60.0f * wpm - 37.2f * effectiveWpm) / (wpm * effectiveWpm) * 1000.0f;  // Egy szó összes nyújtott szünete
+        charGapMs = 3.0f * delayMs / 19.0f;
+        wordGapMs = 7.0f * delayMs / 19.0f;
+    }
+
+    for (const char *p = text; *p != '\0'; p++) {
+        if (*p == ' ') {
+            addKeyed(toneHz, amplitude, wordGapMs - charGapMs, false);  // Az előző karakter után már egy karakterköz van
+            continue;
+        }
+        uint8_t codeBits, codeLength;
+        if (!MorseCode::encode(*p, codeBits, codeLength)) {
+            continue;
+        }
+        for (int8_t i = codeLength - 1; i >= 0; i--) {
+            addKeyed(toneHz, amplitude, ((codeBits >> i) & 1) ? 3.0f * unitMs : unitMs, true);
+            addKeyed(toneHz, amplitude, i > 0 ? unitMs : charGapMs, false);
+        }
+    }
+    return length_ - start;
+}
+
+/**
+ * @brief FSK hang a kurzortól egy (tört) minta pozícióig, folytonos fázissal
+ * @param toneHz A hang frekvenciája
+ * @param amplitude A hang amplitúdója
+ * @param endSample A szakasz vége
+ * @param fadingPhase A hang fading fáziseltolása (mark: 0, space: fadingSpacePhase_)
+ */
+void TestSignalGenerator::addFsk(float toneHz, float amplitude, double endSample, float fadingPhase) {
+    const double phaseStep = toneHz / sampleRateHz_;
+    for (; length_ < endSample && length_ < capacity_; length_++) {
+        phase_ += phaseStep;
+        mixSample(length_, amplitude * fadingGain(length_, fadingPhase) * sinf(static_cast<float>(2.0 * M_PI * (phase_ - floor(phase_)))));
+    }
+}
+
+/**
+ * @brief Egy Baudot karakter keret: start bit (space), 5 adat bit (LSB először, 1 = mark), 1.5 stop bit (mark)
+ * @param code Az 5 bites kód (RTTY_FRAMING_ERROR-ral a stop bit előtt egy bitnyi space)
+ * @param markHz A mark frekvencia
+ * @param spaceHz A space frekvencia
+ * @param bitSamples Egy bit hossza mintákban (tört)
+ * @param amplitude A jel amplitúdója
+ * @param position A keret eleje, a végére lép
+ */
+void TestSignalGenerator::addRttyCode(uint8_t code, float markHz, float spaceHz, double bitSamples, float amplitude, double &position) {
+    using namespace TestSignalGeneratorConstants;
+
+    position += bitSamples;
+    addFsk(spaceHz, amplitude, position, fadingSpacePhase_);
+    for (uint8_t bit = 0; bit < 5; bit++) {
+        const bool mark = (code >> bit) & 1;
+        position += bitSamples;
+        addFsk(mark ? markHz : spaceHz, amplitude, position, mark ? 0.0f : fadingSpacePhase_);
+    }
+    if (code & RTTY_FRAMING_ERROR) {
+        position += bitSamples;
+        addFsk(spaceHz, amplitude, position, fadingSpacePhase_);
+    }
+    position += bitSamples * RTTY_STOP_BITS_X2 / 2.0;
+    addFsk(markHz, amplitude, position, 0.0f);
+}
+
+/**
+ * @brief RTTY (FSK) szöveg a kurzortól
+ * @param text A szöveg
+ * @param markHz A mark frekvencia
+ * @param shiftHz A shift
+ * @param baudRate A baud
+ * @param amplitude A jel amplitúdója
+ * @return A hozzáadott minták száma
+ *
+ * Egy karakter: start bit (space), 5 adat bit (LSB először, 1 = mark), 1.5 stop bit (mark).
+ * A szöveg előtt két bitnyi mark és egy LTRS kód, a bit határok tört mintára esnek (a 45.45
+ * baud bitje nem egész számú minta), így a baud nem sodródik. A Baudot készleten kívüli
+ * karakterek kimaradnak.
+ */
+uint32_t TestSignalGenerator::addRtty(const char *text, float markHz, float shiftHz, float baudRate, float amplitude) {
+    using namespace TestSignalGeneratorConstants;
+
+    const uint32_t start = length_;
+    const double bitSamples = sampleRateHz_ / baudRate;
+    const float spaceHz = markHz - shiftHz;
+    double position = length_;
+    bool figs = false;
+
+    auto sendCode = [&](uint8_t code) { addRttyCode(code, markHz, spaceHz, bitSamples, amplitude, position); };
+
+    position += 2.0 * bitSamples;
+    addFsk(markHz, amplitude, position, 0.0f);
+    sendCode(BAUDOT_LTRS);
+
+    for (const char *p = text; *p != '\0'; p++) {
+        const char c = (*p >= 'a' && *p <= 'z') ? *p - ('a' - 'A') : *p;
+        int8_t ltrsCode = -1;
+        int8_t figsCode = -1;
+        for (uint8_t code = 1; code < 32; code++) {
+            if (code == BAUDOT_LTRS || code == BAUDOT_FIGS) {
+                continue;
+            }
+            if (ltrsCode < 0 && RttyDecoder::getBaudotCharacter(code, false) == c) {
+                ltrsCode = code;
+            }
+            if (figsCode < 0 && RttyDecoder::getBaudotCharacter(code, true) == c) {
+                figsCode = code;
+            }
+        }
+
+        if (ltrsCode >= 0 && (figsCode < 0 || !figs)) {
+            if (figs) {
+                sendCode(BAUDOT_LTRS);
+                figs = false;
+            }
+            sendCode(ltrsCode);
+        } else if (figsCode >= 0) {
+            if (!figs) {
+                sendCode(BAUDOT_FIGS);
+                figs = true;
+            }
+            sendCode(figsCode);
+        }
+    }
+    return length_ - start;
+}
+
+/**
+ * @brief Nyers Baudot kódok (RTTY) a kurzortól, váltó kódok beszúrása nélkül
+ * @param codes Az 5 bites kódok (RTTY_FRAMING_ERROR jelöléssel)
+ * @param count A kódok száma
+ * @param markHz A mark frekvencia
+ * @param shiftHz A shift
+ * @param baudRate A baud
+ * @param amplitude A jel amplitúdója
+ * @return A hozzáadott minták száma
+ *
+ * Mint az addRtty(), két bitnyi mark után, de LTRS kód nélkül: a hívó adja a teljes kód sorozatot.
+ */
+uint32_t TestSignalGenerator::addRttyCodes(const uint8_t *codes, uint16_t count, float markHz, float shiftHz, float baudRate, float amplitude) {
+    const uint32_t start = length_;
+    const double bitSamples = sampleRateHz_ / baudRate;
+    double position = length_ + 2.0 * bitSamples;
+    addFsk(markHz, amplitude, position, 0.0f);
+    for (uint16_t i = 0; i < count; i++) {
+        addRttyCode(codes[i], markHz, markHz - shiftHz, bitSamples, amplitude, position);
+    }
+    return length_ - start;
+}
+
+/**
+ * @brief Fading (QSB) az ezután generált CW/RTTY jelekre
+ * @param periodMs A fading periódusa (0: nincs fading)
+ * @param depthDb A legmélyebb pont csillapítása
+ * @param spacePhase Az RTTY space hang fadingjének fáziseltolása periódusban
+ */
+void TestSignalGenerator::setFading(float periodMs, float depthDb, float spacePhase) {
+    fadingPeriodSamples_ = periodMs > 0.0f ? periodMs * sampleRateHz_ / 1000.0f : 0.0f;
+    fadingDepthDb_ = depthDb;
+    fadingSpacePhase_ = spacePhase;
+}
+
+/**
+ * @brief A fading erősítése egy mintánál
+ * @param index A minta (a fading a puffer elejétől számolt időhöz kötött)
+ * @param fadingPhase A hang fáziseltolása periódusban
+ */
+float TestSignalGenerator::fadingGain(uint32_t index, float fadingPhase) const {
+    if (fadingPeriodSamples_ <= 0.0f) {
+        return 1.0f;
+    }
+    const float cycle = index / fadingPeriodSamples_ + fadingPhase;
+    const float attenuationDb = fadingDepthDb_ * (0.5f - 0.5f * cosf(2.0f * static_cast<float>(M_PI) * (cycle - floorf(cycle))));
+    return powf(10.0f, -attenuationDb / 20.0f);
+}
+
+/**
+ * @brief Állandó hang keverése a meglévő jelre
+ * @param toneHz A hang frekvenciája
+ * @param amplitude A hang amplitúdója
+ * @param startSample Az első minta
+ * @param sampleCount A hang hossza mintákban (0: a kurzorig)
+ */
+void TestSignalGenerator::mixTone(float toneHz, float amplitude, uint32_t startSample, uint32_t sampleCount) {
+    const uint32_t end = sampleCount == 0 ? length_ : min(startSample + sampleCount, capacity_);
+    const double phaseStep = toneHz / sampleRateHz_;
+    double phase = 0.0;
+    for (uint32_t n = startSample; n < end; n++) {
+        phase += phaseStep;
+        mixSample(n, amplitude * sinf(static_cast<float>(2.0 * M_PI * (phase - floor(phase)))));
+    }
+    length_ = max(length_, end);
+}
+
+/**
+ * @brief Egy normál eloszlású érték (xorshift32 és Box-Muller)
+ */
+float TestSignalGenerator::nextGaussian() {
+    auto next = [this]() {
+        noiseState_ ^= noiseState_ << 13;
+        noiseState_ ^= noiseState_ >> 17;
+        noiseState_ ^= noiseState_ << 5;
+        return (noiseState_ + 1.0f) / 4294967296.0f;  // (0, 1]
+    };
+    const float u1 = next();
+    const float u2 = next();
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * static_cast<float>(M_PI) * u2);
+}
+
+/**
+ * @brief Fehér zaj keverése a kurzorig
+ * @param signalAmplitude A referencia jel amplitúdója
+ * @param snrDb A jel és a SNR_REFERENCE_BW_HZ sávba eső zaj teljesítményének aránya
+ *
+ * A fehér zaj teljesítménye a teljes (fs/2) sávon oszlik el, ezért a referencia sávra
+ * vonatkozó zajszintet a sávszélességek arányával skálázzuk.
+ */
+void TestSignalGenerator::mixNoise(float signalAmplitude, float snrDb) {
+    const float signalPower = 0.5f * signalAmplitude * signalAmplitude;
+    const float noisePowerInBand = signalPower / powf(10.0f, snrDb / 10.0f);
+    const float sigma = sqrtf(noisePowerInBand * (0.5f * sampleRateHz_) / TestSignalGeneratorConstants::SNR_REFERENCE_BW_HZ);
+    for (uint32_t n = 0; n < length_; n++) {
+        mixSample(n, sigma * nextGaussian());
+    }
+}
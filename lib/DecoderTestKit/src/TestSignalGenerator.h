@@ -0,0 +1,154 @@
+#ifndef TEST_SIGNAL_GENERATOR_H
+#define TEST_SIGNAL_GENERATOR_H
+
+#include <stdint.h>
+
+/**
+ * @brief Konstansok a teszt jel generátorhoz
+ */
+namespace TestSignalGeneratorConstants {
+
+constexpr float FULL_SCALE = 2047.0f;           // A minták skálája (12 bites ADC, középre igazítva, mint az ArraySampleSource-nál)
+constexpr float CW_RAMP_MS = 4.0f;              // A CW jel fel- és lefutása (kattanásmentes, mint egy valódi adóé)
+constexpr float SNR_REFERENCE_BW_HZ = 2500.0f;  // Az SNR a jel teljesítménye ebben a sávban mért zajhoz képest (a szokásos rádiós definíció)
+constexpr uint8_t RTTY_STOP_BITS_X2 = 3;        // 1.5 stop bit (félbitekben)
+constexpr uint8_t BAUDOT_LTRS = 31;             // Betű váltó kód
+constexpr uint8_t BAUDOT_FIGS = 27;             // Szám/jel váltó kód
+constexpr uint8_t RTTY_FRAMING_ERROR = 0x80;    // addRttyCodes(): a kódhoz adva a stop bit eleje space (keretezési hiba)
+constexpr uint32_t DEFAULT_SEED = 0x2545F491;   // A zaj kezdőértéke (ugyanaz a seed ugyanazt a zajt adja minden platformon)
+
+};  // namespace TestSignalGeneratorConstants
+
+/**
+ * @brief Determinisztikus teszt jelek a dekóderek hardver nélküli méréséhez
+ *
+ * Egy hívó által adott int16 pufferbe szintetizál: CW szöveget adott WPM-mel (opcionálisan
+ * Farnsworth karakterközzel), RTTY szöveget adott baud/shift értékkel (Baudot, LTRS/FIGS
+ * váltással), tetszőleges állandó hangokat, adott SNR-ű fehér zajt és fadinget (QSB, az RTTY
+ * mark és space hangjára akár külön fázissal). A jelek egymás után
+ * (a kurzortól), a hangok és a zaj a már meglévő jelre keverve kerülnek a pufferbe. Az
+ * eredmény az ArraySampleSource-on át a közös minta buszra tehető, így a dekóderek a
+ * valódi decimációs lánccal, Linuxon is futtathatók, és a kimenetük összevethető a
+ * generált szöveggel (karakter hibaarány, befogási idő, futási idő). A zaj saját,
+ * platformfüggetlen generátorból jön, így egy mérés bármikor megismételhető.
+ */
+class TestSignalGenerator {
+   public:
+    /**
+     * @brief Konstruktor
+     * @param buffer A cél puffer (a hívóé, a generátor csak ír bele)
+     * @param capacity A puffer mérete mintákban
+     * @param sampleRateHz A minták frekvenciája (a közös buszé: AudioSampleBusConstants::SAMPLE_RATE_HZ)
+     * @param seed A zaj kezdőértéke
+     */
+    TestSignalGenerator(int16_t *buffer, uint32_t capacity, float sampleRateHz, uint32_t seed = TestSignalGeneratorConstants::DEFAULT_SEED);
+
+    /**
+     * @brief A puffer törlése, a kurzor az elejére
+     */
+    void clear();
+
+    /**
+     * @brief Csend a kurzortól
+     * @param durationMs A csend hossza
+     */
+    void addSilence(float durationMs);
+
+    /**
+     * @brief CW szöveg a kurzortól
+     * @param text A szöveg (a Morse jelkészlet karakterei és szóköz, a többi kimarad)
+     * @param toneHz A hang frekvenciája
+     * @param wpm A karakter sebesség (PARIS)
+     * @param amplitude A hang amplitúdója (a minta skáláján)
+     * @param effectiveWpm Farnsworth sebesség (0: nincs nyújtott karakterköz)
+     * @return A hozzáadott minták száma (a puffer végén a jel csonkul)
+     */
+    uint32_t addCw(const char *text, float toneHz, float wpm, float amplitude, float effectiveWpm = 0.0f);
+
+    /**
+     * @brief RTTY (FSK) szöveg a kurzortól, folytonos fázissal
+     * @param text A szöveg (a Baudot készlet karakterei, kisbetű is)
+     * @param markHz A mark frekvencia
+     * @param shiftHz A shift (a space a mark alatt van)
+     * @param baudRate A baud (pl. 45.45)
+     * @param amplitude A jel amplitúdója (a minta skáláján)
+     * @return A hozzáadott minták száma
+     */
+    uint32_t addRtty(const char *text, float markHz, float shiftHz, float baudRate, float amplitude);
+
+    /**
+     * @brief Nyers Baudot kódok (RTTY) a kurzortól, váltó kódok beszúrása nélkül (bit szintű tesztekhez)
+     * @param codes Az 5 bites kódok; RTTY_FRAMING_ERROR-ral jelölve a kód stop bitjének első bitnyi része
+     *              space, utána jön a szokásos 1.5 bit mark (a vevő a kódot keretezési hibaként eldobja)
+     * @param count A kódok száma
+     * @param markHz A mark frekvencia
+     * @param shiftHz A shift
+     * @param baudRate A baud
+     * @param amplitude A jel amplitúdója
+     * @return A hozzáadott minták száma
+     */
+    uint32_t addRttyCodes(const uint8_t *codes, uint16_t count, float markHz, float shiftHz, float baudRate, float amplitude);
+
+    /**
+     * @brief Fading (QSB) az ezután generált CW/RTTY jelekre
+     * @param periodMs A fading periódusa (0: nincs fading)
+     * @param depthDb A legmélyebb pont csillapítása
+     * @param spacePhase Az RTTY space hang fadingjének fáziseltolása periódusban (0: sík fading,
+     *                   0.5: szelektív, a mark és a space felváltva halkul)
+     *
+     * Az erősítés a mintaidő szerint 0 és -depthDb között, dB-ben koszinuszosan változik.
+     */
+    void setFading(float periodMs, float depthDb, float spacePhase = 0.0f);
+
+    /**
+     * @brief Állandó hang keverése a meglévő jelre (pl. zavaró vivő, több hangos teszt)
+     * @param toneHz A hang frekvenciája
+     * @param amplitude A hang amplitúdója
+     * @param startSample Az első minta
+     * @param sampleCount A hang hossza mintákban (0: a kurzorig)
+     */
+    void mixTone(float toneHz, float amplitude, uint32_t startSample = 0, uint32_t sampleCount = 0);
+
+    /**
+     * @brief Fehér zaj keverése a kurzorig (az egész eddigi jelre)
+     * @param signalAmplitude A referencia jel amplitúdója (a CW/RTTY amplitude paramétere)
+     * @param snrDb A jel és a SNR_REFERENCE_BW_HZ sávba eső zaj teljesítményének aránya
+     */
+    void mixNoise(float signalAmplitude, float snrDb);
+
+    /**
+     * @brief A generált minták száma (a kurzor)
+     */
+    uint32_t getLength() const { return length_; }
+
+    /**
+     * @brief A minták frekvenciája
+     */
+    float getSampleRateHz() const { return sampleRateHz_; }
+
+    /**
+     * @brief Egy időpont mintában
+     */
+    uint32_t msToSamples(float ms) const { return static_cast<uint32_t>(ms * sampleRateHz_ / 1000.0f + 0.5f); }
+
+   private:
+    int16_t *buffer_;
+    uint32_t capacity_;
+    uint32_t length_;  // A kurzor: az eddig generált minták
+    float sampleRateHz_;
+    uint32_t seed_;
+    uint32_t noiseState_;        // xorshift32 állapot
+    double phase_;               // A CW/RTTY oszcillátor fázisa (ciklusban), a jelek között is folytonos
+    float fadingPeriodSamples_;  // A fading periódusa mintákban (0: nincs fading)
+    float fadingDepthDb_;        // A fading mélysége
+    float fadingSpacePhase_;     // A space hang fading fáziseltolása (periódusban)
+
+    void mixSample(uint32_t index, float value);
+    void addKeyed(float toneHz, float amplitude, float durationMs, bool keyDown);
+    void addFsk(float toneHz, float amplitude, double endSample, float fadingPhase);
+    void addRttyCode(uint8_t code, float markHz, float spaceHz, double bitSamples, float amplitude, double &position);
+    float fadingGain(uint32_t index, float fadingPhase) const;
+    float nextGaussian();
+};
+
+#endif  // TEST_SIGNAL_GENERATOR_H
@@ -0,0 +1,137 @@
+#include "WavFile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+/**
+ * @brief Little endian egészek olvasása/írása (a fájl formátuma nem függ a gép bájtsorrendjétől)
+ */
+uint32_t readLe(const uint8_t *bytes, uint8_t size) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+void writeLe(FILE *file, uint32_t value, uint8_t size) {
+    for (uint8_t i = 0; i < size; i++) {
+        fputc((value >> (8 * i)) & 0xFF, file);
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief WAV fájl beolvasása
+ * @param path A fájl útvonala
+ * @param samples Ide kerülnek a minták (+/-2047 skálán)
+ * @param targetRateHz A kimeneti mintavételi frekvencia
+ * @return false, ha a fájl nem olvasható vagy nem 16 bites PCM
+ *
+ * A chunk-okat végigjárja (LIST és egyéb metaadat chunk-ok kimaradnak), többcsatornás
+ * fájlból az első csatornát veszi.
+ */
+bool WavFile::read(const char *path, std::vector<int16_t> &samples, float targetRateHz) {
+    samples.clear();
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    uint8_t header[12];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        fclose(file);
+        return false;
+    }
+
+    uint16_t channels = 0;
+    uint16_t bitsPerSample = 0;
+    uint32_t sourceRateHz = 0;
+    std::vector<int16_t> pcm;
+    uint8_t chunkHeader[8];
+    while (fread(chunkHeader, 1, sizeof(chunkHeader), file) == sizeof(chunkHeader)) {
+        const uint32_t chunkSize = readLe(chunkHeader + 4, 4);
+        if (memcmp(chunkHeader, "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint8_t format[16];
+            if (fread(format, 1, sizeof(format), file) != sizeof(format)) {
+                break;
+            }
+            const uint16_t audioFormat = readLe(format, 2);
+            channels = readLe(format + 2, 2);
+            sourceRateHz = readLe(format + 4, 4);
+            bitsPerSample = readLe(format + 14, 2);
+            if (audioFormat != 1 || bitsPerSample != 16 || channels == 0) {
+                break;
+            }
+            fseek(file, (chunkSize - sizeof(format) + 1) & ~1u, SEEK_CUR);
+        } else if (memcmp(chunkHeader, "data", 4) == 0 && channels != 0) {
+            std::vector<uint8_t> data(chunkSize);
+            const size_t frames = fread(data.data(), 1, chunkSize, file) / (2u * channels);
+            pcm.resize(frames);
+            for (size_t n = 0; n < frames; n++) {
+                pcm[n] = static_cast<int16_t>(readLe(&data[n * 2u * channels], 2));
+            }
+            break;
+        } else {
+            fseek(file, (chunkSize + 1) & ~1u, SEEK_CUR);  // A chunk-ok páros hosszra igazítottak
+        }
+    }
+    fclose(file);
+
+    if (pcm.empty() || sourceRateHz == 0 || targetRateHz <= 0.0f) {
+        return false;
+    }
+
+    // Lineáris átmintavételezés és a 12 bites skálára vágás
+    const double step = sourceRateHz / static_cast<double>(targetRateHz);
+    const size_t outCount = static_cast<size_t>((pcm.size() - 1) / step) + 1;
+    samples.resize(outCount);
+    for (size_t n = 0; n < outCount; n++) {
+        const double position = n * step;
+        const size_t index = static_cast<size_t>(position);
+        const double fraction = position - index;
+        const double next = index + 1 < pcm.size() ? pcm[index + 1] : pcm[index];
+        samples[n] = static_cast<int16_t>(lrint((pcm[index] + (next - pcm[index]) * fraction) / (1 << WavFileConstants::PCM_SHIFT)));
+    }
+    return true;
+}
+
+/**
+ * @brief Minták kiírása mono 16 bites PCM WAV fájlba
+ * @param path A fájl útvonala
+ * @param samples A minták (+/-2047 skálán)
+ * @param count A minták száma
+ * @param sampleRateHz A mintavételi frekvencia
+ * @return false, ha a fájl nem írható
+ */
+bool WavFile::write(const char *path, const int16_t *samples, uint32_t count, float sampleRateHz) {
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const uint32_t rateHz = static_cast<uint32_t>(lrintf(sampleRateHz));
+    const uint32_t dataBytes = count * 2;
+
+    fwrite("RIFF", 1, 4, file);
+    writeLe(file, 36 + dataBytes, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLe(file, 16, 4);            // fmt chunk mérete
+    writeLe(file, 1, 2);             // PCM
+    writeLe(file, 1, 2);             // Mono
+    writeLe(file, rateHz, 4);        // Mintavételi frekvencia
+    writeLe(file, rateHz * 2, 4);    // Bájt / s
+    writeLe(file, 2, 2);             // Blokk igazítás
+    writeLe(file, 16, 2);            // Bit / minta
+    fwrite("data", 1, 4, file);
+    writeLe(file, dataBytes, 4);
+    for (uint32_t n = 0; n < count; n++) {
+        writeLe(file, static_cast<uint16_t>(static_cast<int16_t>(samples[n] * (1 << WavFileConstants::PCM_SHIFT))), 2);
+    }
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,48 @@
+#ifndef WAV_FILE_H
+#define WAV_FILE_H
+
+#include <stdint.h>
+
+#include <vector>
+
+/**
+ * @brief Konstansok a WAV fájl kezeléshez
+ */
+namespace WavFileConstants {
+
+constexpr uint8_t PCM_SHIFT = 4;  // 16 bites PCM <-> 12 bites ADC skála (+/-2047)
+
+};  // namespace WavFileConstants
+
+/**
+ * @brief 16 bites PCM WAV olvasás/írás a dekóderek felvételekkel való teszteléséhez
+ *
+ * Olvasáskor az első csatornát a közös minta busz frekvenciájára (vagy a kért frekvenciára)
+ * lineárisan átmintavételezi és a 12 bites ADC skálára (+/-2047) alakítja, így a minták
+ * közvetlenül egy ArraySampleSource-ba tehetők. Íráskor fordítva: a generált teszt jelek
+ * meghallgathatók vagy más dekóderekkel is lefuttathatók.
+ */
+namespace WavFile {
+
+/**
+ * @brief WAV fájl beolvasása
+ * @param path A fájl útvonala
+ * @param samples Ide kerülnek a minták (+/-2047 skálán)
+ * @param targetRateHz A kimeneti mintavételi frekvencia
+ * @return false, ha a fájl nem olvasható vagy nem 16 bites PCM
+ */
+bool read(const char *path, std::vector<int16_t> &samples, float targetRateHz);
+
+/**
+ * @brief Minták kiírása mono 16 bites PCM WAV fájlba
+ * @param path A fájl útvonala
+ * @param samples A minták (+/-2047 skálán)
+ * @param count A minták száma
+ * @param sampleRateHz A mintavételi frekvencia (egészre kerekítve kerül a fejlécbe)
+ * @return false, ha a fájl nem írható
+ */
+bool write(const char *path, const int16_t *samples, uint32_t count, float sampleRateHz);
+
+};  // namespace WavFile
+
+#endif  // WAV_FILE_H
@@ -0,0 +1,108 @@
+#ifndef NATIVE_HOST_ARDUINO_H
+#define NATIVE_HOST_ARDUINO_H
+
+/**
+ * @brief Az Arduino-Pico core azon része, amit a DSP kód használ, hoston (env:native)
+ *
+ * Csak a dekóderek, a minta busz, az FFT backendek és a magok közötti sorok igényeit fedi le:
+ * szimulált millis()/micros(), Serial (printf), PROGMEM/PSTR, constrain() és a multicore FIFO.
+ * Kijelzőt, rádiót, GPIO-t nem emulál.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "NativeHost.h"
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+
+#define A0 26
+#define A1 27
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_float(addr) (*reinterpret_cast<const float *>(addr))
+#define pgm_read_ptr(addr) (*(addr))
+
+#define __not_in_flash_func(func) func
+#define __time_critical_func(func) func
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/**
+ * @brief A szimulált óra ezredmásodpercben (lásd NativeHost::setMicros())
+ */
+inline unsigned long millis() { return static_cast<unsigned long>(NativeHost::getMicros() / 1000); }
+
+/**
+ * @brief A szimulált óra mikroszekundumban (32 biten körbefordul, mint a Pico-n)
+ */
+inline unsigned long micros() { return static_cast<uint32_t>(NativeHost::getMicros()); }
+
+/**
+ * @brief Várakozás: a szimulált órát lépteti
+ */
+inline void delay(unsigned long ms) { NativeHost::advanceMicros(static_cast<uint64_t>(ms) * 1000); }
+inline void delayMicroseconds(unsigned int us) { NativeHost::advanceMicros(us); }
+
+/**
+ * @brief Nincs ADC: a hoston a minták egy ArraySampleSource-ból jönnek
+ */
+inline int analogRead(int pin) {
+    (void)pin;
+    return 2048;
+}
+
+inline void tight_loop_contents() {}
+
+/**
+ * @brief A Serial printf jellegű része (a DEBUG makró és a diagnosztikák)
+ */
+class HostSerial {
+   public:
+    int printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    int printf_P(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char *text);
+    size_t println(const char *text = "");
+
+    explicit operator bool() const { return true; }
+};
+extern HostSerial Serial;
+
+/**
+ * @brief Az rp2040 objektum multicore FIFO-ja (irányonként 8 mély, mint a hardveré)
+ *
+ * A Core0 szála a Core1 felé ír és onnan olvas, a Core1 szála fordítva (NativeHost::setCurrentCore()).
+ */
+class HostMulticoreFifo {
+   public:
+    bool push_nb(uint32_t value);
+    void push(uint32_t value);
+    bool pop_nb(uint32_t *value);
+    uint32_t pop();
+    int available();
+};
+
+class HostRp2040 {
+   public:
+    HostMulticoreFifo fifo;
+
+    uint32_t getCycleCount() { return static_cast<uint32_t>(NativeHost::getMicros() * 133); }
+};
+extern HostRp2040 rp2040;
+
+#endif  // NATIVE_HOST_ARDUINO_H
@@ -0,0 +1,143 @@
+#include "NativeHost.h"
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+constexpr size_t FIFO_DEPTH = 8;  // A hardver FIFO mélysége irányonként
+
+std::atomic<uint64_t> simulatedMicros(0);
+std::atomic<bool> serialEnabled(false);
+thread_local uint8_t currentCore = 0;
+
+std::mutex fifoMutex;
+std::condition_variable fifoChanged;
+std::deque<uint32_t> fifoToCore[2];  // [n]: a Core n felé tartó szavak
+
+/**
+ * @brief A hívó szál által írt (a másik mag felé tartó) sor
+ */
+std::deque<uint32_t> &outgoingFifo() { return fifoToCore[currentCore ^ 1]; }
+
+/**
+ * @brief A hívó szál által olvasott (neki szóló) sor
+ */
+std::deque<uint32_t> &incomingFifo() { return fifoToCore[currentCore]; }
+
+}  // namespace
+
+HostSerial Serial;
+HostRp2040 rp2040;
+
+void NativeHost::setMicros(uint64_t timeUs) { simulatedMicros = timeUs; }
+
+void NativeHost::advanceMicros(uint64_t deltaUs) { simulatedMicros += deltaUs; }
+
+uint64_t NativeHost::getMicros() { return simulatedMicros; }
+
+void NativeHost::setCurrentCore(uint8_t core) { currentCore = core & 1; }
+
+uint8_t NativeHost::getCurrentCore() { return currentCore; }
+
+void NativeHost::resetFifo() {
+    std::lock_guard<std::mutex> lock(fifoMutex);
+    fifoToCore[0].clear();
+    fifoToCore[1].clear();
+}
+
+void NativeHost::setSerialEnabled(bool enabled) { serialEnabled = enabled; }
+
+int HostSerial::printf(const char *format, ...) {
+    if (!serialEnabled) {
+        return 0;
+    }
+    va_list args;
+    va_start(args, format);
+    const int written = vprintf(format, args);
+    va_end(args);
+    return written;
+}
+
+int HostSerial::printf_P(const char *format, ...) {
+    if (!serialEnabled) {
+        return 0;
+    }
+    va_list args;
+    va_start(args, format);
+    const int written = vprintf(format, args);
+    va_end(args);
+    return written;
+}
+
+size_t HostSerial::print(const char *text) {
+    if (!serialEnabled) {
+        return 0;
+    }
+    fputs(text, stdout);
+    return strlen(text);
+}
+
+size_t HostSerial::println(const char *text) { return print(text) + print("\r\n"); }
+
+/**
+ * @brief Egy szó küldése a másik magnak, ha van hely
+ * @return false, ha a FIFO tele
+ */
+bool HostMulticoreFifo::push_nb(uint32_t value) {
+    std::lock_guard<std::mutex> lock(fifoMutex);
+    if (outgoingFifo().size() >= FIFO_DEPTH) {
+        return false;
+    }
+    outgoingFifo().push_back(value);
+    fifoChanged.notify_all();
+    return true;
+}
+
+/**
+ * @brief Egy szó küldése a másik magnak, tele FIFO-nál várakozik
+ */
+void HostMulticoreFifo::push(uint32_t value) {
+    std::unique_lock<std::mutex> lock(fifoMutex);
+    fifoChanged.wait(lock, [] { return outgoingFifo().size() < FIFO_DEPTH; });
+    outgoingFifo().push_back(value);
+    fifoChanged.notify_all();
+}
+
+/**
+ * @brief Egy szó kivétele, ha van
+ */
+bool HostMulticoreFifo::pop_nb(uint32_t *value) {
+    std::lock_guard<std::mutex> lock(fifoMutex);
+    if (incomingFifo().empty()) {
+        return false;
+    }
+    *value = incomingFifo().front();
+    incomingFifo().pop_front();
+    fifoChanged.notify_all();
+    return true;
+}
+
+/**
+ * @brief Egy szó kivétele, üres FIFO-nál várakozik
+ */
+uint32_t HostMulticoreFifo::pop() {
+    std::unique_lock<std::mutex> lock(fifoMutex);
+    fifoChanged.wait(lock, [] { return !incomingFifo().empty(); });
+    const uint32_t value = incomingFifo().front();
+    incomingFifo().pop_front();
+    fifoChanged.notify_all();
+    return value;
+}
+
+/**
+ * @brief A kiolvasható szavak száma
+ */
+int HostMulticoreFifo::available() {
+    std::lock_guard<std::mutex> lock(fifoMutex);
+    return static_cast<int>(incomingFifo().size());
+}
@@ -0,0 +1,56 @@
+#ifndef NATIVE_HOST_H
+#define NATIVE_HOST_H
+
+#include <stdint.h>
+
+/**
+ * @brief A hoston futó tesztek vezérlése: szimulált óra és mag azonosító
+ *
+ * A millis()/micros() nem a valós időt adja, hanem a teszt által léptetett szimulált
+ * órát, így a dekóderek időbélyegei a betáplált minták számából következnek, és egy
+ * mérés ugyanazt az eredményt adja lassú és gyors gépen is. A mag azonosító szálanként
+ * külön van: a két magot két std::thread emulálja, a multicore FIFO iránya ebből adódik.
+ */
+namespace NativeHost {
+
+/**
+ * @brief A szimulált óra beállítása
+ * @param timeUs Az új idő mikroszekundumban
+ */
+void setMicros(uint64_t timeUs);
+
+/**
+ * @brief A szimulált óra léptetése
+ * @param deltaUs A lépés mikroszekundumban
+ */
+void advanceMicros(uint64_t deltaUs);
+
+/**
+ * @brief A szimulált óra (a micros() 64 bites, körbe nem forduló megfelelője)
+ */
+uint64_t getMicros();
+
+/**
+ * @brief A hívó szál melyik magot emulálja (alapértelmezés: 0)
+ * @param core 0 vagy 1
+ */
+void setCurrentCore(uint8_t core);
+
+/**
+ * @brief A hívó szál magja
+ */
+uint8_t getCurrentCore();
+
+/**
+ * @brief A multicore FIFO-k ürítése (tesztek között)
+ */
+void resetFifo();
+
+/**
+ * @brief A Serial kimenet ki/be kapcsolása (alapból kikapcsolva, a DEBUG üzenetek ne keveredjenek a riportba)
+ */
+void setSerialEnabled(bool enabled);
+
+};  // namespace NativeHost
+
+#endif  // NATIVE_HOST_H
@@ -0,0 +1,18 @@
+#ifndef NATIVE_HOST_HARDWARE_SYNC_H
+#define NATIVE_HOST_HARDWARE_SYNC_H
+
+#include <atomic>
+#include <thread>
+
+/**
+ * @brief A Pico SDK szinkronizációs primitívjei hoston
+ *
+ * A __dmb() teljes memória gát (a két magot emuláló szálak között is), az esemény
+ * (SEV/WFE) pár helyett a WFE csak átadja a processzort a másik szálnak: a hívók úgyis ciklusban
+ * ellenőrzik a feltételt.
+ */
+inline void __dmb() { std::atomic_thread_fence(std::memory_order_seq_cst); }
+inline void __sev() {}
+inline void __wfe() { std::this_thread::yield(); }
+
+#endif  // NATIVE_HOST_HARDWARE_SYNC_H
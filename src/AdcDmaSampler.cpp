@@ -0,0 +1,237 @@
+#include "AdcDmaSampler.h"
+
+#include "defines.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// A DMA write ring wrap miatt a puffernek a saját méretéhez igazítva kell lennie
+alignas(AudioSampleRingConstants::RING_SIZE_BYTES) static uint16_t adcRingBuffer[AudioSampleRingConstants::RING_SIZE];
+
+volatile uint32_t AdcDmaSampler::wrapCount_ = 0;
+int AdcDmaSampler::dataChannel_ = -1;
+int AdcDmaSampler::controlChannel_ = -1;
+spin_lock_t *AdcDmaSampler::wrapLock_ = nullptr;
+
+/**
+ * @brief AdcDmaSampler konstruktor
+ */
+AdcDmaSampler::AdcDmaSampler() : AudioSampleRing(adcRingBuffer), stoppedWriteIndex_(0), ringTransferCount_(AudioSampleRingConstants::RING_SIZE), adcInput_(0) {}
+
+/**
+ * @brief AdcDmaSampler destruktor
+ */
+AdcDmaSampler::~AdcDmaSampler() { stop(); }
+
+/**
+ * @brief DMA IRQ kezelő - csak a gyűrű körbefordulásait számolja
+ *
+ * A számláló növelése és a nyugtázás egy zár alatt történik, így a másik magról
+ * olvasó getWriteIndex() sosem látja a kettő közötti állapotot.
+ */
+void AdcDmaSampler::dmaIrqHandler() {
+    if (dataChannel_ >= 0 && dma_channel_get_irq0_status(dataChannel_)) {
+        uint32_t irqState = spin_lock_blocking(wrapLock_);
+        wrapCount_ = wrapCount_ + 1;
+        dma_channel_acknowledge_irq0(dataChannel_);
+        spin_unlock(wrapLock_, irqState);
+    }
+}
+
+/**
+ * @brief Mintavételezés indítása (ha már fut más beállítással, újraindul)
+ * @param audioPin Az audio bemenet pin száma (A0..A2)
+ * @param sampleRateHz Kért mintavételezési frekvencia Hz-ben
+ * @return true ha sikeres
+ */
+bool AdcDmaSampler::start(int audioPin, float sampleRateHz) {
+    using namespace AdcDmaSamplerConstants;
+
+    if (sampleRateHz <= 0.0f || audioPin < ADC_FIRST_PIN || audioPin > ADC_FIRST_PIN + 2) {
+        DEBUG("AdcDmaSampler: Érvénytelen paraméterek (pin: %d, Fs: %.1f Hz)\n", audioPin, sampleRateHz);
+        return false;
+    }
+
+    if (running_) {
+        if (requestedSampleRateHz_ == sampleRateHz && adcInput_ == audioPin - ADC_FIRST_PIN) {
+            return true;  // Már fut ugyanezzel a beállítással
+        }
+        stop();
+    }
+
+    if (wrapLock_ == nullptr) {
+        wrapLock_ = spin_lock_instance(spin_lock_claim_unused(true));
+    }
+
+    // Az Arduino core az első analogRead()-nél inicializálja (reseteli) az ADC-t,
+    // ezt előbb ki kell váltani, különben később elrontaná a FIFO beállításainkat
+    (void)analogRead(audioPin);
+
+    // ADC órajel osztó: fs = 48MHz / (1 + div), a tört rész 8 bites
+    float clkDiv = ADC_CLOCK_HZ / sampleRateHz - 1.0f;
+    if (clkDiv < ADC_MIN_CLKDIV) {
+        clkDiv = ADC_MIN_CLKDIV;
+    }
+    clkDiv = floorf(clkDiv * 256.0f) / 256.0f;  // A hardver ugyanígy csonkol
+
+    adcInput_ = audioPin - ADC_FIRST_PIN;
+    requestedSampleRateHz_ = sampleRateHz;
+    actualSampleRateHz_ = ADC_CLOCK_HZ / (1.0f + clkDiv);
+
+    adc_run(false);
+    adc_gpio_init(audioPin);
+    adc_select_input(adcInput_);
+    adc_fifo_setup(true,    // FIFO engedélyezése
+                   true,    // DREQ engedélyezése a DMA számára
+                   1,       // DREQ már 1 mintánál
+                   false,   // Nincs hibabit a mintákban
+                   false);  // 12 bites minták, nincs byte shift
+    adc_set_clkdiv(clkDiv);
+    adc_fifo_drain();
+
+    dataChannel_ = dma_claim_unused_channel(false);
+    controlChannel_ = dma_claim_unused_channel(false);
+    if (dataChannel_ < 0 || controlChannel_ < 0) {
+        DEBUG("AdcDmaSampler: Nincs szabad DMA csatorna!\n");
+        stop();
+        return false;
+    }
+
+    // Adat csatorna: ADC FIFO -> gyűrű, a cím a puffer méretén belül körbefordul
+    dma_channel_config dataConfig = dma_channel_get_default_config(dataChannel_);
+    channel_config_set_transfer_data_size(&dataConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&dataConfig, false);
+    channel_config_set_write_increment(&dataConfig, true);
+    channel_config_set_ring(&dataConfig, true, AudioSampleRingConstants::RING_SIZE_BITS + 1);  // log2(méret bájtban)
+    channel_config_set_dreq(&dataConfig, DREQ_ADC);
+    channel_config_set_chain_to(&dataConfig, controlChannel_);
+    dma_channel_configure(dataChannel_, &dataConfig, adcRingBuffer, &adc_hw->fifo, AudioSampleRingConstants::RING_SIZE, false);
+
+    // Vezérlő csatorna: a transfer count újratöltésével újraindítja az adat csatornát
+    // (az írási cím a ring wrap miatt már a puffer elején áll)
+    dma_channel_config controlConfig = dma_channel_get_default_config(controlChannel_);
+    channel_config_set_transfer_data_size(&controlConfig, DMA_SIZE_32);
+    channel_config_set_read_increment(&controlConfig, false);
+    channel_config_set_write_increment(&controlConfig, false);
+    dma_channel_configure(controlChannel_, &controlConfig, &dma_hw->ch[dataChannel_].al1_transfer_count_trig, &ringTransferCount_, 1, false);
+
+    // Körbefordulás számláló IRQ
+    wrapCount_ = 0;
+    stoppedWriteIndex_ = 0;
+    dma_channel_set_irq0_enabled(dataChannel_, true);
+    irq_add_shared_handler(DMA_IRQ_0, dmaIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    dma_channel_start(dataChannel_);
+    startTimeUs_ = micros();
+    adc_run(true);
+    running_ = true;
+
+    DEBUG("AdcDmaSampler: Indítva, ADC%d, kért Fs: %.1f Hz, tényleges Fs: %.2f Hz (clkdiv: %.4f)\n", adcInput_, requestedSampleRateHz_, actualSampleRateHz_, clkDiv);
+    return true;
+}
+
+/**
+ * @brief Mintavételezés leállítása, a DMA csatornák felszabadítása
+ */
+void AdcDmaSampler::stop() {
+    adc_run(false);
+    if (running_) {
+        stoppedWriteIndex_ = getWriteIndex();
+    }
+
+    if (dataChannel_ >= 0) {
+        dma_channel_set_irq0_enabled(dataChannel_, false);
+        irq_remove_handler(DMA_IRQ_0, dmaIrqHandler);
+    }
+    // Először a vezérlő csatornát állítjuk le, hogy ne indíthassa újra az adat csatornát
+    if (controlChannel_ >= 0) {
+        dma_channel_abort(controlChannel_);
+        dma_channel_unclaim(controlChannel_);
+        controlChannel_ = -1;
+    }
+    if (dataChannel_ >= 0) {
+        dma_channel_abort(dataChannel_);
+        dma_channel_unclaim(dataChannel_);
+        dataChannel_ = -1;
+    }
+
+    adc_fifo_setup(false, false, 0, false, false);
+    adc_fifo_drain();
+    running_ = false;
+}
+
+/**
+ * @brief Az eddig beírt minták száma (monoton növekvő abszolút írási index)
+ *
+ * A pozíció a DMA hátralévő transfer count-jából, a befejezett körök száma az IRQ
+ * számlálójából és a még ki nem szolgált (függő) DMA megszakításból adódik.
+ * A transfer count-ot kétszer olvassuk: ha a két olvasás között véget ért vagy újraindult
+ * a kör, újra próbáljuk, így a függő bit és a pozíció ugyanarra a körre vonatkozik.
+ * Mindkét magról hívható.
+ */
+uint32_t AdcDmaSampler::getWriteIndex() {
+    using namespace AudioSampleRingConstants;
+
+    if (dataChannel_ < 0) {
+        return stoppedWriteIndex_;
+    }
+
+    uint32_t wraps;
+    uint32_t pending;
+    uint32_t remaining;
+    uint32_t remainingCheck;
+    do {
+        uint32_t irqState = spin_lock_blocking(wrapLock_);
+        remaining = dma_hw->ch[dataChannel_].transfer_count;
+        pending = (dma_hw->intr >> dataChannel_) & 1u;
+        wraps = wrapCount_;
+        remainingCheck = dma_hw->ch[dataChannel_].transfer_count;
+        spin_unlock(wrapLock_, irqState);
+    } while (remainingCheck > remaining || (remainingCheck == 0 && remaining != 0));
+
+    // remaining == 0: a kör véget ért, a vezérlő csatorna még nem indította újra
+    uint32_t position = remaining == 0 ? 0 : RING_SIZE - remaining;
+    return (wraps + pending) * RING_SIZE + position;
+}
+
+/**
+ * @brief Mintavételezés ideiglenes szüneteltetése (pl. más ADC csatorna olvasásához)
+ *
+ * A FIFO-t is letiltjuk, hogy a közbenső egyszeri konverzió ne kerüljön a gyűrűbe.
+ * A DMA csatorna élesítve marad, a DREQ visszatértével folytatja az írást.
+ * @return true ha a mintavételezés futott (ezt kell a resumeCapture()-nek átadni)
+ */
+bool AdcDmaSampler::pauseCapture() {
+    if (!running_) {
+        return false;
+    }
+    adc_run(false);
+    while (!(adc_hw->cs & ADC_CS_READY_BITS)) {
+        tight_loop_contents();  // A folyamatban lévő konverzió bevárása
+    }
+    adc_fifo_setup(false, false, 0, false, false);
+    adc_fifo_drain();
+    return true;
+}
+
+/**
+ * @brief Szüneteltetett mintavételezés folytatása
+ *
+ * A szünet alatt nem készültek minták, ezért az időalapot újra horgonyozzuk: a következő
+ * minta (az aktuális írási index) időbélyege a folytatás pillanata lesz, így a szünet
+ * nem csúsztatja el a későbbi minták időbélyegeit.
+ * @param wasRunning A pauseCapture() visszatérési értéke
+ */
+void AdcDmaSampler::resumeCapture(bool wasRunning) {
+    if (!wasRunning || !running_) {
+        return;
+    }
+    adc_select_input(adcInput_);
+    adc_fifo_drain();
+    adc_fifo_setup(true, true, 1, false, false);
+
+    uint32_t nextSampleIndex = getWriteIndex();
+    startTimeUs_ = micros() - getElapsedUs(nextSampleIndex);
+    adc_run(true);
+}
@@ -2,9 +2,11 @@
 
 #include <Arduino.h>
 
+#include "Core1Mailbox.h"        // Üzenetek a Core1-nek
+#include "DecodedTextRing.h"     // A Core1 dekódereinek szövege
+#include "MorseCode.h"           // CW prosignok szövege
 #include "core_communication.h"  // Parancsok definíciója
 #include "defines.h"             // DEBUG makróhoz
-#include "pico/multicore.h"      // FIFO kommunikációhoz
 
 /**
  * @brief Konstruktor az AmDisplay osztályhoz.
@@ -49,8 +51,10 @@ AmDisplay::AmDisplay(TFT_eSPI &tft, SI4735 &si4735, Band &band)
     // Dekódolt szöveg pufferek inicializálása (CW és RTTY)
     for (int i = 0; i < RTTY_MAX_TEXT_LINES; ++i) {
         decodedTextDisplayLines[i] = "";
+        decodedTextDisplayDimMasks[i] = 0;
     }
     decodedTextCurrentLineBuffer = "";
+    decodedTextCurrentLineDimMask = 0;
 
     // Dekódolási módváltó gombok létrehozása
     uint8_t nextButtonId = SCRN_HBTNS_ID_START + horizontalButtonCount;
@@ -62,7 +66,7 @@ AmDisplay::AmDisplay(TFT_eSPI &tft, SI4735 &si4735, Band &band)
     decoderCharHeight_ = tft.fontHeight();
     if (decoderCharHeight_ == 0) decoderCharHeight_ = 16;  // Alapértelmezett érték, ha a font magassága 0
 
-    std::vector<String> decoderLabels = {"Off", "RTTY", "CW"};
+    std::vector<String> decoderLabels = {"Off", "RTTY", "CW", "Skim"};
     decoderModeGroup.createButtons(decoderLabels, nextButtonId);
     decoderModeGroup.selectButtonByIndex(0);
 
@@ -94,6 +98,7 @@ void AmDisplay::drawScreen() {
     uint8_t snr = si4735.getCurrentSNR();
     pSMeter->showRSSI(rssi, snr, band.getCurrentBand().varData.currMod == FM);
     float currFreq = band.getCurrentBand().varData.currFreq;
+    pSevenSegmentFreq->invalidate();  // A képernyőt töröltük, a frekvencia teljesen újrarajzolandó
     pSevenSegmentFreq->freqDispl(currFreq);
     drawDecodedTextAreaBackground();
     updateDecodedTextDisplay();
@@ -268,38 +273,57 @@ void AmDisplay::displayLoop() {
 }
 
 /**
- * @brief Kommunikál a Core1-gyel, hogy dekódolja a CW vagy RTTY szöveget.
+ * @brief Kiüríti a Core1 dekóderei által a közös szöveg gyűrűbe írt karaktereket.
+ *
+ * Nincs kérés-válasz a FIFO-n: egy hívás legfeljebb DECODED_TEXT_DRAIN_MAX karaktert
+ * vesz ki várakozás nélkül. Módváltás után a régi dekóder még beírhatott karaktereket,
+ * ezért csak az aktuális módhoz tartozó forrás karaktereit jelenítjük meg. A dekóder által
+ * bizonytalannak jelölt (DECODED_TEXT_LOW_CONFIDENCE alatti) karakterek halványan jelennek meg.
  */
 void AmDisplay::decodeCwAndRttyText() {
+    DecodedTextSource expectedSource;
+    switch (currentDecodeMode) {
+        case DecodeMode::RTTY:
+            expectedSource = DecodedTextSource::Rtty;
+            break;
+        case DecodeMode::MORSE:
+            expectedSource = DecodedTextSource::Cw;
+            break;
+        case DecodeMode::CW_SKIMMER:
+            expectedSource = DecodedTextSource::CwSkimmer;
+            break;
+        default:
+            decodedTextRing.clear();
+            return;
+    }
 
-    // Parancs küldése a Core1-nek, hogy adjon egy dekódolt karaktert
-    uint32_t getCommand = currentDecodeMode == DecodeMode::MORSE ? CORE1_CMD_GET_CW_CHAR : CORE1_CMD_GET_RTTY_CHAR;
-    if (!rp2040.fifo.push_nb(getCommand)) {
-        Utils::beepError();
-        DEBUG("Core0: getCommand NOT sent to Core1, FIFO full\n");
-        return;  // Ha a FIFO tele van, akkor nem küldjük el a parancsot
-    }
-
-    // Várakozás a válaszra (dekódolt karakter) a Core1-től
-    char decodedChar = '\0';  // Dekódolt karakter inicializálása
-    bool char_popped = false;
-    unsigned long startTimeWait = millis();
-    while (millis() - startTimeWait < 5) {  // Timeout 5 ms. Érdemes lehet konstanssá tenni.
-        if (rp2040.fifo.available() > 0) {
-            uint32_t raw_command;
-            if (rp2040.fifo.pop_nb(&raw_command)) {
-                decodedChar = static_cast<char>(raw_command);
-                // DEBUG("Core0: CW decodedChar received: '%c' (%d)\n", decodedChar, decodedChar);
-                if (decodedChar != '\0') {
-                    appendDecodedCharacter(decodedChar);
-                }
-                char_popped = true;
-                break;  // Kilépés a ciklusból, ha sikeresen olvastunk
+    DecodedTextEntry entries[DECODED_TEXT_DRAIN_MAX];
+    uint16_t count = decodedTextRing.popMany(entries, DECODED_TEXT_DRAIN_MAX);
+    for (uint16_t i = 0; i < count; i++) {
+        const DecodedTextEntry &entry = entries[i];
+        if (entry.source != expectedSource || entry.character == '\0') {
+            continue;
+        }
+
+        // Skimmer: másik állomás szövege új sorban, a hangfrekvenciájával kezdődik
+        if (entry.source == DecodedTextSource::CwSkimmer && entry.channelHz != lastSkimmerOffsetHz_) {
+            lastSkimmerOffsetHz_ = entry.channelHz;
+            appendDecodedCharacter('\n');
+            char tag[8];
+            snprintf(tag, sizeof(tag), "%u: ", entry.channelHz);
+            for (const char *p = tag; *p != '\0'; p++) {
+                appendDecodedCharacter(*p);
             }
         }
-        // Ha nem volt elérhető karakter, a ciklus folytatódik a timeoutig.
-        // Egy rövid várakozás itt csökkentheti a CPU terhelést.
-        delayMicroseconds(50);  // Opcionális: rövid várakozás
+        const bool dimmed = entry.confidence != DecodedTextRingConstants::CONFIDENCE_UNKNOWN && entry.confidence < DECODED_TEXT_LOW_CONFIDENCE;
+        const char *prosign = MorseCode::getProsignText(entry.character);
+        if (prosign != nullptr) {
+            for (const char *p = prosign; *p != '\0'; p++) {
+                appendDecodedCharacter(*p, dimmed);
+            }
+        } else {
+            appendDecodedCharacter(entry.character, dimmed);
+        }
     }
 }
 
@@ -319,6 +343,37 @@ void AmDisplay::drawDecodedTextAreaBackground() {
     tft.drawRect(decodedTextAreaX - 1, decodedTextAreaY - 1, decodedTextAreaW + 2, decodedTextAreaH + 2, TFT_DARKGREY);
 }
 
+/**
+ * @brief Egy dekódolt sor kirajzolása; a halvány (bizonytalan) karakterek szürkén
+ * @param line A sor szövege
+ * @param dimMask A halvány karakterek bitjei (bit i = az i. karakter)
+ * @param y A sor teteje
+ *
+ * Az azonos színű karakter futamokat egyben rajzolja, így egy bizonytalan karakter nélküli
+ * sor továbbra is egyetlen drawString.
+ */
+void AmDisplay::drawDecodedTextLine(const String &line, uint64_t dimMask, uint16_t y) {
+    if (dimMask == 0) {
+        tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
+        tft.drawString(line, decodedTextAreaX + 2, y);
+        return;
+    }
+
+    int32_t x = decodedTextAreaX + 2;
+    uint16_t runStart = 0;
+    while (runStart < line.length()) {
+        const bool dimmed = (dimMask >> runStart) & 1;
+        uint16_t runEnd = runStart + 1;
+        while (runEnd < line.length() && (((dimMask >> runEnd) & 1) != 0) == dimmed) {
+            runEnd++;
+        }
+        tft.setTextColor(dimmed ? TFT_DARKGREY : TFT_GREENYELLOW, TFT_BLACK);
+        x += tft.drawString(line.substring(runStart, runEnd), x, y);
+        runStart = runEnd;
+    }
+    tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
+}
+
 /**
  * @brief Csak az aktuális beviteli sort rajzolja újra a dekódolt szöveg területén.
  * Minimalizálja a villogást karakterenkénti hozzáfűzéskor.
@@ -351,21 +406,26 @@ void AmDisplay::redrawCurrentInputLine() {
     tft.setFreeFont();  // Biztosítjuk a helyes fontot
     tft.setTextSize(1);
     if (!decodedTextCurrentLineBuffer.isEmpty()) {
-        tft.drawString(decodedTextCurrentLineBuffer, decodedTextAreaX + 2, yPos);
+        drawDecodedTextLine(decodedTextCurrentLineBuffer, decodedTextCurrentLineDimMask, yPos);
     }
 }
 
 /**
  * @brief Hozzáfűz egy karaktert a dekódolt szöveg kijelző pufferéhez és frissíti a kijelzőt.
+ * @param c A karakter
+ * @param dimmed A dekóder bizonytalan a karakterben (halványan jelenik meg)
  */
-void AmDisplay::appendDecodedCharacter(char c) {
+void AmDisplay::appendDecodedCharacter(char c, bool dimmed) {
     bool needs_full_redraw = false;
     bool char_appended = false;
 
     if (c == '\n') {  // Explicit sortörés
         needs_full_redraw = true;
-    } else if (c >= 32 && c <= 126) {  // Nyomtatható karakter
+    } else if ((c >= 32 && c <= 126) || static_cast<uint8_t>(c) >= 0x80) {  // Nyomtatható karakter (a GLCD font CP437 felső fele: ékezetes betűk)
         if (decodedTextCurrentLineBuffer.length() < RTTY_LINE_BUFFER_SIZE - 1) {
+            if (dimmed) {
+                decodedTextCurrentLineDimMask |= 1ULL << decodedTextCurrentLineBuffer.length();
+            }
             decodedTextCurrentLineBuffer += c;
             char_appended = true;
             // Ellenőrizzük, hogy a puffer most telt-e meg
@@ -386,13 +446,17 @@ void AmDisplay::appendDecodedCharacter(char c) {
         if (decodedTextCurrentLineIndex >= RTTY_MAX_TEXT_LINES - 1) {  // Görgetés szükséges
             for (int i = 0; i < RTTY_MAX_TEXT_LINES - 1; ++i) {
                 decodedTextDisplayLines[i] = decodedTextDisplayLines[i + 1];
+                decodedTextDisplayDimMasks[i] = decodedTextDisplayDimMasks[i + 1];
             }
             decodedTextDisplayLines[RTTY_MAX_TEXT_LINES - 1] = decodedTextCurrentLineBuffer;
+            decodedTextDisplayDimMasks[RTTY_MAX_TEXT_LINES - 1] = decodedTextCurrentLineDimMask;
         } else {  // Nincs görgetés, csak a következő sorra lépünk
             decodedTextDisplayLines[decodedTextCurrentLineIndex] = decodedTextCurrentLineBuffer;
+            decodedTextDisplayDimMasks[decodedTextCurrentLineIndex] = decodedTextCurrentLineDimMask;
             decodedTextCurrentLineIndex++;
         }
         decodedTextCurrentLineBuffer = "";
+        decodedTextCurrentLineDimMask = 0;
         updateDecodedTextDisplay();  // Teljes újrarajzolás
     } else if (char_appended) {
         // Karakter hozzáfűzve, nincs sortörés
@@ -424,7 +488,7 @@ void AmDisplay::updateDecodedTextDisplay() {
             // A legegyszerűbb, ha minden sort kirajzolunk a decodedTextDisplayLines-ból, ami nem üres,
             // és nem az aktuális szerkesztés alatt álló sor.
             if (i != decodedTextCurrentLineIndex && !decodedTextDisplayLines[i].isEmpty()) {
-                tft.drawString(decodedTextDisplayLines[i], decodedTextAreaX + 2, line_y_start);
+                drawDecodedTextLine(decodedTextDisplayLines[i], decodedTextDisplayDimMasks[i], line_y_start);
             }
         }
     }
@@ -434,7 +498,7 @@ void AmDisplay::updateDecodedTextDisplay() {
     uint16_t currentLineYPos = decodedTextAreaY + 2 + decodedTextCurrentLineIndex * (decoderCharHeight_ + DECODER_LINE_GAP);
     if (currentLineYPos + decoderCharHeight_ <= decodedTextAreaY + decodedTextAreaH) {  // Határellenőrzés
         if (!decodedTextCurrentLineBuffer.isEmpty()) {
-            tft.drawString(decodedTextCurrentLineBuffer, decodedTextAreaX + 2, currentLineYPos);
+            drawDecodedTextLine(decodedTextCurrentLineBuffer, decodedTextCurrentLineDimMask, currentLineYPos);
         }
         // Ha a decodedTextCurrentLineBuffer üres (pl. sortörés után), akkor a hátteret a drawDecodedTextAreaBackground már törölte.
     }
@@ -446,8 +510,10 @@ void AmDisplay::updateDecodedTextDisplay() {
 void AmDisplay::clearDecodedTextBufferOnly() {
     for (int i = 0; i < RTTY_MAX_TEXT_LINES; ++i) {
         decodedTextDisplayLines[i] = "";
+        decodedTextDisplayDimMasks[i] = 0;
     }
     decodedTextCurrentLineBuffer = "";
+    decodedTextCurrentLineDimMask = 0;
     decodedTextCurrentLineIndex = 0;
 }
 
@@ -477,22 +543,50 @@ void AmDisplay::setDecodeMode(DecodeMode newMode) {
             decoderModeGroup.selectButtonByIndex(2);
             core1_cmd_set_mode = CORE1_CMD_SET_MODE_CW;
             break;
+
+        case DecodeMode::CW_SKIMMER:
+            decoderModeGroup.selectButtonByIndex(3);
+            core1_cmd_set_mode = CORE1_CMD_SET_MODE_CW_SKIMMER;
+            lastSkimmerOffsetHz_ = 0;
+            break;
         default:
             break;
     }
 
-    // Parancs küldése Core1-nek a módváltásról
-    if (!rp2040.fifo.push_nb(static_cast<uint32_t>(core1_cmd_set_mode))) {
+    // Üzenet küldése Core1-nek a módváltásról
+    Core1Message message;
+    message.command = core1_cmd_set_mode;
+    if (core1Mailbox.post(message) == 0) {
         Utils::beepError();
-        DEBUG("Core0: Command NOT sent to Core1, FIFO full\n");
-        return;  // Ha a FIFO tele van, akkor nem küldjük el a parancsot
-    } else {
-        // A parancsküldés sikeres volt
-        // Ha kikapcsoljuk a módot, akkor nem töröljük a területet
-        if (core1_cmd_set_mode != CORE1_CMD_SET_MODE_OFF) {
-            clearDecodedTextBufferAndDisplay();
+        DEBUG("Core0: Command NOT sent to Core1, mailbox full\n");
+        return;  // Ha a postafiók tele van, akkor nem küldjük el a parancsot
+    }
+
+    // Az RTTY dekóder a beállított mark/shift frekvenciákra hangol (a baud automatikus)
+    if (core1_cmd_set_mode == CORE1_CMD_SET_MODE_RTTY) {
+        message.command = CORE1_CMD_SET_RTTY_PARAMS;
+        message.params.rtty.markHz = config.data.rttyMarkFrequencyHz;
+        message.params.rtty.shiftHz = config.data.rttyShiftHz;
+        message.params.rtty.baudRate = 0;
+        if (core1Mailbox.post(message) == 0) {
+            DEBUG("Core0: RTTY parameters NOT sent to Core1, mailbox full\n");
+        }
+    }
+
+    // A CW dekóder a beállított vételi eltolásra hangol (a Core1 nem olvassa a config-ot)
+    if (core1_cmd_set_mode == CORE1_CMD_SET_MODE_CW) {
+        message.command = CORE1_CMD_SET_CW_PARAMS;
+        message.params.cw.offsetHz = config.data.cwReceiverOffsetHz;
+        if (core1Mailbox.post(message) == 0) {
+            DEBUG("Core0: CW parameters NOT sent to Core1, mailbox full\n");
         }
     }
+
+    // A parancsküldés sikeres volt
+    // Ha kikapcsoljuk a módot, akkor nem töröljük a területet
+    if (core1_cmd_set_mode != CORE1_CMD_SET_MODE_OFF) {
+        clearDecodedTextBufferAndDisplay();
+    }
 }
 
 /**
@@ -501,8 +595,10 @@ void AmDisplay::setDecodeMode(DecodeMode newMode) {
 void AmDisplay::clearDecodedTextBufferAndDisplay() {
     for (int i = 0; i < RTTY_MAX_TEXT_LINES; ++i) {
         decodedTextDisplayLines[i] = "";
+        decodedTextDisplayDimMasks[i] = 0;
     }
     decodedTextCurrentLineBuffer = "";
+    decodedTextCurrentLineDimMask = 0;
     decodedTextCurrentLineIndex = 0;
     updateDecodedTextDisplay();
 }
@@ -517,4 +613,6 @@ void AmDisplay::setDecodeModeBasedOnButtonId(uint8_t buttonId) {
         setDecodeMode(DecodeMode::RTTY);
     else if (buttonId == decoderModeStartId_ + 2)
         setDecodeMode(DecodeMode::MORSE);
+    else if (buttonId == decoderModeStartId_ + 3)
+        setDecodeMode(DecodeMode::CW_SKIMMER);
 }
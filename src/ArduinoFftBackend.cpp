@@ -0,0 +1,95 @@
+#include "ArduinoFftBackend.h"
+
+#include "FftTables.h"
+
+#include <new>
+
+/**
+ * @brief ArduinoFftBackend konstruktor
+ */
+ArduinoFftBackend::ArduinoFftBackend() : vReal_(nullptr), vImag_(nullptr), size_(0), fft_(), windowType_(FFTWindow::Hamming), windowGainCorrection_(1.0f) {}
+
+/**
+ * @brief ArduinoFftBackend destruktor
+ */
+ArduinoFftBackend::~ArduinoFftBackend() { deallocate(); }
+
+/**
+ * @brief Munkatömbök felszabadítása
+ */
+void ArduinoFftBackend::deallocate() {
+    delete[] vReal_;
+    delete[] vImag_;
+    vReal_ = vImag_ = nullptr;
+    size_ = 0;
+}
+
+/**
+ * @brief FFT méret beállítása
+ * @param size Az új FFT méret (2 hatványa)
+ * @return true ha sikeres
+ */
+bool ArduinoFftBackend::setSize(uint16_t size) {
+    if (size < 4 || (size & (size - 1)) != 0) {
+        return false;
+    }
+    if (size == size_) {
+        return true;
+    }
+
+    deallocate();
+    vReal_ = new (std::nothrow) double[size];
+    vImag_ = new (std::nothrow) double[size];
+    if (!vReal_ || !vImag_) {
+        deallocate();
+        return false;
+    }
+    fft_.setArrays(vReal_, vImag_, size);
+    size_ = size;
+    return true;
+}
+
+/**
+ * @brief Ablakfüggvény kiválasztása
+ * @param type Az ablak típusa
+ */
+void ArduinoFftBackend::setWindowType(FftWindowType type) {
+    switch (type) {
+        case FftWindowType::Hann:
+            windowType_ = FFTWindow::Hann;
+            break;
+        case FftWindowType::BlackmanHarris:
+            windowType_ = FFTWindow::Blackman_Harris;
+            break;
+        case FftWindowType::FlatTop:
+            windowType_ = FFTWindow::Flat_top;
+            break;
+        case FftWindowType::Hamming:
+        default:
+            windowType_ = FFTWindow::Hamming;
+            break;
+    }
+    windowGainCorrection_ = FftTables::getWindowGainCorrection(type);
+}
+
+/**
+ * @brief Ablakozás, FFT és magnitúdó számítás double pontossággal
+ * @param samples N darab bemeneti minta
+ * @param magnitudes N/2 elemű kimeneti tömb
+ */
+void ArduinoFftBackend::computeMagnitudes(const int16_t *samples, float *magnitudes) {
+    if (size_ == 0) {
+        return;
+    }
+    for (uint16_t i = 0; i < size_; i++) {
+        vReal_[i] = samples[i];
+        vImag_[i] = 0.0;
+    }
+    fft_.windowing(vReal_, size_, windowType_, FFTDirection::Forward);
+    fft_.compute(vReal_, vImag_, size_, FFTDirection::Forward);
+    fft_.complexToMagnitude(vReal_, vImag_, size_);  // Az eredmény a vReal_-be kerül
+
+    for (uint16_t i = 0; i < size_ / 2; i++) {
+        magnitudes[i] = static_cast<float>(vReal_[i]) * windowGainCorrection_;
+    }
+}
@@ -1,22 +1,34 @@
 #include "AudioAnalyzerDisplay.h"
 
+#include <algorithm>  // std::min
+
+#include "WaterfallPalette.h"
+
 // Színprofilok
 namespace FftDisplayConstants {
-const uint16_t colors0[16] = {0x0000, 0x000F, 0x001F, 0x081F, 0x0810, 0x0800, 0x0C00, 0x1C00, 0xFC00, 0xFDE0, 0xFFE0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};  // Cold
-const uint16_t colors1[16] = {0x0000, 0x1000, 0x2000, 0x4000, 0x8000, 0xC000, 0xF800, 0xF8A0, 0xF9C0, 0xFD20, 0xFFE0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};  // Hot
+constexpr uint16_t colors0[16] = {0x0000, 0x000F, 0x001F, 0x081F, 0x0810, 0x0800, 0x0C00, 0x1C00, 0xFC00, 0xFDE0, 0xFFE0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};  // Cold
+constexpr uint16_t colors1[16] = {0x0000, 0x1000, 0x2000, 0x4000, 0x8000, 0xC000, 0xF800, 0xF8A0, 0xF9C0, 0xFD20, 0xFFE0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};  // Hot
+
+// A profilok 256 elemes palettái: a magnitúdó AMPLITUDE_SCALE-re normált, 0..255-re kvantált bájtja indexeli (a flash-ben)
+constexpr WaterfallPalette<16> PALETTES[] = {{colors0, 255}, {colors1, 255}};
+
 };  // namespace FftDisplayConstants
 
 /**
  * Az AudioAnalyzerDisplay osztály konstruktora
  */
 AudioAnalyzerDisplay::AudioAnalyzerDisplay(TFT_eSPI& tft, SI4735& si4735, Band& band, float& audioAnalyzerGainConfigRef)
-    : DisplayBase(tft, si4735, band), pAudioProcessor(nullptr), audioAnalyzerGainConfigRef_(audioAnalyzerGainConfigRef) {
+    : DisplayBase(tft, si4735, band), pAudioProcessor(nullptr), audioAnalyzerGainConfigRef_(audioAnalyzerGainConfigRef), waterfallPanel_(tft) {
     DEBUG("AudioAnalyzerDisplay::AudioAnalyzerDisplay\n");
     // A buildHorizontalScreenButtons-t a drawScreen-ben hívjuk,
     // miután a képernyő méretei és a DisplayBase inicializálása megtörtént.
 
     // AudioProcessor példányosítása
     pAudioProcessor = new AudioProcessor(audioAnalyzerGainConfigRef_, AUDIO_INPUT_PIN, 30000.0);  // 30kHz target sampling rate for 15kHz Nyquist
+    if (pAudioProcessor) {
+        pAudioProcessor->setWindowType(FftWindowType::BlackmanHarris);  // Vízeséshez alacsony oldalsávú ablak
+        pAudioProcessor->startCore1Processing();                        // A mintavétel és az FFT a Core1-en fut
+    }
 }
 
 /**
@@ -53,14 +65,17 @@ void AudioAnalyzerDisplay::drawScreen() {
     // Frekvencia skála kirajzolása alulra
     audioScaleAnalyzer(buttonAreaHeight);  // Átadjuk a gombok magasságát, hogy felette rajzoljon
 
-    // A vízesés rajzolásának kezdő Y pozíciója, közvetlenül a skála felett
-    current_y_analyzer = tft.height() - buttonAreaHeight - (AudioAnalyzerConstants::ANALYZER_BOTTOM_MARGIN + 1);
+    // A vízesés sávja a státuszsor alatt, közvetlenül a skála felett végződik (a státuszsor, a skála és a gombok fix sávok)
+    uint16_t waterfallBottomLimit = tft.height() - buttonAreaHeight - (AudioAnalyzerConstants::ANALYZER_BOTTOM_MARGIN + 1);
+    scroller_.begin(waterfallPanel_, FftDisplayConstants::PALETTES[AudioAnalyzerConstants::COLOR_PROFILE], AudioAnalyzerConstants::WATERFALL_TOP_Y,
+                    waterfallBottomLimit - AudioAnalyzerConstants::WATERFALL_TOP_Y + 1, std::min<int>(tft.width(), WaterfallScrollerConstants::MAX_WIDTH));
 
     // Az FFT objektumot a konstruktorban inicializáltuk.
 }
 
 AudioAnalyzerDisplay::~AudioAnalyzerDisplay() {
     DEBUG("AudioAnalyzerDisplay::~AudioAnalyzerDisplay\n");
+    scroller_.end();  // Hardveres görgetésnél a panel ismét egy az egyben mutatja a memóriát
     if (pAudioProcessor) {
         delete pAudioProcessor;
         pAudioProcessor = nullptr;
@@ -75,69 +90,48 @@ void AudioAnalyzerDisplay::displayLoop() {
 
     // FFT mintavételezés és számítás
     if (!pAudioProcessor) return;
-    pAudioProcessor->process(false);  // false: nem gyűjtünk oszcilloszkóp mintákat
-    const double* magnitudeData = pAudioProcessor->getMagnitudeData();
+    if (pAudioProcessor->process(false)) {  // false: nem gyűjtünk oszcilloszkóp mintákat
+        addWaterfallLine();                 // Új spektrum: új vízesés sor (különben a vízesés nem lép)
+    }
+
+    // Szoftveres görgetésnél a sáv következő sorainak újrarajzolása (körönként egy csík, a loop nem blokkol a teljes sáv idejéig)
+    scroller_.update();
+}
+
+/**
+ * @brief Az új spektrum a vízesés tetejére
+ *
+ * A sor a kijelzett bin-ek paletta bájtjai (legfeljebb a sáv szélességében, mert a görgető az
+ * előzményt ebben a felbontásban tárolja), a pixelekre a görgető nyújtja.
+ */
+void AudioAnalyzerDisplay::addWaterfallLine() {
+    const float* magnitudeData = pAudioProcessor->getMagnitudeData();
     float currentBinWidthHz = pAudioProcessor->getBinWidthHz();
     if (currentBinWidthHz == 0) return;  // Hiba elkerülése
 
-    // Az új spektrumvonal kirajzolása
-    // Végigiterálunk a kijelző szélességén, és leképezzük az FFT "bin"-ekre (frekvenciasávokra)
-    for (int x_coord = 0; x_coord < tft.width(); x_coord++) {
-        // Képernyő x-koordináta leképezése FFT bin indexre
-        // A kijelzendő tartomány: ANALYZER_MIN_FREQ_HZ-től ANALYZER_MAX_FREQ_HZ-ig
-        int start_display_bin = static_cast<int>(roundf(AudioAnalyzerConstants::ANALYZER_MIN_FREQ_HZ / currentBinWidthHz));
-        int end_display_bin =
-            static_cast<int>(roundf(AudioAnalyzerConstants::ANALYZER_MAX_FREQ_HZ / currentBinWidthHz));  // Biztosítjuk, hogy ne lépjük túl a maximális elérhető bin indexet
-        int fftSize = pAudioProcessor ? pAudioProcessor->getFftSize() : AudioProcessorConstants::DEFAULT_FFT_SAMPLES;
-        start_display_bin = constrain(start_display_bin, 0, fftSize / 2 - 1);
-        end_display_bin = constrain(end_display_bin, start_display_bin, fftSize / 2 - 1);
-        int num_displayable_bins = end_display_bin - start_display_bin + 1;
-
-        int fft_bin_index;
-        if (num_displayable_bins <= 1) {  // Elkerüljük az osztást nullával vagy negatívval, ha a tartomány túl szűk
-            fft_bin_index = start_display_bin;
-        } else {
-            // Lineáris interpoláció a képernyő pixel és a bin index között
-            fft_bin_index = start_display_bin + static_cast<int>(roundf(static_cast<float>(x_coord) / (tft.width() - 1.0f) * (num_displayable_bins - 1.0f)));
-        }
+    // A kijelzendő tartomány: ANALYZER_MIN_FREQ_HZ-től ANALYZER_MAX_FREQ_HZ-ig (soronként egyszer számoljuk)
+    const int displayWidth = std::min<int>(tft.width(), WaterfallScrollerConstants::MAX_WIDTH);
+    int fftSize = pAudioProcessor->getFftSize();
+    int start_display_bin = constrain(static_cast<int>(roundf(AudioAnalyzerConstants::ANALYZER_MIN_FREQ_HZ / currentBinWidthHz)), 0, fftSize / 2 - 1);
+    int end_display_bin = constrain(static_cast<int>(roundf(AudioAnalyzerConstants::ANALYZER_MAX_FREQ_HZ / currentBinWidthHz)), start_display_bin,
+                                    fftSize / 2 - 1);  // Biztosítjuk, hogy ne lépjük túl a maximális elérhető bin indexet
+    int num_displayable_bins = end_display_bin - start_display_bin + 1;
+    const int lineLength = std::min(num_displayable_bins, displayWidth);  // Több bin, mint pixel: pixelenként egy bin
+    const float binsPerElement = lineLength <= 1 ? 0.0f : (num_displayable_bins - 1.0f) / (lineLength - 1.0f);
+    constexpr float LEVEL_SCALE = 255.0f / AudioAnalyzerConstants::AMPLITUDE_SCALE;  // Magnitúdó -> paletta index (0..255)
+
+    uint8_t levels[WaterfallScrollerConstants::MAX_WIDTH];
+    for (int i = 0; i < lineLength; i++) {
+        int fft_bin_index = start_display_bin + static_cast<int>(roundf(i * binsPerElement));
         fft_bin_index = constrain(fft_bin_index, start_display_bin, end_display_bin);
 
-        double magnitude = magnitudeData[fft_bin_index];
-
-        // Magnitúdó skálázása és normalizálása (0.0 és 1.0 közé)
-        float normalized_magnitude = magnitude / AudioAnalyzerConstants::AMPLITUDE_SCALE;
-        if (normalized_magnitude > 1.0f) normalized_magnitude = 1.0f;
-        if (normalized_magnitude < 0.0f) normalized_magnitude = 0.0f;
-
-        // Szín meghatározása (a FftDisplayConstants-ben lévő colors0 profilt használva)
-        uint16_t color = valueToWaterfallColorAnalyzer(normalized_magnitude, 0.0f, 1.0f, 0);
-
-        // Pixel kirajzolása
-        tft.drawPixel(x_coord, current_y_analyzer, color);
+        // Magnitúdó skálázása és kvantálása (a 16 lépcsős profilban ugyanazt az indexet adja, mint a 0.0-1.0 normálás)
+        float level = magnitudeData[fft_bin_index] * LEVEL_SCALE;
+        levels[i] = level >= 255.0f ? 255 : (level > 0.0f ? static_cast<uint8_t>(level) : 0);
     }
 
-    // A gombok által elfoglalt magasság meghatározása
-    uint16_t buttonAreaHeight = SCRN_BTN_H + SCREEN_HBTNS_Y_MARGIN * 2;
-    // A vízesés alsó határa (ahol újra kell kezdeni a rajzolást)
-    uint16_t waterfallBottomLimit = tft.height() - buttonAreaHeight - (AudioAnalyzerConstants::ANALYZER_BOTTOM_MARGIN + 1);
-
-    // Kijelző görgetése: Y csökkentése, körbejárás, ha eléri a tetejét
-    current_y_analyzer--;
-    // A görgetés felső határa a státuszsor alatt kezdődik
-    if (current_y_analyzer < AudioAnalyzerConstants::WATERFALL_TOP_Y) {
-        current_y_analyzer = waterfallBottomLimit;
-        // Opcionális: a skála újrarajzolása, ha felülíródott vagy az átláthatóság kedvéért,
-        // de az új vonal rajzolása előtti fillRect-nek ezt kezelnie kellene.
-
-        // Annak a sornak a törlése, amelyik újra lesz rajzolva, a szellemkép elkerülése érdekében
-        tft.drawFastHLine(0, current_y_analyzer, tft.width(), TFT_COLOR_BACKGROUND);
-    }
-    // A következő rajzolandó sor törlése, hogy elkerüljük az előző képkocka szellemképét
-    if (current_y_analyzer >= AudioAnalyzerConstants::WATERFALL_TOP_Y) {  // Biztosítjuk, hogy y a határokon belül legyen
-        tft.drawFastHLine(0, current_y_analyzer, tft.width(), TFT_COLOR_BACKGROUND);
-    } else {  // Ha y körbejárt, töröljük az új kezdő sort
-        tft.drawFastHLine(0, waterfallBottomLimit, tft.width(), TFT_COLOR_BACKGROUND);
-    }
+    // Hardveres görgetésnél egyetlen sor írás (DMA) és a VSCRSADD, szoftveresen az előzménybe kerül
+    scroller_.addLine(levels, lineLength);
 }
 
 bool AudioAnalyzerDisplay::handleRotary(RotaryEncoder::EncoderState encoderState) {
@@ -203,28 +197,3 @@ void AudioAnalyzerDisplay::audioScaleAnalyzer(uint16_t occupiedBottomHeight) {
         tft.drawString(label, text_x + textWidth / 2, scaleBaseY - (ANALYZER_BOTTOM_MARGIN / 2) + 4);  // Y pozíció igazítása a scaleBaseY-hoz
     }
 }
-
-/**
- * @brief Egy értéket RGB565 színkóddá alakít a vízesés diagramhoz.
- * @param val Bemeneti érték (normalizálás után tipikusan 0.0 és 1.0 között).
- * @param min_val Várható minimális bemeneti érték.
- * @param max_val Várható maximális bemeneti érték.
- * @param colorProfileIndex Színprofil indexe (0 a FftDisplayConstants::colors0-hoz, 1 a FftDisplayConstants::colors1-hez).
- * @return RGB565 színkód.
- */
-uint16_t AudioAnalyzerDisplay::valueToWaterfallColorAnalyzer(float val, float min_val, float max_val, byte colorProfileIndex) {
-    uint16_t color;
-    // A DisplayBase-ben definiált színprofilokat használjuk
-    const uint16_t* colors = (colorProfileIndex == 0) ? FftDisplayConstants::colors0 : FftDisplayConstants::colors1;
-    byte color_size = 16;  // A DisplayBase-ben lévő profilok mérete
-
-    if (val < min_val) val = min_val;
-    if (val > max_val) val = max_val;
-
-    int index = (int)((val - min_val) * (color_size - 1) / (max_val - min_val));
-    if (index < 0) index = 0;
-    if (index >= color_size) index = color_size - 1;
-
-    color = colors[index];
-    return color;
-}
@@ -2,26 +2,62 @@
 
 #include <cmath>  // std::abs, std::round
 
+#include "AdcDmaSampler.h"
+#include "ArduinoFftBackend.h"
+#include "Core1Mailbox.h"
+#include "FixedPointFftBackend.h"
+#include "SpectrumFrameBuffer.h"
 #include "defines.h"  // DEBUG makróhoz, ha szükséges
 
 /**
  * @brief AudioProcessor konstruktor - inicializálja az audio feldolgozó objektumot
  * @param gainConfigRef Referencia a gain konfigurációs értékre
  * @param audioPin Az audio bemenet pin száma
- * @param targetSamplingFrequency Cél mintavételezési frekvencia Hz-ben
+ * @param targetSamplingFrequency Cél (minimális) mintavételezési frekvencia Hz-ben, ehhez választjuk a busz decimációját
  * @param fftSize FFT méret (alapértelmezett: DEFAULT_FFT_SAMPLES)
+ * @param sampleSource Minta forrás (nullptr esetén a globális ADC DMA mintavételező busz)
  */
-AudioProcessor::AudioProcessor(float& gainConfigRef, int audioPin, double targetSamplingFrequency, uint16_t fftSize)
-    : FFT(),
+AudioProcessor::AudioProcessor(float& gainConfigRef, int audioPin, double targetSamplingFrequency, uint16_t fftSize, AudioSampleRing* sampleSource)
+    : rawSamples(nullptr),
+      magnitudes(nullptr),
+      currentFftSize_(0),
+      fftBackend(nullptr),
+      windowType_(FftWindowType::Hamming),
+      core1Session_(0),
+      core1ConfigDirty_(false),
+      core1CollectOsci_(false),
+      core1WaitStartMs_(0),
+      core1FrameSequence_(0),
+      core1Magnitudes_(nullptr),
+      core1OsciSamples_(nullptr),
       activeFftGainConfigRef(gainConfigRef),
       audioInputPin(audioPin),
+      sampleSource_(sampleSource != nullptr ? sampleSource : &adcDmaSampler),
+      sampleReader_(*sampleSource_),
       targetSamplingFrequency_(targetSamplingFrequency),
       binWidthHz_(0.0f),
-      smoothed_auto_gain_factor_(1.0f),  // Simított erősítési faktor inicializálása
-      currentFftSize_(0),
-      vReal(nullptr),
-      vImag(nullptr),
-      RvReal(nullptr) {
+      smoothed_auto_gain_factor_(1.0f) {  // Simított erősítési faktor inicializálása
+
+    // FFT backend létrehozása
+    if (AudioProcessorConstants::USE_FIXED_POINT_FFT) {
+        fftBackend = new (std::nothrow) FixedPointFftBackend();
+    } else {
+        fftBackend = new (std::nothrow) ArduinoFftBackend();
+    }
+    if (!fftBackend) {
+        DEBUG("AudioProcessor: KRITIKUS: FFT backend létrehozása sikertelen!\n");
+        return;
+    }
+
+    if (targetSamplingFrequency_ <= 0) {
+        targetSamplingFrequency_ = 40000.0;  // Tartalék: 40kHz
+        DEBUG("AudioProcessor: Figyelmeztetés - targetSamplingFrequency nulla, tartalék használata.");
+    }
+
+    // A busz ellenőrzése és a decimáció kiválasztása, hogy az első process() hívásra már legyenek minták
+    // (az FFT méret felső korlátja a decimációtól függ, ezért előbb kell)
+    ensureSamplingRunning();
+    sampleReader_.setTargetSampleRate(static_cast<float>(targetSamplingFrequency_));
 
     // FFT méret érvényesítése és beállítása
     if (!validateFftSize(fftSize)) {
@@ -37,16 +73,9 @@ AudioProcessor::AudioProcessor(float& gainConfigRef, int audioPin, double target
             return;
         }
     }
-    if (targetSamplingFrequency_ > 0) {
-        sampleIntervalMicros_ = static_cast<uint32_t>(1000000.0 / targetSamplingFrequency_);
-        binWidthHz_ = static_cast<float>(targetSamplingFrequency_) / currentFftSize_;
-    } else {
-        sampleIntervalMicros_ = 25;  // Tartalék: 40kHz
-        binWidthHz_ = (1000000.0f / sampleIntervalMicros_) / currentFftSize_;
-        DEBUG("AudioProcessor: Figyelmeztetés - targetSamplingFrequency nulla, tartalék használata.");
-    }
-    DEBUG("AudioProcessor: FFT Méret: %d, Cél Fs: %.1f Hz, Minta Intervallum: %lu us, Bin Szélesség: %.2f Hz\n", currentFftSize_, targetSamplingFrequency_, sampleIntervalMicros_,
-          binWidthHz_);
+    updateBinWidth();
+    DEBUG("AudioProcessor: FFT Méret: %d, Cél Fs: %.1f Hz, Tényleges Fs: %.2f Hz (decimáció: %d), Bin Szélesség: %.2f Hz\n", currentFftSize_, targetSamplingFrequency_,
+          sampleReader_.getSampleRateHz(), sampleReader_.getDecimation(), binWidthHz_);
 
     // Oszcilloszkóp minták inicializálása középpontra (ADC nyers érték)
     for (int i = 0; i < AudioProcessorConstants::MAX_INTERNAL_WIDTH; ++i) {
@@ -55,9 +84,13 @@ AudioProcessor::AudioProcessor(float& gainConfigRef, int audioPin, double target
 }
 
 /**
- * @brief AudioProcessor destruktor - felszabadítja az allokált memóriát
+ * @brief AudioProcessor destruktor - felszabadítja az allokált memóriát (a közös busz tovább fut)
  */
-AudioProcessor::~AudioProcessor() { deallocateFftArrays(); }
+AudioProcessor::~AudioProcessor() {
+    stopCore1Processing();
+    deallocateFftArrays();
+    delete fftBackend;
+}
 
 /**
  * @brief FFT tömbök allokálása a megadott mérettel
@@ -74,24 +107,19 @@ bool AudioProcessor::allocateFftArrays(uint16_t size) {
     deallocateFftArrays();
 
     // Új tömbök allokálása
-    vReal = new (std::nothrow) double[size];
-    vImag = new (std::nothrow) double[size];
-    RvReal = new (std::nothrow) double[size];
+    rawSamples = new (std::nothrow) uint16_t[size];
+    magnitudes = new (std::nothrow) float[size / 2];
 
-    // Allokálás sikerességének ellenőrzése
-    if (!vReal || !vImag || !RvReal) {
+    // Allokálás sikerességének ellenőrzése (a backend a saját munkaterületét foglalja)
+    if (!rawSamples || !magnitudes || !fftBackend || !fftBackend->setSize(size)) {
         DEBUG("AudioProcessor: FFT tömbök allokálása sikertelen a %d mérethez\n", size);
         deallocateFftArrays();  // Részleges allokálás takarítása
         return false;
     }
 
     // Tömbök nullázása
-    memset(vReal, 0, size * sizeof(double));
-    memset(vImag, 0, size * sizeof(double));
-    memset(RvReal, 0, size * sizeof(double));
-
-    // FFT objektum frissítése az új tömbökkel
-    FFT.setArrays(vReal, vImag, size);
+    memset(rawSamples, 0, size * sizeof(uint16_t));
+    memset(magnitudes, 0, (size / 2) * sizeof(float));
     currentFftSize_ = size;
 
     DEBUG("AudioProcessor: FFT tömbök sikeresen allokálva a %d mérethez\n", size);
@@ -102,13 +130,11 @@ bool AudioProcessor::allocateFftArrays(uint16_t size) {
  * @brief FFT tömbök felszabadítása és nullázása
  */
 void AudioProcessor::deallocateFftArrays() {
-    delete[] vReal;
-    delete[] vImag;
-    delete[] RvReal;
+    delete[] rawSamples;
+    delete[] magnitudes;
 
-    vReal = nullptr;
-    vImag = nullptr;
-    RvReal = nullptr;
+    rawSamples = nullptr;
+    magnitudes = nullptr;
     currentFftSize_ = 0;
 }
 
@@ -123,6 +149,11 @@ bool AudioProcessor::validateFftSize(uint16_t size) const {
         return false;
     }
 
+    // A readLatest() a gyűrű feléből dolgozik: nagy decimációnál a nagy FFT méreteket nem tudná kitölteni
+    if (size > sampleReader_.getMaxLatestCount()) {
+        return false;
+    }
+
     // Ellenőrizni, hogy a méret 2 hatványa-e (FFT követelmény)
     return (size > 0) && ((size & (size - 1)) == 0);
 }
@@ -150,10 +181,13 @@ bool AudioProcessor::setFftSize(uint16_t newSize) {
     }
 
     // Bin szélesség frissítése az új FFT mérettel
-    if (targetSamplingFrequency_ > 0) {
-        binWidthHz_ = static_cast<float>(targetSamplingFrequency_) / currentFftSize_;
-    } else {
-        binWidthHz_ = (1000000.0f / sampleIntervalMicros_) / currentFftSize_;
+    updateBinWidth();
+
+    // Core1 módban a régi méretű képkocka már nem használható, az új méretet el kell küldeni
+    if (core1Session_ != 0) {
+        core1Magnitudes_ = nullptr;
+        core1OsciSamples_ = nullptr;
+        core1ConfigDirty_ = true;
     }
 
     DEBUG("AudioProcessor: FFT méret módosítva %d-re, új bin szélesség: %.2f Hz\n", currentFftSize_, binWidthHz_);
@@ -162,66 +196,183 @@ bool AudioProcessor::setFftSize(uint16_t newSize) {
 }
 
 /**
- * @brief Fő audio feldolgozó függvény - mintavételezés, FFT számítás és spektrum analízis
+ * @brief Ablakfüggvény beállítása - a flash táblák miatt csak pointer csere, olcsón hívható
+ * @param type Az ablak típusa
+ */
+void AudioProcessor::setWindowType(FftWindowType type) {
+    if (type == windowType_ || !fftBackend) {
+        return;
+    }
+    windowType_ = type;
+    fftBackend->setWindowType(type);
+
+    // Core1 módban a régi ablakkal számolt képkocka már nem használható
+    if (core1Session_ != 0) {
+        core1Magnitudes_ = nullptr;
+        core1OsciSamples_ = nullptr;
+        core1ConfigDirty_ = true;
+    }
+}
+
+/**
+ * @brief A számítás átadása a Core1-nek (csak a Core0 példányán)
+ * @return true ha a kérés elment a Core1-nek
+ */
+bool AudioProcessor::startCore1Processing() {
+    if (!AudioProcessorConstants::USE_CORE1_SPECTRUM || core1Session_ != 0 || currentFftSize_ == 0) {
+        return false;
+    }
+
+    const uint16_t session = postCore1Spectrum(CORE1_CMD_SPECTRUM_START, false);
+    if (session == 0) {
+        DEBUG("AudioProcessor: Core1 mailbox full, spectrum stays on Core0\n");
+        return false;
+    }
+    core1Session_ = session;
+    core1ConfigDirty_ = false;
+    core1CollectOsci_ = false;
+    core1WaitStartMs_ = millis();
+    core1Magnitudes_ = nullptr;
+    core1OsciSamples_ = nullptr;
+    return true;
+}
+
+/**
+ * @brief A Core1 számítás leállítása, visszatérés a helyi számításra
+ */
+void AudioProcessor::stopCore1Processing() {
+    if (core1Session_ == 0) {
+        return;
+    }
+    // Tele postafióknál a feladat tovább él, de új képkockát csak az előző átvétele után számol (vagy a következő START lecseréli)
+    postCore1Spectrum(CORE1_CMD_SPECTRUM_STOP, core1CollectOsci_);
+    core1Session_ = 0;
+    core1Magnitudes_ = nullptr;
+    core1OsciSamples_ = nullptr;
+}
+
+/**
+ * @brief Spektrum üzenet küldése a Core1-nek az aktuális beállításokkal
+ * @param command CORE1_CMD_SPECTRUM_START / CONFIG / STOP
+ * @param collectOsciSamples Kellenek-e oszcilloszkóp minták
+ * @return Az üzenet sorszáma, 0 ha a postafiók tele
+ */
+uint16_t AudioProcessor::postCore1Spectrum(Core1Command command, bool collectOsciSamples) {
+    Core1Message message;
+    message.command = command;
+    Core1SpectrumParams &params = message.params.spectrum;
+    params.gainConfig = &activeFftGainConfigRef;
+    params.targetSamplingHz = static_cast<float>(targetSamplingFrequency_);
+    params.session = core1Session_;
+    params.fftSize = currentFftSize_;
+    params.frameIntervalMs = AudioProcessorConstants::CORE1_FRAME_INTERVAL_MS;
+    params.windowType = static_cast<uint8_t>(windowType_);
+    params.collectOsci = collectOsciSamples;
+    return core1Mailbox.post(message);
+}
+
+/**
+ * @brief A legfrissebb Core1 képkocka átvétele
+ *
+ * Az átvett képkockát a Core1 a következő átvételig nem írja felül, ezért a getterek
+ * közvetlenül rá mutatnak. A régi session-ből vagy a régi beállításokkal készült képkocka nem érvényes.
+ * @param collectOsciSamples Kellenek-e oszcilloszkóp minták
+ * @return true ha új, a beállításoknak megfelelő képkocka érkezett
+ */
+bool AudioProcessor::acquireCore1Frame(bool collectOsciSamples) {
+    // A megváltozott beállítások elküldése (tele postafióknál a következő hívás újrapróbálja)
+    if (core1ConfigDirty_ || collectOsciSamples != core1CollectOsci_) {
+        if (postCore1Spectrum(CORE1_CMD_SPECTRUM_CONFIG, collectOsciSamples) != 0) {
+            core1ConfigDirty_ = false;
+            core1CollectOsci_ = collectOsciSamples;
+            core1WaitStartMs_ = millis();
+        }
+    }
+
+    const SpectrumFrame *frame = spectrumFrameBuffer.acquireLatest();
+    if (frame != nullptr && frame->sequence == core1FrameSequence_ && core1Magnitudes_ != nullptr) {
+        return false;  // Nincs újabb képkocka, a régi marad
+    }
+
+    core1Magnitudes_ = nullptr;
+    core1OsciSamples_ = nullptr;
+    if (frame == nullptr || frame->session != core1Session_ || frame->fftSize != currentFftSize_ || frame->windowType != windowType_ || (collectOsciSamples && !frame->hasOsci)) {
+        return false;
+    }
+
+    core1FrameSequence_ = frame->sequence;
+    core1Magnitudes_ = frame->magnitudes;
+    core1OsciSamples_ = frame->hasOsci ? frame->osciSamples : nullptr;
+    return true;
+}
+
+/**
+ * @brief Fő audio feldolgozó függvény - a legfrissebb minták FFT számítása és spektrum analízis
  * @param collectOsciSamples true ha oszcilloszkóp mintákat is gyűjteni kell
+ * @return true ha új spektrum készült (Core1 módban: új képkocka érkezett)
  */
-void AudioProcessor::process(bool collectOsciSamples) {
+bool AudioProcessor::process(bool collectOsciSamples) {
     int osci_sample_idx = 0;
-    uint32_t loopStartTimeMicros;
-    double max_abs_sample_for_auto_gain = 0.0;
+    int32_t max_abs_sample_for_auto_gain = 0;
+
+    if (currentFftSize_ == 0) {
+        return false;  // Sikertelen allokáció után nincs mit számolni
+    }
+
+    // Core1 mód: csak a kész képkocka átvétele, a Core0 nem számol
+    if (core1Session_ != 0) {
+        if (acquireCore1Frame(collectOsciSamples)) {
+            return true;
+        }
+        if (core1Magnitudes_ != nullptr || millis() - core1WaitStartMs_ < AudioProcessorConstants::CORE1_START_TIMEOUT_MS) {
+            return false;
+        }
+        DEBUG("AudioProcessor: No spectrum frame from Core1, computing on Core0\n");
+        stopCore1Processing();
+    }
 
     // Ha az FFT ki van kapcsolva (-1.0f), akkor töröljük a puffereket és visszatérünk
     if (activeFftGainConfigRef == -1.0f) {
-        memset(RvReal, 0, currentFftSize_ * sizeof(double));  // Magnitúdó buffer törlése
+        memset(magnitudes, 0, (currentFftSize_ / 2) * sizeof(float));  // Magnitúdó buffer törlése
         if (collectOsciSamples) {
             for (int i = 0; i < AudioProcessorConstants::MAX_INTERNAL_WIDTH; ++i) osciSamples[i] = 2048;  // Oszcilloszkóp buffer reset
         }
-        return;
+        return true;
     }
 
-    // 1. Mintavételezés és középre igazítás, opcionális oszcilloszkóp mintagyűjtés
-    // A teljes mintavételezési ciklus idejét is mérhetnénk, de az egyes minták időzítése fontosabb.
-    for (int i = 0; i < currentFftSize_; i++) {
-        loopStartTimeMicros = micros();
-        uint32_t sum = 0;
-        for (int j = 0; j < 4; j++) {  // 4 minta átlagolása a zajcsökkentés érdekében
-            sum += analogRead(audioInputPin);
-        }
-        double averaged_sample = sum / 4.0;
+    // 1. A legfrissebb N (decimált) minta kiolvasása a buszról (nem blokkol)
+    if (!ensureSamplingRunning() || sampleReader_.readLatest(rawSamples, currentFftSize_) != currentFftSize_) {
+        return false;  // Indulás után még nincs elég minta, az előző spektrum marad
+    }
 
+    // Középre igazítás helyben (a nyers 12 bites minta int16-ként folytatja), opcionális oszcilloszkóp mintagyűjtés
+    int16_t* samples = reinterpret_cast<int16_t*>(rawSamples);
+    for (int i = 0; i < currentFftSize_; i++) {
         // Oszcilloszkóp minta gyűjtése ha szükséges
         if (collectOsciSamples) {
             if (i % AudioProcessorConstants::OSCI_SAMPLE_DECIMATION_FACTOR == 0 && osci_sample_idx < AudioProcessorConstants::MAX_INTERNAL_WIDTH) {
-                if (osci_sample_idx < sizeof(osciSamples) / sizeof(osciSamples[0])) {  // Biztonsági ellenőrzés
-                    osciSamples[osci_sample_idx] = static_cast<int>(averaged_sample);
-                    osci_sample_idx++;
-                }
+                osciSamples[osci_sample_idx++] = rawSamples[i];
             }
         }
-        vReal[i] = averaged_sample - 2048.0;  // Középre igazítás (2048 a nulla szint 12 bites ADC-nél)
-        vImag[i] = 0.0;
+        samples[i] = static_cast<int16_t>(static_cast<int32_t>(rawSamples[i]) - 2048);  // Középre igazítás (2048 a nulla szint 12 bites ADC-nél)
 
         // Auto Gain mód esetén a legnagyobb minta keresése
         if (activeFftGainConfigRef == 0.0f) {  // Auto Gain mód
-            if (std::abs(vReal[i]) > max_abs_sample_for_auto_gain) {
-                max_abs_sample_for_auto_gain = std::abs(vReal[i]);
+            int32_t abs_sample = samples[i] < 0 ? -samples[i] : samples[i];
+            if (abs_sample > max_abs_sample_for_auto_gain) {
+                max_abs_sample_for_auto_gain = abs_sample;
             }
         }
+    }
 
-        // Időzítés a cél mintavételezési frekvencia eléréséhez
-        uint32_t processingTimeMicros = micros() - loopStartTimeMicros;
-        if (processingTimeMicros < sampleIntervalMicros_) {
-            delayMicroseconds(sampleIntervalMicros_ - processingTimeMicros);
-        }
-    }  // 2. Erősítés alkalmazása (manuális vagy automatikus)
+    // 2. Erősítés meghatározása (manuális vagy automatikus)
+    float gain = 1.0f;
     if (activeFftGainConfigRef > 0.0f) {  // Manuális erősítés
-        for (int i = 0; i < currentFftSize_; i++) {
-            vReal[i] *= activeFftGainConfigRef;
-        }
+        gain = activeFftGainConfigRef;
     } else if (activeFftGainConfigRef == 0.0f) {  // Automatikus erősítés
         float target_auto_gain_factor = 1.0f;     // Alapértelmezett erősítés, ha nincs jel
 
-        if (max_abs_sample_for_auto_gain > 0.001) {  // Nullával osztás és extrém erősítés elkerülése
+        if (max_abs_sample_for_auto_gain > 0) {  // Nullával osztás és extrém erősítés elkerülése
             target_auto_gain_factor = AudioProcessorConstants::FFT_AUTO_GAIN_TARGET_PEAK / max_abs_sample_for_auto_gain;
             target_auto_gain_factor = constrain(target_auto_gain_factor, AudioProcessorConstants::FFT_AUTO_GAIN_MIN_FACTOR, AudioProcessorConstants::FFT_AUTO_GAIN_MAX_FACTOR);
         }
@@ -236,39 +387,59 @@ void AudioProcessor::process(bool collectOsciSamples) {
         }
         // Biztosítjuk, hogy a simított faktor is a határokon belül maradjon
         smoothed_auto_gain_factor_ = constrain(smoothed_auto_gain_factor_, AudioProcessorConstants::FFT_AUTO_GAIN_MIN_FACTOR, AudioProcessorConstants::FFT_AUTO_GAIN_MAX_FACTOR);
+        gain = smoothed_auto_gain_factor_;
+    }
 
-        // Erősítés alkalmazása a mintákra
+    // Erősítés alkalmazása Q8 fixpontos szorzóval, int16 tartományra vágva
+    if (gain != 1.0f) {
+        const int32_t gainQ8 = static_cast<int32_t>(gain * 256.0f + 0.5f);
         for (int i = 0; i < currentFftSize_; i++) {
-            vReal[i] *= smoothed_auto_gain_factor_;
+            int32_t value = (samples[i] * gainQ8) >> 8;
+            samples[i] = static_cast<int16_t>(constrain(value, -32768, 32767));
         }
+    }
+
+    // 3. Ablakozás, FFT számítás, magnitúdó számítás (a backend végzi)
+    fftBackend->computeMagnitudes(samples, magnitudes);
 
-        // Opcionális debug kimenet az auto gain faktorról
-        // #ifdef __DEBUG
-        //         static unsigned long lastGainPrintTime = 0;
-        //         if (millis() - lastGainPrintTime >= 1000) {
-        //             if (activeFftGainConfigRef == 0.0f) { // Csak auto gain módban írjuk ki
-        //                 DEBUG("AudioProcessor: Simított Auto Gain Faktor: %.2f\n", smoothed_auto_gain_factor_);
-        //             }
-        //             lastGainPrintTime = millis();
-        //         }
-        // #endif
-    }  // 3. Ablakozás, FFT számítás, magnitúdó számítás
-    FFT.windowing(vReal, currentFftSize_, FFT_WIN_TYP_HAMMING, FFT_FORWARD);
-    FFT.compute(vReal, vImag, currentFftSize_, FFT_FORWARD);
-    FFT.complexToMagnitude(vReal, vImag, currentFftSize_);  // Az eredmény a vReal-be kerül
-
-    // Magnitúdók átmásolása az RvReal tömbbe
-    for (int i = 0; i < currentFftSize_; ++i) {
-        RvReal[i] = vReal[i];
-    }
-
-    // 4. Alacsony frekvenciák csillapítása az RvReal tömbben
+    // 4. Alacsony frekvenciák csillapítása
     // A binWidthHz_ már tagváltozóként rendelkezésre áll
     const int attenuation_cutoff_bin = static_cast<int>(AudioProcessorConstants::LOW_FREQ_ATTENUATION_THRESHOLD_HZ / binWidthHz_);
 
     for (int i = 0; i < (currentFftSize_ / 2); ++i) {  // Csak a releváns (nem tükrözött) frekvencia bin-eken iterálunk
         if (i < attenuation_cutoff_bin) {
-            RvReal[i] /= AudioProcessorConstants::LOW_FREQ_ATTENUATION_FACTOR;
+            magnitudes[i] /= AudioProcessorConstants::LOW_FREQ_ATTENUATION_FACTOR;
         }
     }
+    return true;
+}
+
+/**
+ * @brief A minta busz ellenőrzése
+ *
+ * A buszt a main indítja, a feldolgozó nem állítja át a frekvenciáját (a többi fogyasztó is használja).
+ * Ha mégsem fut (pl. teszt forrás), a busz frekvenciáján indítjuk.
+ * @return true ha a mintavételező fut
+ */
+bool AudioProcessor::ensureSamplingRunning() {
+    if (sampleSource_->isRunning()) {
+        return true;
+    }
+    if (!sampleSource_->start(audioInputPin, AudioSampleBusConstants::SAMPLE_RATE_HZ)) {
+        return false;
+    }
+    sampleReader_.setTargetSampleRate(static_cast<float>(targetSamplingFrequency_));
+    updateBinWidth();
+    return true;
+}
+
+/**
+ * @brief Bin szélesség frissítése a tényleges mintavételezési frekvencia alapján
+ */
+void AudioProcessor::updateBinWidth() {
+    if (currentFftSize_ == 0) {
+        return;
+    }
+    float sampleRate = sampleReader_.isRunning() ? sampleReader_.getSampleRateHz() : AudioSampleBusConstants::SAMPLE_RATE_HZ / sampleReader_.getDecimation();
+    binWidthHz_ = sampleRate / currentFftSize_;
 }
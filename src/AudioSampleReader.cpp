@@ -0,0 +1,221 @@
+#include "AudioSampleReader.h"
+
+#include <algorithm>
+
+// A fokozatok tervezési ellenőrzése: legfeljebb 0.5dB ingadozás az átviteli sáv szélén, legalább 40dB zárás a záró sáv szélén
+namespace {
+constexpr double PASSBAND_MIN_GAIN = 0.944;  // -0.5dB
+constexpr double PASSBAND_MAX_GAIN = 1.059;  // +0.5dB
+constexpr double STOPBAND_MAX_GAIN = 0.01;   // -40dB
+constexpr double STOPBAND_EDGE = 0.5 - HalfBandDesign::PASSBAND_EDGE;
+}  // namespace
+static_assert(HalfBandDesign::magnitude<23, 50>(HalfBandDesign::PASSBAND_EDGE) > PASSBAND_MIN_GAIN && HalfBandDesign::magnitude<23, 50>(HalfBandDesign::PASSBAND_EDGE) < PASSBAND_MAX_GAIN,
+              "1. fokozat: atviteli sav");
+static_assert(HalfBandDesign::magnitude<27, 50>(HalfBandDesign::PASSBAND_EDGE) > PASSBAND_MIN_GAIN && HalfBandDesign::magnitude<27, 50>(HalfBandDesign::PASSBAND_EDGE) < PASSBAND_MAX_GAIN,
+              "2. fokozat: atviteli sav");
+static_assert(HalfBandDesign::magnitude<31, 60>(HalfBandDesign::PASSBAND_EDGE) > PASSBAND_MIN_GAIN && HalfBandDesign::magnitude<31, 60>(HalfBandDesign::PASSBAND_EDGE) < PASSBAND_MAX_GAIN,
+              "3. fokozat: atviteli sav");
+static_assert(HalfBandDesign::magnitude<23, 50>(STOPBAND_EDGE) < STOPBAND_MAX_GAIN, "1. fokozat: zaro sav");
+static_assert(HalfBandDesign::magnitude<27, 50>(STOPBAND_EDGE) < STOPBAND_MAX_GAIN, "2. fokozat: zaro sav");
+static_assert(HalfBandDesign::magnitude<31, 60>(STOPBAND_EDGE) < STOPBAND_MAX_GAIN, "3. fokozat: zaro sav");
+
+/**
+ * @brief Konstruktor
+ * @param ring A közös minta gyűrű
+ * @param decimation Decimációs faktor (1, 2, 4 vagy 8)
+ */
+AudioSampleReader::AudioSampleReader(AudioSampleRing &ring, uint8_t decimation) : ring_(ring), cursor_(0), droppedSamples_(0), decimation_(1), activeStages_(0) {
+    setDecimation(decimation);
+    sync();
+}
+
+/**
+ * @brief Decimációs faktor beállítása egy cél frekvenciához
+ * @param targetSampleRateHz A fogyasztó által igényelt minimális mintavételezési frekvencia
+ */
+void AudioSampleReader::setTargetSampleRate(float targetSampleRateHz) {
+    float busRate = ring_.isRunning() ? ring_.getSampleRateHz() : AudioSampleBusConstants::SAMPLE_RATE_HZ;
+    uint32_t decimation = targetSampleRateHz > 0.0f ? static_cast<uint32_t>(busRate / targetSampleRateHz) : 1;
+    setDecimation(static_cast<uint8_t>(std::min<uint32_t>(std::max<uint32_t>(decimation, 1), AudioSampleBusConstants::MAX_DECIMATION)));
+}
+
+/**
+ * @brief Decimációs faktor beállítása (a szűrők állapota törlődik)
+ * @param decimation Decimációs faktor, lefelé kerekítve 2 hatványra (1..MAX_DECIMATION)
+ */
+void AudioSampleReader::setDecimation(uint8_t decimation) {
+    if (decimation == 0 || decimation > AudioSampleBusConstants::MAX_DECIMATION) {
+        decimation = 1;
+    }
+    activeStages_ = 0;
+    while ((2u << activeStages_) <= decimation) {
+        activeStages_++;
+    }
+    decimation_ = 1u << activeStages_;
+    decimator_.reset();
+}
+
+/**
+ * @brief A kurzor áthelyezése a jelenre (a felgyűlt minták eldobása)
+ */
+void AudioSampleReader::sync() {
+    cursor_ = ring_.getWriteIndex();
+    decimator_.reset();
+}
+
+/**
+ * @brief Olvasásra kész (decimált) minták száma
+ *
+ * Ha az olvasó annyira lemaradt, hogy az író felülírná a kurzor alatti mintákat,
+ * a kurzort a gyűrű negyedével a jelen mögé léptetjük (a kimaradás eldobott mintának számít).
+ */
+uint32_t AudioSampleReader::available() {
+    using namespace AudioSampleRingConstants;
+
+    uint32_t writeIndex = ring_.getWriteIndex();
+    if (writeIndex - cursor_ > RING_SIZE / 2) {
+        uint32_t newCursor = writeIndex - RING_SIZE / 4;
+        droppedSamples_ += newCursor - cursor_;
+        cursor_ = newCursor;
+        decimator_.reset();  // A folytonosság megszakadt
+    }
+    return (writeIndex - cursor_) / decimation_;
+}
+
+/**
+ * @brief Mennyi idő múlva lesz olvasható legalább count (decimált) minta
+ * @param count A szükséges minták száma
+ * @return Mikroszekundum, 0 ha már most olvasható, UINT32_MAX ha a busz nem fut
+ *
+ * A Core1 ennyi időre alszik el, amíg a dekóder következő blokkja összegyűlik.
+ */
+uint32_t AudioSampleReader::getMicrosUntilAvailable(uint32_t count) {
+    if (!isRunning()) {
+        return UINT32_MAX;
+    }
+    uint32_t ready = available();
+    if (ready >= count) {
+        return 0;
+    }
+    return static_cast<uint32_t>((count - ready) * 1000000.0f / getSampleRateHz()) + 1;  // Felfelé kerekítve
+}
+
+/**
+ * @brief Minták olvasása a kurzortól, a kurzor léptetésével
+ * @param dst Cél puffer: középre igazított (előjeles) minták
+ * @param count Kért minták száma
+ * @param blockStartTimeUs Ha nem nullptr, ide kerül a blokk első mintájának időbélyege
+ * @return A ténylegesen olvasott minták száma
+ */
+uint16_t AudioSampleReader::read(int16_t *dst, uint16_t count, uint32_t *blockStartTimeUs) {
+    uint32_t ready = available();
+    if (count > ready) {
+        count = static_cast<uint16_t>(ready);
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    if (blockStartTimeUs != nullptr) {
+        *blockStartTimeUs = ring_.getSampleTimeUs(cursor_);
+    }
+
+    uint16_t produced = decimate(cursor_, dst, count);
+    cursor_ += static_cast<uint32_t>(produced) * decimation_;
+
+    return produced;
+}
+
+/**
+ * @brief A readLatest() egy hívással kérhető legtöbb mintája az aktuális decimációnál
+ *
+ * A gyűrű felét olvassuk legfeljebb, decimálásnál ebből a szűrők feltöltése is levonódik.
+ */
+uint16_t AudioSampleReader::getMaxLatestCount() const {
+    constexpr uint16_t maxRawCount = AudioSampleRingConstants::RING_SIZE / 2;
+    return decimation_ == 1 ? maxRawCount : maxRawCount / decimation_ - AudioSampleBusConstants::LATEST_WARMUP_SAMPLES;
+}
+
+/**
+ * @brief A legfrissebb minták olvasása a kurzor módosítása nélkül
+ *
+ * Decimálásnál LATEST_WARMUP_SAMPLES kimeneti mintával korábbról indulva feltöltjük a szűrőket,
+ * így az első visszaadott minta is teljes szűrő ablakból számolódik.
+ * @param dst Cél puffer: nyers skálájú (0..4095) minták
+ * @param count Kért minták száma (legfeljebb getMaxLatestCount())
+ * @return A másolt minták száma (0, ha még nincs elég minta)
+ */
+uint16_t AudioSampleReader::readLatest(uint16_t *dst, uint16_t count) {
+    using namespace AudioSampleBusConstants;
+
+    if (decimation_ == 1) {
+        return ring_.copyLatest(dst, count);
+    }
+
+    if (count > getMaxLatestCount()) {
+        return 0;
+    }
+    uint32_t rawCount = (static_cast<uint32_t>(count) + LATEST_WARMUP_SAMPLES) * decimation_;
+    uint32_t writeIndex = ring_.getWriteIndex();
+    if (writeIndex < rawCount) {
+        return 0;  // Indulás után még nincs elég minta
+    }
+
+    uint32_t startIndex = writeIndex - rawCount;
+    int16_t warmup[LATEST_WARMUP_SAMPLES];
+    decimator_.reset();
+    if (decimate(startIndex, warmup, LATEST_WARMUP_SAMPLES) != LATEST_WARMUP_SAMPLES) {
+        return 0;
+    }
+
+    // Az előjeles kimenetet helyben alakítjuk vissza nyers skálára
+    int16_t *samples = reinterpret_cast<int16_t *>(dst);
+    if (decimate(startIndex + LATEST_WARMUP_SAMPLES * decimation_, samples, count) != count) {
+        return 0;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t value = static_cast<int32_t>(samples[i]) + AudioSampleRingConstants::ADC_MID_LEVEL;
+        dst[i] = static_cast<uint16_t>(std::min<int32_t>(std::max<int32_t>(value, 0), 4095));
+    }
+    return count;
+}
+
+/**
+ * @brief Decimált, középre igazított minták előállítása egy adott nyers indextől
+ *
+ * A gyűrűből DECIMATION_CHUNK_SAMPLES méretű darabokban másolunk, középre igazítunk,
+ * majd a half-band kaszkád helyben decimál. Mivel mindig a decimáció többszörösét adjuk be,
+ * a fokozatok fázisa hívások között is megmarad (folytonos szűrés).
+ * @param startIndex Az első nyers minta abszolút indexe
+ * @param dst Cél puffer
+ * @param count Kért kimeneti minták száma
+ * @return A ténylegesen előállított minták száma
+ */
+uint16_t AudioSampleReader::decimate(uint32_t startIndex, int16_t *dst, uint16_t count) {
+    using namespace AudioSampleBusConstants;
+
+    int16_t chunk[DECIMATION_CHUNK_SAMPLES];
+    uint16_t *rawChunk = reinterpret_cast<uint16_t *>(chunk);
+    const uint16_t outputsPerChunk = DECIMATION_CHUNK_SAMPLES / decimation_;
+    uint16_t produced = 0;
+
+    while (produced < count) {
+        uint16_t outputs = count - produced;
+        if (outputs > outputsPerChunk) {
+            outputs = outputsPerChunk;
+        }
+        const uint16_t rawCount = outputs * decimation_;
+        if (ring_.copyFrom(startIndex, rawChunk, rawCount) != rawCount) {
+            break;  // A kért tartomány már nem (vagy még nem) érhető el
+        }
+        for (uint16_t i = 0; i < rawCount; i++) {
+            chunk[i] = static_cast<int16_t>(static_cast<int32_t>(rawChunk[i]) - AudioSampleRingConstants::ADC_MID_LEVEL);
+        }
+        const uint16_t decimated = decimator_.process(chunk, rawCount, activeStages_);
+        memcpy(&dst[produced], chunk, decimated * sizeof(int16_t));
+        produced += decimated;
+        startIndex += rawCount;
+    }
+
+    return produced;
+}
@@ -0,0 +1,51 @@
+#include "AudioSampleRing.h"
+
+#include <string.h>
+
+/**
+ * @brief A legfrissebb minták másolása
+ * @param dst Cél puffer
+ * @param count Kért minták száma (max. RING_SIZE / 2)
+ * @return A másolt minták száma (0, ha még nincs elég minta)
+ */
+uint16_t AudioSampleRing::copyLatest(uint16_t *dst, uint16_t count) {
+    uint32_t writeIndex = getWriteIndex();
+    if (writeIndex < count) {
+        return 0;  // Indulás után még nincs elég minta
+    }
+    return copyFrom(writeIndex - count, dst, count);
+}
+
+/**
+ * @brief Minták másolása egy adott abszolút indextől
+ * @param startIndex Az első minta abszolút indexe
+ * @param dst Cél puffer
+ * @param count Kért minták száma
+ * @return A másolt minták száma (0, ha a kért tartomány már felülíródott vagy még nem létezik)
+ */
+uint16_t AudioSampleRing::copyFrom(uint32_t startIndex, uint16_t *dst, uint16_t count) {
+    using namespace AudioSampleRingConstants;
+
+    // A gyűrű felét tartjuk fenn az olvasásnak, a másik felét írhatja közben a DMA
+    if (count == 0 || count > RING_SIZE / 2) {
+        return 0;
+    }
+
+    uint32_t writeIndex = getWriteIndex();
+    if (startIndex + count > writeIndex || writeIndex - startIndex > RING_SIZE / 2) {
+        return 0;
+    }
+
+    // Másolás legfeljebb két darabban (a gyűrű vége előtt és után)
+    uint16_t pos = startIndex & RING_MASK;
+    uint16_t firstPart = RING_SIZE - pos;
+    if (firstPart > count) {
+        firstPart = count;
+    }
+    memcpy(dst, &ring_[pos], firstPart * sizeof(uint16_t));
+    if (firstPart < count) {
+        memcpy(&dst[firstPart], &ring_[0], (count - firstPart) * sizeof(uint16_t));
+    }
+
+    return count;
+}
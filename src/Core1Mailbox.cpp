@@ -0,0 +1,108 @@
+#include "Core1Mailbox.h"
+
+#include <Arduino.h>        // rp2040.fifo
+#include <hardware/sync.h>  // __dmb(), __sev()
+
+// A két mag közös példánya (statikus SRAM, mindkét magról elérhető)
+Core1Mailbox core1Mailbox;
+
+/**
+ * @brief Konstruktor
+ */
+Core1Mailbox::Core1Mailbox() : messageHead_(0), messageTail_(0), replyHead_(0), replyTail_(0), droppedReplyCount_(0), nextSequence_(1) {}
+
+/**
+ * @brief Üzenet küldése a Core1-nek (csak a Core0 hívja)
+ * @param message Az üzenet, a sorszámát ez a függvény tölti ki
+ * @return Az üzenet sorszáma, 0 ha a postafiók tele
+ */
+uint16_t Core1Mailbox::post(Core1Message &message) {
+    using namespace Core1MailboxConstants;
+
+    const uint32_t head = messageHead_;
+    if (head - messageTail_ >= QUEUE_SIZE) {
+        return 0;
+    }
+
+    message.sequence = nextSequence_;
+    nextSequence_ = (nextSequence_ == UINT16_MAX) ? 1 : nextSequence_ + 1;  // A 0 a 'nem küldött' jelzés
+
+    messages_[head & QUEUE_MASK] = message;
+    __dmb();  // Az üzenet legyen kiírva, mielőtt a Core1 látja az új head-et
+    messageHead_ = head + 1;
+
+    // Csengetés: ha a FIFO tele, a Core1 a bent lévő csengetések egyikénél úgyis kiolvassa az üzenetet
+    rp2040.fifo.push_nb(message.sequence);
+    __sev();  // Az alvó (WFE) Core1 ébresztése
+    return message.sequence;
+}
+
+/**
+ * @brief Egy válasz kivétele (csak a Core0 hívja)
+ * @param reply Ide kerül a válasz
+ * @return true ha volt válasz
+ */
+bool Core1Mailbox::pollReply(Core1Reply &reply) {
+    using namespace Core1MailboxConstants;
+
+    const uint32_t tail = replyTail_;
+    if (replyHead_ == tail) {
+        return false;
+    }
+    __dmb();  // A head olvasása után olvassuk a választ
+    reply = replies_[tail & QUEUE_MASK];
+    __dmb();  // A válasz kiolvasva, mielőtt a Core1 felülírhatja
+    replyTail_ = tail + 1;
+    return true;
+}
+
+/**
+ * @brief Egy üzenet kivétele (csak a Core1 hívja)
+ * @param message Ide kerül az üzenet
+ * @return true ha volt üzenet
+ */
+bool Core1Mailbox::receive(Core1Message &message) {
+    using namespace Core1MailboxConstants;
+
+    const uint32_t tail = messageTail_;
+    if (messageHead_ == tail) {
+        return false;
+    }
+    __dmb();  // A head olvasása után olvassuk az üzenetet
+    message = messages_[tail & QUEUE_MASK];
+    __dmb();  // Az üzenet kiolvasva, mielőtt a Core0 felülírhatja
+    messageTail_ = tail + 1;
+    return true;
+}
+
+/**
+ * @brief Válasz egy üzenetre (csak a Core1 hívja)
+ * @param message A megválaszolt üzenet
+ * @param status Az eredmény
+ * @return false ha a válasz sor tele (a válasz eldobódott)
+ */
+bool Core1Mailbox::reply(const Core1Message &message, Core1ReplyStatus status) {
+    using namespace Core1MailboxConstants;
+
+    const uint32_t head = replyHead_;
+    if (head - replyTail_ >= QUEUE_SIZE) {
+        droppedReplyCount_ = droppedReplyCount_ + 1;
+        return false;
+    }
+
+    Core1Reply &slot = replies_[head & QUEUE_MASK];
+    slot.sequence = message.sequence;
+    slot.command = message.command;
+    slot.status = status;
+    __dmb();  // A válasz legyen kiírva, mielőtt a Core0 látja az új head-et
+    replyHead_ = head + 1;
+    return true;
+}
+
+/**
+ * @brief Mindkét sor ürítése (csak leállított Core1 mellett, pl. alvás előtt)
+ */
+void Core1Mailbox::reset() {
+    messageTail_ = messageHead_;
+    replyTail_ = replyHead_;
+}
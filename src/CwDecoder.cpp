@@ -2,7 +2,7 @@
  * @file CwDecoder.cpp
  * @brief Az osztály a Morse kód dekódolására szolgál a Goertzel algoritmus segítségével.
  *
- * Az osztály a https://www.instructables.com/Binary-Tree-Morse-Decoder/MorseCodeDecoder6.ino
+ * Az osztály a https:  //www.instructables.com/Binary-Tree-Morse-Decoder/MorseCodeDecoder6.ino
  * alapján készült, amely a Goertzel algoritmust használja a CW jelek feldolgozására.
  */
 
@@ -10,6 +10,7 @@
 
 #include <cmath>
 
+#include "DecodedTextRing.h"
 #include "defines.h"  // DEBUG
 
 // CW működés debug engedélyezése de csak DEBUG módban
@@ -19,36 +20,21 @@
 #define CW_DEBUG(fmt, ...)  // Üres makró, ha __DEBUG nincs definiálva
 #endif
 
-// Goetzel filter paraméter a SAMPLING_FREQ-hez
-const unsigned long CwDecoder::SAMPLING_PERIOD_US = static_cast<unsigned long>(1000000.0f / CwDecoder::SAMPLING_FREQ);
-
-const char CwDecoder::MORSE_TREE_SYMBOLS[] = {
-    ' ', '5', ' ', 'H', ' ',  '4', ' ', 'S',  // 0
-    ' ', ' ', ' ', 'V', ' ',  '3', ' ', 'I',  // 8
-    ' ', ' ', ' ', 'F', ' ',  ' ', ' ', 'U',  // 16
-    '?', ' ', '_', ' ', ' ',  '2', ' ', 'E',  // 24
-    ' ', '&', ' ', 'L', '"',  ' ', ' ', 'R',  // 32
-    ' ', '+', '.', ' ', ' ',  ' ', ' ', 'A',  // 40
-    ' ', ' ', ' ', 'P', '@',  ' ', ' ', 'W',  // 48
-    ' ', ' ', ' ', 'J', '\'', '1', ' ', ' ',  // 56
-    ' ', '6', '-', 'B', ' ',  '=', ' ', 'D',  // 64
-    ' ', '/', ' ', 'X', ' ',  ' ', ' ', 'N',  // 72
-    ' ', ' ', ' ', 'C', ';',  ' ', '!', 'K',  // 80
-    ' ', '(', ')', 'Y', ' ',  ' ', ' ', 'T',  // 88
-    ' ', '7', ' ', 'Z', ' ',  ' ', ',', 'G',  // 96
-    ' ', ' ', ' ', 'Q', ' ',  ' ', ' ', 'M',  // 104
-    ':', '8', ' ', ' ', ' ',  ' ', ' ', 'O',  // 112
-    ' ', '9', ' ', ' ', ' ',  '0', ' ', ' '   // 120
-};
-
 /**
  * @brief CwDecoder konstruktor
  * @param audioPin Az analóg bemenet pin száma, ahol az audio jel érkezik
+ * @param sampleSource Minta forrás (a firmware-ben a globális ADC DMA mintavételező busz; pl. ArraySampleSource hardver nélküli futtatáshoz)
  *
  * Inicializálja a CW dekódert a megadott audio bemenettel és meghívja az initialize() függvényt
- * az összes tagváltozó kezdőértékeinek beállításához.
+ * az összes tagváltozó kezdőértékeinek beállításához. A hangfrekvencia az alapértelmezett, a beállított
+ * értéket a Core0 a CORE1_CMD_SET_CW_PARAMS üzenetben küldi (a Core1 nem olvassa a config-ot).
  */
-CwDecoder::CwDecoder(int audioPin) : audioInputPin_(audioPin) { initialize(); }
+CwDecoder::CwDecoder(int audioPin, AudioSampleRing &sampleSource)
+    : targetOffsetHz_(CW_DECODER_DEFAULT_FREQUENCY), timing_(INITIAL_DOT_MS), audioInputPin_(audioPin), sampleReader_(sampleSource) {
+    sampleReader_.setTargetSampleRate(SAMPLING_FREQ);
+    initialize();
+    resetToneDetector();
+}
 
 /**
  * @brief CwDecoder destruktor
@@ -58,542 +44,484 @@ CwDecoder::CwDecoder(int audioPin) : audioInputPin_(audioPin) { initialize(); }
 CwDecoder::~CwDecoder() {}
 
 /**
- * @brief Inicializálja a CW dekóder összes tagváltozóját alapértelmezett értékekre
+ * @brief Inicializálja a CW dekóder karakter állapotát alapértelmezett értékekre
  *
- * Beállítja a kezdeti értékeket a Goertzel szűrő változóinak, a Morse dekódolás
- * állapotváltozóinak, az időzítési paramétereknek és a karakterpuffernek.
- * Ezt a függvényt hívja meg a konstruktor és a resetDecoderState().
+ * Törli az összegyűjtött elemeket, a jel/szünet mérést és a karakter SNR gyűjtését.
+ * A tanult időzítés (timing_) megmarad: ezt hívja a konstruktor, a resetDecoderState()
+ * és a hosszú tétlenség is.
  */
 void CwDecoder::initialize() {
-    noiseBlankerLoops_ = 1;
-    startReferenceMs_ = 120;  // Kezdő referencia 10 WPM-hez (pont ~120ms) - jó kiindulási pont 7-25 WPM tartományhoz
-    currentReferenceMs_ = startReferenceMs_;
-    leadingEdgeTimeMs_ = 0;
-    trailingEdgeTimeMs_ = 0;
+    markStartMs_ = 0;
+    markEndMs_ = 0;
+    markPending_ = false;
     toneIndex_ = 0;
-    toneMaxDurationMs_ = 0L;
-    toneMinDurationMs_ = 9999L;
-    currentLetterStartTimeMs_ = 0;
-    symbolCountForWpm_ = 0;
     decoderStarted_ = false;
     measuringTone_ = false;
     toneDetectedState_ = false;
-    lastActivityMs_ = 0;  // Tagváltozó inicializálása
+    lastActivityMs_ = 0;
     lastDecodedChar_ = '\0';
-    wordSpaceProcessed_ = false;
     lastSpaceDebugMs_ = 0;  // Debug kimenet korlátozott gyakoriságához
     inInactiveState = false;
-    resetMorseTree();
-    q0 = 0;
-    q1 = 0;
-    q2 = 0;
-    memset(testData, 0, sizeof(testData));
+    keyDownSum_ = 0.0f;
+    keyUpSum_ = 0.0f;
+    keyDownSamples_ = 0;
+    keyUpSamples_ = 0;
     memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
-    // Puffer inicializálása
-    memset(decodedCharBuffer_, 0, sizeof(decodedCharBuffer_));
-    charBufferReadPos_ = 0;
-    charBufferWritePos_ = 0;
-    charBufferCount_ = 0;
+    memset(rawGapDurations_, 0, sizeof(rawGapDurations_));
+    pendingGapMs_ = 0;
 }
 
 /**
  * @brief Visszaállítja a CW dekóder állapotát a kezdeti értékekre
  *
- * Meghívja az initialize() függvényt, majd debug üzenetet ír ki a reset eseményről.
- * Ezt a metódust hívják meg a CW módra váltáskor vagy hosszas inaktivitás után.
+ * Meghívja az initialize() függvényt, a tanult időzítést és a hangdetektort is alaphelyzetbe állítja, majd debug üzenetet ír ki a reset eseményről.
+ * Ezt a metódust hívják meg a CW módra váltáskor.
  */
 void CwDecoder::resetDecoderState() {
     initialize();
+    timing_.reset();
+    resetToneDetector();
     CW_DEBUG("CW Decoder state reset.\n");
 }
 
 /**
- * @brief Goertzel algoritmus végrehajtása a beérkező audio jel feldolgozására
- * @return true ha a célfrekvencián (750Hz) hang található, false egyébként
+ * @brief A csúszó Goertzel együtthatóinak számítása a beállított vételi eltoláshoz
  *
- * Végrehajtja a Goertzel algoritmus két fázisát:
- * 1. N_SAMPLES számú minta begyűjtése az ADC-ről meghatározott időközönként
- * 2. A Goertzel szűrő alkalmazása a célfrekvencia (750Hz) detektálására
- * A kimeneti amplitúdót összehasonlítja a THRESHOLD értékkel.
+ * A cos/sin csak akkor fut, ha a vételi frekvencia megváltozott (nem mintánként).
+ * A frekvencia nincs bin-re kerekítve, a szűrő pontosan a beállított eltolásra hangol.
  */
-bool CwDecoder::goertzelProcess() {
-    unsigned long loopStartTimeMicros;
-    for (short index = 0; index < N_SAMPLES; index++) {
-        loopStartTimeMicros = micros();
-        int raw_adc = analogRead(audioInputPin_);
-        testData[index] = raw_adc - 2048;  // DC eltolás eltávolítása (12-bit ADC feltételezése, 0-4095 tartomány)
-        unsigned long processingTimeMicros = micros() - loopStartTimeMicros;
-        if (processingTimeMicros < SAMPLING_PERIOD_US) {
-            if (SAMPLING_PERIOD_US > processingTimeMicros) delayMicroseconds(SAMPLING_PERIOD_US - processingTimeMicros);
-        }
-    }
-
-    q1 = 0;
-    q2 = 0;
-    for (short index = 0; index < N_SAMPLES; index++) {
-        q0 = COEFF() * q1 - q2 + (float)testData[index];
-        q2 = q1;
-        q1 = q0;
-    }
-    float magnitudeSquared = (q1 * q1) + (q2 * q2) - q1 * q2 * COEFF();
-    float magnitude = sqrt(magnitudeSquared);
-
-    if (magnitude > THRESHOLD) {
-        toneDetectedState_ = true;
-        return true;
-    } else {
-        toneDetectedState_ = false;
-        return false;
-    }
+void CwDecoder::updateGoertzelCoefficients() {
+    cachedOffsetHz_ = targetOffsetHz_;
+
+    const float omega = 2.0f * M_PI * static_cast<float>(cachedOffsetHz_) / SAMPLING_FREQ;
+    const float dampingN = powf(SDFT_DAMPING, N_SAMPLES);
+    rotatorRe_ = SDFT_DAMPING * cosf(omega);
+    rotatorIm_ = SDFT_DAMPING * sinf(omega);
+    combRe_ = dampingN * cosf(omega * N_SAMPLES);
+    combIm_ = dampingN * sinf(omega * N_SAMPLES);
+
+    // A régi frekvencián felgyűlt állapot (és a szintek követése) érvénytelen
+    sdftRe_ = 0.0f;
+    sdftIm_ = 0.0f;
+    memset(sdftHistory_, 0, sizeof(sdftHistory_));
+    sdftHistoryPos_ = 0;
+    sdftWarmupSamples_ = N_SAMPLES;
+    peakLevel_ = 0.0f;
+    noiseLevel_ = 0.0f;
+    rawKeyDown_ = false;
+
+    CW_DEBUG("CW: Goertzel együtthatók frissítve: %u Hz\n", cachedOffsetHz_);
 }
 
 /**
- * @brief Zaj-elnyomó algoritmus a Goertzel szűrő kimenetén
- * @return true ha hang van jelen, false ha nincs
+ * @brief A vételi hangfrekvencia beállítása újrapéldányosítás nélkül
+ * @param offsetHz A CW hang frekvenciája
  *
- * Többszöri Goertzel mérést végez (noiseBlankerLoops_ alkalommal) és
- * megszámolja, hogy hányszor észlel hangot vs. csendet.
- * Csak akkor jelzi hang jelenlétét, ha a hang detektálások száma meghaladja a csend detektálásokat.
+ * Az együtthatók a következő updateDecoder() hívásban frissülnek, a Morse időzítés megmarad.
  */
-bool CwDecoder::sampleWithNoiseBlanking() {
-    int no_tone_count = 0;
-    int tone_count = 0;
-
-    for (int i = 0; i < noiseBlankerLoops_; i++) {
-        if (goertzelProcess()) {
-            tone_count++;
-        } else {
-            no_tone_count++;
-        }
-    }
-    return (tone_count > no_tone_count);
-}
+void CwDecoder::setTargetFrequency(uint16_t offsetHz) { targetOffsetHz_ = constrain(offsetHz, CW_DECODER_MIN_FREQUENCY, CW_DECODER_MAX_FREQUENCY); }
 
 /**
- * @brief Visszaállítja a Morse fa dekódolási állapotát a gyökér pozícióra
+ * @brief A hangdetektor (csúszó DFT, él megerősítés, mintaóra) alaphelyzetbe állítása
  *
- * Beállítja a fa index változókat a kezdeti értékekre, hogy új karakter
- * dekódolását lehessen elkezdeni. A Morse fa egy bináris fa, ahol balra
- * lépés a pont (.), jobbra lépés a vonás (-) karaktert jelenti.
+ * A kurzort a jelenre állítja, így a korábban felgyűlt mintákat nem dolgozzuk fel.
  */
-void CwDecoder::resetMorseTree() {
-    treeIndex_ = MORSE_TREE_ROOT_INDEX;
-    treeOffset_ = MORSE_TREE_INITIAL_OFFSET;
-    treeCount_ = MORSE_TREE_MAX_DEPTH;
+void CwDecoder::resetToneDetector() {
+    updateGoertzelCoefficients();
+    pendingStateSamples_ = 0;
+    pendingEdgeTimeMs_ = 0;
+    streamClockValid_ = false;
+    lastBlockStartUs_ = 0;
+    streamTimeUs_ = 0;
+    sampleReader_.sync();
 }
 
 /**
- * @brief Kiolvassa a Morse fa aktuális pozíciójának megfelelő karaktert
- * @return A Morse fában található karakter vagy '\0' ha érvénytelen pozíció
+ * @brief Csúszó Goertzel (sliding DFT) egy mintára
+ * @param sample Középre igazított minta
+ * @return Az utolsó N_SAMPLES minta amplitúdója a célfrekvencián (a DFT skáláján: N/2 * a hang amplitúdója)
  *
- * A treeIndex_ alapján megkeresi a megfelelő karaktert a MORSE_TREE_SYMBOLS
- * tömbben. Ha az index érvénytelen tartományban van, '\0'-t ad vissza.
+ * S(n) = r*e^(jw) * S(n-1) + x(n) - r^N*e^(jwN) * x(n-N)
+ * Az amplitúdó ugyanaz, mint a blokkos Goertzel-é N_SAMPLES mintán, de minden mintánál frissül,
+ * így az élek időzítése minta pontosságú. Gyökvonás helyett max + 3/8 min közelítés (legfeljebb ~7% hiba,
+ * a küszöb a követett szintekhez relatív, így ez nem számít).
  */
-char CwDecoder::getCharFromTree() {
-    if (treeIndex_ >= 0 && treeIndex_ < sizeof(MORSE_TREE_SYMBOLS)) {
-        return MORSE_TREE_SYMBOLS[treeIndex_];
-    }
-    return '\0';
+float CwDecoder::goertzelProcessSample(int16_t sample) {
+    const float leaving = static_cast<float>(sdftHistory_[sdftHistoryPos_]);
+    sdftHistory_[sdftHistoryPos_] = sample;
+    sdftHistoryPos_ = sdftHistoryPos_ + 1 == N_SAMPLES ? 0 : sdftHistoryPos_ + 1;
+
+    const float re = rotatorRe_ * sdftRe_ - rotatorIm_ * sdftIm_ + static_cast<float>(sample) - combRe_ * leaving;
+    const float im = rotatorRe_ * sdftIm_ + rotatorIm_ * sdftRe_ - combIm_ * leaving;
+    sdftRe_ = re;
+    sdftIm_ = im;
+
+    const float absRe = fabsf(re);
+    const float absIm = fabsf(im);
+    return absRe > absIm ? absRe + 0.375f * absIm : absIm + 0.375f * absRe;
 }
 
 /**
- * @brief Egy pont (.) elem feldolgozása a Morse fában
+ * @brief Adaptív küszöb döntés a hang amplitúdójából
+ * @param magnitude A goertzelProcessSample() amplitúdója
+ * @return true ha a kulcs le van nyomva (hang van)
  *
- * Balra lép a Morse fában (treeIndex_ csökkentése), frissíti az offset és mélység értékeket.
- * Hozzáadja a pont súlyértékét (2) a WPM számításhoz. Ha a fa túl mély lesz,
- * hibakezelést végez és reseteli a dekóder állapotát.
+ * A csúcs gyorsan emelkedik és lassan csökken, a zajszint csak felengedett kulcsnál mozog
+ * (lefelé gyorsabban), így a hang nem emeli a zajszintet. A küszöb a kettő között van,
+ * lenyomáshoz magasabb, felengedéshez alacsonyabb (hiszterézis), így sem az AGC, sem az
+ * erősítés nem rontja el a detektálást. Ha a csúcs nem emelkedik elég magasan a zaj fölé,
+ * a kulcs felengedett marad (a zaj nem billentyűz).
  */
-void CwDecoder::processDot() {
-    treeIndex_ -= treeOffset_;
-    treeOffset_ /= 2;
-    treeCount_--;
-    symbolCountForWpm_ += 2;
-    if (treeCount_ < 0) {
-        CW_DEBUG("CW Decoder: Tree error (dot)\n");
-        resetMorseTree();
-        currentReferenceMs_ = startReferenceMs_;
-        toneMinDurationMs_ = 9999L;
-        toneMaxDurationMs_ = 0L;
-        toneIndex_ = 0;
-        symbolCountForWpm_ = 0;
-        decoderStarted_ = false;
-        measuringTone_ = false;
+bool CwDecoder::detectKeyState(float magnitude) {
+    if (sdftWarmupSamples_ > 0) {
+        // Amíg az ablak nem telt meg, az amplitúdó nem érvényes: a követés az első teljes ablakról indul
+        if (--sdftWarmupSamples_ == 0) {
+            peakLevel_ = magnitude;
+            noiseLevel_ = magnitude;
+        }
+        return false;
     }
-}
 
-/**
- * @brief Egy vonás (-) elem feldolgozása a Morse fában
- *
- * Jobbra lép a Morse fában (treeIndex_ növelése), frissíti az offset és mélység értékeket.
- * Hozzáadja a vonás súlyértékét (4) a WPM számításhoz. Ha a fa túl mély lesz,
- * hibakezelést végez és reseteli a dekóder állapotát.
- */
-void CwDecoder::processDash() {
-    treeIndex_ += treeOffset_;
-    treeOffset_ /= 2;
-    treeCount_--;
-    symbolCountForWpm_ += 4;
-    if (treeCount_ < 0) {
-
-        CW_DEBUG("CW Decoder: Tree error (dash)\n");
-
-        resetMorseTree();
-        currentReferenceMs_ = startReferenceMs_;
-        toneMinDurationMs_ = 9999L;
-        toneMaxDurationMs_ = 0L;
-        toneIndex_ = 0;
-        symbolCountForWpm_ = 0;
-        decoderStarted_ = false;
-        measuringTone_ = false;
+    peakLevel_ += (magnitude - peakLevel_) * (magnitude > peakLevel_ ? PEAK_ATTACK_COEFF : PEAK_DECAY_COEFF);
+    if (!rawKeyDown_) {
+        noiseLevel_ += (magnitude - noiseLevel_) * (magnitude < noiseLevel_ ? NOISE_FALL_COEFF : NOISE_RISE_COEFF);
+    }
+    if (peakLevel_ < noiseLevel_) {
+        peakLevel_ = noiseLevel_;
     }
+
+    const float span = peakLevel_ - noiseLevel_;
+    const bool signalPresent = peakLevel_ > MIN_PEAK_TO_NOISE * noiseLevel_ && peakLevel_ > MIN_TONE_AMPLITUDE * N_SAMPLES / 2;
+    if (!signalPresent) {
+        rawKeyDown_ = false;
+    } else if (rawKeyDown_) {
+        rawKeyDown_ = magnitude > noiseLevel_ + KEY_UP_FRACTION * span;
+    } else {
+        rawKeyDown_ = magnitude > noiseLevel_ + KEY_DOWN_FRACTION * span;
+    }
+    return rawKeyDown_;
 }
 
 /**
- * @brief Frissíti a Morse időzítési referencia értékeket adaptív módon
- * @param duration Az aktuálisan mért hanghossz milliszekundumban
- *
- * Adaptív algoritmus, amely tanul a beérkező Morse jelek időzítéséből.
- * Külön kezeli a pont és vonás időtartamokat, és ezek alapján számítja ki
- * a pont/vonás közötti döntési küszöböt. Biztonsági korlátokat alkalmaz
- * a DOT_MIN_MS és DOT_MAX_MS értékek között.
+ * @brief Az aktuális karakter megbízhatósága
+ * @return 0..100 a lenyomott és felengedett kulcs átlagos amplitúdójának arányából (SNR),
+ *         vagy CONFIDENCE_UNKNOWN ha a karakter alatt nem volt lenyomott kulcs (pl. szóköz)
  */
-void CwDecoder::updateReferenceTimings(unsigned long duration) {  // Adaptív referencia - gyorsabb tanulás a széles WPM tartományhoz (7-25 WPM)
-    const unsigned long ADAPTIVE_WEIGHT_OLD = 2;                  // Régi érték súlya (gyorsabb adaptálás)
-    const unsigned long ADAPTIVE_WEIGHT_NEW = 1;                  // Új érték súlya
-    const unsigned long ADAPTIVE_DIVISOR = ADAPTIVE_WEIGHT_OLD + ADAPTIVE_WEIGHT_NEW;
-
-    if (toneMinDurationMs_ == 9999L) {
-        // Első elem - intelligensebb inicializálás
-        if (duration < (startReferenceMs_ * 1.5)) {
-            // Ez valószínűleg pont
-            toneMinDurationMs_ = duration;
-            currentReferenceMs_ = duration * 2.2;  // Pont/vonás küszöb optimalizálása
-        } else {
-            // Ez valószínűleg vonás
-            toneMinDurationMs_ = duration / 3.2;  // Reálisabb pont/vonás arány (1:3.2)
-            toneMaxDurationMs_ = duration;
-            currentReferenceMs_ = (toneMinDurationMs_ + toneMaxDurationMs_) / 2;
-        }
-        CW_DEBUG("CW: Első elem init - duration: %lu, min: %lu, max: %lu, ref: %lu\n", duration, toneMinDurationMs_, toneMaxDurationMs_, currentReferenceMs_);
-    } else {
-        unsigned long currentThreshold = currentReferenceMs_;
-        if (duration < currentThreshold) {
-            // Pont detektálva
-            toneMinDurationMs_ = (toneMinDurationMs_ * ADAPTIVE_WEIGHT_OLD + duration * ADAPTIVE_WEIGHT_NEW) / ADAPTIVE_DIVISOR;
-        } else {
-            // Vonás detektálva
-            if (toneMaxDurationMs_ == 0L) {
-                toneMaxDurationMs_ = duration;
-            } else {
-                toneMaxDurationMs_ = (toneMaxDurationMs_ * ADAPTIVE_WEIGHT_OLD + duration * ADAPTIVE_WEIGHT_NEW) / ADAPTIVE_DIVISOR;
-            }
-        }
-
-        // Intelligens referencia számítás
-        if (toneMaxDurationMs_ > 0L && toneMinDurationMs_ < 9999L) {
-            // Optimális küszöb: pont + (vonás-pont)/3
-            unsigned long calculatedRef = toneMinDurationMs_ + ((toneMaxDurationMs_ - toneMinDurationMs_) / 3);
-            currentReferenceMs_ = (currentReferenceMs_ * ADAPTIVE_WEIGHT_OLD + calculatedRef * ADAPTIVE_WEIGHT_NEW) / ADAPTIVE_DIVISOR;
-        }
-    }  // Széles biztonságos tartomány 7-30 WPM-hez
-    toneMinDurationMs_ = constrain(toneMinDurationMs_, DOT_MIN_MS, DOT_MAX_MS);
-    toneMaxDurationMs_ = constrain(toneMaxDurationMs_, DOT_MIN_MS, DASH_MAX_MS);
-
-    // Adaptív referencia biztonsági korlátok
-    unsigned long lowerBound = max(DOT_MIN_MS + 5, toneMinDurationMs_ * 2);  // Dinamikus alsó határ
-    unsigned long upperBound = DOT_MAX_MS + 50;                              // ~300ms (6- WPM)
-    currentReferenceMs_ = constrain(currentReferenceMs_, lowerBound, upperBound);
+uint8_t CwDecoder::characterConfidence() const {
+    if (keyDownSamples_ == 0 || keyUpSamples_ == 0 || keyUpSum_ <= 0.0f) {
+        return keyDownSamples_ == 0 ? DecodedTextRingConstants::CONFIDENCE_UNKNOWN : 100;
+    }
 
-    // WPM becslés és debug kimenet
-    CW_DEBUG("CW: Ref frissítve - min: %lu, max: %lu, ref: %lu, új elem: %lu, WPM: %d\n", toneMinDurationMs_, toneMaxDurationMs_, currentReferenceMs_, duration, estimateWpm());
+    const float ratio = (keyDownSum_ / keyDownSamples_) / (keyUpSum_ / keyUpSamples_);
+    const float snrDb = ratio > 0.0f ? 20.0f * log10f(ratio) : 0.0f;
+    return static_cast<uint8_t>(constrain((snrDb - CONFIDENCE_MIN_SNR_DB) * 100.0f / (CONFIDENCE_FULL_SNR_DB - CONFIDENCE_MIN_SNR_DB), 0.0f, 100.0f) + 0.5f);
 }
 
 /**
  * @brief Feldolgozza az összegyűjtött Morse elemeket és dekódolja őket karakterré
- * @return A dekódolt karakter vagy '\0' ha nincs érvényes karakter
+ * @return A dekódolt karakter (vagy prosign), vagy '\0' ha nincs érvényes karakter
  *
  * Végigmegy a rawToneDurations_ tömbön és minden elemet pont vagy vonásként
- * osztályoz a currentReferenceMs_ küszöb alapján. A Morse fában navigál
- * és a végén megpróbálja visszaadni a megfelelő karaktert.
+ * osztályoz a timing_ aktuális küszöbe alapján (a karakter elemeivel már tanított modell
+ * szerint, így egy sebességváltás első karakterén is pontosabb). A pont/vonás sorozat
+ * bitmintájához a MorseCode tábla egyetlen olvasással adja a karaktert.
  */
 char CwDecoder::processCollectedElements() {
     if (toneIndex_ == 0) return '\0';
-    CW_DEBUG("CW: Feldolgozás - %d elem, ref: %lu ms\n", toneIndex_, currentReferenceMs_);
-    resetMorseTree();
+    CW_DEBUG("CW: Feldolgozás - %d elem, pont/vonás küszöb: %.0f ms\n", toneIndex_, timing_.getDashThreshold());
 
+    uint8_t codeBits = 0;
     for (short i = 0; i < toneIndex_; i++) {
-        unsigned long duration = rawToneDurations_[i];
-        if (duration < currentReferenceMs_) {
-            processDot();
-            CW_DEBUG("CW: [%d] Pont: %lu ms\n", i, duration);
-        } else {
-            processDash();
-            CW_DEBUG("CW: [%d] Vonás: %lu ms\n", i, duration);
-        }
-    }  // Érvényes karakter?
-    char result = getCharFromTree();
-    if (result != '\0' && result != ' ') {  // Szóköz karaktert nem tekintünk érvényes dekódolt karakternek
-        if (isprint(result)) {              // Nyomtatható karakter
-            CW_DEBUG("CW: Érvényes karakter dekódolva: '%c'\n", result);
-            return result;
-        }
-    } else {
-        // Ha result '\0' vagy ' ', az azt jelenti, hogy nincs érvényes karakter ezen a pozíción
-        CW_DEBUG("CW: Ismeretlen minta - treeIndex: %d, result: '%c'\n", treeIndex_, result);
+        const bool dash = timing_.isDash(rawToneDurations_[i]);
+        codeBits = (codeBits << 1) | (dash ? 1 : 0);
+        CW_DEBUG("CW: [%d] %s: %lu ms\n", i, dash ? "Vonás" : "Pont", rawToneDurations_[i]);
+    }
+
+    const char result = MorseCode::decode(codeBits, toneIndex_);
+    if (result == '\0') {
+        CW_DEBUG("CW: Ismeretlen minta - %d elem, bitek: 0x%02X\n", toneIndex_, codeBits);
     }
-    return '\0';
+    return result;
 }
 
 /**
- * @brief Hozzáad egy karaktert a dekódolt karakterek pufferéhez
- * @param c A hozzáadandó karakter
+ * @brief Egy dekódolt karakter átadása a Core0-nak a közös szöveg gyűrűn
+ * @param c A karakter
  *
- * Körkörös puffer implementáció, amely automatikusan felülírja a legrégebbi
- * elemeket, ha a puffer megtelt. Üres karaktereket ('\0') nem ad hozzá a pufferhez.
- * Debug üzenetet ír ki a puffer állapotáról.
+ * Üres karaktereket ('\0') nem ad át. A karakter mellé a vételi eltolás, a mért WPM és a
+ * karakter alatt mért SNR-ből számolt megbízhatóság kerül; utána az SNR gyűjtése újraindul.
  */
 void CwDecoder::addToBuffer(char c) {
-    if (c == '\0') {  // Üres karaktert nem teszünk a pufferbe
+    if (c == '\0') {  // Üres karaktert nem teszünk a gyűrűbe
         return;
     }
 
-    decodedCharBuffer_[charBufferWritePos_] = c;
-    charBufferWritePos_ = (charBufferWritePos_ + 1) % DECODED_CHAR_BUFFER_SIZE;
-    if (charBufferCount_ < DECODED_CHAR_BUFFER_SIZE) {
-        charBufferCount_++;
-    } else {
-        // Ha a puffer tele volt, a legrégebbi elem (readPos) felülíródott,
-        // ezért a readPos-t is el kell léptetni.
-        charBufferReadPos_ = (charBufferReadPos_ + 1) % DECODED_CHAR_BUFFER_SIZE;
+    const uint8_t confidence = characterConfidence();
+    if (keyDownSamples_ > 0) {
+        keyDownSum_ = 0.0f;
+        keyUpSum_ = 0.0f;
+        keyDownSamples_ = 0;
+        keyUpSamples_ = 0;
     }
-    CW_DEBUG("CW: Bufferhez adva: '%c'. Count: %d, R:%d, W:%d\n", c, charBufferCount_, charBufferReadPos_, charBufferWritePos_);
-}
 
-/**
- * @brief Kivesz egy karaktert a dekódolt karakterek pufferéből
- * @return A legrégebbi dekódolt karakter vagy '\0' ha a puffer üres
- *
- * FIFO (First In, First Out) elvű olvasás a körkörös pufferből.
- * Frissíti a read pozíciót és csökkenti a pufferben lévő elemek számát.
- * Debug üzenetet ír ki a műveletról.
- */
-char CwDecoder::getCharacterFromBuffer() {
-    if (charBufferCount_ == 0) {
-        return '\0';
+    if (!decodedTextRing.push(DecodedTextSource::Cw, c, targetOffsetHz_, timing_.getWpm(), confidence)) {
+        CW_DEBUG("CW: A szöveg gyűrű tele, '%c' eldobva\n", c);
+        return;
     }
-    char c = decodedCharBuffer_[charBufferReadPos_];
-    charBufferReadPos_ = (charBufferReadPos_ + 1) % DECODED_CHAR_BUFFER_SIZE;
-    charBufferCount_--;
-    CW_DEBUG("CW: Bufferből olvasva: '%c' Count: %d, R:%d, W:%d\n", c, charBufferCount_, charBufferReadPos_, charBufferWritePos_);
-    return c;
+    CW_DEBUG("CW: Gyűrűbe adva: '%c' (megbízhatóság: %u)\n", c, confidence);
 }
 
 /**
  * @brief A CW dekóder fő ciklikus feldolgozó függvénye
  *
- * Ez a Core1-en futó main loop, amely folyamatosan:
- * - Mintavételezi az audio jelet és detektálja a CW hangokat
- * - Méri a hangok és szünetek időtartamát
- * - Adaptívan tanul az időzítésből (WPM sebesség)
- * - Dekódolja a Morse karaktereket
- * - Kezeli a karakter és szó közötti szüneteket
- * - Puffereli a dekódolt karaktereket a Core0 számára
+ * Ez a Core1-en futó main loop, amely minden hívásnál:
+ * - Kiolvassa a közös minta buszon felgyűlt mintákat (várakozás nélkül)
+ * - Mintánként frissíti a csúszó Goertzel szűrőt és adaptív küszöbbel detektálja a CW hangokat
+ * - Az éleket a mintaóra szerint, minta pontossággal időzíti
+ * - Minden megerősített élnél és blokkonként egyszer lépteti a dekódoló állapotgépet
  *
- * Állapotgép alapú működés:
- * - Hang detektálás → időzítés kezdete
- * - Hang vége → elem hozzáadása, időzítés frissítése
- * - Karakterközi szünet → dekódolás
- * - Hosszú csend → állapot reset
+ * Egy él akkor megerősített, ha az új állapot EDGE_CONFIRM_SAMPLES mintán át kitart;
+ * az él időpontja az első ilyen minta időpontja.
  */
 void CwDecoder::updateDecoder() {
-    static const unsigned long MAX_SILENCE_MS = 4000;
-
-    // Dinamikus element gap minimum - adaptív zajszűrés alapján
-    unsigned long elementGapMinMs = DOT_MIN_MS / 2;
-    if (toneMinDurationMs_ != 9999L && toneMinDurationMs_ > 0) {
-        elementGapMinMs = max(DOT_MIN_MS / 2, toneMinDurationMs_ / 4);  // Pont hossz / 4
+    if (!sampleReader_.isRunning()) {
+        return;
+    }
+    if (targetOffsetHz_ != cachedOffsetHz_) {
+        updateGoertzelCoefficients();
     }
 
-    unsigned long estimatedDotLength = (toneMinDurationMs_ == 9999L || toneMinDurationMs_ == 0) ? (currentReferenceMs_ / 2) : toneMinDurationMs_;
-    if (estimatedDotLength < DOT_MIN_MS || currentReferenceMs_ == 0) estimatedDotLength = DOT_MIN_MS;  // Biztosítjuk, hogy legyen értelmes alap
+    int16_t block[BLOCK_SAMPLES];
+    const float samplePeriodUs = 1000000.0f / sampleReader_.getSampleRateHz();
+    while (sampleReader_.available() > 0) {
+        uint32_t blockStartUs;
+        uint16_t count = sampleReader_.read(block, BLOCK_SAMPLES, &blockStartUs);
+        if (count == 0) {
+            break;
+        }
+
+        // Mintaóra: a 32 bites időbélyeg különbségeit gyűjtjük, így a túlcsordulás nem okoz ugrást
+        if (streamClockValid_) {
+            streamTimeUs_ += blockStartUs - lastBlockStartUs_;
+        } else {
+            streamTimeUs_ = blockStartUs;
+            streamClockValid_ = true;
+        }
+        lastBlockStartUs_ = blockStartUs;
+
+        for (uint16_t i = 0; i < count; i++) {
+            const float magnitude = goertzelProcessSample(block[i]);
+            bool rawToneState = detectKeyState(magnitude);
+
+            // A karakter SNR-jéhez a megerősített állapot szerint gyűjtjük az amplitúdókat
+            if (toneDetectedState_) {
+                keyDownSum_ += magnitude;
+                keyDownSamples_++;
+            } else if (decoderStarted_) {
+                keyUpSum_ += magnitude;
+                keyUpSamples_++;
+            }
 
-    unsigned long charGapMs = max(MIN_CHAR_GAP_MS_FALLBACK, (unsigned long)(estimatedDotLength * CHAR_GAP_DOT_MULTIPLIER));
-    unsigned long wordGapMs = max(MIN_WORD_GAP_MS_FALLBACK, (unsigned long)(estimatedDotLength * WORD_GAP_DOT_MULTIPLIER));
-    // Biztosítjuk, hogy a wordGapMs nagyobb legyen, mint a charGapMs
-    if (wordGapMs <= charGapMs) wordGapMs = charGapMs + max(1UL, MIN_CHAR_GAP_MS_FALLBACK / 2);
+            if (rawToneState == toneDetectedState_) {
+                pendingStateSamples_ = 0;
+                continue;
+            }
+            if (pendingStateSamples_ == 0) {
+                pendingEdgeTimeMs_ = static_cast<unsigned long>((streamTimeUs_ + static_cast<uint64_t>(i * samplePeriodUs)) / 1000);
+            }
+            if (++pendingStateSamples_ >= EDGE_CONFIRM_SAMPLES) {
+                toneDetectedState_ = rawToneState;
+                pendingStateSamples_ = 0;
+                processToneState(toneDetectedState_, pendingEdgeTimeMs_);
+            }
+        }
 
-    bool currentToneState = sampleWithNoiseBlanking();
-    unsigned long currentTimeMs = millis();
-    char decodedChar = '\0';
+        // A szünetek (karakter/szó határ, tétlenség) ellenőrzése a blokk végének időpontjával
+        processToneState(toneDetectedState_, static_cast<unsigned long>((streamTimeUs_ + static_cast<uint64_t>(count * samplePeriodUs)) / 1000));
+    }
+}
 
+/**
+ * @brief A dekódoló állapotgép léptetése
+ * @param currentToneState A megerősített hang állapot
+ * @param currentTimeMs Az állapot időpontja a mintaóra szerint (ms)
+ *
+ * - Felfutó él: a szünet hossza tanítja az időzítést, új jel mérése kezdődik; egy jel
+ *   közepén lévő rövid kimaradás (zaj, QSB) után a jel folytatódik
+ * - Lefutó él: a jel vége függő, a rövid kimaradás idejéig még folytatódhat
+ * - Szünet: a jel véglegesítése, majd a tanult küszöbök szerint karakter- és szóhatár
+ * A dekódolt karaktereket a Core0 számára puffereli.
+ */
+void CwDecoder::processToneState(bool currentToneState, unsigned long currentTimeMs) {
     if (currentToneState) {
         lastActivityMs_ = currentTimeMs;
-        // Ha hangot észlelünk, és előtte nem mértünk hangot (azaz egy új hang kezdődött)
-        if (!measuringTone_) {
-            wordSpaceProcessed_ = false;  // Új hang megszakítja az előző csendperiódust, reseteljük a flag-et
-        }
+        inInactiveState = false;
     }
 
-    if (currentTimeMs - lastActivityMs_ > MAX_SILENCE_MS) {
-        if (!inInactiveState) {   // Csak akkor írjuk ki, ha még nem tettük
-            resetDecoderState();  // Teljes reset, ami az initialize()-t hívja
-            CW_DEBUG("CW: Reset tétlenség (%lu ms) miatt\n", MAX_SILENCE_MS);
-            inInactiveState = true;  // Beállítjuk, hogy kiírtuk
+    if (currentToneState == measuringTone_) {
+        if (!currentToneState) {
+            checkSilence(currentTimeMs);
         }
-        return;  // Nem adunk vissza karaktert, csak resetelünk
+        return;
     }
 
-    if (!decoderStarted_ && !measuringTone_ && currentToneState) {
-        leadingEdgeTimeMs_ = currentTimeMs;
-        decoderStarted_ = true;
-        inInactiveState = false;  // Újra aktívak vagyunk, reseteljük a flag-et
-        measuringTone_ = true;
-        wordSpaceProcessed_ = false;  // Új hangjel kezdődött
-
-        CW_DEBUG("CW: Első él, idő: %lu\n", currentTimeMs);
+    if (!currentToneState) {
+        // Lefutó él: a jel hossza csak a kimaradás idejének leteltével végleges
+        markEndMs_ = currentTimeMs;
+        markPending_ = true;
+        measuringTone_ = false;
+        return;
+    }
 
-    } else if (decoderStarted_ && measuringTone_ && !currentToneState) {
-        trailingEdgeTimeMs_ = currentTimeMs;
-        unsigned long duration = trailingEdgeTimeMs_ - leadingEdgeTimeMs_;
+    // Felfutó él
+    measuringTone_ = true;
+    if (markPending_ && currentTimeMs - markEndMs_ < glitchGapMs()) {
+        markPending_ = false;  // Rövid kimaradás a jel közepén: a jel folytatódik
+        return;
+    }
 
-        CW_DEBUG("CW: Hang vége, tartam: %lu ms\n", duration);
+    checkSilence(currentTimeMs);  // A szünet alatt esedékes karakter/szóköz kiadása
+    if (markPending_) {
+        commitMark();
+    }
+    pendingGapMs_ = decoderStarted_ ? currentTimeMs - markEndMs_ : 0;
+    CW_DEBUG("CW: Szünet: %lu ms (karakterköz > %.0f ms, szóköz > %.0f ms)\n", pendingGapMs_, timing_.getCharGapThreshold(), timing_.getWordGapThreshold());
+    markStartMs_ = currentTimeMs;
+}
 
-        if (toneIndex_ >= 6) {
+/**
+ * @brief Ennél rövidebb jel zaj tüske, nem elem (a hosszú szünetekben a detektor zajt is billentyűzhet)
+ */
+unsigned long CwDecoder::glitchMarkMs() const { return constrain(static_cast<unsigned long>(timing_.getDot() * GLITCH_DOT_FRACTION), MIN_ELEMENT_MS, MAX_NOISE_MARK_MS); }
 
-            CW_DEBUG("CW: Tömb tele (%d elem), kényszer dekódolás hang végén\n", toneIndex_);
+/**
+ * @brief Ennél rövidebb szünet a jelen belüli kimaradás (zaj, QSB), nem elemköz
+ */
+unsigned long CwDecoder::glitchGapMs() const { return min(MAX_GLITCH_MS, static_cast<unsigned long>(timing_.getDot() * GLITCH_DOT_FRACTION)); }
 
-            decodedChar = processCollectedElements();
-            memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
-            resetMorseTree();
-            toneIndex_ = 0;
+/**
+ * @brief A teli elem tömb és az új jel a hiba jel része-e
+ * @param durationMs Az új jel hossza
+ * @return true ha minden eddigi elem és az új jel is pont
+ *
+ * A hiba jelet (8 pont) sokan hosszabban adják: a további pontok nem kezdenek új karaktert.
+ */
+bool CwDecoder::isErrorSignal(unsigned long durationMs) const {
+    if (timing_.isDash(durationMs)) {
+        return false;
+    }
+    for (short i = 0; i < toneIndex_; i++) {
+        if (timing_.isDash(rawToneDurations_[i])) {
+            return false;
         }
-        if (duration >= DOT_MIN_MS && duration <= DASH_MAX_MS && toneIndex_ < 6) {  // Dinamikus zaj ellenőrzés
-            unsigned long dynamicMinDuration = DOT_MIN_MS;
-            if (toneMinDurationMs_ != 9999L && toneMinDurationMs_ > 0) {
-                // Adaptív minimum: aktuális min pont / 5, de minimum MIN_ADAPTIVE_DOT_MS (15ms)
-                // Ez lehetővé teszi a rövid elemek elfogadását 25 WPM-nél
-                dynamicMinDuration = max(DOT_MIN_MS, max(MIN_ADAPTIVE_DOT_MS, toneMinDurationMs_ / NOISE_THRESHOLD_FACTOR));
-
-                // Speciális eset: ha már van tanulási adat és a jel 25% hosszabb mint a min zaj küszöb,
-                // akkor elfogadjuk, még ha rövid is (pl. rossz vételi körülmények)
-                if (duration >= DOT_MIN_MS && duration >= (dynamicMinDuration * 0.6)) {
-                    // Ez 25 WPM-nél (~48ms dot) esetén 18-20ms körüli jeleket is elfogad
-                    dynamicMinDuration = min(dynamicMinDuration, duration);
-                }
-            } else {
-                // Ha még nincs tanulási adat, kevésbé konzervatív küszöb
-                dynamicMinDuration = max(DOT_MIN_MS, MIN_ADAPTIVE_DOT_MS);
-            }
-
-            if (duration >= dynamicMinDuration) {
-                rawToneDurations_[toneIndex_] = duration;
-                toneIndex_++;
-                updateReferenceTimings(duration);
-                CW_DEBUG("CW: Elem hozzáadva [%d]: %lu ms, ref: %lu ms, dyn_min: %lu ms\n", toneIndex_ - 1, duration, currentReferenceMs_, dynamicMinDuration);
-            } else {
-                CW_DEBUG("CW: Dinamikus zajszűrés: %lu ms < %lu ms (adaptív minimum)\n", duration, dynamicMinDuration);
-            }
-        } else {
+    }
+    return true;
+}
 
-            if (duration > DASH_MAX_MS) {
+/**
+ * @brief A függő jel elemként rögzítése
+ *
+ * A nagyon rövid jel zaj tüske, a nagyon hosszú vivő: egyik sem elem. Egy vivő az
+ * addig összegyűjtött elemeket is érvényteleníti.
+ */
+void CwDecoder::commitMark() {
+    markPending_ = false;
+    const unsigned long durationMs = markEndMs_ - markStartMs_;
+    if (durationMs < glitchMarkMs()) {
+        CW_DEBUG("CW: Zaj tüske: %lu ms\n", durationMs);
+        return;
+    }
+    if (durationMs > MAX_ELEMENT_MS) {
+        CW_DEBUG("CW: TÚL HOSSZÚ elem (vivő): %lu ms\n", durationMs);
+        toneIndex_ = 0;
+        decoderStarted_ = false;
+        return;
+    }
 
-                CW_DEBUG("CW: TÚL HOSSZÚ elem: %lu ms (max: %lu, index: %d)\n", duration, DASH_MAX_MS, toneIndex_);
-            } else if (duration < DOT_MIN_MS) {
-                CW_DEBUG("CW: TÚL RÖVID elem: %lu ms (min: %lu, index: %d)\n", duration, DOT_MIN_MS, toneIndex_);
-            }
+    decoderStarted_ = true;
+    if (toneIndex_ >= MorseCode::MAX_ELEMENTS) {
+        if (isErrorSignal(durationMs)) {
+            CW_DEBUG("CW: Hiba jel további pontja: %lu ms\n", durationMs);
+            return;
         }
-        measuringTone_ = false;
-    } else if (decoderStarted_ && !measuringTone_ && currentToneState) {
-        unsigned long gapDuration = currentTimeMs - trailingEdgeTimeMs_;
-        wordSpaceProcessed_ = false;  // Új hangjel kezdődött egy szünet után
-        if (toneIndex_ >= 6) {
-            CW_DEBUG("CW: Tömb tele (%d elem), kényszer dekódolás\n", toneIndex_);
-            decodedChar = processCollectedElements();
-            memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
-            resetMorseTree();
-            toneIndex_ = 0;
+        CW_DEBUG("CW: Tömb tele (%d elem), kényszer dekódolás\n", toneIndex_);
+        finishCharacter();
+    }
+    rawGapDurations_[toneIndex_] = pendingGapMs_;
+    rawToneDurations_[toneIndex_++] = durationMs;
+    CW_DEBUG("CW: Elem [%d]: %lu ms (%s), pont: %.0f ms, WPM: %u (tényleges %u)\n", toneIndex_ - 1, durationMs, timing_.isDash(durationMs) ? "vonás" : "pont", timing_.getDot(), timing_.getWpm(),
+             timing_.getEffectiveWpm());
+}
+
+/**
+ * @brief A szünet hossza szerinti teendők (a kulcs felengedett állapotában)
+ * @param currentTimeMs Az aktuális időpont a mintaóra szerint (ms)
+ *
+ * A jel a kimaradás idejének leteltével végleges, a tanult karakterköz küszöb felett a
+ * karakter, a szóköz küszöb felett egy szóköz kerül kiadásra. Hosszú csend után a
+ * karakter állapot törlődik (a tanult időzítés megmarad).
+ */
+void CwDecoder::checkSilence(unsigned long currentTimeMs) {
+    if (!decoderStarted_ && !markPending_) {
+        if (!inInactiveState && lastActivityMs_ != 0 && currentTimeMs - lastActivityMs_ > MAX_SILENCE_MS) {
+            initialize();  // A hangdetektor, a mintaóra és a tanult időzítés fut tovább
+            inInactiveState = true;
+            CW_DEBUG("CW: Reset tétlenség (%lu ms) miatt\n", MAX_SILENCE_MS);
         }
-        if (gapDuration >= charGapMs && toneIndex_ > 0) {  // Karakter elválasztó szünet
-            CW_DEBUG("CW: Karakterhatár detektálva, gap: %lu ms (küszöb: %lu ms)\n", gapDuration, charGapMs);
-            decodedChar = processCollectedElements();
-            if (decodedChar != '\0') {
-                lastDecodedChar_ = decodedChar;
-                lastActivityMs_ = currentTimeMs;
-            }
-            resetMorseTree();
-            // trailingEdgeTimeMs_ nem frissül itt, mert a következő hang leadingEdgeTimeMs_-e lesz a mérvadó
-            toneIndex_ = 0;
-            memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
-            leadingEdgeTimeMs_ = currentTimeMs;
-            measuringTone_ = true;
-            CW_DEBUG("CW: Karakterhatár, gap: %lu ms\n", gapDuration);
-        } else if (gapDuration >= elementGapMinMs || toneIndex_ == 0) {
-            leadingEdgeTimeMs_ = currentTimeMs;
-            measuringTone_ = true;
-        } else {
-            CW_DEBUG("CW: Rövid gap: %lu ms (küszöb: %lu)\n", gapDuration, charGapMs);
-            if (toneIndex_ >= 1 && gapDuration >= 150) {
-                CW_DEBUG("CW: 1+ elem 150ms+ gap-pel - karakterhatár feltételezés\n");
-                // Ez az ág potenciálisan problémás lehet, ha a 150ms rövidebb, mint a charGapMs.
-                // De meghagyjuk az eredeti logika szerint.
-                decodedChar = processCollectedElements();
-                if (decodedChar != '\0') lastDecodedChar_ = decodedChar;  // lastActivityMs frissül, ha van karakter
-                memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
-                resetMorseTree();
-                toneIndex_ = 0;
-            }
-            leadingEdgeTimeMs_ = currentTimeMs;
-            measuringTone_ = true;
+        return;
+    }
+
+    const unsigned long silenceMs = currentTimeMs - markEndMs_;
+    if (markPending_ && silenceMs >= glitchGapMs()) {
+        commitMark();
+    }
+
+    if (toneIndex_ > 0 && silenceMs > timing_.getCharGapThreshold()) {
+        CW_DEBUG("CW: Karakterhatár, szünet: %lu ms (küszöb: %.0f ms)\n", silenceMs, timing_.getCharGapThreshold());
+        finishCharacter();
+    }
+
+    if (toneIndex_ == 0 && lastDecodedChar_ != '\0' && lastDecodedChar_ != ' ' && silenceMs > timing_.getWordGapThreshold()) {
+        CW_DEBUG("CW: Szóköz, szünet: %lu ms (küszöb: %.0f ms, WPM: %u)\n", silenceMs, timing_.getWordGapThreshold(), timing_.getWpm());
+        lastDecodedChar_ = ' ';
+        addToBuffer(' ');
+    }
+
+    if (silenceMs > MAX_SILENCE_MS) {
+        decoderStarted_ = false;  // A következő jel előtti szünet nem tanít
+    }
+    if (currentTimeMs - lastSpaceDebugMs_ >= SPACE_DEBUG_INTERVAL_MS) {
+        CW_DEBUG("CW: Szünet: %lu ms, elemek: %d, lastChar: '%c'\n", silenceMs, toneIndex_, lastDecodedChar_);
+        lastSpaceDebugMs_ = currentTimeMs;
+    }
+}
+
+/**
+ * @brief Az összegyűjtött elemek karakterré alakítása és kiadása
+ *
+ * Előbb a karakter jelei és szünetei tanítják az időzítést, így az elemek már a frissített
+ * küszöbökkel sorolódnak pont/vonás közé. A zajból billentyűzött (kis megbízhatóságú)
+ * karakter nem tanít: jel nélkül a detektor zajt is billentyűz, ez ne húzza el a tanult sebességet.
+ */
+void CwDecoder::finishCharacter() {
+    if (characterConfidence() >= MIN_LEARN_CONFIDENCE) {
+        for (short i = 0; i < toneIndex_; i++) {
+            timing_.addMark(rawToneDurations_[i]);
         }
-    } else if (decoderStarted_ && !measuringTone_ && !currentToneState) {
-        unsigned long spaceDuration = currentTimeMs - trailingEdgeTimeMs_;
-        if ((spaceDuration > charGapMs && toneIndex_ > 0) || toneIndex_ >= 6) {
-            if (toneIndex_ >= 6) {
-                CW_DEBUG("CW: Tömb tele csendben (%d elem), kényszer dekódolás\n", toneIndex_);
-            } else {
-                CW_DEBUG("CW: Hosszú csend detektálva, space: %lu ms (küszöb: %lu ms)\n", spaceDuration, charGapMs);
+        for (short i = 0; i < toneIndex_; i++) {
+            if (rawGapDurations_[i] > 0) {
+                timing_.addSpace(rawGapDurations_[i]);
             }
-            decodedChar = processCollectedElements();
-            resetMorseTree();
-            memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
-            toneIndex_ = 0;
-            decoderStarted_ = false;
-            CW_DEBUG("CW: Hosszú csend, space: %lu ms\n", spaceDuration);
-        }
-    }  // Szóköz beillesztés ellenőrzése - dinamikus WPM alapú küszöbökkel
-    if (decodedChar == '\0' && !measuringTone_ && !currentToneState && lastDecodedChar_ != '\0') {
-        unsigned long spaceDuration = currentTimeMs - trailingEdgeTimeMs_;
-
-        // Dinamikus szóköz küszöb WPM alapján
-        unsigned long dynamicWordGapMs;
-        if (toneMinDurationMs_ != 9999L && toneMinDurationMs_ > 0) {
-            // Szóköz = 7 * pont hossz (standard Morse timing)
-            dynamicWordGapMs = toneMinDurationMs_ * 7;
-        } else {
-            // Fallback érték
-            dynamicWordGapMs = max(200UL, (unsigned long)(estimatedDotLength * 4.0f));
-        }  // Debug kimenet korlátozása - csak 1 másodpercenként írjuk ki
-        if (currentTimeMs - lastSpaceDebugMs_ >= SPACE_DEBUG_INTERVAL_MS) {
-            // WPM becslés debug kiíráshoz
-            CW_DEBUG("CW: Szóköz ellenőrzés - space: %lu ms, küszöb: %lu ms, WPM: %d, lastChar: '%c', processed: %s\n", spaceDuration, dynamicWordGapMs,
-                     (toneMinDurationMs_ != 9999L && toneMinDurationMs_ > 0) ? (1200 / toneMinDurationMs_) : 15, lastDecodedChar_, wordSpaceProcessed_ ? "igen" : "nem");
-
-            lastSpaceDebugMs_ = currentTimeMs;
-        }
-
-        if (spaceDuration > dynamicWordGapMs && !wordSpaceProcessed_ && lastDecodedChar_ != ' ') {
-            decodedChar = ' ';           // Szóköz karakter beszúrása
-            wordSpaceProcessed_ = true;  // Jelöljük, hogy ehhez a szünethez már adtunk szóközt
-            CW_DEBUG("CW: Szóköz beszúrva, gap: %lu ms (küszöb: %lu ms, WPM: %d)\n", spaceDuration, dynamicWordGapMs, currentWpm);
         }
     }
 
+    const char decodedChar = processCollectedElements();
+    memset(rawToneDurations_, 0, sizeof(rawToneDurations_));
+    memset(rawGapDurations_, 0, sizeof(rawGapDurations_));
+    toneIndex_ = 0;
     if (decodedChar != '\0') {
         CW_DEBUG("CW: Dekódolt karakter: '%c'\n", decodedChar);
-        if (decodedChar != ' ') {
-            lastDecodedChar_ = decodedChar;  // Frissítjük az utolsó karaktert (de szóközt nem)
-        }
+        lastDecodedChar_ = decodedChar;
+        addToBuffer(decodedChar);
     }
-    addToBuffer(decodedChar);
-    return;
 }
@@ -0,0 +1,289 @@
+/**
+ * @file CwSkimmer.cpp
+ * @brief Több csatornás CW dekóder: közös FFT szűrőbank, csatornánként könnyű dekóder állapot
+ */
+
+#include "CwSkimmer.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "DecodedTextRing.h"
+#include "MorseCode.h"
+#include "defines.h"
+
+// Skimmer működés debug engedélyezése de csak DEBUG módban
+#ifdef nem__DEBUG
+#define SKIMMER_DEBUG(fmt, ...) DEBUG(fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define SKIMMER_DEBUG(fmt, ...)  // Üres makró, ha __DEBUG nincs definiálva
+#endif
+
+/**
+ * @brief CwSkimmer konstruktor
+ * @param source A közös minta busz
+ */
+CwSkimmer::CwSkimmer(AudioSampleRing &source) : reader_(source), fft_(true), hopCount_(0), binWidthHz_(0.0f), minBin_(0), maxBin_(0), ready_(false) {
+    using namespace CwSkimmerConstants;
+
+    reader_.setTargetSampleRate(SAMPLE_RATE_HZ);
+    fft_.setWindowType(FftWindowType::Hann);  // A szomszédos csatornák szétválasztásához
+    ready_ = fft_.setSize(FFT_SIZE);
+    if (!ready_) {
+        DEBUG("CwSkimmer: FFT előkészítése sikertelen!\n");
+    }
+
+    binWidthHz_ = (reader_.isRunning() ? reader_.getSampleRateHz() : SAMPLE_RATE_HZ) / FFT_SIZE;
+    minBin_ = static_cast<uint8_t>(constrain(static_cast<int>(MIN_TONE_HZ / binWidthHz_ + 0.5f), 1, FFT_SIZE / 2 - 2));
+    maxBin_ = static_cast<uint8_t>(constrain(static_cast<int>(MAX_TONE_HZ / binWidthHz_ + 0.5f), minBin_, FFT_SIZE / 2 - 2));
+    reset();
+}
+
+/**
+ * @brief Az összes csatorna törlése
+ */
+void CwSkimmer::reset() {
+    memset(frame_, 0, sizeof(frame_));
+    memset(magnitudes_, 0, sizeof(magnitudes_));
+    memset(averageSpectrum_, 0, sizeof(averageSpectrum_));
+    memset(channels_, 0, sizeof(channels_));
+    hopCount_ = 0;
+    reader_.sync();
+}
+
+/**
+ * @brief Az új minták feldolgozása
+ *
+ * Minden HOP_SAMPLES új mintánál egy spektrum készül az utolsó FFT_SIZE mintából,
+ * ez lépteti az összes csatornát.
+ */
+void CwSkimmer::process() {
+    using namespace CwSkimmerConstants;
+
+    if (!ready_ || !reader_.isRunning()) {
+        return;
+    }
+
+    while (reader_.available() >= HOP_SAMPLES) {
+        memmove(frame_, &frame_[HOP_SAMPLES], (FFT_SIZE - HOP_SAMPLES) * sizeof(int16_t));
+        if (reader_.read(&frame_[FFT_SIZE - HOP_SAMPLES], HOP_SAMPLES) != HOP_SAMPLES) {
+            break;
+        }
+        processHop();
+    }
+}
+
+/**
+ * @brief Egy spektrum feldolgozása: átlagolás, időnként csúcskeresés, majd a csatornák léptetése
+ */
+void CwSkimmer::processHop() {
+    using namespace CwSkimmerConstants;
+
+    fft_.computeMagnitudes(frame_, magnitudes_);
+    hopCount_++;
+
+    for (uint8_t k = minBin_ - 1; k <= maxBin_ + 1; k++) {
+        averageSpectrum_[k] += (magnitudes_[k] - averageSpectrum_[k]) * SPECTRUM_AVERAGE_ALPHA;
+    }
+    if (hopCount_ % PEAK_SCAN_HOPS == 0) {
+        scanPeaks();
+    }
+
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        if (channels_[i].active) {
+            updateChannel(channels_[i]);
+        }
+    }
+}
+
+/**
+ * @brief Csúcskeresés az átlag spektrumban, csatornák foglalása és felszabadítása
+ *
+ * A zajszint a sáv bin-jeinek alsó kvantilise (a jelek nem emelik meg). Csúcs az a helyi
+ * maximum, ami PEAK_MIN_SNR-szer a zajszint felett van. Egy csúcshoz tartozó meglévő
+ * csatorna (+/-1 bin) frissül, különben szabad csatornát kap.
+ */
+void CwSkimmer::scanPeaks() {
+    using namespace CwSkimmerConstants;
+
+    float sorted[FFT_SIZE / 2];
+    const uint8_t bandBins = maxBin_ - minBin_ + 1;
+    memcpy(sorted, &averageSpectrum_[minBin_], bandBins * sizeof(float));
+    const uint8_t percentileIndex = static_cast<uint8_t>(bandBins * NOISE_FLOOR_PERCENTILE);
+    std::nth_element(sorted, sorted + percentileIndex, sorted + bandBins);
+    const float noiseFloor = sorted[percentileIndex];
+
+    for (uint8_t k = minBin_; k <= maxBin_; k++) {
+        const float level = averageSpectrum_[k];
+        if (level < noiseFloor * PEAK_MIN_SNR || level < averageSpectrum_[k - 1] || level <= averageSpectrum_[k + 1]) {
+            continue;
+        }
+
+        Channel *target = nullptr;
+        Channel *freeChannel = nullptr;
+        for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+            Channel &channel = channels_[i];
+            if (channel.active && abs(static_cast<int>(channel.bin) - k) <= 1) {
+                target = &channel;
+                break;
+            }
+            if (!channel.active && freeChannel == nullptr) {
+                freeChannel = &channel;
+            }
+        }
+
+        if (target == nullptr) {
+            if (freeChannel == nullptr) {
+                continue;  // Minden csatorna foglalt
+            }
+            target = freeChannel;
+            memset(target, 0, sizeof(Channel));
+            target->active = true;
+            target->bin = k;
+            target->noiseLevel = noiseFloor;
+            target->peakLevel = level;
+            target->dotHops = INITIAL_DOT_HOPS;
+            target->edgeHop = hopCount_;
+            if (magnitudes_[k] > noiseFloor * PEAK_MIN_SNR) {
+                target->codeLength = UINT8_MAX;  // Egy karakter közepén kezdünk: ezt az első (csonka) karaktert eldobjuk
+            }
+            SKIMMER_DEBUG("CwSkimmer: Új csatorna: %u Hz\n", binToHz(k));
+        }
+        target->lastSeenHop = hopCount_;
+    }
+
+    for (uint8_t i = 0; i < MAX_CHANNELS; i++) {
+        Channel &channel = channels_[i];
+        if (channel.active && !channel.keyDown && hopCount_ - channel.lastSeenHop > CHANNEL_TIMEOUT_HOPS) {
+            finishCharacter(channel);
+            flushWord(channel);
+            channel.active = false;
+            SKIMMER_DEBUG("CwSkimmer: Csatorna felszabadítva: %u Hz\n", binToHz(channel.bin));
+        }
+    }
+}
+
+/**
+ * @brief Egy csatorna léptetése az aktuális spektrummal
+ *
+ * A burkoló a csatorna bin-jének magnitúdója. A küszöbök a követett zaj és csúcs szint közé
+ * esnek (hiszterézissel). Az elemeket a pont hossz kétszeresénél választjuk szét, a pont
+ * hosszt a mért elemekből folyamatosan becsüljük. Karakterhatár 2.5, szóhatár 5 pontnyi szünetnél.
+ */
+void CwSkimmer::updateChannel(Channel &channel) {
+    using namespace CwSkimmerConstants;
+
+    const float level = magnitudes_[channel.bin];
+    if (level > channel.peakLevel) {
+        channel.peakLevel = level;
+    } else {
+        channel.peakLevel -= (channel.peakLevel - channel.noiseLevel) * ENVELOPE_PEAK_DECAY;
+    }
+    if (!channel.keyDown) {
+        channel.noiseLevel += (level - channel.noiseLevel) * ENVELOPE_NOISE_ALPHA;
+    }
+
+    const float swing = channel.peakLevel - channel.noiseLevel;
+    const bool keyable = channel.peakLevel > channel.noiseLevel * MIN_KEYING_SNR;
+    const uint32_t elapsed = hopCount_ - channel.edgeHop;
+
+    if (!channel.keyDown) {
+        if (keyable && level > channel.noiseLevel + swing * KEY_DOWN_RATIO) {
+            channel.keyDown = true;
+            channel.edgeHop = hopCount_;
+            return;
+        }
+        // Szünet: karakter, majd szóhatár
+        if (channel.codeLength > 0 && elapsed > channel.dotHops * 2.5f) {
+            finishCharacter(channel);
+        }
+        if (channel.wordLength > 0 && elapsed > channel.dotHops * 5.0f) {
+            flushWord(channel);
+        }
+        return;
+    }
+
+    if (level >= channel.noiseLevel + swing * KEY_UP_RATIO) {
+        return;  // Még tart a hang
+    }
+
+    channel.keyDown = false;
+    channel.edgeHop = hopCount_;
+    if (elapsed < channel.dotHops * 0.3f) {
+        return;  // Zaj tüske, nem elem
+    }
+
+    const bool isDash = elapsed > channel.dotHops * 2.0f;
+    const float dotEstimate = isDash ? elapsed / 3.0f : static_cast<float>(elapsed);
+    channel.dotHops = constrain(channel.dotHops * 0.75f + dotEstimate * 0.25f, MIN_DOT_HOPS, MAX_DOT_HOPS);
+
+    if (channel.codeLength < UINT8_MAX) {
+        channel.codeBits = static_cast<uint8_t>((channel.codeBits << 1) | (isDash ? 1 : 0));
+        channel.codeLength++;
+    }
+}
+
+/**
+ * @brief Az összegyűlt elemek karakterré alakítása és a szó pufferbe írása
+ */
+void CwSkimmer::finishCharacter(Channel &channel) {
+    using namespace CwSkimmerConstants;
+
+    if (channel.codeLength == 0) {
+        return;
+    }
+    char c = MorseCode::decode(channel.codeBits, channel.codeLength);
+    channel.codeBits = 0;
+    channel.codeLength = 0;
+    if (c == '\0') {
+        return;
+    }
+
+    if (channel.wordLength >= WORD_BUFFER_SIZE) {
+        flushWord(channel);  // Túl hosszú szó: darabokban adjuk ki
+    }
+    channel.word[channel.wordLength++] = c;
+}
+
+/**
+ * @brief A csatorna szavának kiadása a közös szöveg gyűrűbe, szóközzel lezárva
+ *
+ * A karakterek mellé a csatorna hangfrekvenciája és a becsült sebesség (WPM) kerül.
+ * Tele gyűrűnél a szó maradéka elveszik.
+ */
+void CwSkimmer::flushWord(Channel &channel) {
+    using namespace CwSkimmerConstants;
+
+    if (channel.wordLength == 0) {
+        return;
+    }
+    const uint16_t offsetHz = binToHz(channel.bin);
+    const float dotMs = channel.dotHops * HOP_SAMPLES * 1000.0f / (binWidthHz_ * FFT_SIZE);
+    const uint8_t wpm = static_cast<uint8_t>(constrain(1200.0f / dotMs + 0.5f, 1.0f, 255.0f));
+    for (uint8_t i = 0; i < channel.wordLength; i++) {
+        if (!decodedTextRing.push(DecodedTextSource::CwSkimmer, channel.word[i], offsetHz, wpm)) {
+            break;
+        }
+    }
+    decodedTextRing.push(DecodedTextSource::CwSkimmer, ' ', offsetHz, wpm);
+    channel.wordLength = 0;
+}
+
+/**
+ * @brief Az aktív csatornák száma
+ */
+uint8_t CwSkimmer::getActiveChannelCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CwSkimmerConstants::MAX_CHANNELS; i++) {
+        if (channels_[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Egy bin középfrekvenciája Hz-ben
+ */
+uint16_t CwSkimmer::binToHz(uint8_t bin) const { return static_cast<uint16_t>(bin * binWidthHz_ + 0.5f); }
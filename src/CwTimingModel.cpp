@@ -0,0 +1,239 @@
+#include "CwTimingModel.h"
+
+#include <Arduino.h>
+
+#include <cmath>
+
+/**
+ * @brief Konstruktor
+ * @param initialDot A kezdeti pont hossz (a névleges arányokkal ebből indul minden klaszter)
+ */
+CwTimingModel::CwTimingModel(float initialDot) : initialDot_(initialDot) { reset(); }
+
+/**
+ * @brief Vissza a kezdeti pont hosszra, a betanult klaszterek törlődnek
+ */
+void CwTimingModel::reset() {
+    using namespace CwTimingModelConstants;
+
+    dot_ = {initialDot_, 0};
+    dash_ = {initialDot_ * DASH_TO_DOT, 0};
+    elementGap_ = {initialDot_, 0};
+    charGap_ = {initialDot_ * CHAR_TO_ELEMENT_GAP, 0};
+    wordGap_ = {initialDot_ * CHAR_TO_ELEMENT_GAP * WORD_TO_CHAR_GAP, 0};
+    markRun_.count = 0;
+    gapRun_.count = 0;
+    updateThresholds();
+}
+
+/**
+ * @brief Egy mérés hozzáadása a klaszterhez
+ *
+ * Az első mérések átlagolnak (1/n súly), utána ADAPT_RATE súlyú exponenciális átlag,
+ * így egy újraindított klasztert az első mérés teljesen beállít.
+ */
+void CwTimingModel::learn(Cluster &cluster, float duration) {
+    const float rate = max(CwTimingModelConstants::ADAPT_RATE, 1.0f / (cluster.count + 1));
+    cluster.center += (duration - cluster.center) * rate;
+    if (cluster.count < UINT16_MAX) {
+        cluster.count++;
+    }
+}
+
+/**
+ * @brief Két szomszédos klaszter arányának ellenőrzése
+ * @param lower Az alsó klaszter
+ * @param upper A felső klaszter
+ * @param keepLower true: az alsót frissítettük, érvénytelen aránynál a felső pótlódik (és fordítva)
+ * @param nominalRatio A pótláshoz használt névleges arány
+ * @param minRatio Az érvényes arány alsó határa
+ * @param maxRatio Az érvényes arány felső határa
+ *
+ * Érvénytelen aránynál a két klaszter egybeolvadt (pl. csak pontok jöttek), vagy a sebesség
+ * megváltozott: a nem frissített klaszter a névleges arányra ugrik, és a következő mérés
+ * teljes súllyal tanítja.
+ */
+void CwTimingModel::enforceRatio(Cluster &lower, Cluster &upper, bool keepLower, float nominalRatio, float minRatio, float maxRatio) {
+    const float ratio = upper.center / lower.center;
+    if (ratio >= minRatio && ratio <= maxRatio) {
+        return;
+    }
+    if (keepLower) {
+        upper.center = lower.center * nominalRatio;
+        upper.count = 0;
+    } else {
+        lower.center = upper.center / nominalRatio;
+        lower.count = 0;
+    }
+}
+
+/**
+ * @brief A szünet klaszterek a pont klaszterhez kötése
+ *
+ * A jelek hossza megbízhatóbb a szüneteknél (egy zajos szünet két jelre esik szét): ha az
+ * elemköz vagy a karakterköz már nem illik a ponthoz, a pontból, a névleges arányokkal pótlódik.
+ * Ez egy holtpontot is felold: egy túl rövid karakterköz minden elemet külön karakterként zár
+ * le, így elemköz mérés sem jönne, ami javítaná.
+ */
+void CwTimingModel::anchorGapsToDot() {
+    using namespace CwTimingModelConstants;
+
+    const float ratio = elementGap_.center / dot_.center;
+    if (ratio < MIN_ELEMENT_GAP_TO_DOT || ratio > MAX_ELEMENT_GAP_TO_DOT) {
+        elementGap_ = {dot_.center, 0};
+        enforceRatio(elementGap_, charGap_, true, CHAR_TO_ELEMENT_GAP, MIN_CHAR_TO_ELEMENT_GAP, MAX_CHAR_TO_ELEMENT_GAP);
+    }
+    if (charGap_.center < dot_.center * MIN_CHAR_GAP_TO_DOT) {
+        charGap_ = {dot_.center * CHAR_TO_ELEMENT_GAP, 0};
+    }
+    enforceRatio(charGap_, wordGap_, true, WORD_TO_CHAR_GAP, MIN_WORD_TO_CHAR_GAP, MAX_WORD_TO_CHAR_GAP);
+}
+
+/**
+ * @brief A döntési küszöbök: a szomszédos klaszterek mértani közepei
+ */
+void CwTimingModel::updateThresholds() {
+    dashThreshold_ = sqrtf(dot_.center * dash_.center);
+    charGapThreshold_ = sqrtf(elementGap_.center * charGap_.center);
+    wordGapThreshold_ = sqrtf(charGap_.center * wordGap_.center);
+}
+
+/**
+ * @brief Egy mérés hozzáadása az azonos klaszterbe sorolt mérések futamához
+ * @param run A futam (más klaszterbe sorolt mérés újat kezd)
+ * @param cluster A mérés klaszterének sorszáma
+ * @param duration A mérés
+ * @return true ha a futam két klaszterre esik szét
+ *
+ * Sebességváltásnál a régi küszöbök mellett két szomszédos klaszter mérései egy klaszterbe
+ * kerülhetnek (gyorsulásnál pl. a vonások a pontok közé), a másik klaszter pedig nem frissül,
+ * így az arány ellenőrzés sem veszi észre. Egy ilyen futam leghosszabb és legrövidebb mérése
+ * viszont már két klaszter távolságára van egymástól.
+ */
+bool CwTimingModel::trackRun(Run &run, uint8_t cluster, float duration) {
+    using namespace CwTimingModelConstants;
+
+    if (run.count == 0 || run.cluster != cluster) {
+        run = {duration, duration, cluster, 1};
+        return false;
+    }
+    run.shortest = min(run.shortest, duration);
+    run.longest = max(run.longest, duration);
+    if (run.count < UINT8_MAX) {
+        run.count++;
+    }
+    return run.count >= SPLIT_RUN_LENGTH && run.longest >= run.shortest * SPLIT_RUN_RATIO;
+}
+
+/**
+ * @brief Egy szétesett futamból a két szomszédos klaszter újraindítása
+ */
+void CwTimingModel::splitRun(Cluster &lower, Cluster &upper, Run &run) {
+    lower = {run.shortest, 1};
+    upper = {run.longest, 1};
+    run.count = 0;
+}
+
+/**
+ * @brief Egy jel (kulcs lenyomva) hosszának tanítása
+ * @param duration A jel hossza
+ * @return true ha a jel vonás
+ */
+bool CwTimingModel::addMark(float duration) {
+    using namespace CwTimingModelConstants;
+
+    bool dash = isDash(duration);
+    if (trackRun(markRun_, dash ? 1 : 0, duration)) {
+        splitRun(dot_, dash_, markRun_);
+        dash = duration > sqrtf(dot_.center * dash_.center);
+    } else {
+        learn(dash ? dash_ : dot_, duration);
+        enforceRatio(dot_, dash_, !dash, DASH_TO_DOT, MIN_DASH_TO_DOT, MAX_DASH_TO_DOT);
+    }
+    anchorGapsToDot();
+    updateThresholds();
+    return dash;
+}
+
+/**
+ * @brief Egy szünet (két jel között) hosszának tanítása
+ * @param duration A szünet hossza
+ *
+ * A szóköz klaszternél jóval hosszabb szünet (adásszünet) nem tanít. A szóköz klaszternél
+ * kétszer hosszabb szünet viszont azt jelzi, hogy a szóköz klaszter a karakterközöket
+ * gyűjtötte (pl. Farnsworth adás nyújtott karakterközei): a szóköz klaszter karakterközzé lép
+ * elő, az új szóköz klaszter pedig ebből a szünetből indul.
+ */
+void CwTimingModel::addSpace(float duration) {
+    using namespace CwTimingModelConstants;
+
+    if (duration > wordGap_.center * MAX_LEARNED_GAP_TO_WORD_GAP) {
+        return;
+    }
+
+    if (duration > wordGap_.center * SPLIT_GAP_TO_WORD_GAP) {
+        gapRun_.count = 0;
+        charGap_ = wordGap_;
+        wordGap_ = {duration, 1};
+        enforceRatio(elementGap_, charGap_, false, CHAR_TO_ELEMENT_GAP, MIN_CHAR_TO_ELEMENT_GAP, MAX_CHAR_TO_ELEMENT_GAP);
+        enforceRatio(charGap_, wordGap_, false, WORD_TO_CHAR_GAP, MIN_WORD_TO_CHAR_GAP, MAX_WORD_TO_CHAR_GAP);
+    } else if (duration > wordGapThreshold_) {
+        if (trackRun(gapRun_, 2, duration)) {
+            splitRun(charGap_, wordGap_, gapRun_);
+        } else {
+            learn(wordGap_, duration);
+            enforceRatio(charGap_, wordGap_, false, WORD_TO_CHAR_GAP, MIN_WORD_TO_CHAR_GAP, MAX_WORD_TO_CHAR_GAP);
+        }
+        enforceRatio(elementGap_, charGap_, false, CHAR_TO_ELEMENT_GAP, MIN_CHAR_TO_ELEMENT_GAP, MAX_CHAR_TO_ELEMENT_GAP);
+    } else if (duration > charGapThreshold_) {
+        if (trackRun(gapRun_, 1, duration)) {
+            // A karakterköz klaszter futama a rövidebb szomszéddal (elemköz) vagy a hosszabbal (szóköz) keveredett
+            if (gapRun_.shortest < dot_.center * MIN_CHAR_GAP_TO_DOT) {
+                splitRun(elementGap_, charGap_, gapRun_);
+                enforceRatio(charGap_, wordGap_, true, WORD_TO_CHAR_GAP, MIN_WORD_TO_CHAR_GAP, MAX_WORD_TO_CHAR_GAP);
+            } else {
+                splitRun(charGap_, wordGap_, gapRun_);
+                enforceRatio(elementGap_, charGap_, false, CHAR_TO_ELEMENT_GAP, MIN_CHAR_TO_ELEMENT_GAP, MAX_CHAR_TO_ELEMENT_GAP);
+            }
+        } else {
+            learn(charGap_, duration);
+            enforceRatio(elementGap_, charGap_, false, CHAR_TO_ELEMENT_GAP, MIN_CHAR_TO_ELEMENT_GAP, MAX_CHAR_TO_ELEMENT_GAP);
+            enforceRatio(charGap_, wordGap_, true, WORD_TO_CHAR_GAP, MIN_WORD_TO_CHAR_GAP, MAX_WORD_TO_CHAR_GAP);
+        }
+    } else {
+        if (trackRun(gapRun_, 0, duration)) {
+            splitRun(elementGap_, charGap_, gapRun_);
+        } else {
+            learn(elementGap_, duration);
+        }
+        enforceRatio(elementGap_, charGap_, true, CHAR_TO_ELEMENT_GAP, MIN_CHAR_TO_ELEMENT_GAP, MAX_CHAR_TO_ELEMENT_GAP);
+        enforceRatio(charGap_, wordGap_, true, WORD_TO_CHAR_GAP, MIN_WORD_TO_CHAR_GAP, MAX_WORD_TO_CHAR_GAP);
+    }
+    anchorGapsToDot();
+    updateThresholds();
+}
+
+/**
+ * @brief A karakter sebesség WPM-ben
+ *
+ * Az egység a pont és a vonás együttes hosszának negyede (névlegesen 1 + 3 egység), így a
+ * kézi adás nehéz pontjai vagy rövid vonásai kevésbé torzítják.
+ */
+uint8_t CwTimingModel::getWpm() const {
+    const float unitMs = (dot_.center + dash_.center) / (1.0f + CwTimingModelConstants::DASH_TO_DOT);
+    return static_cast<uint8_t>(constrain(1200.0f / unitMs + 0.5f, 1.0f, 255.0f));
+}
+
+/**
+ * @brief A tényleges (Farnsworth) sebesség WPM-ben
+ *
+ * Egy PARIS szó hossza a mért egységgel és a mért karakter- és szóközökkel
+ * (31 egység jel és elemköz, 4 karakterköz, 1 szóköz). Szabályos adásnál megegyezik a getWpm()-mel.
+ */
+uint8_t CwTimingModel::getEffectiveWpm() const {
+    using namespace CwTimingModelConstants;
+
+    const float unitMs = (dot_.center + dash_.center) / (1.0f + DASH_TO_DOT);
+    const float wordMs = MARK_UNITS_PER_WORD * unitMs + CHAR_GAPS_PER_WORD * charGap_.center + wordGap_.center;
+    return static_cast<uint8_t>(constrain(60000.0f / wordMs + 0.5f, 1.0f, 255.0f));
+}
@@ -0,0 +1,91 @@
+#include "DecodedTextRing.h"
+
+#include <Arduino.h>
+#include <hardware/sync.h>  // __dmb()
+
+// A két mag közös példánya (statikus SRAM, mindkét magról elérhető)
+DecodedTextRing decodedTextRing;
+
+/**
+ * @brief Konstruktor
+ */
+DecodedTextRing::DecodedTextRing() : head_(0), tail_(0), droppedCount_(0) {}
+
+/**
+ * @brief Egy bejegyzés beírása (csak az író, Core1)
+ * @param entry A bejegyzés
+ * @return false, ha a gyűrű tele volt (a bejegyzés eldobódott)
+ */
+bool DecodedTextRing::push(const DecodedTextEntry &entry) {
+    using namespace DecodedTextRingConstants;
+
+    const uint32_t head = head_;
+    if (head - tail_ >= RING_SIZE) {
+        droppedCount_ = droppedCount_ + 1;
+        return false;
+    }
+
+    entries_[head & RING_MASK] = entry;
+    __dmb();  // A bejegyzés legyen kiírva, mielőtt az olvasó látja az új head-et
+    head_ = head + 1;
+    return true;
+}
+
+/**
+ * @brief Egy karakter beírása az aktuális időbélyeggel (csak az író, Core1)
+ * @param source A dekóder
+ * @param character A dekódolt karakter
+ * @param channelHz A csatorna frekvenciája
+ * @param speed WPM vagy baud
+ * @param confidence Megbízhatóság 0..100 (vagy CONFIDENCE_UNKNOWN)
+ * @return false, ha a gyűrű tele volt
+ */
+bool DecodedTextRing::push(DecodedTextSource source, char character, uint16_t channelHz, uint8_t speed, uint8_t confidence) {
+    DecodedTextEntry entry;
+    entry.timestampMs = millis();
+    entry.channelHz = channelHz;
+    entry.confidence = confidence;
+    entry.speed = speed;
+    entry.source = source;
+    entry.character = character;
+    return push(entry);
+}
+
+/**
+ * @brief Egy bejegyzés kivétele (csak az olvasó, Core0)
+ * @param entry Ide kerül a bejegyzés
+ * @return true ha volt bejegyzés
+ */
+bool DecodedTextRing::pop(DecodedTextEntry &entry) { return popMany(&entry, 1) == 1; }
+
+/**
+ * @brief Több bejegyzés kivétele egyszerre (csak az olvasó, Core0)
+ * @param entries Cél tömb
+ * @param maxCount A cél tömb mérete
+ * @return A kivett bejegyzések száma
+ */
+uint16_t DecodedTextRing::popMany(DecodedTextEntry *entries, uint16_t maxCount) {
+    using namespace DecodedTextRingConstants;
+
+    const uint32_t tail = tail_;
+    uint32_t count = head_ - tail;
+    if (count == 0) {
+        return 0;
+    }
+    if (count > maxCount) {
+        count = maxCount;
+    }
+
+    __dmb();  // A head_ olvasása után olvassuk a bejegyzéseket
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i] = entries_[(tail + i) & RING_MASK];
+    }
+    __dmb();  // A bejegyzések kiolvasva, mielőtt az író felülírhatja őket
+    tail_ = tail + count;
+    return static_cast<uint16_t>(count);
+}
+
+/**
+ * @brief Az összes várakozó bejegyzés eldobása (csak az olvasó)
+ */
+void DecodedTextRing::clear() { tail_ = head_; }
@@ -3,6 +3,7 @@
 #include "FrequencyInputDialog.h"
 #include "PicoSensorUtils.h"
 #include "StationStore.h"  // Hiányzó include hozzáadása
+#include "TftDmaPipeline.h"
 #include "ValueChangeDialog.h"
 
 namespace DisplayConstants {
@@ -1135,6 +1136,9 @@ bool DisplayBase::loop(RotaryEncoder::EncoderState encoderState) {
     // Az ős loop hívása a squelch kezelésére
     Si4735Utils::loop();
 
+    // Kerítés: az előző kör DMA képkockájának le kell mennie, mielőtt bármi a TFT-hez (vagy az SPI buszon lévő touch-hoz) nyúl
+    tftDma.waitForFrame();
+
     // Csak rádió módban (AM/FM) mérjük a szenzorokat és ha nincs aktív dialóg
     DisplayType displayType = this->getDisplayType();
     if (!pDialog and (displayType == DisplayBase::DisplayType::fm or displayType == DisplayBase::DisplayType::am)) {
@@ -1227,6 +1231,9 @@ bool DisplayBase::loop(RotaryEncoder::EncoderState encoderState) {
     } else {
         // Semmilyen touch esemény nem volt, meghívjuk a képernyő loop-ját
         this->displayLoop();
+
+        // A kör beküldött képkockája (sprite/sor) DMA-val megy ki, amíg a fő loop a többi dolgát végzi
+        tftDma.startPendingFrame();
     }
 
     return touched;
@@ -0,0 +1,214 @@
+#include "DspScheduler.h"
+
+#include <Arduino.h>  // micros()
+#include <string.h>
+
+#include "defines.h"
+
+// Ütemező működés debug engedélyezése de csak DEBUG módban
+#ifdef nem__DEBUG
+#define SCHEDULER_DEBUG(fmt, ...) DEBUG(fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define SCHEDULER_DEBUG(fmt, ...)  // Üres makró, ha __DEBUG nincs definiálva
+#endif
+
+// A Core1 ütemezője (statikus SRAM, a statisztikát a Core0 is olvassa)
+DspScheduler dspScheduler;
+
+/**
+ * @brief Konstruktor
+ */
+DspScheduler::DspScheduler() {
+    memset(slots_, 0, sizeof(slots_));
+    for (uint8_t i = 0; i < DspSchedulerConstants::MAX_TASKS; i++) {
+        stats_[i].name = nullptr;
+        stats_[i].loadPermille = 0;
+        stats_[i].averageRunUs = 0;
+        stats_[i].maxRunUs = 0;
+        stats_[i].maxLatenessUs = 0;
+        stats_[i].shedCount = 0;
+        stats_[i].deadlineMisses = 0;
+    }
+}
+
+/**
+ * @brief Feladat hozzáadása (csak a Core1 hívja)
+ * @param task A feladat (a hívó birtokolja, az eltávolításáig élnie kell)
+ * @return false ha nincs szabad hely
+ */
+bool DspScheduler::addTask(IDspTask *task) {
+    using namespace DspSchedulerConstants;
+
+    if (task == nullptr) {
+        return false;
+    }
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        if (slots_[i].task != nullptr) {
+            continue;
+        }
+        memset(&slots_[i], 0, sizeof(TaskSlot));
+        slots_[i].task = task;
+
+        DspTaskStats &stats = stats_[i];
+        stats.loadPermille = 0;
+        stats.averageRunUs = 0;
+        stats.maxRunUs = 0;
+        stats.maxLatenessUs = 0;
+        stats.shedCount = 0;
+        stats.deadlineMisses = 0;
+        stats.name = task->getTaskName();  // Utoljára: a Core0 a névből látja, hogy a hely foglalt
+
+        SCHEDULER_DEBUG("DspScheduler: '%s' hozzáadva (%u. hely)\n", task->getTaskName(), i);
+        return true;
+    }
+    DEBUG("DspScheduler: Nincs szabad hely a '%s' feladatnak!\n", task->getTaskName());
+    return false;
+}
+
+/**
+ * @brief Feladat eltávolítása (csak a Core1 hívja, a feladat törlése előtt)
+ * @param task A feladat
+ */
+void DspScheduler::removeTask(IDspTask *task) {
+    for (uint8_t i = 0; i < DspSchedulerConstants::MAX_TASKS; i++) {
+        if (slots_[i].task == task && task != nullptr) {
+            slots_[i].task = nullptr;
+            stats_[i].name = nullptr;
+            stats_[i].loadPermille = 0;
+        }
+    }
+}
+
+/**
+ * @brief Egy feladat bemenetének lekérdezése, a várt elkészülési idő nyilvántartása
+ * @return Mikroszekundum a kész bemenetig (0 = kész)
+ */
+uint32_t DspScheduler::pollSlot(TaskSlot &slot, uint32_t nowUs) {
+    const uint32_t untilReadyUs = slot.task->getMicrosUntilReady();
+    if (untilReadyUs == UINT32_MAX) {
+        slot.readyAtValid = false;  // Nincs bemenet (pl. nem fut a busz)
+    } else if (untilReadyUs > 0 || !slot.readyAtValid) {
+        // Ha már korábban készre jósoltuk, az a jóslat marad: a késést attól mérjük
+        slot.readyAtUs = nowUs + untilReadyUs;
+        slot.readyAtValid = true;
+    }
+    return untilReadyUs;
+}
+
+/**
+ * @brief Egy kész feladat futtatása, a futási idő és a késés mérése
+ */
+void DspScheduler::runSlot(TaskSlot &slot, DspTaskStats &stats) {
+    using namespace DspSchedulerConstants;
+
+    const uint32_t startUs = micros();
+    if (slot.readyAtValid && static_cast<int32_t>(startUs - slot.readyAtUs) > 0) {
+        const uint32_t lateUs = startUs - slot.readyAtUs;
+        if (lateUs > slot.windowMaxLateUs) {
+            slot.windowMaxLateUs = lateUs;
+        }
+        if (lateUs > slot.task->getDeadlineUs()) {
+            stats.deadlineMisses = stats.deadlineMisses + 1;
+        }
+    }
+    slot.readyAtValid = false;
+
+    slot.task->runTask();
+
+    const uint32_t runUs = micros() - startUs;
+    slot.windowBusyUs += runUs;
+    if (runUs > slot.windowMaxRunUs) {
+        slot.windowMaxRunUs = runUs;
+    }
+    // Mozgó átlag egész aritmetikával: avg += (run - avg) / 2^shift (az első futás közvetlenül beállítja)
+    if (slot.averageRunUs == 0) {
+        slot.averageRunUs = runUs;
+    } else {
+        slot.averageRunUs = slot.averageRunUs + ((static_cast<int32_t>(runUs) - static_cast<int32_t>(slot.averageRunUs)) >> RUN_TIME_EMA_SHIFT);
+    }
+}
+
+/**
+ * @brief Egy ütemezési kör: a kész feladatok futtatása
+ * @return Mikroszekundum a következő kész bemenetig (ennyit alhat a Core1), UINT32_MAX ha nincs feladat
+ *
+ * 1. A kész Realtime feladatok futnak (a sorrendjük a hozzáadás sorrendje).
+ * 2. A tartalék a legközelebbi Realtime határidőig: min(elkészülés + határidő).
+ * 3. Egy kész Background feladat csak akkor fut, ha az átlagos futási ideje belefér a tartalékba,
+ *    különben kimarad; a kimaradt feladat miatt nem ébredünk azonnal újra.
+ */
+uint32_t DspScheduler::runReadyTasks() {
+    using namespace DspSchedulerConstants;
+
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        TaskSlot &slot = slots_[i];
+        if (slot.task != nullptr && slot.task->getTaskPriority() == DspTaskPriority::Realtime && pollSlot(slot, micros()) == 0) {
+            runSlot(slot, stats_[i]);
+        }
+    }
+
+    uint32_t nextReadyUs = UINT32_MAX;
+    uint32_t slackUs = UINT32_MAX;
+    const uint32_t nowUs = micros();
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        TaskSlot &slot = slots_[i];
+        if (slot.task == nullptr || slot.task->getTaskPriority() != DspTaskPriority::Realtime) {
+            continue;
+        }
+        const uint32_t untilReadyUs = pollSlot(slot, nowUs);
+        if (untilReadyUs == UINT32_MAX) {
+            continue;
+        }
+        nextReadyUs = min(nextReadyUs, untilReadyUs);
+        const uint32_t deadlineUs = slot.task->getDeadlineUs();
+        slackUs = min(slackUs, untilReadyUs > UINT32_MAX - deadlineUs ? UINT32_MAX : untilReadyUs + deadlineUs);
+    }
+
+    for (uint8_t i = 0; i < MAX_TASKS; i++) {
+        TaskSlot &slot = slots_[i];
+        if (slot.task == nullptr || slot.task->getTaskPriority() != DspTaskPriority::Background) {
+            continue;
+        }
+        uint32_t untilReadyUs = pollSlot(slot, micros());
+        if (untilReadyUs == 0) {
+            if (slot.averageRunUs > slackUs) {
+                stats_[i].shedCount = stats_[i].shedCount + 1;  // Egy dekóder lekésné a határidejét
+                slot.readyAtValid = false;
+                continue;
+            }
+            runSlot(slot, stats_[i]);
+            slackUs = slackUs > slot.averageRunUs ? slackUs - slot.averageRunUs : 0;
+            untilReadyUs = pollSlot(slot, micros());
+        }
+        if (untilReadyUs > 0) {
+            nextReadyUs = min(nextReadyUs, untilReadyUs);
+        }
+    }
+
+    return nextReadyUs;
+}
+
+/**
+ * @brief A mérési ablak lezárása, a statisztika közzététele
+ * @param windowUs Az ablak hossza
+ */
+void DspScheduler::publishStats(uint32_t windowUs) {
+    if (windowUs == 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < DspSchedulerConstants::MAX_TASKS; i++) {
+        TaskSlot &slot = slots_[i];
+        if (slot.task == nullptr) {
+            continue;
+        }
+        DspTaskStats &stats = stats_[i];
+        stats.loadPermille = static_cast<uint16_t>(min(static_cast<uint64_t>(slot.windowBusyUs) * 1000 / windowUs, static_cast<uint64_t>(1000)));
+        stats.averageRunUs = slot.averageRunUs;
+        stats.maxRunUs = slot.windowMaxRunUs;
+        stats.maxLatenessUs = slot.windowMaxLateUs;
+
+        slot.windowBusyUs = 0;
+        slot.windowMaxRunUs = 0;
+        slot.windowMaxLateUs = 0;
+    }
+}
@@ -0,0 +1,145 @@
+#include "FftTables.h"
+
+#include "ConstexprMath.h"
+
+namespace {
+
+using ConstexprMath::toQ15;
+
+/**
+ * @brief Cosine-sum ablak együtthatói (w = a0 - a1*cos(x) + a2*cos(2x) - a3*cos(3x) + a4*cos(4x))
+ */
+struct WindowCoeffs {
+    double a0, a1, a2, a3, a4;
+};
+
+constexpr WindowCoeffs windowCoeffs(FftWindowType type) {
+    switch (type) {
+        case FftWindowType::Hann:
+            return {0.5, 0.5, 0.0, 0.0, 0.0};
+        case FftWindowType::BlackmanHarris:
+            return {0.35875, 0.48829, 0.14128, 0.01168, 0.0};
+        case FftWindowType::FlatTop:
+            return {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+        case FftWindowType::Hamming:
+        default:
+            return {0.54, 0.46, 0.0, 0.0, 0.0};
+    }
+}
+
+/**
+ * @brief Ablak érték az n. mintára (szimmetrikus ablak, N-1 nevezővel, mint az ArduinoFFT-nél)
+ */
+constexpr double windowValue(FftWindowType type, uint16_t n, uint16_t size) {
+    const WindowCoeffs c = windowCoeffs(type);
+    const double x = 2.0 * ConstexprMath::PI * n / (size - 1);
+    return c.a0 - c.a1 * ConstexprMath::cos(x) + c.a2 * ConstexprMath::cos(2.0 * x) - c.a3 * ConstexprMath::cos(3.0 * x) + c.a4 * ConstexprMath::cos(4.0 * x);
+}
+
+/**
+ * @brief Twiddle tábla a legnagyobb FFT mérethez
+ */
+struct TwiddleTable {
+    int16_t cosValues[FftTables::TWIDDLE_TABLE_SIZE];
+    int16_t sinValues[FftTables::TWIDDLE_TABLE_SIZE];
+
+    constexpr TwiddleTable() : cosValues(), sinValues() {
+        for (uint16_t k = 0; k < FftTables::TWIDDLE_TABLE_SIZE; k++) {
+            const double phase = 2.0 * ConstexprMath::PI * k / FftTables::MAX_TABLE_FFT_SIZE;
+            cosValues[k] = toQ15(ConstexprMath::cos(phase));
+            sinValues[k] = toQ15(ConstexprMath::sin(phase));
+        }
+    }
+};
+
+/**
+ * @brief Fél ablak tábla egy adott mérethez és típushoz
+ */
+template <uint16_t Size, FftWindowType Type>
+struct WindowTable {
+    int16_t values[Size / 2];
+
+    constexpr WindowTable() : values() {
+        for (uint16_t n = 0; n < Size / 2; n++) {
+            values[n] = toQ15(windowValue(Type, n, Size));
+        }
+    }
+};
+
+constexpr TwiddleTable TWIDDLES{};
+
+/**
+ * @brief Egy ablak típus összes méretének táblája
+ */
+template <FftWindowType Type>
+const int16_t *windowForSize(uint16_t fftSize) {
+    static constexpr WindowTable<64, Type> window64{};
+    static constexpr WindowTable<128, Type> window128{};
+    static constexpr WindowTable<256, Type> window256{};
+    static constexpr WindowTable<512, Type> window512{};
+    static constexpr WindowTable<1024, Type> window1024{};
+    static constexpr WindowTable<2048, Type> window2048{};
+
+    switch (fftSize) {
+        case 64:
+            return window64.values;
+        case 128:
+            return window128.values;
+        case 256:
+            return window256.values;
+        case 512:
+            return window512.values;
+        case 1024:
+            return window1024.values;
+        case 2048:
+            return window2048.values;
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace
+
+namespace FftTables {
+
+/**
+ * @brief cos(2*pi*k/MAX_TABLE_FFT_SIZE) Q15-ben
+ */
+const int16_t *getTwiddleCos() { return TWIDDLES.cosValues; }
+
+/**
+ * @brief sin(2*pi*k/MAX_TABLE_FFT_SIZE) Q15-ben
+ */
+const int16_t *getTwiddleSin() { return TWIDDLES.sinValues; }
+
+/**
+ * @brief Ablak tábla lekérdezése
+ * @param type Ablak típusa
+ * @param fftSize FFT méret
+ * @return Az ablak első fele Q15-ben, vagy nullptr, ha nincs ilyen méret
+ */
+const int16_t *getWindow(FftWindowType type, uint16_t fftSize) {
+    switch (type) {
+        case FftWindowType::Hann:
+            return windowForSize<FftWindowType::Hann>(fftSize);
+        case FftWindowType::BlackmanHarris:
+            return windowForSize<FftWindowType::BlackmanHarris>(fftSize);
+        case FftWindowType::FlatTop:
+            return windowForSize<FftWindowType::FlatTop>(fftSize);
+        case FftWindowType::Hamming:
+        default:
+            return windowForSize<FftWindowType::Hamming>(fftSize);
+    }
+}
+
+/**
+ * @brief Koherens erősítés korrekció a Hamming ablakhoz képest
+ * (a koherens erősítés a cosine-sum ablakok a0 együtthatója)
+ * @param type Ablak típusa
+ * @return Szorzó a Hamming ablak szintjére
+ */
+float getWindowGainCorrection(FftWindowType type) {
+    return static_cast<float>(windowCoeffs(FftWindowType::Hamming).a0 / windowCoeffs(type).a0);
+}
+
+};  // namespace FftTables
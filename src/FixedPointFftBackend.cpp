@@ -0,0 +1,348 @@
+#include "FixedPointFftBackend.h"
+
+#include "FftTables.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <new>
+
+/**
+ * @brief FixedPointFftBackend konstruktor
+ * @param realInputPacking true: N/2 pontos csomagolt transzformáció, false: teljes N pontos komplex FFT
+ */
+FixedPointFftBackend::FixedPointFftBackend(bool realInputPacking)
+    : re_(nullptr),
+      im_(nullptr),
+      twiddleCos_(FftTables::getTwiddleCos()),
+      twiddleSin_(FftTables::getTwiddleSin()),
+      window_(nullptr),
+      size_(0),
+      workSize_(0),
+      twiddleStride_(1),
+      windowType_(FftWindowType::Hamming),
+      windowGainCorrection_(1.0f),
+      realInputPacking_(realInputPacking),
+      blockExponent_(0) {}
+
+/**
+ * @brief FixedPointFftBackend destruktor
+ */
+FixedPointFftBackend::~FixedPointFftBackend() { deallocate(); }
+
+/**
+ * @brief Munkaterületek felszabadítása (a táblák a flash-ben vannak)
+ */
+void FixedPointFftBackend::deallocate() {
+    delete[] re_;
+    delete[] im_;
+    re_ = im_ = nullptr;
+    window_ = nullptr;
+    size_ = 0;
+    workSize_ = 0;
+}
+
+/**
+ * @brief FFT méret beállítása: munkaterület foglalás és a flash táblák kiválasztása
+ * @param size Az új FFT méret (2 hatványa, MIN_TABLE_FFT_SIZE..MAX_TABLE_FFT_SIZE)
+ * @return true ha sikeres
+ */
+bool FixedPointFftBackend::setSize(uint16_t size) {
+    const int16_t *window = FftTables::getWindow(windowType_, size);
+    if (window == nullptr) {
+        return false;  // Nem támogatott méret
+    }
+    if (size == size_) {
+        return true;
+    }
+
+    deallocate();
+    const uint16_t workSize = realInputPacking_ ? size / 2 : size;
+    re_ = new (std::nothrow) int16_t[workSize];
+    im_ = new (std::nothrow) int16_t[workSize];
+    if (!re_ || !im_) {
+        deallocate();
+        return false;
+    }
+
+    window_ = window;
+    twiddleStride_ = FftTables::getTwiddleStride(size);
+    size_ = size;
+    workSize_ = workSize;
+    return true;
+}
+
+/**
+ * @brief Ablakfüggvény kiválasztása (csak tábla pointer csere)
+ * @param type Az ablak típusa
+ */
+void FixedPointFftBackend::setWindowType(FftWindowType type) {
+    windowType_ = type;
+    windowGainCorrection_ = FftTables::getWindowGainCorrection(type);
+    if (size_ != 0) {
+        window_ = FftTables::getWindow(type, size_);
+    }
+}
+
+/**
+ * @brief Ablakozás, FFT és magnitúdó számítás
+ * @param samples N darab bemeneti minta
+ * @param magnitudes N/2 elemű kimeneti tömb
+ */
+void FixedPointFftBackend::computeMagnitudes(const int16_t *samples, float *magnitudes) {
+    if (size_ == 0) {
+        return;
+    }
+
+    loadWindowed(samples);
+    bitReverse();
+    transform();
+
+    if (realInputPacking_) {
+        computePackedMagnitudes(magnitudes);
+        return;
+    }
+
+    // Magnitúdók: a négyzetösszeg 32 biten pontos, a kitevőt a végén alkalmazzuk
+    float scale = ldexpf(windowGainCorrection_, blockExponent_);
+    for (uint16_t k = 0; k < size_ / 2; k++) {
+        int32_t r = re_[k];
+        int32_t i = im_[k];
+        uint32_t power = static_cast<uint32_t>(r * r) + static_cast<uint32_t>(i * i);
+        magnitudes[k] = sqrtf(static_cast<float>(power)) * scale;
+    }
+}
+
+/**
+ * @brief Komplex bemenet ablakozása, FFT és magnitúdó számítás
+ * @param re N darab valós rész
+ * @param im N darab képzetes rész
+ * @param magnitudes N elemű kimeneti tömb (FFT sorrend)
+ * @return true ha sikeres
+ */
+bool FixedPointFftBackend::computeComplexMagnitudes(const int16_t *re, const int16_t *im, float *magnitudes) {
+    if (size_ == 0 || realInputPacking_) {
+        return false;
+    }
+
+    loadWindowedComplex(re, im);
+    bitReverse();
+    transform();
+
+    float scale = ldexpf(windowGainCorrection_, blockExponent_);
+    for (uint16_t k = 0; k < size_; k++) {
+        int32_t r = re_[k];
+        int32_t i = im_[k];
+        uint32_t power = static_cast<uint32_t>(r * r) + static_cast<uint32_t>(i * i);
+        magnitudes[k] = sqrtf(static_cast<float>(power)) * scale;
+    }
+    return true;
+}
+
+/**
+ * @brief Bemenet betöltése a Hamming ablakkal szorozva
+ *
+ * Kis jeleknél az ablakozás előtt balra toljuk a mintákat, hogy a Q15 szorzás
+ * ne vesszen el a kerekítésben (a tolás a blokk kitevőben jelenik meg).
+ * Csomagolt módban a páros minták a valós, a páratlanok a képzetes részbe kerülnek.
+ * @param samples N darab bemeneti minta
+ */
+void FixedPointFftBackend::loadWindowed(const int16_t *samples) {
+    using namespace FixedPointFftConstants;
+
+    int32_t maxAbs = 0;
+    for (uint16_t i = 0; i < size_; i++) {
+        int32_t v = samples[i] < 0 ? -samples[i] : samples[i];
+        if (v > maxAbs) maxAbs = v;
+    }
+    uint8_t shift = 0;
+    while (maxAbs > 0 && (maxAbs << (shift + 1)) <= Q15_ONE) {
+        shift++;
+    }
+
+    const int32_t gain = 1 << shift;
+    const int32_t round = 1 << (Q15_SHIFT - 1);
+    const uint16_t half = size_ / 2;
+    blockExponent_ = -static_cast<int8_t>(shift);
+
+    if (realInputPacking_) {
+        for (uint16_t n = 0; n < half; n++) {
+            const uint16_t even = 2 * n;
+            const uint16_t odd = even + 1;
+            const int32_t wEven = window_[even < half ? even : size_ - 1 - even];
+            const int32_t wOdd = window_[odd < half ? odd : size_ - 1 - odd];
+            re_[n] = static_cast<int16_t>((samples[even] * gain * wEven + round) >> Q15_SHIFT);
+            im_[n] = static_cast<int16_t>((samples[odd] * gain * wOdd + round) >> Q15_SHIFT);
+        }
+        return;
+    }
+
+    for (uint16_t i = 0; i < half; i++) {
+        int32_t w = window_[i];
+        re_[i] = static_cast<int16_t>((samples[i] * gain * w + round) >> Q15_SHIFT);
+        re_[size_ - 1 - i] = static_cast<int16_t>((samples[size_ - 1 - i] * gain * w + round) >> Q15_SHIFT);
+    }
+    memset(im_, 0, size_ * sizeof(int16_t));
+}
+
+/**
+ * @brief Komplex bemenet betöltése ablakozva (ugyanaz a normalizáló tolás, mint a valós esetben)
+ * @param re N darab valós rész
+ * @param im N darab képzetes rész
+ */
+void FixedPointFftBackend::loadWindowedComplex(const int16_t *re, const int16_t *im) {
+    using namespace FixedPointFftConstants;
+
+    int32_t maxAbs = 0;
+    for (uint16_t i = 0; i < size_; i++) {
+        int32_t r = re[i] < 0 ? -re[i] : re[i];
+        int32_t m = im[i] < 0 ? -im[i] : im[i];
+        if (r > maxAbs) maxAbs = r;
+        if (m > maxAbs) maxAbs = m;
+    }
+    uint8_t shift = 0;
+    while (maxAbs > 0 && (maxAbs << (shift + 1)) <= Q15_ONE) {
+        shift++;
+    }
+
+    const int32_t gain = 1 << shift;
+    const int32_t round = 1 << (Q15_SHIFT - 1);
+    blockExponent_ = -static_cast<int8_t>(shift);
+
+    for (uint16_t i = 0; i < size_ / 2; i++) {
+        const int32_t w = window_[i];
+        const uint16_t mirror = size_ - 1 - i;
+        re_[i] = static_cast<int16_t>((re[i] * gain * w + round) >> Q15_SHIFT);
+        im_[i] = static_cast<int16_t>((im[i] * gain * w + round) >> Q15_SHIFT);
+        re_[mirror] = static_cast<int16_t>((re[mirror] * gain * w + round) >> Q15_SHIFT);
+        im_[mirror] = static_cast<int16_t>((im[mirror] * gain * w + round) >> Q15_SHIFT);
+    }
+}
+
+/**
+ * @brief Bit-fordított sorrendbe rendezés (helyben)
+ */
+void FixedPointFftBackend::bitReverse() {
+    for (uint16_t i = 1, j = 0; i < workSize_; i++) {
+        uint16_t bit = workSize_ >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int16_t tmp = re_[i];
+            re_[i] = re_[j];
+            re_[j] = tmp;
+            tmp = im_[i];
+            im_[i] = im_[j];
+            im_[j] = tmp;
+        }
+    }
+}
+
+/**
+ * @brief Blokk skálázás egy fokozat előtt
+ *
+ * Ha a legnagyobb érték túllépné a pillangó határt, annyi bittel tolunk jobbra,
+ * amennyi szükséges. A kitevő követi a tolást.
+ */
+void FixedPointFftBackend::rescaleBlock() {
+    using namespace FixedPointFftConstants;
+
+    int32_t maxAbs = 0;
+    for (uint16_t i = 0; i < workSize_; i++) {
+        int32_t r = re_[i] < 0 ? -re_[i] : re_[i];
+        int32_t m = im_[i] < 0 ? -im_[i] : im_[i];
+        if (r > maxAbs) maxAbs = r;
+        if (m > maxAbs) maxAbs = m;
+    }
+
+    if (maxAbs > BUTTERFLY_INPUT_LIMIT) {
+        uint8_t shift = 0;
+        while ((maxAbs >> shift) > BUTTERFLY_INPUT_LIMIT) {
+            shift++;
+        }
+        const int32_t round = 1 << (shift - 1);
+        for (uint16_t i = 0; i < workSize_; i++) {
+            re_[i] = static_cast<int16_t>((re_[i] + round) >> shift);
+            im_[i] = static_cast<int16_t>((im_[i] + round) >> shift);
+        }
+        blockExponent_ += shift;
+    }
+}
+
+/**
+ * @brief Radix-2 decimation-in-time FFT (a bemenet már bit-fordított sorrendben)
+ *
+ * A twiddle tábla a legnagyobb FFT méretre szól, a lépésköz az első fokozatnál
+ * a tábla mérete, és fokozatonként feleződik (csomagolt módban ez az N/2 pontos
+ * transzformációnak megfelelő kétszeres lépésköz).
+ */
+void FixedPointFftBackend::transform() {
+    using namespace FixedPointFftConstants;
+
+    for (uint16_t span = 1, twiddleStep = FftTables::TWIDDLE_TABLE_SIZE; span < workSize_; span <<= 1, twiddleStep >>= 1) {
+        rescaleBlock();
+
+        for (uint16_t group = 0; group < workSize_; group += span * 2) {
+            for (uint16_t k = 0; k < span; k++) {
+                const int32_t wr = twiddleCos_[k * twiddleStep];
+                const int32_t ws = twiddleSin_[k * twiddleStep];
+                const uint16_t a = group + k;
+                const uint16_t b = a + span;
+
+                // t = x[b] * e^(-j*phase)
+                const int32_t tr = (re_[b] * wr + im_[b] * ws + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
+                const int32_t ti = (im_[b] * wr - re_[b] * ws + (1 << (Q15_SHIFT - 1))) >> Q15_SHIFT;
+
+                re_[b] = static_cast<int16_t>(re_[a] - tr);
+                im_[b] = static_cast<int16_t>(im_[a] - ti);
+                re_[a] = static_cast<int16_t>(re_[a] + tr);
+                im_[a] = static_cast<int16_t>(im_[a] + ti);
+            }
+        }
+    }
+}
+
+/**
+ * @brief A csomagolt N/2 pontos transzformációból az N pontos valós spektrum magnitúdói
+ *
+ * Z[k] = FFT(x[2n] + j*x[2n+1]) esetén
+ *   X[k] = (Z[k] + Z*[M-k]) / 2 + W^k * (Z[k] - Z*[M-k]) / 2j,   W = e^(-j*2*pi/N), M = N/2
+ * A 2*X[k]-t számoljuk egészben (a felezést a kitevő kapja), a blokk előzetes
+ * skálázása miatt a négyzetösszeg elfér 32 biten.
+ * @param magnitudes N/2 elemű kimeneti tömb
+ */
+void FixedPointFftBackend::computePackedMagnitudes(float *magnitudes) {
+    using namespace FixedPointFftConstants;
+
+    rescaleBlock();
+
+    const float scale = ldexpf(windowGainCorrection_, blockExponent_ - 1);
+    const int32_t round = 1 << (Q15_SHIFT - 1);
+    for (uint16_t k = 0; k < workSize_; k++) {
+        const uint16_t mirror = (workSize_ - k) & (workSize_ - 1);
+        const int32_t a = re_[k];
+        const int32_t b = im_[k];
+        const int32_t c = re_[mirror];
+        const int32_t d = im_[mirror];
+
+        // 2*E = Z[k] + Z*[M-k], 2*O = (Z[k] - Z*[M-k]) / j
+        const int32_t evenRe = a + c;
+        const int32_t evenIm = b - d;
+        const int32_t oddRe = b + d;
+        const int32_t oddIm = c - a;
+
+        // W^k * 2*O
+        const int32_t wr = twiddleCos_[k * twiddleStride_];
+        const int32_t ws = twiddleSin_[k * twiddleStride_];
+        const int32_t rotRe = (oddRe * wr + oddIm * ws + round) >> Q15_SHIFT;
+        const int32_t rotIm = (oddIm * wr - oddRe * ws + round) >> Q15_SHIFT;
+
+        const int32_t xr = evenRe + rotRe;
+        const int32_t xi = evenIm + rotIm;
+        const uint32_t absRe = static_cast<uint32_t>(xr < 0 ? -xr : xr);
+        const uint32_t absIm = static_cast<uint32_t>(xi < 0 ? -xi : xi);
+        magnitudes[k] = sqrtf(static_cast<float>(absRe * absRe + absIm * absIm)) * scale;
+    }
+}
@@ -147,6 +147,7 @@ void FmDisplay::drawScreen() {
 
     // Frekvencia
     float currFreq = currentBand.varData.currFreq;  // A Rotary változtatásakor már eltettük a Band táblába
+    pSevenSegmentFreq->invalidate();                 // A képernyőt töröltük, a frekvencia teljesen újrarajzolandó
     pSevenSegmentFreq->freqDispl(currFreq);
 
     // Gombok kirajzolása
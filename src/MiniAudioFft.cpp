@@ -2,7 +2,10 @@
 
 #include <cmath>  // std::round, std::max, std::min, std::abs
 
-#include "Config.h"  // Szükséges a config.data eléréséhez
+#include "AdcDmaSampler.h"  // A közös minta busz a zoom FFT-hez
+#include "Config.h"        // Szükséges a config.data eléréséhez
+#include "TftDmaPipeline.h"
+#include "WaterfallPalette.h"
 #include "rtVars.h"  // rtv::muteStat eléréséhez
 
 // Konstans a módkijelző láthatósági idejéhez (ms)
@@ -10,6 +13,13 @@ constexpr uint32_t MODE_INDICATOR_TIMEOUT_MS = 20000;  // 20 másodperc
 
 #define NUM_BINS(maxX, minX) std::max(1, maxX - minX + 1)
 
+namespace {
+
+// A wabuf bájtjainak színe (a WATERFALL_COLORS lépcsői, WF_GRADIENT szerint telítve), a flash-ben
+constexpr WaterfallPalette<16> WATERFALL_PALETTE(MiniAudioFftConstants::WATERFALL_COLORS, MiniAudioFftConstants::WATERFALL_PALETTE_FULL_SCALE);
+
+}  // namespace
+
 /**
  * @brief A MiniAudioFft komponens konstruktora.
  *
@@ -46,16 +56,22 @@ MiniAudioFft::MiniAudioFft(TFT_eSPI& tft, int x, int y, int w, int h, float conf
       indicatorFontHeight_(0),                            // Inicializálás
       currentTuningAidType_(TuningAidType::OFF_DECODER),  // Alapértelmezetten OFF_DECODER
       pAudioProcessor(nullptr),                           // Inicializáljuk nullptr-rel
+      pZoomFft(nullptr),                                  // Csak TuningAid módban jön létre
+      lineBuf_(nullptr),                                  // A méretek ellenőrzése után foglaljuk
       sprGraph(&tft),                                     // Sprite inicializálása a TFT referenciával
       spriteCreated(false) {
 
     // A mintavételezési frekvencia kétszerese, mert a nyers adatokat kétszer kell feldolgozni
     pAudioProcessor = new AudioProcessor(activeFftGainConfigRef, AUDIO_INPUT_PIN, configuredMaxDisplayAudioFreq * 2.0f, AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
+    if (pAudioProcessor) {
+        pAudioProcessor->startCore1Processing();  // A mintavétel és az FFT a Core1-en fut, a loop() csak rajzol
+    }
 
-    // A `wabuf` (vízesés és burkológörbe buffer) inicializálása a komponens tényleges méreteivel.
-    // Biztosítjuk, hogy a magasság és szélesség pozitív legyen az átméretezés előtt.
+    // A `wabuf` (vízesés és burkológörbe előzmény) tárának lefoglalása a komponens tényleges méreteivel.
+    // Minden mód ebben a width * height bájtos tárban rendezi át az alakját, módváltáskor nincs foglalás.
     if (this->height > 0 && this->width > 0) {
-        wabuf.resize(this->height, std::vector<uint8_t>(this->width, 0));
+        wabuf.reshape(this->height, this->width);
+        lineBuf_ = new (std::nothrow) uint16_t[std::max(this->width, this->height)];
     } else {
         DEBUG("MiniAudioFft: Invalid dimensions w=%d, h=%d\n", this->width, this->height);
     }
@@ -75,12 +91,17 @@ MiniAudioFft::MiniAudioFft(TFT_eSPI& tft, int x, int y, int w, int h, float conf
  */
 MiniAudioFft::~MiniAudioFft() {
     if (spriteCreated) {
+        tftDma.waitForFrame();  // A sprite lehet még a levegőben
         sprGraph.deleteSprite();
     }
     if (pAudioProcessor) {
         delete pAudioProcessor;
         pAudioProcessor = nullptr;
     }
+    delete pZoomFft;
+    pZoomFft = nullptr;
+    delete[] lineBuf_;
+    lineBuf_ = nullptr;
 }
 
 /**
@@ -99,16 +120,37 @@ void MiniAudioFft::setInitialMode(DisplayMode mode) {
         setTuningAidType(currentTuningAidType_);
     }
 
+    resetHistoryForMode(currentMode);
     manageSpriteForMode(currentMode);  // Sprite előkészítése a kezdeti módhoz
     forceRedraw();                     // Ez gondoskodik a clearArea-ról és a drawModeIndicator-ról
 }
 
+/**
+ * @brief Az előzmény (wabuf) alakjának beállítása és törlése a módhoz.
+ * @param mode A mód, amelyhez az előzményt elő kell készíteni.
+ *
+ * Waterfall/Envelope: egy szelet egy oszlop (height bin), width szelet (időben balra lép).
+ * TuningAid: egy szelet egy sor (width pixel oszlop), height szelet (időben lefelé lép).
+ * Mindkét alak ugyanabba a tárba fér, így módváltáskor nincs új foglalás.
+ */
+void MiniAudioFft::resetHistoryForMode(DisplayMode mode) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    if (mode == DisplayMode::Waterfall || mode == DisplayMode::Envelope) {
+        wabuf.reshape(height, width);
+    } else if (mode == DisplayMode::TuningAid) {
+        wabuf.reshape(width, height);
+    }
+}
+
 /**
  * @brief Kezeli a sprite létrehozását/törlését a megadott módhoz.
  * @param modeToPrepareFor Az a mód, amelyhez a sprite-ot elő kell készíteni.
  */
 void MiniAudioFft::manageSpriteForMode(DisplayMode modeToPrepareFor) {
-    if (spriteCreated) {  // Ha létezik sprite egy korábbi módból
+    if (spriteCreated) {        // Ha létezik sprite egy korábbi módból
+        tftDma.waitForFrame();  // A sprite lehet még a levegőben
         sprGraph.deleteSprite();
         spriteCreated = false;
     }
@@ -163,10 +205,7 @@ void MiniAudioFft::cycleMode() {
         memset(Rpeak, 0, sizeof(Rpeak));
     }
 
-    if (currentMode == DisplayMode::Waterfall || currentMode == DisplayMode::Envelope || currentMode == DisplayMode::TuningAid ||  // TuningAid is használja a wabuf-ot
-        (currentMode < DisplayMode::Waterfall && !wabuf.empty() && !wabuf[0].empty() && wabuf[0][0] != 0)) {                       // Ha korábbi módból váltunk, ami nem használta
-        for (auto& row : wabuf) std::fill(row.begin(), row.end(), 0);
-    }
+    resetHistoryForMode(currentMode);  // Waterfall, Envelope és TuningAid: üres előzmény az új alakban
 
     if (currentMode == DisplayMode::Envelope || (currentMode != DisplayMode::Envelope && envelope_prev_smoothed_max_val != 0.0f)) {
         envelope_prev_smoothed_max_val = 0.0f;  // Envelope simítási előzmény nullázása
@@ -381,14 +420,24 @@ void MiniAudioFft::loop() {
     // --- Csak akkor jutunk ide, ha nincs némítás, a mód nem "Off", és nem volt állapotváltozás miatti forceRedraw ---
 
     // Csak akkor végezzük el, ha a kijelzési mód nem Off
+    bool newFrame = false;
     if (currentMode != DisplayMode::Off) {
 
-        // Ellenőrizzük, hogy a pAudioProcessor létezik-e
-        if (pAudioProcessor) {
-            pAudioProcessor->process(currentMode == DisplayMode::Oscilloscope);
+        // A hangolássegéd a saját zoom FFT-jét használja, a többi mód a teljes sávú feldolgozót
+        if (currentMode == DisplayMode::TuningAid) {
+            if (pZoomFft) {
+                newFrame = pZoomFft->process();  // Csak új zoom spektrumnál görgetünk
+            }
+        } else if (pAudioProcessor) {
+            newFrame = pAudioProcessor->process(currentMode == DisplayMode::Oscilloscope);
         }
     }
 
+    // Csak új képkockánál rajzolunk: a vízesés és a burkológörbe különben ismételt sorokkal görgetne
+    if (!newFrame) {
+        return;
+    }
+
     // Grafikonok kirajzolása a nekik szánt (csökkentett) területre
     // Ezek a függvények a `posY`-tól `posY + getGraphHeight() - 1`-ig rajzolnak.
     // A `getGraphHeight()` mindig a grafikon magasságát adja vissza, a módkijelző sávja nélkül.
@@ -526,12 +575,19 @@ void MiniAudioFft::forceRedraw() {
 
         if (activeFftGainConfigRef != -1.0f) {  // Csak akkor végezzük el az FFT-t és a rajzolást, ha nincs letiltva
 
-            // TuningAid mód használja a nagy felbontású processort, minden más a standard processort
-            if (currentMode == DisplayMode::TuningAid) {
+            // Ablakfüggvény a módhoz: a vízesés és a hangolássegéd a Blackman-Harris alacsony oldalsávjait igényli,
+            // a spektrum módok maradnak a Hamming ablaknál (a szintek a Hamming erősítésére normáltak)
+            if (pAudioProcessor) {
+                bool lowSidelobeMode = currentMode == DisplayMode::Waterfall || currentMode == DisplayMode::TuningAid;
+                pAudioProcessor->setWindowType(lowSidelobeMode ? FftWindowType::BlackmanHarris : FftWindowType::Hamming);
+            }
 
-                // TuningAid mód: nagy felbontású FFT feldolgozás - Átkapcsolunk ha nem abban vagyunk
-                if (pAudioProcessor && pAudioProcessor->getFftSize() != AudioProcessorConstants::HIGH_RES_FFT_SAMPLES) {
-                    pAudioProcessor->setFftSize(AudioProcessorConstants::HIGH_RES_FFT_SAMPLES);
+            // TuningAid mód a zoom FFT-t használja, minden más a standard processort
+            updateZoomFft();
+            bool newFrame = false;
+            if (currentMode == DisplayMode::TuningAid) {
+                if (pZoomFft) {
+                    newFrame = pZoomFft->process();
                 }
 
             } else {
@@ -540,32 +596,36 @@ void MiniAudioFft::forceRedraw() {
                     pAudioProcessor->setFftSize(AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
                 }
 
+                // Core1 módban a képkocka még készülhet, a UI nem vár rá
                 if (pAudioProcessor) {
-                    pAudioProcessor->process(currentMode == DisplayMode::Oscilloscope);
+                    newFrame = pAudioProcessor->process(currentMode == DisplayMode::Oscilloscope);
                 }
             }
 
-            switch (currentMode) {
-                case DisplayMode::SpectrumLowRes:
-                    drawSpectrumLowRes();
-                    break;
-                case DisplayMode::SpectrumHighRes:
-                    drawSpectrumHighRes();
-                    break;
-                case DisplayMode::Oscilloscope:
-                    drawOscilloscope();
-                    break;
-                case DisplayMode::Waterfall:
-                    drawWaterfall();
-                    break;
-                case DisplayMode::Envelope:
-                    drawEnvelope();
-                    break;
-                case DisplayMode::TuningAid:
-                    drawTuningAid();
-                    break;
-                default:
-                    break;  // DisplayMode::Off itt nem fordulhat elő az else ág miatt
+            // Csak új képkockánál rajzolunk grafikont, a módkijelző enélkül is kikerül
+            if (newFrame) {
+                switch (currentMode) {
+                    case DisplayMode::SpectrumLowRes:
+                        drawSpectrumLowRes();
+                        break;
+                    case DisplayMode::SpectrumHighRes:
+                        drawSpectrumHighRes();
+                        break;
+                    case DisplayMode::Oscilloscope:
+                        drawOscilloscope();
+                        break;
+                    case DisplayMode::Waterfall:
+                        drawWaterfall();
+                        break;
+                    case DisplayMode::Envelope:
+                        drawEnvelope();
+                        break;
+                    case DisplayMode::TuningAid:
+                        drawTuningAid();
+                        break;
+                    default:
+                        break;  // DisplayMode::Off itt nem fordulhat elő az else ág miatt
+                }
             }
 
         } else {
@@ -909,18 +969,16 @@ void MiniAudioFft::drawOscilloscope() {
 void MiniAudioFft::drawWaterfall() {
     using namespace MiniAudioFftConstants;
     int graphH = getGraphHeight();
-    if (!spriteCreated || width == 0 || graphH <= 0 || wabuf.empty() || wabuf[0].empty()) {
+    if (!spriteCreated || width == 0 || graphH <= 0 || wabuf.getSliceLength() != height || lineBuf_ == nullptr) {
         if (!spriteCreated && (currentMode == DisplayMode::Waterfall || currentMode == DisplayMode::TuningAid)) {
             DEBUG("MiniAudioFft::drawWaterfall - Sprite not created for mode %d\n", static_cast<int>(currentMode));
         }
         return;
-    }  // 1. Adatok eltolása balra a `wabuf`-ban (ez továbbra is szükséges a `wabuf` frissítéséhez)
-    for (int r = 0; r < height; ++r) {  // A teljes `this->height` magasságon iterálunk a `wabuf` miatt
-        for (int c = 0; c < width - 1; ++c) {
-            wabuf[r][c] = wabuf[r][c + 1];
-        }
     }
 
+    // 1. Új oszlop a `wabuf` gyűrűben (a legrégebbi helyére, eltolás nélkül)
+    uint8_t* newColumn = wabuf.push();
+
     float currentBinWidthHz = pAudioProcessor ? pAudioProcessor->getBinWidthHz() : (40000.0f / AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
     if (currentBinWidthHz == 0) currentBinWidthHz = (40000.0f / AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
 
@@ -931,7 +989,7 @@ void MiniAudioFft::drawWaterfall() {
     const int max_bin_for_wf_env = std::min(static_cast<int>(actualFftSize / 2 - 1), static_cast<int>(std::round(currentConfiguredMaxDisplayAudioFreqHz / currentBinWidthHz)));
     const int num_bins_in_wf_env_range = NUM_BINS(max_bin_for_wf_env, min_bin_for_wf_env);
 
-    // 2. Új adatok betöltése a `wabuf` jobb szélére (a `wabuf` továbbra is `height` magas)
+    // 2. Új adatok betöltése az új oszlopba (a `wabuf` oszlopa `height` magas)
     for (int r = 0; r < height; ++r) {
         // 'r' (0 to height-1) leképezése FFT bin indexre a szűkített tartományon belül
         int fft_bin_index = min_bin_for_wf_env + static_cast<int>(std::round(static_cast<float>(r) / std::max(1, (height - 1)) * (num_bins_in_wf_env_range - 1)));
@@ -939,13 +997,13 @@ void MiniAudioFft::drawWaterfall() {
 
         if (!pAudioProcessor) continue;
         constexpr float WATERFALL_INPUT_SCALE = 0.1f;  // Csökkentve, hogy ne legyen túl fehér auto gain mellett
-        wabuf[r][width - 1] = static_cast<uint8_t>(constrain((pAudioProcessor ? pAudioProcessor->getMagnitudeData()[fft_bin_index] : 0.0) * WATERFALL_INPUT_SCALE, 0.0, 255.0));
+        newColumn[r] = static_cast<uint8_t>(constrain((pAudioProcessor ? pAudioProcessor->getMagnitudeData()[fft_bin_index] : 0.0) * WATERFALL_INPUT_SCALE, 0.0, 255.0));
     }
 
     // 3. Sprite görgetése és új oszlop kirajzolása
     sprGraph.scroll(-1, 0);  // Tartalom görgetése 1 pixellel balra
 
-    // Az új (jobb szélső) oszlop kirajzolása a sprite-ra
+    // Az új (jobb szélső) oszlop színei a sor pufferbe, majd egyetlen pushImage a sprite-ra
     // A sprite `graphH` magas, a `wabuf` `height` magas.
     for (int r_wabuf = 0; r_wabuf < height; ++r_wabuf) {
         // `r_wabuf` (0..height-1) leképezése `y_on_sprite`-ra (0..graphH-1)
@@ -954,30 +1012,14 @@ void MiniAudioFft::drawWaterfall() {
         int screen_y_relative_inverted = (r_wabuf * (graphH - 1)) / std::max(1, (height - 1));
         int y_on_sprite = (graphH - 1 - screen_y_relative_inverted);  // Y koordináta a sprite-on belül
 
-        if (y_on_sprite >= 0 && y_on_sprite < graphH) {                                       // Biztosítjuk, hogy a sprite-on belül rajzolunk
-            uint16_t color = valueToWaterfallColor(WF_GRADIENT * wabuf[r_wabuf][width - 1]);  // Az új oszlop adata
-            sprGraph.drawPixel(width - 1, y_on_sprite, color);                                // Rajzolás a sprite jobb szélére
+        if (y_on_sprite >= 0 && y_on_sprite < graphH) {                     // Biztosítjuk, hogy a sprite-on belül rajzolunk
+            lineBuf_[y_on_sprite] = WATERFALL_PALETTE[newColumn[r_wabuf]];  // Az új oszlop adata
         }
     }
+    sprGraph.pushImage(width - 1, 0, 1, graphH, lineBuf_);  // Natív RGB565 puffer: a sprite a saját bájtsorrendjére alakítja
 
-    // Sprite kirakása a képernyőre
-    sprGraph.pushSprite(posX, posY);
-}
-
-/**
- * @brief Értéket konvertál egy színné a vízesés diagramhoz a definiált színpaletta alapján.
- * @param scaled_value A skálázott bemeneti érték (pl. gradient * wabuf_érték).
- * @return A megfelelő RGB565 színkód.
- */
-uint16_t MiniAudioFft::valueToWaterfallColor(int scaled_value) {
-    using namespace MiniAudioFftConstants;
-
-    // Normalizálás 0.0 és 1.0 közé a MAX_WATERFALL_COLOR_INPUT_VALUE alapján
-    float normalized = static_cast<float>(constrain(scaled_value, 0, MAX_WATERFALL_COLOR_INPUT_VALUE)) / static_cast<float>(MAX_WATERFALL_COLOR_INPUT_VALUE);
-    byte color_size = sizeof(WATERFALL_COLORS) / sizeof(WATERFALL_COLORS[0]);
-    int index = (int)(normalized * (color_size - 1));  // Index számítása a normalizált értékből
-    index = constrain(index, 0, color_size - 1);       // Biztosítjuk, hogy az index a tömb határain belül maradjon
-    return WATERFALL_COLORS[index];
+    // Sprite kirakása a képernyőre (DMA, a képernyő loop végén)
+    tftDma.submitSprite(sprGraph, posX, posY);
 }
 
 /**
@@ -989,19 +1031,17 @@ uint16_t MiniAudioFft::valueToWaterfallColor(int scaled_value) {
 void MiniAudioFft::drawEnvelope() {
     using namespace MiniAudioFftConstants;
     int graphH = getGraphHeight();
-    if (!spriteCreated || width == 0 || graphH <= 0 || wabuf.empty() || wabuf[0].empty()) {
+    if (!spriteCreated || width == 0 || graphH <= 0 || wabuf.getSliceLength() != height || wabuf.getSliceCount() != width) {
         if (!spriteCreated && currentMode == DisplayMode::Envelope) {
             DEBUG("MiniAudioFft::drawEnvelope - Sprite not created for Envelope mode.\n");
         }
         return;
     }
 
-    sprGraph.fillSprite(TFT_BLACK);     // Sprite törlése minden rajzolás előtt    // 1. Adatok eltolása balra
-    for (int r = 0; r < height; ++r) {  // Teljes `this->height`
-        for (int c = 0; c < width - 1; ++c) {
-            wabuf[r][c] = wabuf[r][c + 1];
-        }
-    }
+    sprGraph.fillSprite(TFT_BLACK);  // Sprite törlése minden rajzolás előtt
+
+    // 1. Új oszlop a `wabuf` gyűrűben (a legrégebbi helyére, eltolás nélkül)
+    uint8_t* newColumn = wabuf.push();
 
     float currentBinWidthHz = pAudioProcessor ? pAudioProcessor->getBinWidthHz() : (40000.0f / AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
     if (currentBinWidthHz == 0) currentBinWidthHz = (40000.0f / AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
@@ -1024,20 +1064,19 @@ void MiniAudioFft::drawEnvelope() {
         // Az AudioProcessor->getMagnitudeData()[fft_bin_index] már tartalmazza a csillapított értéket.
         // Alkalmazzuk az ENVELOPE_INPUT_GAIN-t.
         double gained_val = (pAudioProcessor ? pAudioProcessor->getMagnitudeData()[fft_bin_index] : 0.0) * ENVELOPE_INPUT_GAIN;
-        wabuf[r][width - 1] = static_cast<uint8_t>(constrain(gained_val, 0.0, 255.0));  // 0-255 közé korlátozzuk a wabuf számára
+        newColumn[r] = static_cast<uint8_t>(constrain(gained_val, 0.0, 255.0));  // 0-255 közé korlátozzuk a wabuf számára
     }
 
-    // 3. Burkológörbe kirajzolása
+    // 3. Burkológörbe kirajzolása (balról jobbra a legrégebbi oszloptól a legújabbig)
     for (int c = 0; c < width; ++c) {
+        const uint8_t* column = wabuf.getSlice(width - 1 - c);
         int max_val_in_col = 0;
-        bool column_has_signal = false;
-
-        for (int r_wabuf = 0; r_wabuf < height; ++r_wabuf) {  // Teljes `this->height`
-            if (wabuf[r_wabuf][c] > 0) column_has_signal = true;
-            if (wabuf[r_wabuf][c] > max_val_in_col) {
-                max_val_in_col = wabuf[r_wabuf][c];
+        for (int r_wabuf = 0; r_wabuf < height; ++r_wabuf) {  // Teljes `this->height`, egy oszlop összefüggő a gyűrűben
+            if (column[r_wabuf] > max_val_in_col) {
+                max_val_in_col = column[r_wabuf];
             }
         }
+        const bool column_has_signal = max_val_in_col > 0;
 
         // A maximális amplitúdó simítása az oszlopban
         float current_col_max_amplitude = static_cast<float>(max_val_in_col);
@@ -1070,7 +1109,7 @@ void MiniAudioFft::drawEnvelope() {
             }
         }
     }
-    sprGraph.pushSprite(posX, posY);  // Sprite kirakása a képernyőre
+    tftDma.submitSprite(sprGraph, posX, posY);  // Sprite kirakása a képernyőre (DMA, a képernyő loop végén)
 }
 
 /**
@@ -1084,58 +1123,32 @@ void MiniAudioFft::drawTuningAid() {
     using namespace MiniAudioFftConstants;
 
     int graphH = getGraphHeight();
-    if (!spriteCreated || width == 0 || graphH <= 0 || wabuf.empty() || wabuf[0].empty()) {
+    if (!spriteCreated || width == 0 || graphH <= 0 || wabuf.getSliceLength() != width || lineBuf_ == nullptr) {
         if (!spriteCreated && (currentMode == DisplayMode::Waterfall || currentMode == DisplayMode::TuningAid)) {
             DEBUG("MiniAudioFft::drawTuningAid - Sprite not created for mode %d\n", static_cast<int>(currentMode));
         }
         return;
     }
 
-    // 1. Adatok eltolása "lefelé" a `wabuf`-ban (időbeli léptetés)
-    // Csak a grafikon magasságáig (`graphH`) használjuk a `wabuf` sorait.
-    // A wabuf mérete (height x width), de itt csak graphH sort használunk fel a vízeséshez.
-    for (int r = graphH - 1; r > 0; --r) {  // Utolsó sortól a másodikig
-        for (int c = 0; c < width; ++c) {   // Minden oszlop (frekvencia bin)
-            wabuf[r][c] = wabuf[r - 1][c];
-        }
-    }
-
-    // 2. Nagy felbontású adatok használata
-    float currentBinWidthHz = pAudioProcessor ? pAudioProcessor->getBinWidthHz() : (40000.0f / AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
-    if (currentBinWidthHz == 0) currentBinWidthHz = (40000.0f / AudioProcessorConstants::DEFAULT_FFT_SAMPLES);
-
-    // Get the actual FFT size from the high-res processor or use default fallback
-    const uint16_t actualHighResFftSize = pAudioProcessor ? pAudioProcessor->getFftSize() : AudioProcessorConstants::HIGH_RES_FFT_SAMPLES;
-
-    const int min_fft_bin_for_tuning_local = std::max(1, static_cast<int>(std::round(currentTuningAidMinFreqHz_ / currentBinWidthHz)));
-    const int max_fft_bin_for_tuning_local = std::min(static_cast<int>(actualHighResFftSize / 2 - 1), static_cast<int>(std::round(currentTuningAidMaxFreqHz_ / currentBinWidthHz)));
-    const int num_bins_in_tuning_range = NUM_BINS(max_fft_bin_for_tuning_local, min_fft_bin_for_tuning_local);
-
-    // Biztonsági ellenőrzés - nagy felbontású processor szükséges
-    if (!pAudioProcessor or pAudioProcessor->getFftSize() != AudioProcessorConstants::HIGH_RES_FFT_SAMPLES) return;
+    // 1-2. Zoom FFT adatok egy új sorba a `wabuf` gyűrűben (időbeli léptetés eltolás nélkül):
+    // minden pixel oszlop a rá eső frekvencia tartomány csúcsát kapja
+    if (!pZoomFft || !pZoomFft->isReady()) return;
+    uint8_t* newRow = wabuf.push();
 
-    // Iterálás a komponens teljes szélességén (minden pixel oszlop)
+    const float displayedSpanHz = currentTuningAidMaxFreqHz_ - currentTuningAidMinFreqHz_;
+    const float pixelSpanHz = (width <= 1) ? displayedSpanHz : displayedSpanHz / (width - 1);
     for (int c = 0; c < width; ++c) {
-        // Képernyő pixel X koordinátájának (c) leképezése FFT bin indexre
-        // a nagy felbontású FFT tartományon belül
-        float ratio_in_display_width = (width <= 1) ? 0.0f : (static_cast<float>(c) / (width - 1));  // <= 1 a biztonság kedvéért
-        int fft_bin_index = min_fft_bin_for_tuning_local + static_cast<int>(std::round(ratio_in_display_width * (num_bins_in_tuning_range - 1)));
-        fft_bin_index = constrain(fft_bin_index, min_fft_bin_for_tuning_local, max_fft_bin_for_tuning_local);
-        fft_bin_index = constrain(fft_bin_index, 2, static_cast<int>(actualHighResFftSize / 2 - 1));
-
-        // Nagy felbontású FFT adatok használata
-        wabuf[0][c] = static_cast<uint8_t>(constrain((pAudioProcessor->getMagnitudeData()[fft_bin_index]) * TUNING_AID_INPUT_SCALE, 0.0, 255.0));
+        float pixelFreqHz = currentTuningAidMinFreqHz_ + c * pixelSpanHz;
+        float magnitude = pZoomFft->getPeakMagnitude(pixelFreqHz - pixelSpanHz / 2.0f, pixelFreqHz + pixelSpanHz / 2.0f);
+        newRow[c] = static_cast<uint8_t>(constrain(magnitude * TUNING_AID_INPUT_SCALE, 0.0f, 255.0f));
     }
 
     // 3. Sprite görgetése és új sor kirajzolása
     sprGraph.scroll(0, 1);  // Tartalom görgetése 1 pixellel lefelé
 
-    // Az új (legfelső) sor kirajzolása a sprite-ra (teljes szélességben)
-    for (int c = 0; c < width; ++c) {
-        // 'c' (0-tól width-1-ig) az index a wabuf[0]-hoz és a sprite X koordinátája
-        uint16_t color = valueToWaterfallColor(WF_GRADIENT * wabuf[0][c]);
-        sprGraph.drawPixel(c, 0, color);  // Rajzolás a sprite x=c, y=0 pozíciójára
-    }
+    // Az új (legfelső) sor kirajzolása a sprite-ra (teljes szélességben, egyetlen pushImage)
+    WATERFALL_PALETTE.mapLine(newRow, lineBuf_, width);
+    sprGraph.pushImage(0, 0, width, 1, lineBuf_);
 
     // 4. Célfrekvencia vonalának kirajzolása a sprite-ra
     // Only draw lines if the tuning aid type is not OFF_DECODER
@@ -1183,8 +1196,36 @@ void MiniAudioFft::drawTuningAid() {
         }
     }
 
-    // Sprite kirakása a képernyőre
-    sprGraph.pushSprite(posX, posY);
+    // Sprite kirakása a képernyőre (DMA, a képernyő loop végén)
+    tftDma.submitSprite(sprGraph, posX, posY);
+}
+
+/**
+ * @brief Zoom FFT kezelése a hangolássegédhez
+ *
+ * TuningAid módban létrehozza (ha még nincs) és a sáv változásakor újrahangolja,
+ * más módban felszabadítja, hogy a puffereit ne tartsuk feleslegesen.
+ */
+void MiniAudioFft::updateZoomFft() {
+    if (currentMode != DisplayMode::TuningAid) {
+        delete pZoomFft;
+        pZoomFft = nullptr;
+        return;
+    }
+
+    if (!pZoomFft) {
+        pZoomFft = new (std::nothrow) ZoomFft(adcDmaSampler);
+        if (!pZoomFft) {
+            DEBUG("MiniAudioFft: Zoom FFT létrehozása sikertelen!\n");
+            return;
+        }
+    }
+
+    float centerHz = (currentTuningAidMinFreqHz_ + currentTuningAidMaxFreqHz_) / 2.0f;
+    float spanHz = currentTuningAidMaxFreqHz_ - currentTuningAidMinFreqHz_;
+    if (std::abs(pZoomFft->getCenterFreqHz() - centerHz) > 0.5f || std::abs(pZoomFft->getSpanHz() - spanHz) > 0.5f) {
+        pZoomFft->configure(centerHz, spanHz);
+    }
 }
 
 /**
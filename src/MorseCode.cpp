@@ -0,0 +1,143 @@
+#include "MorseCode.h"
+
+namespace {
+
+/**
+ * @brief Egy jel a jelkészletben: a kód pontokkal és vonásokkal írva
+ */
+struct MorseSymbol {
+    const char *pattern;
+    char symbol;
+};
+
+/**
+ * @brief A jelkészlet (ITU betűk, számok, írásjelek, prosignok és a HA ékezetes betűk)
+ *
+ * Az AR, BT és KN kódja a '+', '=' és '(' kódja: rádióforgalomban prosignként dekódoljuk.
+ */
+constexpr MorseSymbol SYMBOLS[] = {
+    {".-", 'A'},         {"-...", 'B'},      {"-.-.", 'C'},      {"-..", 'D'},       {".", 'E'},         {"..-.", 'F'},      {"--.", 'G'},
+    {"....", 'H'},       {"..", 'I'},        {".---", 'J'},      {"-.-", 'K'},       {".-..", 'L'},      {"--", 'M'},        {"-.", 'N'},
+    {"---", 'O'},        {".--.", 'P'},      {"--.-", 'Q'},      {".-.", 'R'},       {"...", 'S'},       {"-", 'T'},         {"..-", 'U'},
+    {"...-", 'V'},       {".--", 'W'},       {"-..-", 'X'},      {"-.--", 'Y'},      {"--..", 'Z'},
+
+    {"-----", '0'},      {".----", '1'},     {"..---", '2'},     {"...--", '3'},     {"....-", '4'},     {".....", '5'},     {"-....", '6'},
+    {"--...", '7'},      {"---..", '8'},     {"----.", '9'},
+
+    {".-.-.-", '.'},     {"--..--", ','},    {"..--..", '?'},    {".----.", '\''},   {"-.-.--", '!'},    {"-..-.", '/'},     {"-.--.-", ')'},
+    {".-...", '&'},      {"---...", ':'},    {"-.-.-.", ';'},    {"-....-", '-'},    {"..--.-", '_'},    {".-..-.", '"'},    {".--.-.", '@'},
+    {"...-..-", '$'},
+
+    {".-.-.", MorseCode::PROSIGN_AR},
+    {"...-.-", MorseCode::PROSIGN_SK},
+    {"-...-", MorseCode::PROSIGN_BT},
+    {"-.--.", MorseCode::PROSIGN_KN},
+    {"........", MorseCode::PROSIGN_ERROR},
+
+    {".--.-", MorseCode::LETTER_A_ACUTE},
+    {"..-..", MorseCode::LETTER_E_ACUTE},
+    {"---.", MorseCode::LETTER_O_UMLAUT},
+    {"..--", MorseCode::LETTER_U_UMLAUT},
+};
+
+/**
+ * @brief A kód tábla: index = 1 << hossz | minta (TABLE_SIZE elem, a nem használt helyeken '\0')
+ */
+struct CodeTable {
+    char symbols[MorseCode::TABLE_SIZE];
+    bool valid;  // Minden kód 1..MAX_ELEMENTS hosszú, csak pontból és vonásból áll, és egyszer szerepel
+
+    constexpr CodeTable() : symbols(), valid(true) {
+        for (const MorseSymbol &entry : SYMBOLS) {
+            uint16_t index = 1;  // A vezető 1-es bit jelöli a hosszt
+            uint8_t length = 0;
+            for (const char *p = entry.pattern; *p != '\0'; p++) {
+                if ((*p != '.' && *p != '-') || ++length > MorseCode::MAX_ELEMENTS) {
+                    valid = false;
+                    break;
+                }
+                index = (index << 1) | (*p == '-' ? 1 : 0);
+            }
+            if (!valid || length == 0 || symbols[index] != '\0') {
+                valid = false;
+                break;
+            }
+            symbols[index] = entry.symbol;
+        }
+    }
+};
+
+constexpr CodeTable CODE_TABLE{};
+static_assert(CODE_TABLE.valid, "Hibás vagy kétszer szereplő Morse kód a jelkészletben");
+
+}  // namespace
+
+namespace MorseCode {
+
+/**
+ * @brief Egy teljes elem sorozat dekódolása
+ * @param codeBits Az elemek, az első elem a legmagasabb használt biten (0 = pont, 1 = vonás)
+ * @param codeLength Az elemek száma (1..MAX_ELEMENTS)
+ * @return A karakter vagy prosign, vagy '\0' ha a sorozat érvénytelen
+ */
+char decode(uint8_t codeBits, uint8_t codeLength) {
+    if (codeLength == 0 || codeLength > MAX_ELEMENTS) {
+        return '\0';
+    }
+    const uint16_t pattern = codeBits & ((1u << codeLength) - 1);
+    return CODE_TABLE.symbols[(1u << codeLength) | pattern];
+}
+
+/**
+ * @brief Egy karakter (vagy prosign) kódja
+ * @param symbol A karakter (a kisbetű a nagybetű kódját kapja)
+ * @param codeBits Ide kerülnek az elemek, az első elem a legmagasabb használt biten
+ * @param codeLength Ide kerül az elemek száma
+ * @return false ha a jel nincs a jelkészletben
+ *
+ * A tábla visszafelé keresése (lassú, nem a dekódolás útja).
+ */
+bool encode(char symbol, uint8_t &codeBits, uint8_t &codeLength) {
+    if (symbol >= 'a' && symbol <= 'z') {
+        symbol -= 'a' - 'A';
+    }
+    if (symbol == '\0') {
+        return false;
+    }
+    for (uint16_t index = 2; index < TABLE_SIZE; index++) {
+        if (CODE_TABLE.symbols[index] != symbol) {
+            continue;
+        }
+        codeLength = 0;
+        while ((index >> (codeLength + 1)) != 0) {
+            codeLength++;
+        }
+        codeBits = static_cast<uint8_t>(index & ((1u << codeLength) - 1));
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief A prosign kiírandó szövege
+ * @param symbol A dekódolt jel
+ * @return Pl. "<AR>", vagy nullptr ha a jel nem prosign
+ */
+const char *getProsignText(char symbol) {
+    switch (symbol) {
+        case PROSIGN_AR:
+            return "<AR>";
+        case PROSIGN_SK:
+            return "<SK>";
+        case PROSIGN_BT:
+            return "<BT>";
+        case PROSIGN_KN:
+            return "<KN>";
+        case PROSIGN_ERROR:
+            return "<HH>";
+        default:
+            return nullptr;
+    }
+}
+
+};  // namespace MorseCode
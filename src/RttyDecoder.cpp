@@ -1,16 +1,23 @@
 /**
  * @file RttyDecoder.cpp
- * @brief RTTY dekóder implementáció a CwDecoder mintájára
+ * @brief RTTY dekóder implementáció folyamatos mintafolyamon
  *
- * Az osztály RTTY jelek dekódolására szolgál dupla Goertzel algoritmus segítségével.
- * Automatikusan detektálja a shift frekvenciát (170Hz vagy 850Hz) és a baud rate-et (45-100 baud).
- * Mark és Space frekvenciák automatikus felismerése a defines.h-ban megadott értékek alapján.
+ * A mark és a space hangot egy-egy NCO keveri alapsávba, utána egy bit hosszú mozgó összeg
+ * (a derékszögű bitre illesztett szűrő) adja a két hang burkolóját minden mintánál. A döntést
+ * ATC (automatikus küszöb korrekció) hozza: hangonként követi a csúcs- és a zajszintet, így a
+ * szelektív fading (QSB) alatt is a két szint közepén marad a küszöb. A bit órát a minták száma
+ * lépteti (nem a millis()), a start él után fél bittel mintavételez, és a bitek közötti váltásokon
+ * mért fázishibával (early/late gate) követi az adó óráját. A baud rate a space futamok hosszából
+ * detektálható (45.45/50/75/100 baud). A mark/space frekvenciát és a shift-et (170/425/850Hz) az
+ * RttyToneTracker keresi meg az átlagolt spektrumból a beállított mark körül, és követi a sodródást.
  */
 
 #include "RttyDecoder.h"
 
 #include <cmath>
 
+#include "DecodedTextRing.h"
+#include "FftTables.h"
 #include "defines.h"
 
 // RTTY működés debug engedélyezése csak DEBUG módban
@@ -20,9 +27,6 @@
 #define RTTY_DEBUG(fmt, ...)  // Üres makró, ha __DEBUG nincs definiálva
 #endif
 
-// Goertzel filter paraméter a SAMPLING_FREQ-hez
-const unsigned long RttyDecoder::SAMPLING_PERIOD_US = static_cast<unsigned long>(1000000.0f / RttyDecoder::SAMPLING_FREQ);
-
 // Baudot LTRS (Letters) tábla - ITA2 standard
 const char RttyDecoder::BAUDOT_LTRS_TABLE[32] = {
     '\0', 'E', '\n', 'A',  ' ', 'S', 'I', 'U',  // 0-7
@@ -39,11 +43,67 @@ const char RttyDecoder::BAUDOT_FIGS_TABLE[32] = {
     '9',  '?', '&',  '\0', '.', '/',  ';', '\0'  // 24-31 (27=FIGS, 31=LTRS)
 };
 
+namespace {
+
+/**
+ * @brief Komplex összeg abszolút értékének közelítése gyökvonás nélkül (max + 3/8 min, hiba < 7%)
+ */
+inline uint32_t approxMagnitude(int32_t i, int32_t q) {
+    uint32_t a = static_cast<uint32_t>(i < 0 ? -i : i);
+    uint32_t b = static_cast<uint32_t>(q < 0 ? -q : q);
+    if (a < b) {
+        const uint32_t t = a;
+        a = b;
+        b = t;
+    }
+    return a + (b >> 2) + (b >> 3);
+}
+
+/**
+ * @brief ATC szint követése: gyors követés az egyik irányba, lassú a másikba
+ */
+inline void trackLevel(float &level, float value, bool fast, float fastCoeff, float slowCoeff) { level += (value - level) * (fast ? fastCoeff : slowCoeff); }
+
+}  // namespace
+
+/**
+ * @brief Egy hang keverése és az illesztett szűrő (mozgó összeg) léptetése
+ * @param tone A hang szűrője
+ * @param x A bemeneti minta
+ * @param pos A kilépő minta indexe a szűrő pufferében
+ * @param cosTable A koszinusz tábla
+ * @param sinTable A szinusz tábla
+ */
+inline void RttyDecoder::mixTone(ToneFilter &tone, int32_t x, uint16_t pos, const int16_t *cosTable, const int16_t *sinTable) {
+    // A 2048 pontos kör első fele van a táblában, a második fele annak negáltja
+    const uint32_t index = tone.phase >> NCO_PHASE_SHIFT;
+    tone.phase += tone.phaseStep;
+    int32_t c, s;
+    if (index < FftTables::TWIDDLE_TABLE_SIZE) {
+        c = cosTable[index];
+        s = sinTable[index];
+    } else {
+        c = -cosTable[index - FftTables::TWIDDLE_TABLE_SIZE];
+        s = -sinTable[index - FftTables::TWIDDLE_TABLE_SIZE];
+    }
+
+    const int16_t i = static_cast<int16_t>((x * c) >> 15);
+    const int16_t q = static_cast<int16_t>((x * s) >> 15);
+    tone.sumI += i - tone.historyI[pos];
+    tone.sumQ += q - tone.historyQ[pos];
+    tone.historyI[pos] = i;
+    tone.historyQ[pos] = q;
+}
+
 /**
  * @brief RttyDecoder konstruktor
  * @param audioPin Az analóg bemenet pin száma, ahol az audio jel érkezik
+ * @param sampleSource Minta forrás (a firmware-ben a globális ADC DMA mintavételező busz; pl. ArraySampleSource hardver nélküli futtatáshoz)
  */
-RttyDecoder::RttyDecoder(int audioPin) : audioInputPin_(audioPin) { initialize(); }
+RttyDecoder::RttyDecoder(int audioPin, AudioSampleRing &sampleSource) : audioInputPin_(audioPin), sampleReader_(sampleSource), toneTracker_(SAMPLING_FREQ) {
+    sampleReader_.setTargetSampleRate(SAMPLING_FREQ);
+    initialize();
+}
 
 /**
  * @brief RttyDecoder destruktor
@@ -54,41 +114,43 @@ RttyDecoder::~RttyDecoder() {}
  * @brief Inicializálja az RTTY dekóder összes tagváltozóját alapértelmezett értékekre
  */
 void RttyDecoder::initialize() {
-    // Goertzel szűrő változók nullázása
-    q0_mark = q1_mark = q2_mark = 0;
-    q0_space = q1_space = q2_space = 0;
-    memset(testData, 0, sizeof(testData));
+    sampleReader_.sync();  // A korábban felgyűlt mintákat nem dolgozzuk fel
 
     // RTTY állapotgép inicializálása
     currentState_ = IDLE;
-    bitDurationMs_ = DEFAULT_BIT_DURATION_MS;
-    lastBitTimeMs_ = 0;
-    startBitTimeMs_ = 0;
-    bitsReceived_ = 0; // NOLINT(readability-magic-numbers)
+    bitsReceived_ = 0;
     currentByte_ = 0;
-    currentToneState_ = false;
-    lastToneState_ = false;  // Automatikus detektálás
+    currentToneState_ = true;  // Nyugalmi állapot: Mark
+    lastToneState_ = true;
+    signalPresent_ = false;
+
+    // Automatikus detektálás
     autoDetectActive_ = true;
-    autoDetectStartMs_ = millis();
     detectedMarkFreq_ = RTTY_DEFAULT_MARKER_FREQUENCY;
     detectedSpaceFreq_ = RTTY_DEFAULT_SPACE_FREQUENCY;
     detectedShiftFreq_ = RTTY_DEFAULT_SHIFT_FREQUENCY;
-    detectedBaudRate_ = MIN_BAUD_RATE;
 
-    // Baudrate detektálás
-    memset(transitionTimes_, 0, sizeof(transitionTimes_));
-    transitionIndex_ = 0;
-    lastTransitionMs_ = 0;
+    // Demodulátor: az ATC szintek az első teljes szűrő ablakból indulnak
+    mark_.phase = 0;
+    space_.phase = 0;
+    mark_.peak = mark_.noise = 0.0f;
+    space_.peak = space_.noise = 0.0f;
+    contrast_ = 0.0f;
 
-    // Karakter puffer
-    memset(decodedCharBuffer_, 0, sizeof(decodedCharBuffer_));
-    charBufferReadPos_ = 0;
-    charBufferWritePos_ = 0;
-    charBufferCount_ = 0;
+    // Baudrate detektálás
+    memset(runLengths_, 0, sizeof(runLengths_));
+    runIndex_ = 0;
+    runCount_ = 0;
+    samplesSinceTransition_ = 0;
+    framingErrors_ = 0;
 
     // Baudot dekódolás
     figsShift_ = false;  // Kezdeti állapot: LTRS mód
 
+    toneTracker_.reset(detectedMarkFreq_, detectedShiftFreq_);
+    configureTones();
+    configureBitTiming(DEFAULT_BAUD_RATE);
+
     RTTY_DEBUG("RTTY Decoder initialized. Mark: %.1f Hz, Space: %.1f Hz, Shift: %.1f Hz\n", detectedMarkFreq_, detectedSpaceFreq_, detectedShiftFreq_);
 }
 
@@ -101,159 +163,342 @@ void RttyDecoder::resetDecoderState() {
 }
 
 /**
- * @brief Végrehajtja a Goertzel algoritmusokat Mark és Space frekvenciákra
- * @param isMarkStronger Kimenet: true ha Mark erősebb, false ha Space erősebb
- * @return true ha valamelyik jel erős enough, false egyébként
+ * @brief Mark/shift/baud beállítása újrapéldányosítás nélkül
+ * @param markHz Mark frekvencia
+ * @param shiftHz Shift (a space a mark alatt van)
+ * @param baudRate Baud, 0 = automatikus detektálás (45 = 45.45 baud)
+ *
+ * A félig vett karakter eldobódik, a Baudot LTRS/FIGS állapot megmarad.
  */
-bool RttyDecoder::processGoertzelFilters(bool& isMarkStronger) {
-    unsigned long loopStartTimeMicros;
-
-    // N_SAMPLES számú minta begyűjtése
-    for (short index = 0; index < N_SAMPLES; index++) {
-        loopStartTimeMicros = micros();
-        int raw_adc = analogRead(audioInputPin_);
-        testData[index] = raw_adc - 2048;  // DC eltolás eltávolítása (12-bit ADC)
-
-        unsigned long processingTimeMicros = micros() - loopStartTimeMicros;
-        if (processingTimeMicros < SAMPLING_PERIOD_US) {
-            delayMicroseconds(SAMPLING_PERIOD_US - processingTimeMicros);
-        }
-    }
-
-    // Mark frekvencia Goertzel szűrő
-    q1_mark = 0;
-    q2_mark = 0;
-    for (short index = 0; index < N_SAMPLES; index++) {
-        q0_mark = COEFF_MARK(detectedMarkFreq_) * q1_mark - q2_mark + static_cast<float>(testData[index]);
-        q2_mark = q1_mark;
-        q1_mark = q0_mark;
-    }
-    float markMagnitudeSquared = (q1_mark * q1_mark) + (q2_mark * q2_mark) - q1_mark * q2_mark * COEFF_MARK(detectedMarkFreq_);
-    float markMagnitude = sqrt(markMagnitudeSquared);
-
-    // Space frekvencia Goertzel szűrő
-    q1_space = 0;
-    q2_space = 0;
-    for (short index = 0; index < N_SAMPLES; index++) {
-        q0_space = COEFF_SPACE(detectedSpaceFreq_) * q1_space - q2_space + static_cast<float>(testData[index]);
-        q2_space = q1_space;
-        q1_space = q0_space;
+void RttyDecoder::setParameters(float markHz, float shiftHz, uint16_t baudRate) {
+    detectedMarkFreq_ = markHz;
+    detectedShiftFreq_ = shiftHz;
+    detectedSpaceFreq_ = markHz - shiftHz;
+    toneTracker_.reset(markHz, shiftHz);  // A beállított mark körül keres
+    configureTones();
+
+    runIndex_ = 0;
+    runCount_ = 0;
+    if (baudRate > 0) {
+        autoDetectActive_ = false;
+        configureBitTiming(baudRate == 45 ? 45.45f : constrain(static_cast<float>(baudRate), BAUD_RATES[0], BAUD_RATES[BAUD_RATE_COUNT - 1]));
+    } else {
+        autoDetectActive_ = true;
+        configureBitTiming(DEFAULT_BAUD_RATE);
     }
-    float spaceMagnitudeSquared = (q1_space * q1_space) + (q2_space * q2_space) - q1_space * q2_space * COEFF_SPACE(detectedSpaceFreq_);
-    float spaceMagnitude = sqrt(spaceMagnitudeSquared);
 
-    // Jelerősség ellenőrzése
-    float maxMagnitude = max(markMagnitude, spaceMagnitude);
-    if (maxMagnitude < SIGNAL_THRESHOLD) {
-        return false;  // Nincs elég erős jel
-    }
+    RTTY_DEBUG("RTTY: Parameters set. Mark: %.1f Hz, Space: %.1f Hz, Baud: %.2f%s\n", detectedMarkFreq_, detectedSpaceFreq_, detectedBaudRate_, autoDetectActive_ ? " (auto)" : "");
+}
 
-    // Mark/Space arány ellenőrzése
-    float ratio = (markMagnitude > spaceMagnitude) ? (markMagnitude / max(spaceMagnitude, 1.0f)) : (spaceMagnitude / max(markMagnitude, 1.0f));
+/**
+ * @brief A keverők frekvenciájának beállítása a mark/space frekvenciákhoz
+ */
+void RttyDecoder::configureTones() {
+    mark_.phaseStep = static_cast<uint32_t>(detectedMarkFreq_ / SAMPLING_FREQ * 4294967296.0);
+    space_.phaseStep = static_cast<uint32_t>(detectedSpaceFreq_ / SAMPLING_FREQ * 4294967296.0);
+}
 
-    if (ratio < MARK_SPACE_RATIO_THRESHOLD) {
-        return false;  // A két jel túl közel van egymáshoz
+/**
+ * @brief A bit óra és az illesztett szűrő beállítása egy baud rate-hez
+ * @param baudRate A baud rate (pl. 45.45)
+ *
+ * Az illesztett szűrő egy bit hosszú, ezért a pufferei törlődnek; az ATC szintek maradnak
+ * (az amplitúdó a szűrő hosszára normált), a félig vett karakter eldobódik. Az ATC időállandói
+ * bitekben számoltak, a csúcs csökkenése rögzített baudnál ATC_PEAK_MAX_MS-ra korlátozott.
+ */
+void RttyDecoder::configureBitTiming(float baudRate) {
+    detectedBaudRate_ = baudRate;
+    const float bitSamples = SAMPLING_FREQ / baudRate;
+    bitSamplesQ8_ = static_cast<int32_t>(bitSamples * 256.0f + 0.5f);
+
+    windowSamples_ = constrain(static_cast<uint16_t>(bitSamples + 0.5f), static_cast<uint16_t>(1), MAX_BIT_SAMPLES);
+    windowPos_ = 0;
+    windowFill_ = 0;
+    amplitudeScale_ = 2.0f / windowSamples_;
+    for (ToneFilter *tone : {&mark_, &space_}) {
+        tone->sumI = 0;
+        tone->sumQ = 0;
+        memset(tone->historyI, 0, sizeof(tone->historyI));
+        memset(tone->historyQ, 0, sizeof(tone->historyQ));
     }
 
-    isMarkStronger = markMagnitude > spaceMagnitude;
+    atcFastCoeff_ = 1.0f / (ATC_FAST_BITS * bitSamples);
+    // A baud felismerés a futamok hosszát a döntésből méri: ott a lassabb csúcs követés pontosabb
+    const float peakSamples = ATC_PEAK_BITS * bitSamples;
+    atcPeakCoeff_ = 1.0f / (autoDetectActive_ ? peakSamples : min(peakSamples, ATC_PEAK_MAX_MS * SAMPLING_FREQ / 1000.0f));
+    atcNoiseCoeff_ = 1.0f / (ATC_NOISE_BITS * bitSamples);
+    squelchCoeff_ = 1.0f / (SQUELCH_BITS * bitSamples);
 
-    RTTY_DEBUG("RTTY Goertzel: Mark=%.1f, Space=%.1f, Ratio=%.2f, IsMarkStronger=%d\n", markMagnitude, spaceMagnitude, ratio, isMarkStronger);
-
-    return true;
+    resetRttyStateMachine();
+    RTTY_DEBUG("RTTY: Bit timing: %.2f baud, %.1f samples/bit\n", baudRate, bitSamples);
 }
 
 /**
- * @brief Detektálja az aktuális hangállapotot (Mark/Space)
- * @return true ha érvényes hangot detektált, false egyébként
+ * @brief Egy minta demodulálása: keverés, illesztett szűrő, ATC döntés
+ * @param sample A bemeneti minta
+ *
+ * Beállítja a currentToneState_ (Mark/Space) és a signalPresent_ (squelch) értékét.
  */
-bool RttyDecoder::detectToneState() {
-    bool isMarkStronger;
-    if (!processGoertzelFilters(isMarkStronger)) {
-        return false;  // Nincs érvényes jel
+void RttyDecoder::sliceSample(int16_t sample) {
+    static const int16_t *cosTable = FftTables::getTwiddleCos();
+    static const int16_t *sinTable = FftTables::getTwiddleSin();
+
+    mixTone(mark_, sample, windowPos_, cosTable, sinTable);
+    mixTone(space_, sample, windowPos_, cosTable, sinTable);
+    windowPos_ = windowPos_ + 1 == windowSamples_ ? 0 : windowPos_ + 1;
+
+    // Amíg a szűrő ablaka nem telt meg, nincs értelmes burkoló
+    if (windowFill_ < windowSamples_) {
+        windowFill_++;
+        return;
     }
 
-    currentToneState_ = isMarkStronger;  // true = Mark, false = Space
-    return true;
+    const float markAmplitude = approxMagnitude(mark_.sumI, mark_.sumQ) * amplitudeScale_;
+    const float spaceAmplitude = approxMagnitude(space_.sumI, space_.sumQ) * amplitudeScale_;
+    updateAtc(markAmplitude, spaceAmplitude);
+
+    // Squelch: RTTY jelnél mindig csak az egyik hang szól, így a két burkoló különbsége az összegükhöz
+    // képest nagy; zajban a két burkoló hasonló. Hiszterézissel, hogy a jel szélén ne villogjon.
+    const float total = markAmplitude + spaceAmplitude;
+    const float contrast = total > 0.0f ? fabsf(markAmplitude - spaceAmplitude) / total : 0.0f;
+    contrast_ += (contrast - contrast_) * squelchCoeff_;
+    const float threshold = signalPresent_ ? SQUELCH_CLOSE_CONTRAST : SQUELCH_OPEN_CONTRAST;
+    signalPresent_ = contrast_ >= threshold && max(mark_.peak, space_.peak) >= MIN_SIGNAL_AMPLITUDE;
+    if (!signalPresent_) {
+        currentToneState_ = true;  // Jel nélkül nyugalmi (Mark) állapot: nem indul karakter
+        return;
+    }
+
+    // ATC döntés: hangonként a zajszint és a csúcs közé vágott szint, a hang saját tartományával súlyozva.
+    // A küszöb mindkét hang tartományának közepén van, így a váltások (a bit óra élei) nem tolódnak el;
+    // ha az egyik hang elhalkul (szelektív fading), a súlya csökken, és a döntést az erősebb hang hozza.
+    const float markSpan = mark_.peak - mark_.noise;
+    const float spaceSpan = space_.peak - space_.noise;
+    const float markLevel = constrain(markAmplitude, mark_.noise, mark_.peak) - mark_.noise;
+    const float spaceLevel = constrain(spaceAmplitude, space_.noise, space_.peak) - space_.noise;
+    const float decision = markSpan * (markLevel - 0.5f * markSpan) - spaceSpan * (spaceLevel - 0.5f * spaceSpan);
+    currentToneState_ = decision > 0.0f;
 }
 
 /**
- * @brief Frissíti a baud rate detektálást az állapotváltások alapján
+ * @brief Az ATC csúcs- és zajszintjeinek követése
  */
-void RttyDecoder::updateBaudRateDetection() {
-    unsigned long currentTime = millis();
-
-    // Állapotváltás detektálása
-    if (currentToneState_ != lastToneState_) {
-        // Új állapotváltás
-        if (lastTransitionMs_ > 0) {
-            // Előző állapotváltás óta eltelt idő
-            unsigned long timeSinceLastTransition = currentTime - lastTransitionMs_;
-
-            // Tárolás a transition times tömbben
-            transitionTimes_[transitionIndex_] = timeSinceLastTransition;
-            transitionIndex_ = (transitionIndex_ + 1) % 10;
+void RttyDecoder::updateAtc(float markAmplitude, float spaceAmplitude) {
+    if (windowFill_ == windowSamples_) {
+        // Az első teljes ablak: a szintek innen indulnak
+        windowFill_++;
+        if (mark_.peak <= 0.0f) {
+            mark_.peak = mark_.noise = markAmplitude;
+            space_.peak = space_.noise = spaceAmplitude;
+            return;
         }
+    }
+    trackLevel(mark_.peak, markAmplitude, markAmplitude > mark_.peak, atcFastCoeff_, atcPeakCoeff_);
+    trackLevel(mark_.noise, markAmplitude, markAmplitude < mark_.noise, atcFastCoeff_, atcNoiseCoeff_);
+    trackLevel(space_.peak, spaceAmplitude, spaceAmplitude > space_.peak, atcFastCoeff_, atcPeakCoeff_);
+    trackLevel(space_.noise, spaceAmplitude, spaceAmplitude < space_.noise, atcFastCoeff_, atcNoiseCoeff_);
+}
 
-        lastTransitionMs_ = currentTime;
-        lastToneState_ = currentToneState_;
+/**
+ * @brief A minták feldolgozása: hang követés, demodulálás, baud detektálás, bit óra
+ */
+void RttyDecoder::processSamples(const int16_t *samples, uint16_t count) {
+    if (toneTracker_.addSamples(samples, count)) {
+        updateToneTracking();
+    }
 
-        RTTY_DEBUG("RTTY Transition: %s->%s at %lu ms\n", lastToneState_ ? "Space" : "Mark", currentToneState_ ? "Mark" : "Space", currentTime);
+    for (uint16_t i = 0; i < count; i++) {
+        sliceSample(samples[i]);
+
+        const bool transition = currentToneState_ != lastToneState_;
+        lastToneState_ = currentToneState_;
+        if (autoDetectActive_) {
+            updateBaudRateDetection(transition);
+        }
+        runBitClock(transition);
     }
 }
 
 /**
- * @brief Megbecsüli a baud rate-et a tárolt állapotváltások alapján
- * @return Becsült baud rate
+ * @brief A mintákkal léptetett bit óra és az RTTY állapotgép
+ * @param transition Ennél a mintánál váltott-e a döntés (Mark <-> Space)
+ *
+ * Az illesztett szűrő kimenete a bit határ után fél bittel váltja a döntést, a legjobb
+ * mintavételi pont (a teljes bitet átfedő ablak) még fél bittel később van. A start él után
+ * ezért fél bittel, utána bitenként mintavételezünk. A bitek közötti váltásnak két mintavétel
+ * között félúton kell lennie; az eltérés egy részével a következő mintavételt eltoljuk (early/late gate).
  */
-unsigned long RttyDecoder::estimateBaudRate() {
-    unsigned long totalTime = 0;
-    short validSamples = 0;
-
-    for (short i = 0; i < 10; i++) {
-        if (transitionTimes_[i] > 0 && transitionTimes_[i] >= MIN_BIT_DURATION_MS && transitionTimes_[i] <= MAX_BIT_DURATION_MS * 3) {
-            totalTime += transitionTimes_[i];
-            validSamples++;
+void RttyDecoder::runBitClock(bool transition) {
+    if (!signalPresent_ && currentState_ != IDLE) {
+        resetRttyStateMachine();  // Elveszett a jel: a félig vett karakter nem érvényes
+        return;
+    }
+
+    if (currentState_ == IDLE) {
+        // Start bit keresése: Mark -> Space váltás
+        if (transition && !currentToneState_) {
+            currentState_ = WAITING_FOR_START_BIT;
+            nextBitSampleQ8_ = bitSamplesQ8_ / 2;
         }
+        return;
     }
 
-    if (validSamples < 3) {
-        return MIN_BAUD_RATE;  // Nincs elég adat, alapértelmezett érték
+    if (transition) {
+        // Pozitív hiba: a váltás a vártnál később jött, a mintavételt is később tesszük
+        const int32_t phaseErrorQ8 = bitSamplesQ8_ / 2 - nextBitSampleQ8_;
+        nextBitSampleQ8_ += phaseErrorQ8 >> EARLY_LATE_GAIN_SHIFT;
+    }
+
+    nextBitSampleQ8_ -= 256;
+    if (nextBitSampleQ8_ > 0) {
+        return;
+    }
+    nextBitSampleQ8_ += bitSamplesQ8_;
+
+    switch (currentState_) {
+        case WAITING_FOR_START_BIT:
+            // Start bit megerősítése a bit közepén
+            if (!currentToneState_) {
+                currentState_ = RECEIVING_DATA_BITS;
+                bitsReceived_ = 0;
+                currentByte_ = 0;
+            } else {
+                currentState_ = IDLE;  // Téves start bit (zaj)
+            }
+            break;
+
+        case RECEIVING_DATA_BITS:
+            if (currentToneState_) {  // Mark = 1
+                currentByte_ |= (1 << bitsReceived_);
+            }
+            bitsReceived_++;
+            if (bitsReceived_ >= 5) {
+                currentState_ = RECEIVING_STOP_BIT;
+            }
+            break;
+
+        case RECEIVING_STOP_BIT:
+            if (currentToneState_) {  // Érvényes (Mark) stop bit
+                char decodedChar = decodeBaudotCharacter(currentByte_);
+                addToBuffer(decodedChar);
+            } else {
+                framingErrors_++;
+                RTTY_DEBUG("RTTY: Invalid stop bit, discarding character 0x%02X (framing errors: %lu)\n", currentByte_, framingErrors_);
+            }
+            resetRttyStateMachine();  // A következő start él keresése
+            break;
+
+        default:
+            resetRttyStateMachine();
+            break;
     }
+}
 
-    unsigned long averageBitTime = totalTime / validSamples;
-    unsigned long baudRate = 1000 / averageBitTime;
+/**
+ * @brief A space futamok hosszának gyűjtése és a baud rate becslése
+ * @param transition Ennél a mintánál váltott-e a döntés
+ *
+ * Csak a space futamokat mérjük: ezek a start bittel kezdődnek és adat bitekből állnak, így
+ * mindig egész bit hosszúak (a mark futamokban az 1.5 stop bit is benne lehet).
+ */
+void RttyDecoder::updateBaudRateDetection(bool transition) {
+    samplesSinceTransition_++;
+    if (!transition) {
+        return;
+    }
 
-    // Korlátok között tartás
-    baudRate = constrain(baudRate, MIN_BAUD_RATE, MAX_BAUD_RATE);
+    // A zaj okozta rövid tüskék és a hosszú szünetek nem mérvadók
+    const uint32_t minRunSamples = static_cast<uint32_t>(MIN_RUN_BITS * SAMPLING_FREQ / BAUD_RATES[BAUD_RATE_COUNT - 1]);
+    const uint32_t maxRunSamples = static_cast<uint32_t>(MAX_RUN_BITS * SAMPLING_FREQ / BAUD_RATES[0]);
+    if (signalPresent_ && currentToneState_ && samplesSinceTransition_ >= minRunSamples && samplesSinceTransition_ <= maxRunSamples) {
+        runLengths_[runIndex_] = static_cast<uint16_t>(samplesSinceTransition_);
+        runIndex_ = (runIndex_ + 1) % RUN_HISTORY_SIZE;
+        if (runCount_ < RUN_HISTORY_SIZE) {
+            runCount_++;
+        }
 
-    RTTY_DEBUG("RTTY Baud estimation: %lu samples, avg bit time: %lu ms, baud: %lu\n", validSamples, averageBitTime, baudRate);
+        // Néhány új futamonként újrabecslés
+        if (runCount_ >= MIN_RUNS_FOR_ESTIMATE && (runIndex_ & 0x03) == 0) {
+            const float estimatedBaud = estimateBaudRate();
+            if (estimatedBaud != detectedBaudRate_) {
+                RTTY_DEBUG("RTTY: Baud rate updated to %.2f\n", estimatedBaud);
+                configureBitTiming(estimatedBaud);
+                figsShift_ = false;  // A rossz baud rate-tel vett karakterek FIGS váltása se maradjon meg
+            }
+        }
+    }
+    samplesSinceTransition_ = 0;
+}
 
-    return baudRate;
+/**
+ * @brief Mennyire illeszkednek a tárolt futamok egy baud rate bit hosszának egész többszöröseihez
+ * @return A futamonkénti pontok összege (RUN_FIT_TOLERANCE - eltérés bitekben, ha az pozitív)
+ */
+float RttyDecoder::scoreBaudRate(float baudRate) const {
+    const float bitSamples = SAMPLING_FREQ / baudRate;
+    float score = 0.0f;
+    for (uint8_t i = 0; i < runCount_; i++) {
+        const float bits = runLengths_[i] / bitSamples;
+        const float error = fabsf(bits - max(1.0f, roundf(bits)));
+        if (error < RUN_FIT_TOLERANCE) {
+            score += RUN_FIT_TOLERANCE - error;
+        }
+    }
+    return score;
 }
 
 /**
- * @brief Detektálja a shift frekvenciát
- * @return true ha sikeres a detektálás, false egyébként
+ * @brief Megbecsüli a baud rate-et a tárolt space futamok alapján
+ * @return A szabványos baud rate-ek közül az, amelynek bit hosszához a futamok a legjobban illeszkednek
+ *
+ * A kétszeres baud rate-hez is illeszkedik minden futam, ezért a gyorsabb csak egyértelműen jobb
+ * illeszkedéssel nyer, és a beállított baud rate-ről is csak egyértelműen jobbra váltunk.
  */
-bool RttyDecoder::detectShiftFrequency() {
-    float actualShift = abs(detectedMarkFreq_ - detectedSpaceFreq_);
-
-    // 850Hz shift ellenőrzése
-    if (abs(actualShift - TARGET_SHIFT_850HZ) <= SHIFT_TOLERANCE) {
-        detectedShiftFreq_ = TARGET_SHIFT_850HZ;
-        RTTY_DEBUG("RTTY Shift detected: 850Hz (actual: %.1f Hz)\n", actualShift);
-        return true;
+float RttyDecoder::estimateBaudRate() const {
+    float bestBaud = BAUD_RATES[0];
+    float bestScore = scoreBaudRate(BAUD_RATES[0]);
+    for (uint8_t b = 1; b < BAUD_RATE_COUNT; b++) {
+        const float score = scoreBaudRate(BAUD_RATES[b]);
+        if (score > bestScore * BAUD_SWITCH_MARGIN) {
+            bestScore = score;
+            bestBaud = BAUD_RATES[b];
+        }
     }
 
-    // 170Hz shift ellenőrzése (defines.h-ből)
-    if (abs(actualShift - TARGET_SHIFT_170HZ) <= SHIFT_TOLERANCE) {
-        detectedShiftFreq_ = TARGET_SHIFT_170HZ;
-        RTTY_DEBUG("RTTY Shift detected: 170Hz (actual: %.1f Hz)\n", actualShift);
-        return true;
+    // A beállított baud rate marad, ha közel olyan jó (kivéve, ha a lassabb a többszörösét is lefedi)
+    const float currentScore = scoreBaudRate(detectedBaudRate_);
+    if (bestScore < currentScore * BAUD_SWITCH_MARGIN && !(bestBaud < detectedBaudRate_ && bestScore >= currentScore)) {
+        return detectedBaudRate_;
     }
+    return bestBaud;
+}
 
-    RTTY_DEBUG("RTTY Shift not recognized: %.1f Hz\n", actualShift);
-    return false;
+/**
+ * @brief A keverők áthangolása a hang követő frekvenciáira
+ *
+ * A sodródás követése csak a keverők frekvenciáját módosítja. Nagy ugrásnál (új jel befogása)
+ * az ATC szintjei és a baud futamok a régi hangokhoz tartoztak, ezért újraindulnak.
+ */
+void RttyDecoder::updateToneTracking() {
+    const float markHz = toneTracker_.getMarkHz();
+    const float spaceHz = toneTracker_.getSpaceHz();
+    const bool retuned = fabsf(markHz - detectedMarkFreq_) > TONE_JUMP_HZ || fabsf(spaceHz - detectedSpaceFreq_) > TONE_JUMP_HZ;
+
+    detectedMarkFreq_ = markHz;
+    detectedSpaceFreq_ = spaceHz;
+    detectedShiftFreq_ = toneTracker_.getShiftHz();
+    configureTones();
+
+    if (retuned) {
+        mark_.peak = mark_.noise = 0.0f;
+        space_.peak = space_.noise = 0.0f;
+        contrast_ = 0.0f;
+        runIndex_ = 0;
+        runCount_ = 0;
+        figsShift_ = false;  // A befogás előtt vett szemét FIGS váltása se maradjon meg
+        configureBitTiming(detectedBaudRate_);
+        RTTY_DEBUG("RTTY: Tones acquired. Mark: %.1f Hz, Space: %.1f Hz, Shift: %.0f Hz\n", detectedMarkFreq_, detectedSpaceFreq_, detectedShiftFreq_);
+    }
 }
 
 /**
@@ -265,56 +510,6 @@ void RttyDecoder::resetRttyStateMachine() {
     currentByte_ = 0;
 }
 
-// --- AUTOMATIKUS MARK/SPACE FREKVENCIA FINE-TUNING ---
-// Meghívható pl. minden dekódolt karakter után vagy időnként
-void RttyDecoder::autoTuneFrequencies() {
-    // Keresési tartomány (Hz)
-    const float markStart = 2270.0f, markEnd = 2320.0f;
-    const float spaceStart = 2100.0f, spaceEnd = 2150.0f;
-    const float step = 5.0f;
-    float bestMark = detectedMarkFreq_;
-    float bestSpace = detectedSpaceFreq_;
-    float bestScore = 0.0f;
-    // Mintavétel a jelenlegi audio jellel
-    for (float markF = markStart; markF <= markEnd; markF += step) {
-        for (float spaceF = spaceStart; spaceF <= spaceEnd; spaceF += step) {
-            // Számold ki a Goertzel paramétereket
-            short kMark = round(N_SAMPLES * markF / SAMPLING_FREQ);
-            float coeffMark = 2.0f * cos(2.0f * M_PI * kMark / N_SAMPLES);
-            short kSpace = round(N_SAMPLES * spaceF / SAMPLING_FREQ);
-            float coeffSpace = 2.0f * cos(2.0f * M_PI * kSpace / N_SAMPLES);
-            // Mintavétel
-            float markMag = 0.0f, spaceMag = 0.0f;
-            // Goertzel Mark
-            float q1 = 0, q2 = 0, q0 = 0;
-            for (short i = 0; i < N_SAMPLES; i++) {
-                q0 = coeffMark * q1 - q2 + (float)testData[i];
-                q2 = q1;
-                q1 = q0;
-            }
-            markMag = sqrt(q1 * q1 + q2 * q2 - q1 * q2 * coeffMark);
-            // Goertzel Space
-            q1 = q2 = q0 = 0;
-            for (short i = 0; i < N_SAMPLES; i++) {
-                q0 = coeffSpace * q1 - q2 + (float)testData[i];
-                q2 = q1;
-                q1 = q0;
-            }
-            spaceMag = sqrt(q1 * q1 + q2 * q2 - q1 * q2 * coeffSpace);
-            float score = fabs(markMag - spaceMag);  // Minél nagyobb a különbség, annál jobb
-            if (score > bestScore) {
-                bestScore = score;
-                bestMark = markF;
-                bestSpace = spaceF;
-            }
-        }
-    }
-    detectedMarkFreq_ = bestMark;
-    detectedSpaceFreq_ = bestSpace;
-    // Frissítsd a Goertzel paramétereket is, ha szükséges
-    RTTY_DEBUG("RTTY: Auto-tuned Mark=%.1f Hz, Space=%.1f Hz (score=%.1f)\n", bestMark, bestSpace, bestScore);
-}
-
 /**
  * @brief Dekódol egy Baudot karaktert ASCII-ra
  * @param baudotCode 5-bites Baudot kód
@@ -339,7 +534,7 @@ char RttyDecoder::decodeBaudotCharacter(uint8_t baudotCode) {
     }
 
     // Karakter dekódolása
-    char result = figsShift_ ? BAUDOT_FIGS_TABLE[baudotCode] : BAUDOT_LTRS_TABLE[baudotCode];
+    char result = getBaudotCharacter(baudotCode, figsShift_);
 
     RTTY_DEBUG("RTTY: Decoded 0x%02X -> '%c' (%s mode)\n", baudotCode, result, figsShift_ ? "FIGS" : "LTRS");
 
@@ -347,161 +542,37 @@ char RttyDecoder::decodeBaudotCharacter(uint8_t baudotCode) {
 }
 
 /**
- * @brief Hozzáad egy karaktert a dekódolt karakterek pufferéhez
- * @param c A hozzáadandó karakter
+ * @brief Egy dekódolt karakter átadása a Core0-nak a közös szöveg gyűrűn
+ * @param c A karakter (a mark frekvencia és a baud rate kerül mellé)
  */
 void RttyDecoder::addToBuffer(char c) {
     if (c == '\0') {
-        return;  // Üres karaktert nem teszünk a pufferbe
-    }
-
-    decodedCharBuffer_[charBufferWritePos_] = c;
-    charBufferWritePos_ = (charBufferWritePos_ + 1) % DECODED_CHAR_BUFFER_SIZE;
-
-    if (charBufferCount_ < DECODED_CHAR_BUFFER_SIZE) {
-        charBufferCount_++;
-    } else {
-        // Puffer tele, legrégebbi elem felülírása
-        charBufferReadPos_ = (charBufferReadPos_ + 1) % DECODED_CHAR_BUFFER_SIZE;
+        return;  // Üres karaktert nem teszünk a gyűrűbe
     }
 
-    RTTY_DEBUG("RTTY: Buffer add: '%c'. Count: %d, R:%d, W:%d\n", c, charBufferCount_, charBufferReadPos_, charBufferWritePos_);
-}
-
-/**
- * @brief Kivesz egy karaktert a dekódolt karakterek pufferéből
- * @return A legrégebbi dekódolt karakter vagy '\0' ha a puffer üres
- */
-char RttyDecoder::getCharacterFromBuffer() {
-    if (charBufferCount_ == 0) {
-        return '\0';
+    const uint8_t baud = static_cast<uint8_t>(detectedBaudRate_ + 0.5f);
+    if (!decodedTextRing.push(DecodedTextSource::Rtty, c, static_cast<uint16_t>(detectedMarkFreq_ + 0.5f), baud)) {
+        RTTY_DEBUG("RTTY: Text ring full, '%c' dropped\n", c);
+        return;
     }
-
-    char c = decodedCharBuffer_[charBufferReadPos_];
-    charBufferReadPos_ = (charBufferReadPos_ + 1) % DECODED_CHAR_BUFFER_SIZE;
-    charBufferCount_--;
-
-    RTTY_DEBUG("RTTY: Buffer read: '%c' Count: %d, R:%d, W:%d\n", c, charBufferCount_, charBufferReadPos_, charBufferWritePos_);
-
-    return c;
+    RTTY_DEBUG("RTTY: Ring add: '%c'\n", c);
 }
 
 /**
  * @brief Az RTTY dekóder fő ciklikus feldolgozó függvénye
  *
- * Ez a Core1-en futó main loop, amely folyamatosan:
- * - Mintavételezi az audio jelet és detektálja az RTTY hangokat
- * - Automatikusan detektálja a shift frekvenciát és baud rate-et
- * - Dekódolja az RTTY karaktereket Baudot kódból ASCII-ra
- * - Kezeli a LTRS/FIGS shift állapotokat
- * - Puffereli a dekódolt karaktereket a Core0 számára
+ * A Core1 ütemezője hívja, ha van legalább egy blokknyi új minta. Az összes kész mintát
+ * várakozás nélkül feldolgozza; az időzítés a minták számából adódik, így a hívás késése
+ * nem okoz bit hibát.
  */
 void RttyDecoder::updateDecoder() {
-    unsigned long currentTime = millis();
-
-    // Automatikus detektálás időtúllépés ellenőrzése
-    if (autoDetectActive_ && (currentTime - autoDetectStartMs_) > AUTO_DETECT_TIMEOUT_MS) {
-        autoDetectActive_ = false;
-        RTTY_DEBUG("RTTY: Auto-detect timeout, using default settings\n");
+    if (!sampleReader_.isRunning()) {
+        return;
     }
 
-    // Hangállapot detektálása
-    if (!detectToneState()) {
-        return;  // Nincs érvényes jel
-    }
-
-    // Baud rate detektálás frissítése
-    if (autoDetectActive_) {
-        updateBaudRateDetection();
-
-        // Baud rate becslés frissítése
-        if ((currentTime - autoDetectStartMs_) > 2000) {  // 2 sec után
-            unsigned long estimatedBaud = estimateBaudRate();
-            if (estimatedBaud != detectedBaudRate_) {
-                detectedBaudRate_ = estimatedBaud;
-                bitDurationMs_ = 1000 / detectedBaudRate_;
-                RTTY_DEBUG("RTTY: Baud rate updated to %lu (bit duration: %lu ms)\n", detectedBaudRate_, bitDurationMs_);
-            }
-        }
-    }
-
-    // RTTY állapotgép időzítési logikája
-    switch (currentState_) {
-        case IDLE:
-            // Start bit (Space) keresése
-            if (!currentToneState_) {  // Space jel
-                currentState_ = WAITING_FOR_START_BIT;
-                startBitTimeMs_ = currentTime;
-                RTTY_DEBUG("RTTY: Potential start bit detected at %lu ms\n", currentTime);
-            }
-            break;
-
-        case WAITING_FOR_START_BIT:
-            // Start bit megerősítése (fél bit idő után)
-            if (currentTime - startBitTimeMs_ >= (bitDurationMs_ / 2)) {
-                if (!currentToneState_) {  // Még mindig Space
-                    currentState_ = RECEIVING_DATA_BITS;
-                    bitsReceived_ = 0;
-                    currentByte_ = 0;
-                    lastBitTimeMs_ = startBitTimeMs_ + bitDurationMs_;  // Első data bit időpontja
-                    RTTY_DEBUG("RTTY: Start bit confirmed, first data bit at %lu ms\n", lastBitTimeMs_);
-                } else {
-                    // Téves start bit
-                    currentState_ = IDLE;
-                    RTTY_DEBUG("RTTY: False start bit, back to IDLE\n");
-                }
-            }
-            break;
-
-        case RECEIVING_DATA_BITS:
-            // Data bit mintavételezése a bit közepén
-            if (currentTime >= lastBitTimeMs_) {
-                // Bit mintavételezése
-                if (currentToneState_) {  // Mark = 1
-                    currentByte_ |= (1 << bitsReceived_);
-                }
-                bitsReceived_++;
-
-                RTTY_DEBUG("RTTY: Data bit %d: %s (byte: 0x%02X) at %lu ms\n", bitsReceived_, currentToneState_ ? "Mark" : "Space", currentByte_, currentTime);
-
-                if (bitsReceived_ >= 5) {  // 5 data bits received
-                    currentState_ = RECEIVING_STOP_BIT;
-                    lastBitTimeMs_ += bitDurationMs_;  // Stop bit időpontja
-                    RTTY_DEBUG("RTTY: 5 data bits received, stop bit expected at %lu ms\n", lastBitTimeMs_);
-                } else {
-                    lastBitTimeMs_ += bitDurationMs_;  // Következő data bit időpontja
-                }
-            }
-            break;
-
-        case RECEIVING_STOP_BIT: {
-            // 7 minta a stop bit periódusán belül, többségi szavazás + részletes log
-            int markCount = 0;
-            const int sampleCount = 7;
-            char sampleLog[16] = {0};
-            delay(bitDurationMs_ / (sampleCount + 1));
-            for (int i = 0; i < sampleCount; ++i) {
-                bool valid = detectToneState() && currentToneState_;
-                if (valid) markCount++;
-                sampleLog[i] = valid ? 'M' : 'S';
-                if (i < sampleCount - 1) {
-                    delay(bitDurationMs_ / (sampleCount + 1));
-                }
-            }
-            RTTY_DEBUG("RTTY: Stop bit samples: %s (%d Mark, %d Space)\n", sampleLog, markCount, sampleCount - markCount);
-            if (markCount >= 4) {  // Legalább 4 Mark: érvényes stop bit
-                char decodedChar = decodeBaudotCharacter(currentByte_);
-                if (decodedChar != '\0') {
-                    addToBuffer(decodedChar);
-                    RTTY_DEBUG("RTTY: Character decoded: '%c' (0x%02X) at %lu ms [7-sample stop bit]\n", decodedChar, currentByte_, millis());
-                    autoTuneFrequencies();  // <-- automatikus finomhangolás
-                }
-            } else {
-                RTTY_DEBUG("RTTY: Invalid stop bit (Space, majority, 7-sample) at %lu ms, discarding character 0x%02X\n", millis(), currentByte_);
-            }
-            // Reset for next character
-            resetRttyStateMachine();
-            break;
-        }
+    int16_t block[BLOCK_SAMPLES];
+    uint16_t count;
+    while ((count = sampleReader_.read(block, BLOCK_SAMPLES)) > 0) {
+        processSamples(block, count);
     }
 }
@@ -0,0 +1,178 @@
+#include "RttyToneTracker.h"
+
+#include <Arduino.h>
+
+#include <cmath>
+
+/**
+ * @brief Konstruktor
+ * @param sampleRateHz A bemeneti minták frekvenciája
+ */
+RttyToneTracker::RttyToneTracker(float sampleRateHz)
+    : frameFill_(0),
+      averagePrimed_(false),
+      binWidthHz_(sampleRateHz / RttyToneTrackerConstants::FFT_SIZE),
+      anchorMarkHz_(0.0f),
+      markHz_(0.0f),
+      spaceHz_(0.0f),
+      shiftHz_(0.0f),
+      locked_(false),
+      candidateMarkHz_(0.0f),
+      candidateShiftHz_(0.0f),
+      candidateFrames_(0) {
+    fft_.setWindowType(FftWindowType::Hann);
+    fft_.setSize(RttyToneTrackerConstants::FFT_SIZE);
+}
+
+/**
+ * @brief Új keresés a beállított hangok körül
+ * @param markHz A beállított mark frekvencia (a keresés közepe)
+ * @param shiftHz A beállított shift
+ */
+void RttyToneTracker::reset(float markHz, float shiftHz) {
+    anchorMarkHz_ = markHz;
+    markHz_ = markHz;
+    spaceHz_ = markHz - shiftHz;
+    shiftHz_ = shiftHz;
+    locked_ = false;
+    candidateFrames_ = 0;
+    frameFill_ = 0;
+    averagePrimed_ = false;
+}
+
+/**
+ * @brief Minták hozzáadása; egy teljes keretnél új spektrum és becslés
+ * @param samples A minták
+ * @param count A minták száma
+ * @return true ha a követett frekvenciák frissültek
+ */
+bool RttyToneTracker::addSamples(const int16_t *samples, uint16_t count) {
+    if (!isReady()) {
+        return false;
+    }
+
+    bool updated = false;
+    while (count > 0) {
+        const uint16_t chunk = min(count, static_cast<uint16_t>(RttyToneTrackerConstants::FFT_SIZE - frameFill_));
+        memcpy(&frame_[frameFill_], samples, chunk * sizeof(int16_t));
+        frameFill_ += chunk;
+        samples += chunk;
+        count -= chunk;
+
+        if (frameFill_ == RttyToneTrackerConstants::FFT_SIZE) {
+            frameFill_ = 0;
+            updated |= analyzeFrame();
+        }
+    }
+    return updated;
+}
+
+/**
+ * @brief Egy bin körüli csúcs pontos helye parabolikus interpolációval
+ * @param bin A csúcs környéki bin (a szomszédai közül a legnagyobbra lép)
+ * @return A csúcs frekvenciája Hz-ben
+ */
+float RttyToneTracker::refinePeakHz(uint16_t bin) const {
+    constexpr uint16_t LAST_BIN = RttyToneTrackerConstants::FFT_SIZE / 2 - 1;
+
+    // A durva keresés a shift-re kerekített binjét adja, a valódi csúcs lehet a szomszéd
+    if (bin > 1 && average_[bin - 1] > average_[bin]) {
+        bin--;
+    } else if (bin < LAST_BIN - 1 && average_[bin + 1] > average_[bin]) {
+        bin++;
+    }
+    if (bin == 0 || bin >= LAST_BIN) {
+        return bin * binWidthHz_;
+    }
+
+    const float left = average_[bin - 1];
+    const float center = average_[bin];
+    const float right = average_[bin + 1];
+    const float denominator = left - 2.0f * center + right;
+    const float offset = denominator < 0.0f ? constrain(0.5f * (left - right) / denominator, -0.5f, 0.5f) : 0.0f;
+    return (bin + offset) * binWidthHz_;
+}
+
+/**
+ * @brief Egy teljes keret feldolgozása: spektrum, átlag, hang pár keresés, befogás és követés
+ * @return true ha a követett frekvenciák frissültek
+ */
+bool RttyToneTracker::analyzeFrame() {
+    using namespace RttyToneTrackerConstants;
+    constexpr uint16_t LAST_BIN = FFT_SIZE / 2 - 1;
+
+    fft_.computeMagnitudes(frame_, magnitudes_);
+    if (!averagePrimed_) {
+        memcpy(average_, magnitudes_, sizeof(average_));
+        averagePrimed_ = true;
+    } else {
+        for (uint16_t k = 0; k <= LAST_BIN; k++) {
+            average_[k] += (magnitudes_[k] - average_[k]) * AVERAGE_COEFF;
+        }
+    }
+
+    // A mark keresési tartománya és a teljes vizsgált sáv (a legnagyobb shift-tel lejjebb a space)
+    const uint16_t markLow = static_cast<uint16_t>(constrain((anchorMarkHz_ - SEARCH_RANGE_HZ) / binWidthHz_, 1.0f, static_cast<float>(LAST_BIN - 1)));
+    const uint16_t markHigh = static_cast<uint16_t>(constrain((anchorMarkHz_ + SEARCH_RANGE_HZ) / binWidthHz_, 1.0f, static_cast<float>(LAST_BIN - 1)));
+    const uint16_t bandLow = static_cast<uint16_t>(max(1.0f, markLow - SHIFTS_HZ[SHIFT_COUNT - 1] / binWidthHz_));
+
+    float floor = 0.0f;
+    for (uint16_t k = bandLow; k <= markHigh; k++) {
+        floor += average_[k];
+    }
+    floor /= markHigh - bandLow + 1;
+
+    // A legjobb hang pár: a gyengébb hang csúcsa számít (egyetlen vivő nem RTTY)
+    float bestScore = 0.0f;
+    uint16_t bestMarkBin = 0;
+    uint16_t bestSpaceBin = 0;
+    uint8_t bestShift = 0;
+    for (uint8_t s = 0; s < SHIFT_COUNT; s++) {
+        const uint16_t offset = static_cast<uint16_t>(SHIFTS_HZ[s] / binWidthHz_ + 0.5f);
+        for (uint16_t m = max(markLow, static_cast<uint16_t>(offset + 1)); m <= markHigh; m++) {
+            const float score = min(average_[m], average_[m - offset]);
+            if (score > bestScore) {
+                bestScore = score;
+                bestMarkBin = m;
+                bestSpaceBin = m - offset;
+                bestShift = s;
+            }
+        }
+    }
+
+    if (bestScore < MIN_PEAK_TO_FLOOR * floor) {
+        candidateFrames_ = 0;
+        return false;  // Nincs RTTY jel: a követés marad
+    }
+
+    const float measuredMarkHz = refinePeakHz(bestMarkBin);
+    const float measuredSpaceHz = refinePeakHz(bestSpaceBin);
+    const float shiftHz = SHIFTS_HZ[bestShift];
+
+    // Új jel vagy shift: csak több egyező keret után fogjuk be
+    if (!locked_ || shiftHz != shiftHz_ || fabsf(measuredMarkHz - markHz_) > PULL_IN_HZ) {
+        if (candidateFrames_ > 0 && shiftHz == candidateShiftHz_ && fabsf(measuredMarkHz - candidateMarkHz_) <= binWidthHz_) {
+            candidateFrames_++;
+        } else {
+            candidateMarkHz_ = measuredMarkHz;
+            candidateShiftHz_ = shiftHz;
+            candidateFrames_ = 1;
+        }
+        if (candidateFrames_ < CONFIRM_FRAMES) {
+            return false;
+        }
+
+        markHz_ = measuredMarkHz;
+        spaceHz_ = measuredSpaceHz;
+        shiftHz_ = shiftHz;
+        locked_ = true;
+        candidateFrames_ = 0;
+        return true;
+    }
+
+    // Sodródás követése kis erősítésű hurokkal
+    candidateFrames_ = 0;
+    markHz_ += constrain((measuredMarkHz - markHz_) * LOOP_GAIN, -MAX_LOOP_STEP_HZ, MAX_LOOP_STEP_HZ);
+    spaceHz_ += constrain((measuredSpaceHz - spaceHz_) * LOOP_GAIN, -MAX_LOOP_STEP_HZ, MAX_LOOP_STEP_HZ);
+    return true;
+}
@@ -101,6 +101,7 @@ void ScreenSaverDisplay::displayLoop() {
 
         // Frekvencia pozícionálkása és kijelzése
         pSevenSegmentFreq->setPositions(saverX - xOffset, saverY);
+        pSevenSegmentFreq->invalidate();  // A képernyőt töröltük
         pSevenSegmentFreq->freqDispl(currentFrequency);
 
         // Az animált keretet hozzá igazítjuk a frekvenciához
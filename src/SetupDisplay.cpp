@@ -1,5 +1,6 @@
 #include "SetupDisplay.h"
 
+#include "Core1Mailbox.h"
 #include "InfoDialog.h"
 #include "MultiButtonDialog.h"
 #include "ValueChangeDialog.h"
@@ -329,6 +330,13 @@ void SetupDisplay::activateSetting(SetupList::ItemAction action, int itemIndex)
             DisplayBase::pDialog = new ValueChangeDialog(this, DisplayBase::tft, 270, 150, F("CW Receiver Offset"), F("Hz (600-1500):"), (int *)&config.data.cwReceiverOffsetHz,
                                                          (int)CW_DECODER_MIN_FREQUENCY, (int)CW_DECODER_MAX_FREQUENCY, (int)10, [this](int newOffset) {
                                                              // A ValueChangeDialog már beállította a config értékét.
+                                                             // A futó CW dekódert élőben hangoljuk át (más módban a Core1 NotApplicable-t válaszol)
+                                                             Core1Message message;
+                                                             message.command = CORE1_CMD_SET_CW_PARAMS;
+                                                             message.params.cw.offsetHz = static_cast<uint16_t>(newOffset);
+                                                             if (core1Mailbox.post(message) == 0) {
+                                                                 DEBUG("Core0: CW parameters NOT sent to Core1, mailbox full\n");
+                                                             }
                                                          });
             break;
 
@@ -1,6 +1,7 @@
 #include "SevenSegmentFreq.h"
 
 #include "DSEG7_Classic_Mini_Regular_34.h"
+#include "SevenSegmentGlyphAtlas.h"
 #include "utils.h"  // Beep miatt
 
 namespace SevenSegmentConstants {
@@ -41,6 +42,9 @@ constexpr uint16_t ClearAreaBaseWidth = 240;                          // Törlé
 constexpr uint16_t ClearAreaHeightCorrection = UnderlineHeight + 15;  // Magasság korrekció (aláhúzás + unit)
 }  // namespace SevenSegmentConstants
 
+// A DSEG7 karakterek előre raszterizálva (az összes példány közös atlasza)
+static const SevenSegmentGlyphAtlas glyphAtlas(DSEG7_Classic_Mini_Regular_34);
+
 // Színek a különböző módokhoz
 const SegmentColors normalColors = {TFT_GOLD, TFT_COLOR(50, 50, 50), TFT_YELLOW};
 const SegmentColors screenSaverColors = {TFT_SKYBLUE, TFT_COLOR(50, 50, 50), TFT_SKYBLUE};
@@ -85,6 +89,35 @@ uint32_t SevenSegmentFreq::calcFreqSpriteXPosition() const {
     return x;
 }
 
+/**
+ * @brief A sprite és a cellák beállítása egy maszkhoz (csak ha változott a maszk)
+ * @param mask A maszk
+ * @return false, ha nem sikerült a sprite-ot lefoglalni
+ *
+ * A sprite csak akkor foglalódik újra, ha a maszk szélessége más (pl. BFO be/ki).
+ * A cellák origója ugyanaz, mint a maszk BR_DATUM-os drawString() rajzolásánál.
+ */
+bool SevenSegmentFreq::setupLayout(const char* mask) {
+    spr.setFreeFont(&DSEG7_Classic_Mini_Regular_34);
+    const uint16_t contentWidth = spr.textWidth(mask);
+    if (!spr.created() || spr.width() != contentWidth) {
+        spr.deleteSprite();
+        if (spr.createSprite(contentWidth, FREQ_7SEGMENT_HEIGHT) == nullptr) {
+            layoutMask = nullptr;
+            return false;
+        }
+    }
+
+    cellCount = min(strlen(mask), (size_t)MAX_CELLS);
+    int16_t x = 0;
+    for (uint8_t i = 0; i < cellCount; i++) {
+        cellX[i] = x;
+        x += glyphAtlas.getAdvance(mask[i]);
+    }
+    layoutMask = mask;
+    return true;
+}
+
 /**
  * @brief Kirajzolja a frekvenciát a megadott formátumban.
  *
@@ -92,49 +125,87 @@ uint32_t SevenSegmentFreq::calcFreqSpriteXPosition() const {
  * @param mask A nem aktív szegmensek maszkja.
  * @param colors A szegmensek színei.
  * @param unit A mértékegység.
+ * @return true, ha teljes kirajzolás volt (a kiegészítő feliratokat is rajzolni kell)
  */
-void SevenSegmentFreq::drawFrequency(const String& freq, const char* mask, const SegmentColors& colors, const char* unit) {
+bool SevenSegmentFreq::drawFrequency(const String& freq, const char* mask, const SegmentColors& colors, const char* unit) {
     using namespace SevenSegmentConstants;
-    spr.setFreeFont(&DSEG7_Classic_Mini_Regular_34);
-    uint16_t contentWidth = spr.textWidth(mask);
-    uint32_t x = calcFreqSpriteXPosition();
-    uint16_t spritePushX = freqDispX + x - contentWidth;
-    uint16_t spritePushY = freqDispY + SpriteYOffset;
-    spr.createSprite(contentWidth, FREQ_7SEGMENT_HEIGHT);
-    spr.fillScreen(TFT_COLOR_BACKGROUND);
-    spr.setTextSize(1);
-    spr.setTextPadding(0);
-    spr.setFreeFont(&DSEG7_Classic_Mini_Regular_34);
-    spr.setTextDatum(BR_DATUM);
-    if (config.data.tftDigitLigth) {
-        spr.setTextColor(colors.inactive);
-        spr.drawString(mask, contentWidth, FREQ_7SEGMENT_HEIGHT);
+
+    // Elrendezés váltáskor, más színekkel vagy más digit világítással mindent újrarajzolunk
+    bool repaint = shownColors != &colors or shownDigitLight != config.data.tftDigitLigth;
+    if (mask != layoutMask or !spr.created()) {
+        if (!setupLayout(mask)) {
+            return false;
+        }
+        repaint = true;
     }
-    if (mask != nullptr) {
-        int maskLen = strlen(mask);
-        int freqLen = freq.length();
-        char buf[maskLen + 1];
-        int freqIdx = freqLen - 1;
-        for (int i = maskLen - 1; i >= 0; --i) {
-            if (mask[i] == ' ') {
-                buf[i] = ' ';
-            } else {
-                buf[i] = (freqIdx >= 0) ? freq[freqIdx--] : ' ';
-            }
+
+    // A frekvencia karakterei jobbról a maszk helyeire, a maszk szóközei maradnak
+    char text[MAX_CELLS + 1];
+    int freqIdx = freq.length() - 1;
+    for (int i = cellCount - 1; i >= 0; --i) {
+        if (mask[i] == ' ') {
+            text[i] = ' ';
+        } else {
+            text[i] = (freqIdx >= 0) ? freq[freqIdx--] : ' ';
         }
-        buf[maskLen] = '\0';
-        spr.setTextColor(colors.active);
-        spr.drawString(buf, contentWidth, FREQ_7SEGMENT_HEIGHT);
-    } else {
-        spr.setTextColor(colors.active);
-        spr.drawString(freq.c_str(), contentWidth, FREQ_7SEGMENT_HEIGHT);
     }
-    spr.pushSprite(spritePushX, spritePushY);
-    spr.deleteSprite();
-    uint16_t spriteRightEdgeX = spritePushX + contentWidth;
-    if (unit != nullptr) {
+    text[cellCount] = '\0';
+
+    // A megváltozott cellák újrarajzolása a sprite pufferében, az atlaszból
+    uint16_t* pixels = static_cast<uint16_t*>(spr.getPointer());
+    const int16_t spriteWidth = spr.width();
+    const int16_t baselineY = FREQ_7SEGMENT_HEIGHT - glyphAtlas.getDescent();
+    if (repaint) {
+        spr.fillSprite(TFT_COLOR_BACKGROUND);
+    }
+    int16_t dirtyLeft = spriteWidth;
+    int16_t dirtyRight = 0;
+    for (uint8_t i = 0; i < cellCount; i++) {
+        if (!repaint and text[i] == shownText[i]) {
+            continue;
+        }
+        int16_t left = INT16_MAX;
+        int16_t right = INT16_MIN;
+        glyphAtlas.addGlyphSpan(mask[i], cellX[i], left, right);
+        glyphAtlas.addGlyphSpan(shownText[i], cellX[i], left, right);
+        glyphAtlas.addGlyphSpan(text[i], cellX[i], left, right);
+        left = constrain(left, 0, spriteWidth);
+        right = constrain(right, left, spriteWidth);
+        if (!repaint) {
+            spr.fillRect(left, 0, right - left, FREQ_7SEGMENT_HEIGHT, TFT_COLOR_BACKGROUND);
+        }
+        if (config.data.tftDigitLigth) {
+            glyphAtlas.drawGlyph(pixels, spriteWidth, FREQ_7SEGMENT_HEIGHT, cellX[i], baselineY, mask[i], colors.inactive);
+        }
+        glyphAtlas.drawGlyph(pixels, spriteWidth, FREQ_7SEGMENT_HEIGHT, cellX[i], baselineY, text[i], colors.active);
+        shownText[i] = text[i];
+        if (left < right) {
+            dirtyLeft = min(dirtyLeft, left);
+            dirtyRight = max(dirtyRight, right);
+        }
+    }
+    shownColors = &colors;
+    shownDigitLight = config.data.tftDigitLigth;
+
+    // Kiküldés: pozíció váltáskor vagy érvénytelenítés után a teljes sprite, egyébként csak a változott oszlopok
+    uint32_t x = calcFreqSpriteXPosition();
+    uint16_t spritePushX = freqDispX + x - spriteWidth;
+    uint16_t spritePushY = freqDispY + SpriteYOffset;
+    const bool fullRedraw = repaint or !screenValid or spritePushX != pushedX or spritePushY != pushedY;
+    if (fullRedraw) {
+        spr.pushSprite(spritePushX, spritePushY);
+    } else if (dirtyLeft < dirtyRight) {
+        spr.pushSprite(spritePushX + dirtyLeft, spritePushY, dirtyLeft, 0, dirtyRight - dirtyLeft, FREQ_7SEGMENT_HEIGHT);
+    }
+    pushedX = spritePushX;
+    pushedY = spritePushY;
+    screenValid = true;
+
+    uint16_t spriteRightEdgeX = spritePushX + spriteWidth;
+    if (fullRedraw and unit != nullptr) {
         this->drawUnitLabel(spriteRightEdgeX + UnitXOffset, spritePushY + FREQ_7SEGMENT_HEIGHT, unit, colors.indicator, TFT_COLOR_BACKGROUND);
     }
+    return fullRedraw;
 }
 
 /**
@@ -225,6 +296,7 @@ void SevenSegmentFreq::clearDisplayArea() {
     // A szélességnek elég nagynak kell lennie, hogy minden módot lefedjen
     tft.fillRect(freqDispX, freqDispY + SevenSegmentConstants::SpriteYOffset, SevenSegmentConstants::ClearAreaBaseWidth, FREQ_7SEGMENT_HEIGHT + clearHeightCorr,
                  TFT_COLOR_BACKGROUND);
+    screenValid = false;
 }
 
 /**
@@ -278,8 +350,8 @@ void SevenSegmentFreq::displaySsbCwFrequency(uint16_t currentFrequency, const Se
                 delay(100);
             }
         }
-        if (!rtv::bfoOn) {
-            drawFrequency(s, MASK_MAIN, colors, nullptr);
+        // A "kHz" felirat és az aláhúzás csak teljes kirajzoláskor (az aláhúzás változását a handleTouch() rajzolja)
+        if (!rtv::bfoOn and drawFrequency(s, MASK_MAIN, colors, nullptr)) {
             tft.setTextDatum(BC_DATUM);
             tft.setFreeFont();
             tft.setTextSize(2);
@@ -289,21 +361,27 @@ void SevenSegmentFreq::displaySsbCwFrequency(uint16_t currentFrequency, const Se
         }
     }
     if (rtv::bfoOn) {
-        drawFrequency(String(config.data.currentBFOmanu), MASK_BFO, colors, nullptr);
-        tft.setTextSize(2);
-        tft.setTextDatum(BL_DATUM);
-        tft.setTextColor(colors.indicator, TFT_COLOR_BACKGROUND);
-        tft.drawString(UNIT_HZ, freqDispX + BfoHzLabelXOffset, freqDispY + BfoHzLabelYOffset);
-        tft.setTextColor(TFT_BLACK, colors.active);
-        tft.fillRect(freqDispX + BfoLabelRectXOffset, freqDispY + BfoLabelRectYOffset, BfoLabelRectW, BfoLabelRectH, colors.active);
-        tft.setTextDatum(MC_DATUM);
-        tft.drawString("BFO", freqDispX + BfoLabelRectXOffset + BfoLabelRectW / 2, freqDispY + BfoLabelRectYOffset + BfoLabelRectH / 2);
+        // A "Hz", "BFO" és "kHz" feliratok csak teljes kirajzoláskor, a kicsinyített frekvencia mindig
+        const bool fullRedraw = drawFrequency(String(config.data.currentBFOmanu), MASK_BFO, colors, nullptr);
+        tft.setFreeFont();
+        if (fullRedraw) {
+            tft.setTextSize(2);
+            tft.setTextDatum(BL_DATUM);
+            tft.setTextColor(colors.indicator, TFT_COLOR_BACKGROUND);
+            tft.drawString(UNIT_HZ, freqDispX + BfoHzLabelXOffset, freqDispY + BfoHzLabelYOffset);
+            tft.setTextColor(TFT_BLACK, colors.active);
+            tft.fillRect(freqDispX + BfoLabelRectXOffset, freqDispY + BfoLabelRectYOffset, BfoLabelRectW, BfoLabelRectH, colors.active);
+            tft.setTextDatum(MC_DATUM);
+            tft.drawString("BFO", freqDispX + BfoLabelRectXOffset + BfoLabelRectW / 2, freqDispY + BfoLabelRectYOffset + BfoLabelRectH / 2);
+        }
         tft.setTextSize(2);
         tft.setTextDatum(BR_DATUM);
         tft.setTextColor(colors.indicator, TFT_COLOR_BACKGROUND);
         tft.drawString(s, freqDispX + BfoMiniFreqX, freqDispY + BfoMiniFreqY);
-        tft.setTextSize(1);
-        tft.drawString(UNIT_KHZ, freqDispX + BfoMiniFreqX + BfoMiniUnitXOffset, freqDispY + BfoMiniFreqY);
+        if (fullRedraw) {
+            tft.setTextSize(1);
+            tft.drawString(UNIT_KHZ, freqDispX + BfoMiniFreqX + BfoMiniUnitXOffset, freqDispY + BfoMiniFreqY);
+        }
     }
 }
 
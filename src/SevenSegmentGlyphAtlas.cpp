@@ -0,0 +1,132 @@
+#include "SevenSegmentGlyphAtlas.h"
+
+#include <string.h>
+
+/**
+ * @brief Az atlasz felépítése
+ * @param font A 7 szegmenses GFX font
+ *
+ * A GFX font bitképe soronként nem igazított, MSB-first bitfolyam; ezt bontjuk soronkénti
+ * bitmaszkokra. A szélesebb/magasabb részeket levágjuk (a DSEG7 számjegyek 22x34-esek).
+ */
+SevenSegmentGlyphAtlas::SevenSegmentGlyphAtlas(const GFXfont &font) : glyphs_(), descent_(0) {
+    // Az alapvonal alatti legnagyobb kiterjedés, ugyanúgy, ahogy a TFT_eSPI setFreeFont() számolja
+    const uint16_t numChars = font.last - font.first;
+    for (uint16_t c = 0; c < numChars; c++) {
+        const GFXglyph &fontGlyph = font.glyph[c];
+        const int16_t below = fontGlyph.height + fontGlyph.yOffset;
+        if (below > descent_) {
+            descent_ = below;
+        }
+    }
+
+    for (uint8_t i = 0; i < CHAR_COUNT; i++) {
+        const uint16_t code = static_cast<uint8_t>(CHARS[i]);
+        if (code < font.first || code > font.last) {
+            continue;  // Üres karakter marad
+        }
+        const GFXglyph &fontGlyph = font.glyph[code - font.first];
+        Glyph &glyph = glyphs_[i];
+        glyph.xOffset = fontGlyph.xOffset;
+        glyph.yOffset = fontGlyph.yOffset;
+        glyph.width = fontGlyph.width < 32 ? fontGlyph.width : 32;
+        glyph.height = fontGlyph.height < MAX_GLYPH_HEIGHT ? fontGlyph.height : MAX_GLYPH_HEIGHT;
+        glyph.xAdvance = fontGlyph.xAdvance;
+
+        const uint8_t *bitmap = font.bitmap + fontGlyph.bitmapOffset;
+        uint32_t bitIndex = 0;
+        for (uint8_t row = 0; row < fontGlyph.height; row++) {
+            uint32_t rowBits = 0;
+            for (uint8_t col = 0; col < fontGlyph.width; col++, bitIndex++) {
+                if (row < glyph.height && col < glyph.width && (bitmap[bitIndex >> 3] & (0x80 >> (bitIndex & 7)))) {
+                    rowBits |= 0x80000000UL >> col;
+                }
+            }
+            if (row < glyph.height) {
+                glyph.rows[row] = rowBits;
+            }
+        }
+    }
+}
+
+/**
+ * @brief A karakter indexe az atlaszban (-1, ha nincs benne)
+ */
+int8_t SevenSegmentGlyphAtlas::indexOf(char c) {
+    const char *found = (c != '\0') ? strchr(CHARS, c) : nullptr;
+    return found != nullptr ? found - CHARS : -1;
+}
+
+/**
+ * @brief Egy karakter az atlaszból
+ * @return nullptr, ha a karakter nincs az atlaszban
+ */
+const SevenSegmentGlyphAtlas::Glyph *SevenSegmentGlyphAtlas::getGlyph(char c) const {
+    const int8_t index = indexOf(c);
+    return index >= 0 ? &glyphs_[index] : nullptr;
+}
+
+/**
+ * @brief A karakter utáni kurzor léptetés (0, ha nincs az atlaszban)
+ */
+uint8_t SevenSegmentGlyphAtlas::getAdvance(char c) const {
+    const Glyph *glyph = getGlyph(c);
+    return glyph != nullptr ? glyph->xAdvance : 0;
+}
+
+/**
+ * @brief A karakter oszlop tartományának hozzáadása egy [left, right) tartományhoz
+ * @param c A karakter
+ * @param originX A karakter origója
+ * @param left A tartomány bal széle (bővül)
+ * @param right A tartomány jobb széle, kizárólagos (bővül)
+ */
+void SevenSegmentGlyphAtlas::addGlyphSpan(char c, int16_t originX, int16_t &left, int16_t &right) const {
+    const Glyph *glyph = getGlyph(c);
+    if (glyph == nullptr || glyph->width == 0) {
+        return;
+    }
+    const int16_t glyphLeft = originX + glyph->xOffset;
+    const int16_t glyphRight = glyphLeft + glyph->width;
+    if (glyphLeft < left) {
+        left = glyphLeft;
+    }
+    if (glyphRight > right) {
+        right = glyphRight;
+    }
+}
+
+/**
+ * @brief Egy karakter kirajzolása átlátszó háttérrel egy 16 bites sprite pufferébe
+ * @param pixels A sprite puffere (a kijelző bájtsorrendjében, mint a TFT_eSprite)
+ * @param bufWidth A puffer szélessége
+ * @param bufHeight A puffer magassága
+ * @param originX A karakter origója
+ * @param baselineY Az alapvonal
+ * @param c A karakter (ha nincs az atlaszban, nem rajzol semmit)
+ * @param color A szín (natív RGB565)
+ */
+void SevenSegmentGlyphAtlas::drawGlyph(uint16_t *pixels, int16_t bufWidth, int16_t bufHeight, int16_t originX, int16_t baselineY, char c, uint16_t color) const {
+    const Glyph *glyph = getGlyph(c);
+    if (pixels == nullptr || glyph == nullptr) {
+        return;
+    }
+    const uint16_t panelColor = (color >> 8) | (color << 8);  // A sprite a kijelző bájtsorrendjében tárol
+    const int16_t left = originX + glyph->xOffset;
+    const int16_t top = baselineY + glyph->yOffset;
+
+    for (uint8_t row = 0; row < glyph->height; row++) {
+        const int16_t y = top + row;
+        if (y < 0 || y >= bufHeight) {
+            continue;
+        }
+        uint16_t *line = pixels + y * bufWidth;
+        const uint32_t rowBits = glyph->rows[row];
+        for (uint8_t col = 0; col < glyph->width; col++) {
+            const int16_t x = left + col;
+            if ((rowBits & (0x80000000UL >> col)) && x >= 0 && x < bufWidth) {
+                line[x] = panelColor;
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include "SpectrumFrameBuffer.h"
+
+#include <hardware/sync.h>  // __dmb()
+
+// A két mag közös példánya (statikus SRAM, mindkét magról elérhető)
+SpectrumFrameBuffer spectrumFrameBuffer;
+
+/**
+ * @brief Konstruktor
+ */
+SpectrumFrameBuffer::SpectrumFrameBuffer()
+    : latestIndex_(SpectrumFrameBufferConstants::NO_FRAME),
+      readIndex_(SpectrumFrameBufferConstants::NO_FRAME),
+      writeIndex_(0),
+      publishedCount_(0),
+      acquiredSequence_(0),
+      acquiredCount_(0) {}
+
+/**
+ * @brief A következő írható képkocka kiválasztása: se nem a legfrissebb, se nem az olvasott
+ */
+void SpectrumFrameBuffer::selectWriteIndex() {
+    __dmb();  // A latestIndex_ közzététele előbb, mint a readIndex_ olvasása
+    const uint8_t latest = latestIndex_;
+    const uint8_t reading = readIndex_;
+    for (uint8_t i = 0; i < SpectrumFrameBufferConstants::FRAME_COUNT; i++) {
+        if (i != latest && i != reading) {
+            writeIndex_ = i;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief A beginWrite() képkockájának közzététele (csak a Core1)
+ */
+void SpectrumFrameBuffer::publish() {
+    const uint32_t sequence = publishedCount_ + 1;
+    frames_[writeIndex_].sequence = sequence;
+    __dmb();  // A képkocka legyen kiírva, mielőtt a Core0 látja az indexét
+    latestIndex_ = writeIndex_;
+    publishedCount_ = sequence;
+    selectWriteIndex();
+}
+
+/**
+ * @brief A közzétett képkockák eldobása (csak a Core1)
+ *
+ * Az olvasó által tartott képkockához nem nyúlunk, a Core0 a következő acquireLatest()-ig használhatja.
+ */
+void SpectrumFrameBuffer::reset() {
+    latestIndex_ = SpectrumFrameBufferConstants::NO_FRAME;
+    selectWriteIndex();
+}
+
+/**
+ * @brief A Core0 elvette-e már a legfrissebb képkockát (csak a Core1)
+ * @return true ha nincs elvetlen képkocka (érdemes újat számolni)
+ */
+bool SpectrumFrameBuffer::isLatestConsumed() const {
+    const uint8_t latest = latestIndex_;
+    return latest == SpectrumFrameBufferConstants::NO_FRAME || acquiredSequence_ == frames_[latest].sequence;
+}
+
+/**
+ * @brief A legfrissebb képkocka elvétele (csak a Core0)
+ * @return A képkocka, ami a következő hívásig nem íródik felül; nullptr ha nincs közzétett képkocka
+ */
+const SpectrumFrame *SpectrumFrameBuffer::acquireLatest() {
+    uint8_t latest;
+    do {
+        latest = latestIndex_;
+        if (latest == SpectrumFrameBufferConstants::NO_FRAME) {
+            return nullptr;
+        }
+        readIndex_ = latest;
+        __dmb();  // Az olvasott index közzététele előbb, mint a latestIndex_ újraolvasása
+    } while (latestIndex_ != latest);  // Közben újabb képkocka jött: az író már a régit is írhatja
+
+    const SpectrumFrame *frame = &frames_[latest];
+    if (frame->sequence != acquiredSequence_) {
+        acquiredSequence_ = frame->sequence;
+        acquiredCount_ = acquiredCount_ + 1;
+    }
+    return frame;
+}
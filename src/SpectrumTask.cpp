@@ -0,0 +1,70 @@
+#include "SpectrumTask.h"
+
+#include "defines.h"
+
+/**
+ * @brief Konstruktor
+ * @param params A CORE1_CMD_SPECTRUM_START paraméterei
+ * @param session A START üzenet sorszáma (a képkockák ezzel jelöltek)
+ */
+SpectrumTask::SpectrumTask(const Core1SpectrumParams &params, uint16_t session)
+    : processor_(*params.gainConfig, AUDIO_INPUT_PIN, params.targetSamplingHz, params.fftSize),
+      session_(session),
+      collectOsci_(false),
+      frameIntervalUs_(0),
+      lastFrameUs_(micros()) {
+    if (!configure(params)) {
+        DEBUG("SpectrumTask: Invalid parameters, FFT size %u\n", params.fftSize);
+    }
+}
+
+/**
+ * @brief A futó számítás beállítása (CORE1_CMD_SPECTRUM_CONFIG)
+ * @param params Az új beállítások (a gain és a mintavételezési frekvencia a START-ban dől el)
+ * @return false ha az FFT méret nem fér a képkockába vagy nem állítható be
+ */
+bool SpectrumTask::configure(const Core1SpectrumParams &params) {
+    collectOsci_ = params.collectOsci;
+    frameIntervalUs_ = static_cast<uint32_t>(params.frameIntervalMs) * 1000;
+    processor_.setWindowType(static_cast<FftWindowType>(params.windowType));
+
+    if (params.fftSize / 2 > SpectrumFrameBufferConstants::MAX_BINS) {
+        return false;
+    }
+    return processor_.setFftSize(params.fftSize);
+}
+
+/**
+ * @brief Mennyi idő múlva esedékes a következő képkocka
+ */
+uint32_t SpectrumTask::getMicrosUntilReady() {
+    if (!isReady()) {
+        return UINT32_MAX;
+    }
+    if (!spectrumFrameBuffer.isLatestConsumed()) {
+        return SpectrumTaskConstants::CONSUMER_POLL_US;  // A Core0 még nem rajzolta ki az előzőt
+    }
+    const uint32_t elapsedUs = micros() - lastFrameUs_;
+    return elapsedUs >= frameIntervalUs_ ? 0 : frameIntervalUs_ - elapsedUs;
+}
+
+/**
+ * @brief Egy képkocka számítása és közzététele
+ */
+void SpectrumTask::runTask() {
+    lastFrameUs_ = micros();
+    if (!processor_.process(collectOsci_)) {
+        return;  // Még nincs elég minta
+    }
+
+    SpectrumFrame &frame = spectrumFrameBuffer.beginWrite();
+    frame.session = session_;
+    frame.fftSize = processor_.getFftSize();
+    frame.windowType = processor_.getWindowType();
+    frame.hasOsci = collectOsci_;
+    memcpy(frame.magnitudes, processor_.getMagnitudeData(), processor_.getMagnitudeDataSize() * sizeof(float));
+    if (collectOsci_) {
+        memcpy(frame.osciSamples, processor_.getOscilloscopeData(), sizeof(frame.osciSamples));
+    }
+    spectrumFrameBuffer.publish();
+}
@@ -0,0 +1,137 @@
+#include "TftDmaPipeline.h"
+
+#include "defines.h"  // DEBUG
+
+/**
+ * @brief Konstruktor
+ * @param tft A kijelző
+ */
+TftDmaPipeline::TftDmaPipeline(TFT_eSPI &tft) : tft_(tft), dmaEnabled_(false), frameInFlight_(false), pending_{nullptr, 0, 0, 0, 0} {}
+
+/**
+ * @brief A DMA csatorna lefoglalása (a tft.init() után)
+ * @return false ha nincs DMA: minden beküldés szinkron marad
+ */
+bool TftDmaPipeline::begin() {
+    dmaEnabled_ = tft_.initDMA();
+    if (!dmaEnabled_) {
+        DEBUG("TftDmaPipeline: DMA not available, falling back to blocking pushes\n");
+    }
+    return dmaEnabled_;
+}
+
+/**
+ * @brief A levegőben lévő képkocka megvárása, a CS elengedése
+ */
+void TftDmaPipeline::waitForDma() {
+    if (frameInFlight_) {
+        tft_.dmaWait();
+        tft_.endWrite();
+        frameInFlight_ = false;
+    }
+}
+
+/**
+ * @brief Egy kiküldés szinkron (a puffer a kijelző bájtsorrendjében van, nincs csere)
+ */
+void TftDmaPipeline::pushBlocking(const PendingFrame &frame) {
+    const bool swapBytes = tft_.getSwapBytes();
+    tft_.setSwapBytes(false);
+    tft_.pushImage(frame.x, frame.y, frame.w, frame.h, frame.pixels);
+    tft_.setSwapBytes(swapBytes);
+}
+
+/**
+ * @brief Egy kiküldés beküldése (a loop végén indul)
+ */
+void TftDmaPipeline::submit(uint16_t *pixels, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (pending_.pixels != nullptr) {
+        pushBlocking(pending_);  // Egy UI körben már volt beküldés: az előző szinkron megy ki
+    }
+    pending_ = {pixels, x, y, w, h};
+}
+
+/**
+ * @brief Egy sprite kiküldése a képernyő loop végén
+ * @param sprite A 16 bites sprite (a waitForFrame()-ig nem módosítható, nem törölhető)
+ * @param x A bal felső sarok X koordinátája a képernyőn
+ * @param y A bal felső sarok Y koordinátája a képernyőn
+ */
+void TftDmaPipeline::submitSprite(TFT_eSprite &sprite, int32_t x, int32_t y) {
+    if (!dmaEnabled_) {
+        sprite.pushSprite(x, y);
+        return;
+    }
+    // A sprite a pixeleit már a kijelző bájtsorrendjében tárolja
+    submit(static_cast<uint16_t *>(sprite.getPointer()), x, y, sprite.width(), sprite.height());
+}
+
+/**
+ * @brief A sor puffer (MAX_LINE_PIXELS elem), natív RGB565 színekkel töltendő
+ *
+ * Egyetlen sor puffer van: ha az előző sor még benne vár (ugyanabban a UI körben beküldték),
+ * vagy a DMA még viszi, a kerítés előbb kiküldi, különben a hívó felülírná a kiküldés előtt.
+ */
+uint16_t *TftDmaPipeline::getLineBuffer() {
+    if (pending_.pixels == lineBuffer_ || frameInFlight_) {
+        waitForFrame();
+    }
+    return lineBuffer_;
+}
+
+/**
+ * @brief A sor puffer kiküldése a képernyő loop végén
+ * @param x A sor kezdete
+ * @param y A sor Y koordinátája
+ * @param length A pixelek száma (legfeljebb MAX_LINE_PIXELS)
+ */
+void TftDmaPipeline::submitLine(int32_t x, int32_t y, uint16_t length) {
+    if (length > TftDmaPipelineConstants::MAX_LINE_PIXELS) {
+        length = TftDmaPipelineConstants::MAX_LINE_PIXELS;
+    }
+    // Natív RGB565 -> a kijelző bájtsorrendje (helyben), így a DMA csere nélkül viheti
+    for (uint16_t i = 0; i < length; i++) {
+        lineBuffer_[i] = (lineBuffer_[i] >> 8) | (lineBuffer_[i] << 8);
+    }
+    if (!dmaEnabled_) {
+        pushBlocking({lineBuffer_, x, y, length, 1});
+        return;
+    }
+    submit(lineBuffer_, x, y, length, 1);
+}
+
+/**
+ * @brief A beküldött képkocka DMA indítása (a képernyő loop végén)
+ *
+ * A CS a DMA végéig lent marad (startWrite), a waitForFrame() engedi el.
+ */
+void TftDmaPipeline::startPendingFrame() {
+    if (pending_.pixels == nullptr) {
+        return;
+    }
+    waitForDma();  // Egyszerre egy képkocka lehet a levegőben
+
+    const bool swapBytes = tft_.getSwapBytes();
+    tft_.setSwapBytes(false);
+    tft_.startWrite();
+    tft_.pushImageDMA(pending_.x, pending_.y, pending_.w, pending_.h, pending_.pixels);
+    tft_.setSwapBytes(swapBytes);
+    frameInFlight_ = true;
+    pending_.pixels = nullptr;
+}
+
+/**
+ * @brief Megy-e még képkocka (a puffere nem írható)
+ */
+bool TftDmaPipeline::isFrameInFlight() { return frameInFlight_ && tft_.dmaBusy(); }
+
+/**
+ * @brief Kerítés: a levegőben lévő képkocka megvárása, a még el nem indított kiküldése
+ */
+void TftDmaPipeline::waitForFrame() {
+    waitForDma();
+    if (pending_.pixels != nullptr) {
+        pushBlocking(pending_);
+        pending_.pixels = nullptr;
+    }
+}
@@ -0,0 +1,82 @@
+#include "TftWaterfallPanel.h"
+
+#include "TftDmaPipeline.h"
+#include "WaterfallScroller.h"
+
+static_assert(WaterfallScrollerConstants::MAX_WIDTH <= TftDmaPipelineConstants::MAX_LINE_PIXELS, "A vizeses sora nem fer a csovezetek sor puffereben");
+
+/**
+ * @brief Görgethető-e a képernyő függőlegesen a vezérlő regisztereivel
+ *
+ * A VSCRDEF/VSCRSADD a vezérlő álló (natív) sor irányában görget: csak a 0-s forgatásnál
+ * esik egybe a képernyő függőleges irányával.
+ */
+bool TftWaterfallPanel::hasHardwareScroll() const {
+#if defined(ILI9341_DRIVER) || defined(ILI9488_DRIVER) || defined(ST7789_DRIVER)
+    return tft_.getRotation() == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief A VSCRDEF parancs (a három sáv összege a panel natív magassága)
+ */
+void TftWaterfallPanel::writeScrollDefinition(TFT_eSPI &tft, uint16_t topFixedRows, uint16_t scrollRows, uint16_t bottomFixedRows) {
+    tft.writecommand(TftWaterfallPanelConstants::CMD_VSCRDEF);
+    tft.writedata(topFixedRows >> 8);
+    tft.writedata(topFixedRows & 0xFF);
+    tft.writedata(scrollRows >> 8);
+    tft.writedata(scrollRows & 0xFF);
+    tft.writedata(bottomFixedRows >> 8);
+    tft.writedata(bottomFixedRows & 0xFF);
+}
+
+/**
+ * @brief VSCRDEF: felső fix sáv, görgetett sáv, alsó fix sáv
+ */
+void TftWaterfallPanel::setScrollArea(uint16_t topFixedRows, uint16_t scrollRows, uint16_t bottomFixedRows) {
+    tftDma.waitForFrame();  // Szinkron TFT hozzáférés: a kerítés után
+    writeScrollDefinition(tft_, topFixedRows, scrollRows, bottomFixedRows);
+}
+
+/**
+ * @brief VSCRSADD: a görgetett sáv tetején megjelenő memória sor
+ *
+ * A kerítés előbb kiviszi a még váró új sort, különben a sáv tetején egy pillanatra a
+ * legrégebbi sor látszana.
+ */
+void TftWaterfallPanel::setScrollStart(uint16_t memoryRow) {
+    tftDma.waitForFrame();
+    tft_.writecommand(TftWaterfallPanelConstants::CMD_VSCRSADD);
+    tft_.writedata(memoryRow >> 8);
+    tft_.writedata(memoryRow & 0xFF);
+}
+
+/**
+ * @brief A panel görgetésének alaphelyzetbe állítása (képernyőváltáskor, pl. a képernyővédő előtt)
+ *
+ * A háttérben megmaradó képernyő (képernyővédő alatt) nem állítja vissza a görgetést, ezért
+ * ezt a képernyőváltás is hívja: egy teljes magasságú görgetett sáv nulla eltolással az identitás.
+ */
+void TftWaterfallPanel::resetPanelScroll(TFT_eSPI &tft) {
+#if defined(ILI9341_DRIVER) || defined(ILI9488_DRIVER) || defined(ST7789_DRIVER)
+    tftDma.waitForFrame();
+    writeScrollDefinition(tft, 0, tft.getRotation() % 2 == 0 ? tft.height() : tft.width(), 0);
+    tft.writecommand(TftWaterfallPanelConstants::CMD_VSCRSADD);
+    tft.writedata(0);
+    tft.writedata(0);
+#else
+    (void)tft;
+#endif
+}
+
+/**
+ * @brief A sor puffer: a csővezetéké (a még váró korábbi sort előbb kiküldi)
+ */
+uint16_t *TftWaterfallPanel::getRowBuffer() { return tftDma.getLineBuffer(); }
+
+/**
+ * @brief A sor kiküldése egy memória sorba (DMA, a képernyő loop végén)
+ */
+void TftWaterfallPanel::pushRow(uint16_t memoryRow, uint16_t width) { tftDma.submitLine(0, memoryRow, width); }
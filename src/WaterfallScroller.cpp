@@ -0,0 +1,199 @@
+#include "WaterfallScroller.h"
+
+#include <string.h>
+
+/**
+ * @brief Konstruktor
+ */
+WaterfallScroller::WaterfallScroller()
+    : panel_(nullptr),
+      palette_(nullptr),
+      areaTop_(0),
+      areaHeight_(0),
+      width_(0),
+      mode_(WaterfallScrollMode::Software),
+      lineLength_(0),
+      columnMap_(),
+      headOffset_(0),
+      sweepRow_(0),
+      sweepAge_(0),
+      sweepDirty_(false) {}
+
+/**
+ * @brief A görgetett sáv beállítása (a sáv törlése a hívóé)
+ * @param panel A kijelző
+ * @param palette A sor bájtjainak színei (a 0. a sáv háttere)
+ * @param areaTop A sáv első képernyő sora
+ * @param areaHeight A sáv magassága sorokban
+ * @param width A sáv szélessége pixelben (legfeljebb MAX_WIDTH)
+ * @return true ha hardveres görgetés megy
+ */
+bool WaterfallScroller::begin(IWaterfallPanel &panel, const WaterfallPalette<16> &palette, uint16_t areaTop, uint16_t areaHeight, uint16_t width) {
+    const uint16_t panelHeight = panel.getHeight();
+    if (areaTop >= panelHeight) {
+        areaTop = panelHeight - 1;
+    }
+    if (areaHeight == 0 || areaTop + areaHeight > panelHeight) {
+        areaHeight = panelHeight - areaTop;
+    }
+    if (width > WaterfallScrollerConstants::MAX_WIDTH) {
+        width = WaterfallScrollerConstants::MAX_WIDTH;
+    }
+    const WaterfallScrollMode mode = panel.hasHardwareScroll() ? WaterfallScrollMode::Hardware : WaterfallScrollMode::Software;
+
+    // Ugyanaz a sáv újra (pl. dialógus vagy képernyővédő után): a szoftveres előzmény megmarad és újrarajzolódik
+    const bool keepHistory = mode == WaterfallScrollMode::Software && mode_ == WaterfallScrollMode::Software && lineLength_ != 0 && areaTop == areaTop_ &&
+                             areaHeight == areaHeight_ && width == width_;
+    panel_ = &panel;
+    palette_ = &palette;
+    areaTop_ = areaTop;
+    areaHeight_ = areaHeight;
+    width_ = width;
+    mode_ = mode;
+    headOffset_ = 0;  // Az első sor a sáv aljára kerül
+    if (keepHistory) {
+        startSweep();
+    } else {
+        lineLength_ = 0;  // Az előzmény az első sor hosszával alakul
+        sweepRow_ = areaHeight_;
+        sweepAge_ = 0;
+        sweepDirty_ = false;
+    }
+
+    if (mode_ == WaterfallScrollMode::Hardware) {
+        panel.setScrollArea(areaTop_, areaHeight_, panelHeight - areaTop_ - areaHeight_);
+        panel.setScrollStart(areaTop_);  // Még egy az egyben: a sáv teteje a memória areaTop_ sora
+    }
+    return mode_ == WaterfallScrollMode::Hardware;
+}
+
+/**
+ * @brief A görgetés kikapcsolása (a memória ismét egy az egyben látszik), a képernyő elhagyásakor
+ */
+void WaterfallScroller::end() {
+    if (panel_ != nullptr && mode_ == WaterfallScrollMode::Hardware) {
+        panel_->resetScroll();
+    }
+    areaHeight_ = 0;
+    sweepRow_ = 0;
+}
+
+/**
+ * @brief A sor hosszának beállítása: a pixel -> elem leképezés, szoftveres módban az előzmény alakja
+ *
+ * Ha az előzménynek nincs tár, a görgetés a Wrap tartalékra vált.
+ */
+void WaterfallScroller::setLineLength(uint16_t length) {
+    lineLength_ = length;
+    for (uint16_t x = 0; x < width_; x++) {
+        // Kerekítés a legközelebbi elemre: x * (length - 1) / (width - 1)
+        columnMap_[x] = width_ <= 1 ? 0 : static_cast<uint16_t>((2u * x * (length - 1u) + (width_ - 1u)) / (2u * (width_ - 1u)));
+    }
+
+    if (mode_ == WaterfallScrollMode::Software) {
+        sweepRow_ = areaHeight_;  // Az új hosszal az előzmény üres: a következő sor új rajzolást indít
+        if (!history_.reshape(length, areaHeight_ + WaterfallScrollerConstants::SOFTWARE_SWEEP_SLACK)) {
+            mode_ = WaterfallScrollMode::Wrap;
+            headOffset_ = 0;
+        }
+    }
+}
+
+/**
+ * @brief Egy sor kirajzolása egy memória sorba
+ */
+void WaterfallScroller::drawLine(uint16_t memoryRow, const uint8_t *levels) {
+    uint16_t *pixels = panel_->getRowBuffer();
+    if (lineLength_ == width_) {
+        palette_->mapLine(levels, pixels, width_);
+    } else {
+        for (uint16_t x = 0; x < width_; x++) {
+            pixels[x] = (*palette_)[levels[columnMap_[x]]];
+        }
+    }
+    panel_->pushRow(memoryRow, width_);
+}
+
+/**
+ * @brief Egy sor törlése a sáv hátterére (a paletta 0. színe)
+ */
+void WaterfallScroller::drawBackgroundLine(uint16_t memoryRow) {
+    uint16_t *pixels = panel_->getRowBuffer();
+    const uint16_t background = (*palette_)[0];
+    for (uint16_t x = 0; x < width_; x++) {
+        pixels[x] = background;
+    }
+    panel_->pushRow(memoryRow, width_);
+}
+
+/**
+ * @brief A sáv újrarajzolásának indítása a legújabb sortól
+ */
+void WaterfallScroller::startSweep() {
+    sweepRow_ = 0;
+    sweepAge_ = 0;
+    sweepDirty_ = false;
+}
+
+/**
+ * @brief Új sor a sáv tetejére
+ * @param levels A sor paletta bájtjai
+ * @param length Az elemek száma (1..MAX_WIDTH; ha változik, az előzmény törlődik)
+ */
+void WaterfallScroller::addLine(const uint8_t *levels, uint16_t length) {
+    if (panel_ == nullptr || areaHeight_ == 0 || length == 0) {
+        return;
+    }
+    if (length > WaterfallScrollerConstants::MAX_WIDTH) {
+        length = WaterfallScrollerConstants::MAX_WIDTH;
+    }
+    if (length != lineLength_) {
+        setLineLength(length);
+    }
+
+    if (mode_ == WaterfallScrollMode::Software) {
+        memcpy(history_.push(), levels, length);
+        if (!isRedrawPending()) {
+            startSweep();
+            return;
+        }
+        // Rajzolás közben: a még hátralévő sorok eggyel régebbiek lettek; ha a legrégebbi kiesne a tárból, elölről
+        sweepAge_++;
+        sweepDirty_ = true;
+        if (sweepAge_ + areaHeight_ > history_.getSliceCount()) {
+            startSweep();
+        }
+        return;
+    }
+
+    // A sor a sávban egyet felfelé lép (a sáv tetejéről az aljára fordul): ez a legrégebbi sor helye
+    headOffset_ = (headOffset_ == 0) ? areaHeight_ - 1 : headOffset_ - 1;
+    const uint16_t row = areaTop_ + headOffset_;
+    drawLine(row, levels);
+
+    if (mode_ == WaterfallScrollMode::Hardware) {
+        panel_->setScrollStart(row);  // A legújabb sor a sáv tetejére, a többi egy sorral lejjebb látszik
+    } else {
+        drawBackgroundLine(areaTop_ + ((headOffset_ == 0) ? areaHeight_ - 1 : headOffset_ - 1));  // A gyűrű feje
+    }
+}
+
+/**
+ * @brief Szoftveres görgetésnél a sáv következő sorainak újrarajzolása (minden UI körben hívandó)
+ *
+ * A sáv i. sora a rajzolás kezdetekor i. legújabb sor; a közben érkezett sorok (sweepAge_)
+ * a következő rajzolásban jelennek meg.
+ */
+void WaterfallScroller::update() {
+    if (mode_ != WaterfallScrollMode::Software || !isRedrawPending()) {
+        return;
+    }
+    const uint16_t remaining = areaHeight_ - sweepRow_;
+    const uint16_t rows = remaining < WaterfallScrollerConstants::SOFTWARE_ROWS_PER_PASS ? remaining : WaterfallScrollerConstants::SOFTWARE_ROWS_PER_PASS;
+    for (uint16_t i = 0; i < rows; i++, sweepRow_++) {
+        drawLine(areaTop_ + sweepRow_, history_.getSlice(sweepRow_ + sweepAge_));
+    }
+    if (!isRedrawPending() && sweepDirty_) {
+        startSweep();
+    }
+}
@@ -0,0 +1,239 @@
+#include "ZoomFft.h"
+
+#include <string.h>
+
+#include <new>
+
+#include "FftTables.h"
+#include "defines.h"
+
+/**
+ * @brief ZoomFft konstruktor - a pufferek foglalása és a komplex FFT előkészítése
+ * @param source A közös minta busz
+ */
+ZoomFft::ZoomFft(AudioSampleRing &source)
+    : reader_(source),
+      fft_(false),
+      historyRe_(nullptr),
+      historyIm_(nullptr),
+      fftRe_(nullptr),
+      fftIm_(nullptr),
+      magnitudes_(nullptr),
+      historyPos_(0),
+      historyCount_(0),
+      ncoPhase_(0),
+      ncoStep_(0),
+      centerFreqHz_(0.0f),
+      spanHz_(0.0f),
+      outputRateHz_(ZoomFftConstants::INPUT_SAMPLE_RATE_HZ),
+      activeStages_(0),
+      decimation_(1) {
+
+    using namespace ZoomFftConstants;
+
+    reader_.setTargetSampleRate(INPUT_SAMPLE_RATE_HZ);
+    fft_.setWindowType(FftWindowType::BlackmanHarris);  // A szomszédos erős jelek oldalsávjai ne takarják el a gyengét
+
+    historyRe_ = new (std::nothrow) int16_t[FFT_SIZE];
+    historyIm_ = new (std::nothrow) int16_t[FFT_SIZE];
+    fftRe_ = new (std::nothrow) int16_t[FFT_SIZE];
+    fftIm_ = new (std::nothrow) int16_t[FFT_SIZE];
+    magnitudes_ = new (std::nothrow) float[FFT_SIZE];
+    if (!historyRe_ || !historyIm_ || !fftRe_ || !fftIm_ || !magnitudes_ || !fft_.setSize(FFT_SIZE)) {
+        DEBUG("ZoomFft: Pufferek foglalása sikertelen!\n");
+        deallocate();
+        return;
+    }
+    memset(magnitudes_, 0, FFT_SIZE * sizeof(float));
+}
+
+/**
+ * @brief ZoomFft destruktor
+ */
+ZoomFft::~ZoomFft() { deallocate(); }
+
+/**
+ * @brief Pufferek felszabadítása
+ */
+void ZoomFft::deallocate() {
+    delete[] historyRe_;
+    delete[] historyIm_;
+    delete[] fftRe_;
+    delete[] fftIm_;
+    delete[] magnitudes_;
+    historyRe_ = historyIm_ = fftRe_ = fftIm_ = nullptr;
+    magnitudes_ = nullptr;
+}
+
+/**
+ * @brief A megjelenítendő sáv beállítása
+ *
+ * A legnagyobb decimációt választjuk, aminél a sáv fele még a half-band kaszkád sík részébe esik.
+ * @param centerFreqHz A sáv közepe (a keverő frekvenciája)
+ * @param spanHz A sáv szélessége
+ */
+void ZoomFft::configure(float centerFreqHz, float spanHz) {
+    using namespace ZoomFftConstants;
+
+    const float inputRate = reader_.isRunning() ? reader_.getSampleRateHz() : INPUT_SAMPLE_RATE_HZ;
+
+    activeStages_ = AudioSampleBusConstants::DecimatorChainType::STAGE_COUNT;
+    while (activeStages_ > 0 && PASSBAND_RATIO * (inputRate / (1u << activeStages_)) < spanHz / 2.0f) {
+        activeStages_--;
+    }
+    decimation_ = 1u << activeStages_;
+    outputRateHz_ = inputRate / decimation_;
+
+    centerFreqHz_ = centerFreqHz;
+    spanHz_ = spanHz;
+    ncoStep_ = static_cast<uint32_t>(static_cast<double>(centerFreqHz) / inputRate * 4294967296.0);
+    ncoPhase_ = 0;
+
+    decimatorI_.reset();
+    decimatorQ_.reset();
+    historyPos_ = 0;
+    historyCount_ = 0;
+    if (magnitudes_) {
+        memset(magnitudes_, 0, FFT_SIZE * sizeof(float));
+    }
+    reader_.sync();
+
+    DEBUG("ZoomFft: Közép: %.1f Hz, sáv: %.1f Hz, decimáció: %d, felbontás: %.2f Hz\n", centerFreqHz_, spanHz, decimation_, getBinWidthHz());
+}
+
+/**
+ * @brief Az új minták feldolgozása
+ * @return true ha új spektrum készült
+ */
+bool ZoomFft::process() {
+    using namespace ZoomFftConstants;
+
+    if (!isReady() || !reader_.isRunning()) {
+        return false;
+    }
+
+    // Minden elérhető mintát feldolgozunk, hogy az alapsávi folyam folytonos maradjon
+    const uint16_t blockLimit = BLOCK_SAMPLES - (BLOCK_SAMPLES % decimation_);
+    int16_t block[BLOCK_SAMPLES];
+    bool newSamples = false;
+    uint32_t available = reader_.available();
+    while (available >= decimation_) {
+        uint16_t count = available > blockLimit ? blockLimit : static_cast<uint16_t>(available - (available % decimation_));
+        count = reader_.read(block, count);
+        if (count == 0) {
+            break;
+        }
+        mixAndDecimate(block, count);
+        available -= count;
+        newSamples = true;
+    }
+
+    if (!newSamples || historyCount_ < FFT_SIZE) {
+        return false;
+    }
+    computeSpectrum();
+    return true;
+}
+
+/**
+ * @brief Keverés a sáv közepére (x * e^(-j*w*n)), majd decimálás és az alapsávi gyűrűbe írás
+ * @param samples Középre igazított bemeneti minták
+ * @param count Minták száma (a decimáció többszöröse)
+ */
+void ZoomFft::mixAndDecimate(const int16_t *samples, uint16_t count) {
+    using namespace ZoomFftConstants;
+
+    const int16_t *cosTable = FftTables::getTwiddleCos();
+    const int16_t *sinTable = FftTables::getTwiddleSin();
+    constexpr uint8_t PHASE_SHIFT = 32 - 11;  // A tábla fél periódusa 1024 elem, a teljes kör 2048
+
+    int16_t mixedI[BLOCK_SAMPLES];
+    int16_t mixedQ[BLOCK_SAMPLES];
+    for (uint16_t n = 0; n < count; n++) {
+        uint16_t index = ncoPhase_ >> PHASE_SHIFT;
+        int32_t c;
+        int32_t s;
+        if (index < FftTables::TWIDDLE_TABLE_SIZE) {
+            c = cosTable[index];
+            s = sinTable[index];
+        } else {
+            c = -cosTable[index - FftTables::TWIDDLE_TABLE_SIZE];  // cos(x + pi) = -cos(x)
+            s = -sinTable[index - FftTables::TWIDDLE_TABLE_SIZE];
+        }
+        ncoPhase_ += ncoStep_;
+
+        mixedI[n] = static_cast<int16_t>((samples[n] * c) >> MIXER_SHIFT);
+        mixedQ[n] = static_cast<int16_t>(-((samples[n] * s) >> MIXER_SHIFT));
+    }
+
+    const uint16_t produced = decimatorI_.process(mixedI, count, activeStages_);
+    decimatorQ_.process(mixedQ, count, activeStages_);
+
+    for (uint16_t i = 0; i < produced; i++) {
+        historyRe_[historyPos_] = mixedI[i];
+        historyIm_[historyPos_] = mixedQ[i];
+        historyPos_ = (historyPos_ + 1) & (FFT_SIZE - 1);
+    }
+    historyCount_ = historyCount_ + produced > FFT_SIZE ? FFT_SIZE : historyCount_ + produced;
+}
+
+/**
+ * @brief A legutolsó FFT_SIZE alapsávi minta spektruma, a legkisebb frekvenciától kezdve
+ */
+void ZoomFft::computeSpectrum() {
+    using namespace ZoomFftConstants;
+
+    // Időrendbe rendezés: a legrégebbi minta a következő írási pozíción van
+    const uint16_t firstPart = FFT_SIZE - historyPos_;
+    memcpy(fftRe_, &historyRe_[historyPos_], firstPart * sizeof(int16_t));
+    memcpy(fftIm_, &historyIm_[historyPos_], firstPart * sizeof(int16_t));
+    memcpy(&fftRe_[firstPart], historyRe_, historyPos_ * sizeof(int16_t));
+    memcpy(&fftIm_[firstPart], historyIm_, historyPos_ * sizeof(int16_t));
+
+    if (!fft_.computeComplexMagnitudes(fftRe_, fftIm_, magnitudes_)) {
+        return;
+    }
+
+    // A negatív frekvenciák kerülnek előre (a 0. bin a sáv alja, az N/2. a közepe)
+    for (uint16_t k = 0; k < FFT_SIZE / 2; k++) {
+        const float positive = magnitudes_[k];
+        magnitudes_[k] = magnitudes_[k + FFT_SIZE / 2] * MAGNITUDE_SCALE;
+        magnitudes_[k + FFT_SIZE / 2] = positive * MAGNITUDE_SCALE;
+    }
+}
+
+/**
+ * @brief A legnagyobb magnitúdó egy frekvencia tartományban
+ * @param lowHz Tartomány alja (abszolút hangfrekvencia)
+ * @param highHz Tartomány teteje
+ * @return Magnitúdó (0, ha a tartomány a sávon kívül esik)
+ */
+float ZoomFft::getPeakMagnitude(float lowHz, float highHz) const {
+    using namespace ZoomFftConstants;
+
+    if (!isReady()) {
+        return 0.0f;
+    }
+    if (highHz < lowHz) {
+        float tmp = lowHz;
+        lowHz = highHz;
+        highHz = tmp;
+    }
+
+    const float binWidth = getBinWidthHz();
+    int32_t lowBin = static_cast<int32_t>(roundf((lowHz - centerFreqHz_) / binWidth)) + FFT_SIZE / 2;
+    int32_t highBin = static_cast<int32_t>(roundf((highHz - centerFreqHz_) / binWidth)) + FFT_SIZE / 2;
+    if (highBin < 0 || lowBin >= FFT_SIZE) {
+        return 0.0f;
+    }
+    lowBin = constrain(lowBin, 0, FFT_SIZE - 1);
+    highBin = constrain(highBin, 0, FFT_SIZE - 1);
+
+    float peak = 0.0f;
+    for (int32_t k = lowBin; k <= highBin; k++) {
+        if (magnitudes_[k] > peak) {
+            peak = magnitudes_[k];
+        }
+    }
+    return peak;
+}
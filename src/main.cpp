@@ -9,6 +9,9 @@
 //------------------ TFT
 #include <TFT_eSPI.h>
 TFT_eSPI tft;
+#include "TftDmaPipeline.h"
+#include "TftWaterfallPanel.h"
+TftDmaPipeline tftDma(tft);
 
 //------------------- Rotary Encoder
 #ifdef __USE_ROTARY_ENCODER_IN_HW_TIMER
@@ -24,6 +27,16 @@ RotaryEncoder rotaryEncoder = RotaryEncoder(PIN_ENCODER_CLK, PIN_ENCODER_DT, PIN
 #include "Config.h"
 Config config;
 
+//------------------- Audio mintavételezés (ADC + DMA gyűrűpuffer)
+#include "AdcDmaSampler.h"
+#include "AudioSampleReader.h"
+AdcDmaSampler adcDmaSampler;
+
+//------------------- Core0 <-> Core1 üzenetek
+#include "Core1Mailbox.h"
+#include "DspScheduler.h"
+#include "SpectrumFrameBuffer.h"
+
 //------------------- si4735
 #include <SI4735.h>
 SI4735 si4735;
@@ -105,14 +118,16 @@ void shutdownSystem() {
     Utils::beepTick();
     delay(500);
 
-    // Core1 leállítása
+    // Core1 és az audio minta busz leállítása
     multicore_reset_core1();
+    adcDmaSampler.stop();
 
     // FIFO tisztítása a Core1 leállítása után
     while (rp2040.fifo.available() > 0) {
         uint32_t dummy;
         rp2040.fifo.pop_nb(&dummy);
     }
+    core1Mailbox.reset();  // A leállított Core1 már nem olvassa ki a várakozó üzeneteket
 
     DEBUG("Core1 stopped and FIFO cleared.\n");
 
@@ -151,7 +166,10 @@ void wakeupSystem() {
     // SI4735 újrainicializálása
     Wire.begin();
     si4735.reset();  // Reset a chipet
-    delay(100);      // Core1 újraindítása
+    delay(100);
+
+    // Az audio minta busz és a Core1 újraindítása
+    adcDmaSampler.start(AUDIO_INPUT_PIN, AudioSampleBusConstants::SAMPLE_RATE_HZ);
     multicore_launch_core1(setup1);
 
     // FIFO tisztítása a Core1 újraindítása után
@@ -184,6 +202,10 @@ void wakeupSystem() {
  */
 void changeDisplay() {
 
+    // A régi képernyő sprite-jai törlődnek, az új szinkron rajzol: a levegőben lévő képkockát megvárjuk
+    tftDma.waitForFrame();
+    TftWaterfallPanel::resetPanelScroll(tft);  // Az új képernyő (a képernyővédő is) görgetés nélkül rajzol
+
     // Ha a ScreenSaver-re váltunk...
     if (::newDisplay == DisplayBase::DisplayType::screenSaver) {
 
@@ -260,6 +282,27 @@ void changeDisplay() {
     ::newDisplay = DisplayBase::DisplayType::none;
 }
 
+/**
+ * @brief A Core1 válaszainak feldolgozása
+ *
+ * A válaszok a postafiókban gyűlnek, képernyőtől függetlenül minden körben várakozás nélkül olvassuk őket.
+ * Sikertelen módváltásnál (pl. elfogyott a memória) hibát jelzünk; a spektrum parancsoknál nem,
+ * mert azok hibájánál a kijelző a Core0-n számol tovább.
+ */
+void processCore1Replies() {
+    Core1Reply reply;
+    while (core1Mailbox.pollReply(reply)) {
+        if (reply.status == Core1ReplyStatus::Ok) {
+            continue;
+        }
+        DEBUG("Core0: Core1 reply for #%u (cmd 0x%lX): status %u\n", reply.sequence, static_cast<uint32_t>(reply.command), static_cast<uint8_t>(reply.status));
+        bool spectrumCommand = reply.command == CORE1_CMD_SPECTRUM_START || reply.command == CORE1_CMD_SPECTRUM_CONFIG || reply.command == CORE1_CMD_SPECTRUM_STOP;
+        if (reply.status == Core1ReplyStatus::Failed && !spectrumCommand) {
+            Utils::beepError();
+        }
+    }
+}
+
 #ifdef __USE_ROTARY_ENCODER_IN_HW_TIMER
 /**
  * Hardware timer interrupt service routine a rotaryhoz
@@ -296,6 +339,7 @@ void setup() {
     tft.init();
     tft.setRotation(1);
     tft.fillScreen(TFT_BLACK);  // Fekete háttér a splash screen-hez
+    tftDma.begin();             // Sprite és sor kiküldés DMA-val (ha nincs, szinkron marad)
 
 // Várakozás a soros port megnyitására DEBUG módban
 #ifdef DEBUG_WAIT_FOR_SERIAL
@@ -424,6 +468,9 @@ void setup() {
     // Splash screen eltűntetése
     splash.hide();
 
+    // A közös audio minta busz indítása (a spektrum kijelzők és a dekóderek is ebből olvasnak)
+    adcDmaSampler.start(AUDIO_INPUT_PIN, AudioSampleBusConstants::SAMPLE_RATE_HZ);
+
     // Kezdő mód képernyőjének megjelenítése
     changeDisplay();
 
@@ -471,12 +518,45 @@ void loop() {
     }
 #endif
 
+//------------------- Core1 terhelés megjelenítése
+#ifdef SHOW_CORE1_LOAD
+    static uint32_t lastDebugCore1Load = 0;
+    static uint32_t uiLoopCount = 0;
+    static uint32_t lastSpectrumPublished = 0;
+    static uint32_t lastSpectrumAcquired = 0;
+    uiLoopCount++;
+    if (millis() - lastDebugCore1Load >= CORE1_LOAD_INFO_INTERVAL) {
+        DEBUG("Core1 load: %u.%u%%, wakeups: %u/s, max wake latency: %lu us\n", core1LoadStats.dutyPermille / 10, core1LoadStats.dutyPermille % 10, core1LoadStats.wakeupsPerSecond,
+              core1LoadStats.maxWakeLatencyUs);
+        for (uint8_t i = 0; i < DspSchedulerConstants::MAX_TASKS; i++) {
+            const DspTaskStats &stats = dspScheduler.getTaskStats(i);
+            const char *name = stats.name;
+            if (name != nullptr) {
+                DEBUG("  %s: %u.%u%%, avg: %lu us, max: %lu us, late: %lu us, shed: %lu, missed: %lu\n", name, stats.loadPermille / 10, stats.loadPermille % 10, stats.averageRunUs, stats.maxRunUs,
+                      stats.maxLatenessUs, stats.shedCount, stats.deadlineMisses);
+            }
+        }
+
+        // A spektrum képkocka sebessége (Core1 számolt / Core0 kirajzolt) és a UI ciklus sebessége külön
+        const uint32_t elapsedMs = millis() - lastDebugCore1Load;
+        const uint32_t published = spectrumFrameBuffer.getPublishedCount();
+        const uint32_t acquired = spectrumFrameBuffer.getAcquiredCount();
+        DEBUG("Spectrum: %lu fps computed, %lu fps drawn, UI loop: %lu/s\n", (published - lastSpectrumPublished) * 1000 / elapsedMs, (acquired - lastSpectrumAcquired) * 1000 / elapsedMs,
+              uiLoopCount * 1000 / elapsedMs);
+        lastSpectrumPublished = published;
+        lastSpectrumAcquired = acquired;
+        uiLoopCount = 0;
+        lastDebugCore1Load = millis();
+    }
+#endif
+
     // Rotary Encoder olvasása
     RotaryEncoder::EncoderState encoderState = rotaryEncoder.read();
 
     // Ha folyamatosan nyomva tartják a rotary gombját akkor kikapcsolunk
     if (encoderState.buttonState == RotaryEncoder::ButtonState::Held && !isSystemShuttingDown) {
         isSystemShuttingDown = true;
+        tftDma.waitForFrame();
         tft.fillScreen(TFT_BLACK);
         tft.setTextColor(TFT_RED, TFT_BLACK);
         tft.setTextSize(2);
@@ -494,6 +574,9 @@ void loop() {
     // Aktuális Display loopja
     bool handleInLoop = pDisplay->loop(encoderState);
 
+    // A Core1 válaszai (a képernyőtől függetlenül, hogy a válasz sor ne teljen meg)
+    processCore1Replies();
+
     static uint32_t lastScreenSaver = millis();
     // Ha volt touch valamelyik képernyőn, vagy volt rotary esemény...
     // Volt felhasználói interakció?
@@ -1,32 +1,77 @@
 #include <Arduino.h>         // Serial, millis stb. (debugoláshoz)
-#include <pico/multicore.h>  // FIFO kommunikációhoz
+#include <pico/multicore.h>  // FIFO csengetéshez
+#include <pico/time.h>       // best_effort_wfe_or_timeout()
 
-#include "CwDecoder.h"           // CW dekóder osztály
-#include "RttyDecoder.h"         // RTTY dekóder osztály
-#include "core_communication.h"  // Parancsok definíciója
-#include "defines.h"             // DEBUG makróhoz
+#include "AdcDmaSampler.h"        // A közös minta busz (a dekóderek forrása)
+#include "Core1Mailbox.h"         // Üzenetek Core0-tól
+#include "CwDecoder.h"            // CW dekóder osztály
+#include "CwSkimmer.h"            // Több csatornás CW dekóder
+#include "DspScheduler.h"         // A DSP feladatok ütemezője
+#include "RttyDecoder.h"          // RTTY dekóder osztály
+#include "SpectrumFrameBuffer.h"  // A spektrum képkockák a Core0-nak
+#include "SpectrumTask.h"         // A kijelző spektrum számítása
+#include "core_communication.h"   // Parancsok definíciója
+#include "defines.h"              // DEBUG makróhoz
 #include "utils.h"
 
 // A Core1 belső állapota a dekódolási módhoz
-enum class Core1ActiveMode { MODE_OFF, MODE_RTTY, MODE_CW };
+enum class Core1ActiveMode { MODE_OFF, MODE_RTTY, MODE_CW, MODE_CW_SKIMMER };
 static Core1ActiveMode core1_current_mode = Core1ActiveMode::MODE_OFF;
 
 // A Core1-specifikus dekóder példányok
 static CwDecoder* core1_cw_decoder = nullptr;
 static RttyDecoder* core1_rtty_decoder = nullptr;
+static CwSkimmer* core1_cw_skimmer = nullptr;
+
+// A kijelző spektrumát számoló háttér feladat (a dekódolási módtól független)
+static SpectrumTask* core1_spectrum_task = nullptr;
+
+// Az eseményvezérelt ciklus időzítései
+namespace Core1LoopConstants {
+constexpr uint32_t MAX_SLEEP_US = 100000;     // Leghosszabb alvás (dekóder nélkül is felébredünk a terhelés méréshez)
+constexpr uint32_t LOAD_WINDOW_US = 1000000;  // A terhelés mérési ablaka
+};  // namespace Core1LoopConstants
+
+// A Core1 terhelése (a Core0 olvassa)
+Core1LoadStats core1LoadStats = {0, 0, 0};
+
+// A terhelés mérés állapota az aktuális ablakban
+static uint32_t core1_load_window_start_us = 0;
+static uint32_t core1_load_busy_us = 0;
+static uint32_t core1_load_wakeups = 0;
+static uint32_t core1_load_max_wake_latency_us = 0;
 
 /**
  * @brief Törli a Core1 dekódereit és erőforrásait.
  */
 void deleteDecoders() {
     if (core1_cw_decoder) {
+        dspScheduler.removeTask(core1_cw_decoder);
         delete core1_cw_decoder;
         core1_cw_decoder = nullptr;
     }
     if (core1_rtty_decoder) {
+        dspScheduler.removeTask(core1_rtty_decoder);
         delete core1_rtty_decoder;
         core1_rtty_decoder = nullptr;
     }
+    if (core1_cw_skimmer) {
+        dspScheduler.removeTask(core1_cw_skimmer);
+        delete core1_cw_skimmer;
+        core1_cw_skimmer = nullptr;
+    }
+}
+
+/**
+ * @brief Törli a spektrum feladatot, a közzétett képkockák érvénytelenek lesznek.
+ */
+static void deleteSpectrumTask() {
+    if (core1_spectrum_task) {
+        dspScheduler.removeTask(core1_spectrum_task);
+        delete core1_spectrum_task;
+        core1_spectrum_task = nullptr;
+    }
+    spectrumFrameBuffer.reset();
 }
 
 /**
@@ -43,94 +88,180 @@ void setup1() {
     }
 }
 
+/**
+ * @brief Egy Core0-tól érkezett üzenet végrehajtása
+ * @param message Az üzenet
+ * @return A Core0-nak küldött válasz státusza
+ */
+static Core1ReplyStatus handleCore1Message(const Core1Message& message) {
+    switch (message.command) {
+        case CORE1_CMD_SET_MODE_OFF:
+            DEBUG("Core1: Mode set to OFF by command\n");
+            deleteDecoders();
+            core1_current_mode = Core1ActiveMode::MODE_OFF;
+            return Core1ReplyStatus::Ok;
+
+        case CORE1_CMD_SET_MODE_RTTY:
+            DEBUG("Core1: Mode set to RTTY by command\n");
+            deleteDecoders();
+            core1_current_mode = Core1ActiveMode::MODE_RTTY;
+
+            // RTTY dekóder példányosítása a Core1-en
+            core1_rtty_decoder = new RttyDecoder(AUDIO_INPUT_PIN, adcDmaSampler);
+            if (!core1_rtty_decoder) {
+                DEBUG("Core1: FATAL - Failed to create RttyDecoder instance!\n");
+                return Core1ReplyStatus::Failed;
+            }
+            core1_rtty_decoder->resetDecoderState();
+            return dspScheduler.addTask(core1_rtty_decoder) ? Core1ReplyStatus::Ok : Core1ReplyStatus::Failed;
+
+        case CORE1_CMD_SET_MODE_CW:
+            // DEBUG("Core1: Mode set to CW by command\n");
+            deleteDecoders();
+            core1_current_mode = Core1ActiveMode::MODE_CW;
+
+            // CW dekóder példányosítása a Core1-en
+            core1_cw_decoder = new CwDecoder(AUDIO_INPUT_PIN, adcDmaSampler);
+            if (!core1_cw_decoder) {
+                DEBUG("Core1: FATAL - Failed to create CwDecoder instance!\n");
+                return Core1ReplyStatus::Failed;
+            }
+            core1_cw_decoder->resetDecoderState();
+            return dspScheduler.addTask(core1_cw_decoder) ? Core1ReplyStatus::Ok : Core1ReplyStatus::Failed;
+
+        case CORE1_CMD_SET_MODE_CW_SKIMMER:
+            DEBUG("Core1: Mode set to CW skimmer by command\n");
+            deleteDecoders();
+            core1_current_mode = Core1ActiveMode::MODE_CW_SKIMMER;
+
+            // Több csatornás CW dekóder példányosítása a Core1-en
+            core1_cw_skimmer = new CwSkimmer(adcDmaSampler);
+            if (!core1_cw_skimmer) {
+                DEBUG("Core1: FATAL - Failed to create CwSkimmer instance!\n");
+                return Core1ReplyStatus::Failed;
+            }
+            return dspScheduler.addTask(core1_cw_skimmer) ? Core1ReplyStatus::Ok : Core1ReplyStatus::Failed;
+
+        case CORE1_CMD_SET_CW_PARAMS:
+            // Élő hangolás: a dekóder állapota (időzítés, Morse fa) megmarad
+            if (core1_current_mode != Core1ActiveMode::MODE_CW || !core1_cw_decoder) {
+                return Core1ReplyStatus::NotApplicable;
+            }
+            core1_cw_decoder->setTargetFrequency(message.params.cw.offsetHz);
+            return Core1ReplyStatus::Ok;
+
+        case CORE1_CMD_SET_RTTY_PARAMS:
+            if (core1_current_mode != Core1ActiveMode::MODE_RTTY || !core1_rtty_decoder) {
+                return Core1ReplyStatus::NotApplicable;
+            }
+            core1_rtty_decoder->setParameters(message.params.rtty.markHz, message.params.rtty.shiftHz, message.params.rtty.baudRate);
+            return Core1ReplyStatus::Ok;
+
+        case CORE1_CMD_SPECTRUM_START:
+            // Egy új kijelző kérése lecseréli az előzőét
+            deleteSpectrumTask();
+            if (message.params.spectrum.gainConfig == nullptr) {
+                return Core1ReplyStatus::Failed;
+            }
+            core1_spectrum_task = new SpectrumTask(message.params.spectrum, message.sequence);
+            if (!core1_spectrum_task || !core1_spectrum_task->isReady() || !dspScheduler.addTask(core1_spectrum_task)) {
+                DEBUG("Core1: Failed to start spectrum task\n");
+                deleteSpectrumTask();
+                return Core1ReplyStatus::Failed;
+            }
+            return Core1ReplyStatus::Ok;
+
+        case CORE1_CMD_SPECTRUM_CONFIG:
+            if (!core1_spectrum_task || core1_spectrum_task->getSession() != message.params.spectrum.session) {
+                return Core1ReplyStatus::NotApplicable;
+            }
+            return core1_spectrum_task->configure(message.params.spectrum) ? Core1ReplyStatus::Ok : Core1ReplyStatus::Failed;
+
+        case CORE1_CMD_SPECTRUM_STOP:
+            // Egy már lecserélt kijelző késve érkező STOP-ja nem állítja le az újat
+            if (!core1_spectrum_task || core1_spectrum_task->getSession() != message.params.spectrum.session) {
+                return Core1ReplyStatus::NotApplicable;
+            }
+            deleteSpectrumTask();
+            return Core1ReplyStatus::Ok;
+
+        default:
+            DEBUG("Core1: Unknown command received: 0x%lX\n", static_cast<uint32_t>(message.command));
+            return Core1ReplyStatus::UnknownCommand;
+    }
+}
+
+/**
+ * @brief Alvás a következő eseményig (WFE): Core0 csengetés vagy egy feladat következő blokkja
+ * @param sleepUs Legfeljebb ennyi ideig alszunk
+ *
+ * A Core0 a csengetés után SEV-et ad, a határidőt az SDK alarmja jelzi (szintén SEV-vel).
+ * Ha az esemény már az alvás előtt megjött, a WFE azonnal visszatér, így nem maradunk le róla.
+ */
+static void sleepUntilNextEvent(uint32_t sleepUs) {
+    const absolute_time_t deadline = make_timeout_time_us(sleepUs);
+    if (best_effort_wfe_or_timeout(deadline)) {
+        // Határidőre ébredtünk: mennyit késett az ébredés
+        const uint32_t lateUs = static_cast<uint32_t>(absolute_time_diff_us(deadline, get_absolute_time()));
+        if (lateUs > core1_load_max_wake_latency_us) {
+            core1_load_max_wake_latency_us = lateUs;
+        }
+    }
+    core1_load_wakeups++;
+}
+
+/**
+ * @brief A terhelés mérési ablak lezárása, az eredmény közzététele a Core0-nak
+ */
+static void updateCore1LoadStats() {
+    const uint32_t elapsedUs = micros() - core1_load_window_start_us;
+    if (elapsedUs < Core1LoopConstants::LOAD_WINDOW_US) {
+        return;
+    }
+
+    core1LoadStats.dutyPermille = static_cast<uint16_t>(min(static_cast<uint64_t>(core1_load_busy_us) * 1000 / elapsedUs, static_cast<uint64_t>(1000)));
+    core1LoadStats.wakeupsPerSecond = static_cast<uint16_t>(min(static_cast<uint64_t>(core1_load_wakeups) * 1000000 / elapsedUs, static_cast<uint64_t>(UINT16_MAX)));
+    core1LoadStats.maxWakeLatencyUs = core1_load_max_wake_latency_us;
+    dspScheduler.publishStats(elapsedUs);
+
+    core1_load_window_start_us += elapsedUs;
+    core1_load_busy_us = 0;
+    core1_load_wakeups = 0;
+    core1_load_max_wake_latency_us = 0;
+}
+
 /**
  * @brief Core1 logika futtatása a loop-ban.
+ *
+ * Eseményvezérelt ciklus: a parancsok és a DSP feladatok (DspScheduler) kész blokkjai azonnal
+ * feldolgozásra kerülnek, közöttük a mag WFE-ben alszik (nincs fix várakozás, nincs üres pörgés).
  */
 void loop1() {
-    // Core1 logika indítása
-    // Várakozás parancsra Core0-tól
+    const uint32_t busyStartUs = micros();
+
+    // Csengetés Core0-tól: a FIFO-ban csak jelzés van, az üzenetek a közös postafiókban várnak
     if (rp2040.fifo.available() > 0) {
-        uint32_t raw_command;
-        rp2040.fifo.pop_nb(&raw_command);
-        Core1Command command = static_cast<Core1Command>(raw_command);
-        // DEBUG("Core1: Command received: 0x%lX\n", raw_command);
-
-        switch (command) {
-            case CORE1_CMD_SET_MODE_OFF:
-                DEBUG("Core1: Mode set to OFF by command\n");
-                deleteDecoders();
-                core1_current_mode = Core1ActiveMode::MODE_OFF;
-                break;
-            case CORE1_CMD_SET_MODE_RTTY:
-                DEBUG("Core1: Mode set to RTTY by command\n");
-                deleteDecoders();
-                core1_current_mode = Core1ActiveMode::MODE_RTTY;
-
-                // RTTY dekóder példányosítása a Core1-en
-                core1_rtty_decoder = new RttyDecoder(AUDIO_INPUT_PIN);
-                if (core1_rtty_decoder) {
-                    core1_rtty_decoder->resetDecoderState();
-                } else {
-                    DEBUG("Core1: FATAL - Failed to create RttyDecoder instance!\n");
-                }
-                break;
-
-            case CORE1_CMD_SET_MODE_CW:
-                // DEBUG("Core1: Mode set to CW by command\n");
-                deleteDecoders();
-                core1_current_mode = Core1ActiveMode::MODE_CW;
-
-                // CW dekóder példányosítása a Core1-en
-                core1_cw_decoder = new CwDecoder(AUDIO_INPUT_PIN);
-                if (core1_cw_decoder) {
-                    core1_cw_decoder->resetDecoderState();
-                } else {
-                    DEBUG("Core1: FATAL - Failed to create CwDecoder instance!\n");
-                }
-                break;
-            case CORE1_CMD_GET_RTTY_CHAR:
-                if (core1_current_mode == Core1ActiveMode::MODE_RTTY && core1_rtty_decoder) {
-                    char char_to_send_back = core1_rtty_decoder->getCharacterFromBuffer();
-                    if (char_to_send_back != '\0') {
-                        if (!rp2040.fifo.push_nb(static_cast<uint32_t>(char_to_send_back))) {
-                            Utils::beepError();
-                            DEBUG("Core1: RTTY command NOT sent to Core0, FIFO full\n");
-                        }
-                    }
-                }
-                break;
-
-            case CORE1_CMD_GET_CW_CHAR:
-                // Ez a parancs kéri le a karaktert a CwDecoder belső pufferéből
-                if (core1_current_mode == Core1ActiveMode::MODE_CW and core1_cw_decoder) {
-                    char char_to_send_back = core1_cw_decoder->getCharacterFromBuffer();
-                    if (char_to_send_back != '\0') {
-                        if (!rp2040.fifo.push_nb(static_cast<uint32_t>(char_to_send_back))) {
-                            Utils::beepError();
-                            DEBUG("Core1: CW command NOT sent to Core0, FIFO full\n");
-                        }
-                    }
-                }
-                break;
-
-            default:
-                DEBUG("Core1: Unknown command received: 0x%lX\n", raw_command);
-                break;
+        uint32_t doorbell;
+        while (rp2040.fifo.pop_nb(&doorbell)) {
+            // DEBUG("Core1: Doorbell, last sequence: %lu\n", doorbell);
         }
-    } else {
-        // Ha nincs parancs a Core0-tól, futtatjuk a megfelelő dekódert
-        if (core1_current_mode == Core1ActiveMode::MODE_CW && core1_cw_decoder) {
-            core1_cw_decoder->updateDecoder();  // Folyamatosan feldolgozza az audiót és tölti a belső puffert
-        } else if (core1_current_mode == Core1ActiveMode::MODE_RTTY && core1_rtty_decoder) {
-            core1_rtty_decoder->updateDecoder();  // Folyamatosan feldolgozza az RTTY audiót és tölti a belső puffert
+
+        // Az összes várakozó üzenet végrehajtása, sorrendben, mindegyikre válasszal
+        Core1Message message;
+        while (core1Mailbox.receive(message)) {
+            Core1ReplyStatus status = handleCore1Message(message);
+            if (!core1Mailbox.reply(message, status)) {
+                DEBUG("Core1: Reply queue full, reply for #%u dropped\n", message.sequence);
+            }
         }
+    }
 
-        // Rövid várakozás, hogy ne pörgesse túl a CPU-t, ha nincs más teendő
-        // Ezt az értéket finomhangolni kellhet a dekódolási sebesség és a rendszer válaszkészsége alapján.
-        // Ha túl nagy, lassú lehet a dekódolás. Ha túl kicsi, feleslegesen terheli a CPU-t.
-        // A CwDecoder belső időzítései (pl. sampleWithNoiseBlanking) határozzák meg a tényleges audio feldolgozási sebességet.
-        // Ez a delay csak akkor releváns, ha a dekóder gyorsabban végezne, mint ahogy új adat érkezik,
-        // vagy ha más feladatok is futnának a Core1-en.
-        delayMicroseconds(1000);  // 1 ms várakozás, ha nincs FIFO parancs
+    // A kész feladatok futnak (a dekóderek elsőbbséggel), utána alszunk a következő kész blokkig
+    const uint32_t idleUs = dspScheduler.runReadyTasks();
+    core1_load_busy_us += micros() - busyStartUs;
+
+    if (idleUs > 0 && rp2040.fifo.available() == 0) {
+        sleepUntilNextEvent(min(idleUs, Core1LoopConstants::MAX_SLEEP_US));
     }
-}
\ No newline at end of file
+    updateCore1LoadStats();
+}
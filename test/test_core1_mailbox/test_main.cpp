@@ -0,0 +1,231 @@
+/**
+ * @brief A Core0 <-> Core1 postafiók tesztje: sorrend, telítődés, sorszám körbefordulás és
+ *        két szálon (a két mag emulációja) futó terheléses teszt a FIFO csengővel (env:native)
+ */
+#include <Arduino.h>
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Core1Mailbox.h"
+#include "NativeHost.h"
+
+namespace {
+
+constexpr uint32_t STRESS_MESSAGES = 200000;  // A sorszám (uint16) többször is körbefordul
+
+/**
+ * @brief Egy CW vagy RTTY paraméter üzenet, a mezőkben a sorszámából képzett ellenőrző értékekkel
+ */
+Core1Message makeMessage(uint32_t counter) {
+    Core1Message message{};
+    message.command = (counter & 1) ? CORE1_CMD_SET_CW_PARAMS : CORE1_CMD_SET_RTTY_PARAMS;
+    if (message.command == CORE1_CMD_SET_CW_PARAMS) {
+        message.params.cw.offsetHz = static_cast<uint16_t>(counter * 7);
+    } else {
+        message.params.rtty.markHz = static_cast<float>(counter % 100000);
+        message.params.rtty.shiftHz = 170.0f;
+        message.params.rtty.baudRate = static_cast<uint16_t>(counter);
+    }
+    return message;
+}
+
+/**
+ * @brief Ugyanaz-e a tartalom, mint amit a counter-edik üzenetbe írtunk
+ */
+bool matches(const Core1Message &message, uint32_t counter) {
+    const Core1Message expected = makeMessage(counter);
+    if (message.command != expected.command) {
+        return false;
+    }
+    if (message.command == CORE1_CMD_SET_CW_PARAMS) {
+        return message.params.cw.offsetHz == expected.params.cw.offsetHz;
+    }
+    return message.params.rtty.markHz == expected.params.rtty.markHz && message.params.rtty.baudRate == expected.params.rtty.baudRate;
+}
+
+/**
+ * @brief A következő sorszám (a 0 kimarad)
+ */
+uint16_t nextSequence(uint16_t sequence) { return sequence == UINT16_MAX ? 1 : sequence + 1; }
+
+/**
+ * @brief Tele postafiók és tele válasz sor egy szálon
+ */
+void test_queue_limits() {
+    using Core1MailboxConstants::QUEUE_SIZE;
+
+    Core1Mailbox mailbox;
+    uint16_t sequences[QUEUE_SIZE];
+    for (uint8_t i = 0; i < QUEUE_SIZE; i++) {
+        Core1Message message = makeMessage(i);
+        sequences[i] = mailbox.post(message);
+        TEST_ASSERT_EQUAL_UINT16(i + 1, sequences[i]);
+        TEST_ASSERT_EQUAL_UINT16(sequences[i], message.sequence);
+    }
+    Core1Message overflow = makeMessage(QUEUE_SIZE);
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, mailbox.post(overflow), "tele postafiókba nem kerülhet üzenet");
+
+    // A Core1 sorrendben kapja meg, és a FIFO-ban csak 8 csengetés fér el
+    NativeHost::setCurrentCore(1);
+    TEST_ASSERT_EQUAL_INT(QUEUE_SIZE, rp2040.fifo.available());
+    Core1Message message;
+    for (uint8_t i = 0; i < QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(mailbox.receive(message));
+        TEST_ASSERT_EQUAL_UINT16(sequences[i], message.sequence);
+        TEST_ASSERT_TRUE(matches(message, i));
+        TEST_ASSERT_TRUE(mailbox.reply(message, Core1ReplyStatus::Ok));
+    }
+    TEST_ASSERT_FALSE(mailbox.receive(message));
+    TEST_ASSERT_FALSE_MESSAGE(mailbox.reply(message, Core1ReplyStatus::Failed), "tele válasz sor");
+    TEST_ASSERT_EQUAL_UINT32(1, mailbox.getDroppedReplyCount());
+
+    NativeHost::setCurrentCore(0);
+    Core1Reply reply;
+    for (uint8_t i = 0; i < QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(mailbox.pollReply(reply));
+        TEST_ASSERT_EQUAL_UINT16(sequences[i], reply.sequence);
+        TEST_ASSERT_TRUE(reply.status == Core1ReplyStatus::Ok);
+    }
+    TEST_ASSERT_FALSE(mailbox.pollReply(reply));
+
+    // reset(): a várakozó üzenetek és válaszok eldobódnak, a postafiók újra használható
+    Core1Message pending = makeMessage(0);
+    TEST_ASSERT_TRUE(mailbox.post(pending) != 0);
+    mailbox.reset();
+    NativeHost::setCurrentCore(1);
+    TEST_ASSERT_FALSE(mailbox.receive(message));
+    NativeHost::setCurrentCore(0);
+}
+
+/**
+ * @brief A sorszám a 65535 után 1-gyel folytatódik, a 0 (nem küldött) sosem fordul elő
+ */
+void test_sequence_wraps_past_zero() {
+    Core1Mailbox mailbox;
+    uint16_t expected = 1;
+    Core1Message message;
+    for (uint32_t i = 0; i < 3 * 65536u; i++) {
+        Core1Message outgoing = makeMessage(i);
+        TEST_ASSERT_EQUAL_UINT16(expected, mailbox.post(outgoing));
+        TEST_ASSERT_TRUE(mailbox.receive(message));
+        TEST_ASSERT_EQUAL_UINT16(expected, message.sequence);
+        expected = nextSequence(expected);
+    }
+}
+
+/**
+ * @brief Két szál: a Core0 folyamatosan küld és a válaszokat gyűjti, a Core1 a firmware
+ *        loop1() mintájára a csengetésre üríti a postafiókot és mindenre válaszol
+ *
+ * Ellenőrzi, hogy egy üzenet sem vész el és nem duplázódik (a tartalom a küldési sorrendet
+ * kódolja), a válaszok sorrendben, a megfelelő sorszámmal jönnek, és az elmaradt csengetések
+ * (tele FIFO) ellenére sem ragad bent üzenet.
+ */
+void test_two_core_stress() {
+    Core1Mailbox mailbox;
+    std::atomic<bool> stop(false);
+    std::atomic<uint32_t> core1Errors(0);
+    std::atomic<uint32_t> core1Received(0);
+
+    std::thread core1([&]() {
+        NativeHost::setCurrentCore(1);
+        uint32_t counter = 0;
+        uint16_t expectedSequence = 0;
+        while (!stop) {
+            if (rp2040.fifo.available() == 0) {
+                std::this_thread::yield();  // A firmware itt WFE-ben alszik
+                continue;
+            }
+            uint32_t doorbell;
+            while (rp2040.fifo.pop_nb(&doorbell)) {
+            }
+            Core1Message message;
+            while (mailbox.receive(message)) {
+                if ((expectedSequence != 0 && message.sequence != expectedSequence) || message.sequence == 0 || !matches(message, counter)) {
+                    core1Errors++;
+                }
+                expectedSequence = nextSequence(message.sequence);
+                counter++;
+                while (!mailbox.reply(message, Core1ReplyStatus::Ok) && !stop) {
+                    std::this_thread::yield();  // A teszt nem dob el választ: megvárjuk, amíg a Core0 kiüríti a sort
+                }
+            }
+            core1Received = counter;
+        }
+    });
+
+    constexpr uint32_t MAX_OUTSTANDING = 32;  // Üzenet sor + a feldolgozás alatt lévő + válasz sor (8 + 1 + 8) felett
+    uint16_t sentSequences[MAX_OUTSTANDING];
+    uint32_t sent = 0;
+    uint32_t replied = 0;
+    uint32_t replyErrors = 0;
+    uint32_t mailboxFull = 0;
+    const auto start = std::chrono::steady_clock::now();
+    bool timedOut = false;
+
+    while (replied < STRESS_MESSAGES) {
+        const uint32_t progress = sent + replied;
+        if (sent < STRESS_MESSAGES && sent - replied < MAX_OUTSTANDING) {
+            Core1Message message = makeMessage(sent);
+            const uint16_t sequence = mailbox.post(message);
+            if (sequence != 0) {
+                sentSequences[sent % MAX_OUTSTANDING] = sequence;
+                sent++;
+            } else {
+                mailboxFull++;
+            }
+        }
+
+        Core1Reply reply;
+        while (mailbox.pollReply(reply)) {
+            if (reply.sequence != sentSequences[replied % MAX_OUTSTANDING] || reply.command != makeMessage(replied).command || reply.status != Core1ReplyStatus::Ok) {
+                replyErrors++;
+            }
+            replied++;
+        }
+        if (sent + replied == progress) {
+            std::this_thread::yield();  // Egy magos gépen is haladjon a Core1 szál
+        }
+
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(30)) {
+            timedOut = true;  // Bent ragadt üzenet (pl. elmaradt csengetés után)
+            break;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stop = true;
+    core1.join();
+
+    char summary[160];
+    snprintf(summary, sizeof(summary), "%u messages in %.2fs (%.0f msg/s), mailbox full %u times, Core1 received %u", static_cast<unsigned>(replied), seconds, replied / seconds,
+             static_cast<unsigned>(mailboxFull), static_cast<unsigned>(core1Received.load()));
+    TEST_MESSAGE(summary);
+
+    TEST_ASSERT_FALSE_MESSAGE(timedOut, "a válaszok nem érkeztek meg: bent ragadt üzenet");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, core1Errors.load(), "elveszett, duplázott vagy sérült üzenet a Core1-en");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, replyErrors, "rossz sorrendű vagy hibás válasz a Core0-n");
+    TEST_ASSERT_EQUAL_UINT32(STRESS_MESSAGES, core1Received.load());
+    TEST_ASSERT_EQUAL_UINT32(0, mailbox.getDroppedReplyCount());
+}
+
+}  // namespace
+
+void setUp() {
+    NativeHost::setCurrentCore(0);
+    NativeHost::resetFifo();
+}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_limits);
+    RUN_TEST(test_sequence_wraps_past_zero);
+    RUN_TEST(test_two_core_stress);
+    return UNITY_END();
+}
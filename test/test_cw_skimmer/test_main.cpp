@@ -0,0 +1,275 @@
+/**
+ * @brief A több csatornás CW dekóder (skimmer) mérése több állomásos generált jelen (env:native)
+ *
+ * Egy hangsávba 1..8 különböző sebességű és szövegű CW állomást keverünk, zajjal. Csatornánként
+ * mérjük a karakter hibaarányt (a szöveg gyűrű bejegyzéseit a csatorna frekvenciája szerint
+ * szétválogatva), és a CPU időt hangmásodpercenként: a közös szűrőbank miatt a költség a
+ * csatornák számával alig nő. Minden eset egy JSON sort ír (mint a test_decoder_regression).
+ */
+#include <unity.h>
+
+#include <ArduinoFFT.h>
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "ArraySampleSource.h"
+#include "AudioSampleReader.h"
+#include "CwDecoder.h"
+#include "CwSkimmer.h"
+#include "DecoderRun.h"
+#include "FixedPointFftBackend.h"
+#include "NativeHost.h"
+#include "TestSignalGenerator.h"
+
+namespace {
+
+constexpr float BUS_RATE_HZ = AudioSampleBusConstants::SAMPLE_RATE_HZ;
+constexpr uint32_t CAPACITY = static_cast<uint32_t>(BUS_RATE_HZ * 45);
+constexpr float AMPLITUDE = 250.0f;  // 8 állomás együtt sem vágódik a 12 bites skálán
+constexpr float BIN_WIDTH_HZ = CwSkimmerConstants::SAMPLE_RATE_HZ / CwSkimmerConstants::FFT_SIZE;
+constexpr const char *PREAMBLE = "VVV VVV ";  // Ezalatt nyílik meg a csatorna (a csúcskereső átlagnak idő kell), nem mérjük
+
+/**
+ * @brief Egy állomás: a hang a skimmer bin-jeinek közepén, a szomszédos állomások 4 bin-re
+ */
+struct Station {
+    uint8_t bin;
+    float wpm;
+    const char *text;
+};
+
+const Station STATIONS[] = {
+    {8, 22, "CQ TEST HA5XYZ HA5XYZ TEST"},  {12, 28, "DL1ABC 599 014 TU"},        {16, 18, "CQ CQ DE OK1RR OK1RR K"},
+    {20, 25, "G4XYZ 5NN 123 GL"},           {24, 30, "TEST S57AW S57AW"},         {28, 20, "UA3ABC DE YU1AB 73 TU"},
+    {32, 26, "CQ WW DE OH2BH OH2BH"},       {36, 24, "F5XYZ 599 27 BK"},
+};
+constexpr uint8_t STATION_COUNT = sizeof(STATIONS) / sizeof(STATIONS[0]);
+
+std::vector<int16_t> signalBuffer(CAPACITY);
+std::vector<int16_t> stationBuffer(CAPACITY);
+
+/**
+ * @brief Az első count állomás jele egymásra keverve, zajjal
+ * @param count Az állomások száma
+ * @param snrDb Az egyes állomások SNR-je
+ * @param signalStart Ide kerül a jelek kezdete
+ * @param fadingDepthDb Állomásonként eltérő periódusú fading mélysége (0: nincs)
+ * @return A jel hossza mintákban
+ */
+uint32_t makeStations(uint8_t count, float snrDb, uint32_t &signalStart, float fadingDepthDb = 0.0f) {
+    TestSignalGenerator mix(signalBuffer.data(), CAPACITY, BUS_RATE_HZ);
+    mix.addSilence(44000);  // A leghosszabb szöveg 18 WPM-mel is belefér
+    signalStart = mix.msToSamples(500);
+
+    for (uint8_t i = 0; i < count; i++) {
+        // Minden állomás a saját pufferébe készül, eltolt kezdéssel, aztán összeadjuk
+        TestSignalGenerator station(stationBuffer.data(), CAPACITY, BUS_RATE_HZ);
+        station.setFading(fadingDepthDb > 0.0f ? 2300.0f + 410.0f * i : 0.0f, fadingDepthDb);
+        station.addSilence(500 + 170 * i);
+        const std::string text = std::string(PREAMBLE) + STATIONS[i].text;
+        station.addCw(text.c_str(), STATIONS[i].bin * BIN_WIDTH_HZ, STATIONS[i].wpm, AMPLITUDE);
+        for (uint32_t n = 0; n < station.getLength() && n < mix.getLength(); n++) {
+            signalBuffer[n] += stationBuffer[n];
+        }
+    }
+    mix.mixNoise(AMPLITUDE, snrDb);
+    return mix.getLength();
+}
+
+/**
+ * @brief Egy csatorna szövegéből az üzenet: a bevezető (és a megnyíláskor csonkult töredéke) nélkül
+ * @param decoded A csatorna normalizált szövege
+ * @param reference Az üzenet
+ * @return A szöveg az üzenet első szavától (ha az nem található, az egész szöveg)
+ */
+std::string messageText(const std::string &decoded, const std::string &reference) {
+    const std::string firstWord = reference.substr(0, reference.find(' ') + 1);
+    const size_t start = decoded.find(firstWord);
+    return start != std::string::npos ? decoded.substr(start) : decoded;
+}
+
+/**
+ * @brief A skimmer futtatása a jelen
+ */
+DecoderRunResult runSkimmer(uint32_t length, uint32_t signalStart, uint8_t &activeChannels) {
+    ArraySampleSource source(signalBuffer.data(), length, false);
+    source.start(0, BUS_RATE_HZ);
+    CwSkimmer skimmer(source);
+    TEST_ASSERT_TRUE(skimmer.isReady());
+    const DecoderRunResult result = DecoderRun::run(skimmer, source, DecodedTextSource::CwSkimmer, "", signalStart);
+    activeChannels = skimmer.getActiveChannelCount();
+    return result;
+}
+
+/**
+ * @brief Állomásonkénti karakter hibaarány és CPU idő 1, 2, 4 és 8 állomásnál
+ *
+ * Minden állomás bevezetővel kezd (a csatorna megnyílásáig a szöveg eleje elveszik, 30 WPM-nél
+ * kb. egy szó), a hibaarányt az üzenet első szavától mérjük.
+ */
+void test_multi_station_cer_and_cpu() {
+    constexpr float SNR_DB = 15.0f;
+    constexpr uint8_t MAX_STATION_ERRORS = 2;  // Hibás karakterek állomásonként (mért: 0, egy állomásnál a vége után 1 fantom karakter)
+    constexpr float MAX_TOTAL_CER = 3.0f;      // Az összes állomás együtt (mért: 8 állomásnál 1.3%)
+    const uint8_t counts[] = {1, 2, 4, 8};
+    float singleStationCpu = 0.0f;
+
+    for (uint8_t count : counts) {
+        uint32_t signalStart;
+        const uint32_t length = makeStations(count, SNR_DB, signalStart);
+        uint8_t activeChannels;
+        const DecoderRunResult result = runSkimmer(length, signalStart, activeChannels);
+
+        float worstCer = 0.0f;
+        float totalErrors = 0.0f;
+        uint32_t totalChars = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            const uint16_t channelHz = static_cast<uint16_t>(STATIONS[i].bin * BIN_WIDTH_HZ + 0.5f);
+            const std::string reference = DecoderRun::normalize(STATIONS[i].text);
+            const std::string text = messageText(DecoderRun::collectText(result.entries, DecodedTextSource::CwSkimmer, channelHz, BIN_WIDTH_HZ), reference);
+            const float cer = DecoderRun::characterErrorRate(reference, text);
+            char caseName[160];
+            snprintf(caseName, sizeof(caseName), "%u állomás, %u Hz %.0f WPM: '%s'", count, channelHz, STATIONS[i].wpm, text.c_str());
+            TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(MAX_STATION_ERRORS, lrintf(cer * reference.size() / 100.0f), caseName);
+            worstCer = cer > worstCer ? cer : worstCer;
+            totalErrors += cer * reference.size() / 100.0f;
+            totalChars += reference.size();
+        }
+
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(MAX_TOTAL_CER, totalErrors * 100.0f / totalChars, "összesített hibaarány");
+
+        // Nincs fantom csatorna a zajban
+        TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(count, activeChannels, "aktív csatornák");
+
+        char line[160];
+        snprintf(line, sizeof(line), "{\"case\":\"skimmer %u stations snr%.0f\",\"cer\":%.2f,\"worst_cer\":%.2f,\"cpu_us_per_s\":%.1f,\"audio_s\":%.1f}", count, SNR_DB,
+                 totalErrors * 100.0f / totalChars, worstCer, result.cpuUsPerSecond, result.audioSeconds);
+        TEST_MESSAGE(line);
+
+        if (count == 1) {
+            singleStationCpu = result.cpuUsPerSecond;
+        } else {
+            TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(singleStationCpu * 3.0f, result.cpuUsPerSecond, "a CPU idő a csatornák számával alig nő");
+        }
+    }
+}
+
+/**
+ * @brief 4 állomás, mindegyik más ütemű fadinggel (QSB): a csatornák nem záródnak be és nem nyílnak újra
+ *
+ * A fading mélypontján az állomás SNR-je 15 - 12 = 3dB. Mért: legrosszabb állomás 0%.
+ */
+void test_fading_stations() {
+    constexpr uint8_t COUNT = 4;
+    uint32_t signalStart;
+    const uint32_t length = makeStations(COUNT, 15.0f, signalStart, 12.0f);
+    uint8_t activeChannels;
+    const DecoderRunResult result = runSkimmer(length, signalStart, activeChannels);
+
+    float worstCer = 0.0f;
+    for (uint8_t i = 0; i < COUNT; i++) {
+        const uint16_t channelHz = static_cast<uint16_t>(STATIONS[i].bin * BIN_WIDTH_HZ + 0.5f);
+        const std::string reference = DecoderRun::normalize(STATIONS[i].text);
+        const std::string text = messageText(DecoderRun::collectText(result.entries, DecodedTextSource::CwSkimmer, channelHz, BIN_WIDTH_HZ), reference);
+        const float cer = DecoderRun::characterErrorRate(reference, text);
+        char caseName[160];
+        snprintf(caseName, sizeof(caseName), "fading, %u Hz %.0f WPM: '%s'", channelHz, STATIONS[i].wpm, text.c_str());
+        TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(2, lrintf(cer * reference.size() / 100.0f), caseName);
+        worstCer = cer > worstCer ? cer : worstCer;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(COUNT, activeChannels, "aktív csatornák");
+
+    char line[128];
+    snprintf(line, sizeof(line), "{\"case\":\"skimmer %u stations fading 12dB snr15\",\"worst_cer\":%.2f}", COUNT, worstCer);
+    TEST_MESSAGE(line);
+}
+
+/**
+ * @brief A skimmer CPU ideje ugyanannyi egycsatornás CwDecoder-rel összevetve (tájékoztató)
+ */
+void test_cpu_against_single_channel_decoders() {
+    uint32_t signalStart;
+    const uint32_t length = makeStations(STATION_COUNT, 15.0f, signalStart);
+    uint8_t activeChannels;
+    const DecoderRunResult skimmer = runSkimmer(length, signalStart, activeChannels);
+
+    ArraySampleSource source(signalBuffer.data(), length, false);
+    source.start(0, BUS_RATE_HZ);
+    CwDecoder decoder(0, source);
+    decoder.setTargetFrequency(STATIONS[0].bin * BIN_WIDTH_HZ);
+    const DecoderRunResult single = DecoderRun::run(decoder, source, DecodedTextSource::Cw, STATIONS[0].text, signalStart);
+
+    char line[160];
+    snprintf(line, sizeof(line), "{\"case\":\"skimmer vs %u decoders\",\"skimmer_us_per_s\":%.1f,\"decoders_us_per_s\":%.1f}", STATION_COUNT, skimmer.cpuUsPerSecond,
+             single.cpuUsPerSecond * STATION_COUNT);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN_FLOAT(single.cpuUsPerSecond * STATION_COUNT, skimmer.cpuUsPerSecond);
+}
+
+/**
+ * @brief A szűrőbank FFT ideje spektrumonként: fixpontos és float (arduinoFFT) backend (tájékoztató)
+ *
+ * A skimmer konfigurációjával (N=128, Hann), a hop idejéhez (HOP_SAMPLES / 8400Hz) viszonyítva.
+ */
+void test_filter_bank_fft_timing() {
+    using namespace CwSkimmerConstants;
+    constexpr uint32_t ITERATIONS = 20000;
+
+    std::vector<int16_t> samples(FFT_SIZE);
+    for (uint16_t n = 0; n < FFT_SIZE; n++) {
+        samples[n] = static_cast<int16_t>(lrint(AMPLITUDE * sin(2.0 * M_PI * 800.0 / SAMPLE_RATE_HZ * n)));
+    }
+    float magnitudes[FFT_SIZE / 2];
+
+    FixedPointFftBackend fixedPoint(true);
+    TEST_ASSERT_TRUE(fixedPoint.setSize(FFT_SIZE));
+    fixedPoint.setWindowType(FftWindowType::Hann);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        fixedPoint.computeMagnitudes(samples.data(), magnitudes);
+    }
+    const double fixedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+
+    float vReal[FFT_SIZE];
+    float vImag[FFT_SIZE];
+    ArduinoFFT<float> floatFft;
+    floatFft.setArrays(vReal, vImag, FFT_SIZE);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        for (uint16_t n = 0; n < FFT_SIZE; n++) {
+            vReal[n] = samples[n];
+            vImag[n] = 0.0f;
+        }
+        floatFft.windowing(vReal, FFT_SIZE, FFTWindow::Hann, FFTDirection::Forward);
+        floatFft.compute(vReal, vImag, FFT_SIZE, FFTDirection::Forward);
+        floatFft.complexToMagnitude(vReal, vImag, FFT_SIZE);
+    }
+    const double floatUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+    TEST_ASSERT_FALSE(std::isnan(vReal[FFT_SIZE / 8]));  // Az eredmény használva (ne optimalizálódjon ki)
+
+    const double hopUs = HOP_SAMPLES * 1e6 / SAMPLE_RATE_HZ;
+    char line[160];
+    snprintf(line, sizeof(line), "{\"case\":\"skimmer fft N=%u\",\"fixed_us\":%.2f,\"float_us\":%.2f,\"ratio\":%.2f,\"fixed_hop_share\":%.4f}", FFT_SIZE, fixedUs, floatUs,
+             floatUs / fixedUs, fixedUs / hopUs);
+    TEST_MESSAGE(line);
+}
+
+}  // namespace
+
+void setUp() { NativeHost::setMicros(0); }
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_multi_station_cer_and_cpu);
+    RUN_TEST(test_fading_stations);
+    RUN_TEST(test_cpu_against_single_channel_decoders);
+    RUN_TEST(test_filter_bank_fft_timing);
+    return UNITY_END();
+}
@@ -0,0 +1,326 @@
+/**
+ * @brief A CW időzítés becslés regressziós korpusza 5..50 WPM között (env:native)
+ *
+ * Két szinten: a CwTimingModel közvetlenül, ms-ben megadott jel és szünet hosszakkal (a
+ * CwDecoder tanítási sorrendjében), így pontos, kézi adásra jellemző eltérések (vonás/pont
+ * arány, súlyozás, szórás) és sebességváltás is előállítható; valamint a teljes CwDecoder a
+ * generált hangon, ahol a dekódolt szöveg mellett a kiadott WPM is ellenőrzött.
+ */
+#include <unity.h>
+
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include "ArraySampleSource.h"
+#include "AudioSampleReader.h"
+#include "CwDecoder.h"
+#include "CwTimingModel.h"
+#include "DecoderRun.h"
+#include "MorseCode.h"
+#include "NativeHost.h"
+#include "TestSignalGenerator.h"
+
+namespace {
+
+constexpr const char *TEXT = "CQ CQ DE HA5XYZ PARIS 599 TU";
+constexpr float INITIAL_DOT_MS = 60.0f;  // Mint a CwDecoder-ben (20 WPM)
+const float CORPUS_WPM[] = {5, 8, 10, 13, 15, 18, 20, 22, 25, 28, 30, 35, 40, 45, 50};
+constexpr float MAX_CORPUS_CER = 11.0f;  // Az első szó (3 karakter) a befogás alatt elveszhet, a szöveg többi része hibátlan kell legyen
+
+/**
+ * @brief Egy adó kulcsolása
+ */
+struct Keying {
+    float wpm;           // Karakter sebesség
+    float effectiveWpm;  // Farnsworth sebesség (0: nincs)
+    float dashRatio;     // Vonás/pont arány (szabályos: 3)
+    float weight;        // Súlyozás: a jelek ennyi egységgel hosszabbak, a szünetek ennyivel rövidebbek
+    float jitter;        // Egyenletes eloszlású relatív szórás elemenként (kézi adás)
+};
+
+/**
+ * @brief A jel és szünet hosszak (ms) egy szövegre: pozitív = jel, negatív = szünet
+ * @param keying A kulcsolás
+ * @param text A szöveg
+ * @param events Ide kerülnek a hosszak (hozzáfűzve)
+ * @param seed A szórás generátor állapota
+ */
+void keyText(const Keying &keying, const char *text, std::vector<float> &events, uint32_t &seed) {
+    const float unitMs = 1200.0f / keying.wpm;
+    float charGapMs = 3.0f * unitMs;
+    float wordGapMs = 7.0f * unitMs;
+    if (keying.effectiveWpm > 0.0f) {
+        // Mint a TestSignalGenerator::addCw(): a nyújtott szünetek 3:7 arányban
+        const float delayMs = (60.0f * keying.wpm - 37.2f * keying.effectiveWpm) / (keying.wpm * keying.effectiveWpm) * 1000.0f;
+        charGapMs = 3.0f * delayMs / 19.0f;
+        wordGapMs = 7.0f * delayMs / 19.0f;
+    }
+    auto jittered = [&](float ms) {
+        seed = seed * 1103515245 + 12345;
+        const float u = ((seed >> 16) & 0x7FFF) / 16383.5f - 1.0f;  // -1..1
+        return ms * (1.0f + keying.jitter * u);
+    };
+
+    for (const char *p = text; *p != '\0'; p++) {
+        uint8_t codeBits, codeLength;
+        if (*p == ' ' || !MorseCode::encode(*p, codeBits, codeLength)) {
+            continue;
+        }
+        for (int8_t i = codeLength - 1; i >= 0; i--) {
+            const float markUnits = ((codeBits >> i) & 1) ? keying.dashRatio : 1.0f;
+            events.push_back(jittered((markUnits + keying.weight) * unitMs));
+            const float gapMs = i > 0 ? unitMs : (p[1] == ' ' || p[1] == '\0' ? wordGapMs : charGapMs);
+            events.push_back(-jittered(gapMs - keying.weight * unitMs));
+        }
+    }
+}
+
+/**
+ * @brief A CwDecoder döntései a modellel: elemek gyűjtése, karakterhatárnál tanítás, majd dekódolás
+ * @param model A modell
+ * @param events A jel és szünet hosszak
+ * @param wpmAfterChar Ha nem nullptr, ide kerül minden karakter után a becsült WPM
+ * @return A dekódolt szöveg
+ */
+std::string decodeEvents(CwTimingModel &model, const std::vector<float> &events, std::vector<uint8_t> *wpmAfterChar = nullptr) {
+    std::string text;
+    std::vector<float> marks;
+    std::vector<float> gaps;
+
+    for (float event : events) {
+        if (event > 0.0f) {
+            marks.push_back(event);
+            continue;
+        }
+        const float gapMs = -event;
+        if (gapMs <= model.getCharGapThreshold()) {
+            gaps.push_back(gapMs);
+            continue;
+        }
+        const bool wordGap = gapMs > model.getWordGapThreshold();
+        gaps.push_back(gapMs);
+        for (float mark : marks) {
+            model.addMark(mark);
+        }
+        for (float gap : gaps) {
+            model.addSpace(gap);
+        }
+        uint8_t codeBits = 0;
+        for (float mark : marks) {
+            codeBits = static_cast<uint8_t>((codeBits << 1) | (model.isDash(mark) ? 1 : 0));
+        }
+        const char c = marks.size() <= MorseCode::MAX_ELEMENTS ? MorseCode::decode(codeBits, marks.size()) : '\0';
+        text += c != '\0' ? c : '*';
+        if (wordGap) {
+            text += ' ';
+        }
+        if (wpmAfterChar != nullptr) {
+            wpmAfterChar->push_back(model.getWpm());
+        }
+        marks.clear();
+        gaps.clear();
+    }
+    return DecoderRun::normalize(text);
+}
+
+/**
+ * @brief A szöveg az első szó után pontosan egyezik-e a referenciával
+ */
+bool matchesAfterFirstWord(const std::string &decoded, const char *text) {
+    const std::string reference = DecoderRun::normalize(text);
+    const std::string tail = reference.substr(reference.find(' ') + 1);
+    return decoded.size() >= tail.size() && decoded.compare(decoded.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+/**
+ * @brief Szabályos adás 5..50 WPM: hibátlan szöveg, a becsült sebesség a valódi 5%-án belül
+ *
+ * A modell 20 WPM-ről indul; a szélső sebességeken az első karakterből még tanul (5 WPM-nél
+ * az elemköz 240ms, a kezdeti karakterköz küszöb felett), ezért az első szó hibás lehet.
+ */
+void test_model_speed_corpus() {
+    for (float wpm : CORPUS_WPM) {
+        CwTimingModel model(INITIAL_DOT_MS);
+        std::vector<float> events;
+        uint32_t seed = 1;
+        keyText({wpm, 0, 3.0f, 0.0f, 0.0f}, TEXT, events, seed);
+        const std::string decoded = decodeEvents(model, events);
+
+        char caseName[96];
+        snprintf(caseName, sizeof(caseName), "%.0f WPM: '%s'", wpm, decoded.c_str());
+        TEST_ASSERT_TRUE_MESSAGE(matchesAfterFirstWord(decoded, TEXT), caseName);
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(MAX_CORPUS_CER, DecoderRun::characterErrorRate(DecoderRun::normalize(TEXT), decoded), caseName);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(wpm * 0.05f + 0.5f, wpm, model.getWpm(), caseName);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(wpm * 0.05f + 0.5f, wpm, model.getEffectiveWpm(), caseName);
+    }
+}
+
+/**
+ * @brief Farnsworth adás: a karakterek a karakter sebességgel, a szünetek a tényleges sebességhez nyújtva
+ */
+void test_model_farnsworth() {
+    struct Case {
+        float wpm;
+        float effectiveWpm;
+    };
+    const Case cases[] = {{18, 5}, {18, 10}, {20, 13}, {25, 15}, {30, 20}, {15, 8}};
+
+    for (const Case &c : cases) {
+        CwTimingModel model(INITIAL_DOT_MS);
+        std::vector<float> events;
+        uint32_t seed = 1;
+        keyText({c.wpm, c.effectiveWpm, 3.0f, 0.0f, 0.0f}, TEXT, events, seed);
+        keyText({c.wpm, c.effectiveWpm, 3.0f, 0.0f, 0.0f}, TEXT, events, seed);
+        const std::string decoded = decodeEvents(model, events);
+
+        char caseName[128];
+        snprintf(caseName, sizeof(caseName), "%.0f/%.0f WPM: '%s' (%u/%u)", c.wpm, c.effectiveWpm, decoded.c_str(), model.getWpm(), model.getEffectiveWpm());
+        const std::string reference = DecoderRun::normalize(std::string(TEXT) + " " + TEXT);
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(4.0f, DecoderRun::characterErrorRate(reference, decoded), caseName);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(c.wpm * 0.05f + 0.5f, c.wpm, model.getWpm(), caseName);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(c.effectiveWpm * 0.1f + 0.5f, c.effectiveWpm, model.getEffectiveWpm(), caseName);
+    }
+}
+
+/**
+ * @brief Kézi adás: eltérő vonás/pont arány, súlyozás és elemenkénti szórás ("swing")
+ */
+void test_model_hand_keying() {
+    struct Case {
+        Keying keying;
+        float maxCerPercent;
+    };
+    const Case cases[] = {
+        {{15, 0, 3.5f, 0.0f, 0.10f}, 4}, {{15, 0, 2.6f, 0.0f, 0.15f}, 4}, {{20, 0, 3.0f, 0.25f, 0.10f}, 4},
+        {{25, 0, 4.0f, -0.2f, 0.15f}, 4}, {{12, 0, 3.2f, 0.15f, 0.20f}, 4}, {{35, 0, 3.0f, 0.0f, 0.15f}, 4},
+    };
+
+    for (const Case &c : cases) {
+        CwTimingModel model(INITIAL_DOT_MS);
+        std::vector<float> events;
+        uint32_t seed = 7;
+        keyText(c.keying, TEXT, events, seed);
+        keyText(c.keying, TEXT, events, seed);
+        const std::string decoded = decodeEvents(model, events);
+
+        char caseName[160];
+        snprintf(caseName, sizeof(caseName), "%.0f WPM, vonás/pont %.1f, súly %.2f, szórás %.0f%%: '%s'", c.keying.wpm, c.keying.dashRatio, c.keying.weight,
+                 c.keying.jitter * 100.0f, decoded.c_str());
+        const std::string reference = DecoderRun::normalize(std::string(TEXT) + " " + TEXT);
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(c.maxCerPercent, DecoderRun::characterErrorRate(reference, decoded), caseName);
+    }
+}
+
+/**
+ * @brief Sebességváltás a szöveg közepén: az új sebességre néhány karakter alatt áll át
+ *
+ * A becsült WPM legfeljebb 4 karakter után a valódi 10%-án belül van, a második szó már hibátlan.
+ * Mért: gyorsulásnál 1 karakter (az első szó elemei egy érvénytelen karakterbe olvadnak),
+ * lassulásnál 4 (az első szó elemei külön karakterekre esnek szét).
+ */
+void test_model_speed_change() {
+    struct Case {
+        float fromWpm;
+        float toWpm;
+    };
+    const Case cases[] = {{12, 40}, {40, 12}, {20, 50}, {50, 8}, {8, 25}};
+
+    for (const Case &c : cases) {
+        CwTimingModel model(INITIAL_DOT_MS);
+        std::vector<float> events;
+        uint32_t seed = 1;
+        keyText({c.fromWpm, 0, 3.0f, 0.0f, 0.0f}, "CQ CQ DE HA5XYZ ", events, seed);
+        std::vector<uint8_t> wpm;
+        decodeEvents(model, events, &wpm);
+
+        events.clear();
+        keyText({c.toWpm, 0, 3.0f, 0.0f, 0.0f}, "PARIS TEST 599 TU", events, seed);
+        wpm.clear();
+        const std::string decoded = decodeEvents(model, events, &wpm);
+
+        uint8_t lockChars = 0;
+        while (lockChars < wpm.size() && fabsf(wpm[lockChars] - c.toWpm) > c.toWpm * 0.1f) {
+            lockChars++;
+        }
+        char caseName[128];
+        snprintf(caseName, sizeof(caseName), "%.0f -> %.0f WPM: '%s', befogás %u karakter", c.fromWpm, c.toWpm, decoded.c_str(), lockChars + 1);
+        TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(4, lockChars + 1, caseName);
+        TEST_ASSERT_TRUE_MESSAGE(decoded.find("TEST 599 TU") != std::string::npos, caseName);
+    }
+}
+
+/**
+ * @brief A teljes CwDecoder a korpusz sebességein (generált hang, SNR 20dB)
+ *
+ * A szöveg és a kiadott (utolsó karakterhez tartozó) WPM is ellenőrzött. Mért: 15..35 WPM
+ * hibátlan, lassabban az első 'C' szétesik ("TR", "C Q"), 40 WPM-től az első szó elveszik.
+ */
+void test_decoder_corpus() {
+    constexpr float BUS_RATE_HZ = AudioSampleBusConstants::SAMPLE_RATE_HZ;
+    constexpr float AMPLITUDE = 300.0f;
+    struct Case {
+        float wpm;
+        float effectiveWpm;
+    };
+    std::vector<Case> cases;
+    for (float wpm : CORPUS_WPM) {
+        cases.push_back({wpm, 0.0f});
+    }
+    cases.push_back({18, 5});  // ARRL Farnsworth: a karakterköz 23.5 elemköz
+    cases.push_back({18, 8});
+    cases.push_back({25, 15});
+
+    std::vector<int16_t> samples(static_cast<uint32_t>(BUS_RATE_HZ * 80));  // 5 WPM-nél a szöveg kb. 70s
+    for (const Case &c : cases) {
+        TestSignalGenerator generator(samples.data(), samples.size(), BUS_RATE_HZ);
+        generator.addSilence(500);
+        const uint32_t signalStart = generator.getLength();
+        generator.addCw(TEXT, 800, c.wpm, AMPLITUDE, c.effectiveWpm);
+        generator.addSilence(3000);
+        generator.mixNoise(AMPLITUDE, 20);
+
+        ArraySampleSource source(samples.data(), generator.getLength(), false);
+        source.start(0, BUS_RATE_HZ);
+        CwDecoder decoder(0, source);
+        decoder.setTargetFrequency(800);
+        const DecoderRunResult result = DecoderRun::run(decoder, source, DecodedTextSource::Cw, TEXT, signalStart);
+
+        char caseName[48];
+        if (c.effectiveWpm > 0.0f) {
+            snprintf(caseName, sizeof(caseName), "cw corpus %.0f/%.0fwpm", c.wpm, c.effectiveWpm);
+        } else {
+            snprintf(caseName, sizeof(caseName), "cw corpus %.0fwpm", c.wpm);
+        }
+        DecoderRun::report(caseName, result);
+
+        uint8_t reportedWpm = 0;
+        for (const DecodedTextEntry &entry : result.entries) {
+            if (entry.source == DecodedTextSource::Cw && entry.character != ' ') {
+                reportedWpm = entry.speed;
+            }
+        }
+        TEST_ASSERT_TRUE_MESSAGE(matchesAfterFirstWord(result.decoded, TEXT), caseName);
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(MAX_CORPUS_CER, result.cerPercent, caseName);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(c.wpm * 0.1f + 1.0f, c.wpm, reportedWpm, caseName);
+    }
+}
+
+}  // namespace
+
+void setUp() { NativeHost::setMicros(0); }
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_model_speed_corpus);
+    RUN_TEST(test_model_farnsworth);
+    RUN_TEST(test_model_hand_keying);
+    RUN_TEST(test_model_speed_change);
+    RUN_TEST(test_decoder_corpus);
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+/**
+ * @brief A dekóderek regressziós mérése generált és WAV-ból visszaolvasott jeleken (env:native)
+ *
+ * Minden eset egy JSON sort ír (karakter hibaarány, befogási idő, CPU idő hangmásodpercenként),
+ * a DECODER_REPORT környezeti változóval megadott fájlba is, így két futás összevethető.
+ * A küszöbök a jelenlegi dekóderek eredményei tartalékkal: egy romlás elbuktatja a tesztet.
+ */
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "ArraySampleSource.h"
+#include "AudioSampleReader.h"
+#include "CwDecoder.h"
+#include "DecoderRun.h"
+#include "NativeHost.h"
+#include "RttyDecoder.h"
+#include "TestSignalGenerator.h"
+#include "WavFile.h"
+
+namespace {
+
+constexpr float BUS_RATE_HZ = AudioSampleBusConstants::SAMPLE_RATE_HZ;
+constexpr uint32_t CAPACITY = static_cast<uint32_t>(BUS_RATE_HZ * 90);  // 90s jel (a szöveg 12 WPM-mel kb. 75s)
+constexpr float AMPLITUDE = 300.0f;                                     // Kb. -17dBFS a 12 bites skálán
+constexpr const char *TEXT = "CQ CQ DE HA5XYZ HA5XYZ K THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789";
+
+std::vector<int16_t> signalBuffer(CAPACITY);
+
+/**
+ * @brief Egy CW eset: generálás, dekódolás, riport
+ */
+DecoderRunResult runCw(const char *caseName, const int16_t *samples, uint32_t length, uint32_t signalStart) {
+    ArraySampleSource source(samples, length, false);
+    source.start(0, BUS_RATE_HZ);
+    CwDecoder decoder(0, source);
+    decoder.setTargetFrequency(800);
+    const DecoderRunResult result = DecoderRun::run(decoder, source, DecodedTextSource::Cw, TEXT, signalStart);
+    DecoderRun::report(caseName, result);
+    return result;
+}
+
+/**
+ * @brief Egy RTTY eset (1100Hz mark, 170Hz shift)
+ * @param baudRate A beállított baud (0: automatikus, 45: 45.45 baud)
+ */
+DecoderRunResult runRtty(const char *caseName, const int16_t *samples, uint32_t length, uint32_t signalStart, uint16_t baudRate = 0) {
+    ArraySampleSource source(samples, length, false);
+    source.start(0, BUS_RATE_HZ);
+    RttyDecoder decoder(0, source);
+    decoder.setParameters(1100.0f, 170.0f, baudRate);
+    const DecoderRunResult result = DecoderRun::run(decoder, source, DecodedTextSource::Rtty, TEXT, signalStart);
+    DecoderRun::report(caseName, result);
+    return result;
+}
+
+/**
+ * @brief CW az SNR és a sebesség függvényében
+ */
+void test_cw_speed_and_snr() {
+    struct Case {
+        float wpm;
+        float snrDb;
+        float maxCerPercent;
+    };
+    // Az első karakter a sebesség befogása alatt hibás lehet (12 WPM-nél egy karakter = 2.5%)
+    const Case cases[] = {{12, 20, 5}, {20, 20, 3}, {30, 20, 3}, {12, 6, 6}, {20, 6, 4}, {30, 6, 4}};
+
+    for (const Case &c : cases) {
+        TestSignalGenerator generator(signalBuffer.data(), CAPACITY, BUS_RATE_HZ);
+        generator.addSilence(500);
+        const uint32_t signalStart = generator.getLength();
+        generator.addCw(TEXT, 800, c.wpm, AMPLITUDE);
+        generator.addSilence(1500);
+        generator.mixNoise(AMPLITUDE, c.snrDb);
+
+        char caseName[48];
+        snprintf(caseName, sizeof(caseName), "cw %.0fwpm snr%.0f", c.wpm, c.snrDb);
+        const DecoderRunResult result = runCw(caseName, signalBuffer.data(), generator.getLength(), signalStart);
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(c.maxCerPercent, result.cerPercent, caseName);
+        TEST_ASSERT_TRUE_MESSAGE(result.lockMs >= 0.0f, caseName);
+    }
+}
+
+/**
+ * @brief CW két erős zavaró vivővel a közelben
+ */
+void test_cw_with_interfering_carriers() {
+    TestSignalGenerator generator(signalBuffer.data(), CAPACITY, BUS_RATE_HZ);
+    generator.addSilence(500);
+    const uint32_t signalStart = generator.getLength();
+    generator.addCw(TEXT, 800, 20, AMPLITUDE);
+    generator.addSilence(1000);
+    generator.mixTone(650, AMPLITUDE);
+    generator.mixTone(1000, AMPLITUDE);
+    generator.mixNoise(AMPLITUDE, 15);
+
+    const DecoderRunResult result = runCw("cw 20wpm carriers 650/1000", signalBuffer.data(), generator.getLength(), signalStart);
+    TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(5.0f, result.cerPercent, "zavaró vivők mellett");
+}
+
+/**
+ * @brief RTTY a baud és az SNR függvényében
+ */
+void test_rtty_baud_and_snr() {
+    struct Case {
+        float baud;
+        float snrDb;
+        float maxCerPercent;
+    };
+    // 75 baudnál az automatikus baud felismerés alatt az első szó elveszhet
+    const Case cases[] = {{45.45f, 20, 2}, {75, 20, 10}, {45.45f, 6, 3}, {75, 6, 16}};
+
+    for (const Case &c : cases) {
+        TestSignalGenerator generator(signalBuffer.data(), CAPACITY, BUS_RATE_HZ);
+        generator.addSilence(500);
+        const uint32_t signalStart = generator.getLength();
+        generator.addRtty(TEXT, 1100, 170, c.baud, AMPLITUDE);
+        generator.addSilence(500);
+        generator.mixNoise(AMPLITUDE, c.snrDb);
+
+        char caseName[48];
+        snprintf(caseName, sizeof(caseName), "rtty %.2fbd snr%.0f", c.baud, c.snrDb);
+        const DecoderRunResult result = runRtty(caseName, signalBuffer.data(), generator.getLength(), signalStart);
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(c.maxCerPercent, result.cerPercent, caseName);
+        TEST_ASSERT_TRUE_MESSAGE(result.lockMs >= 0.0f, caseName);
+    }
+}
+
+/**
+ * @brief RTTY fadinggel (QSB): sík és szelektív (a mark és a space felváltva halkul), zajjal
+ *
+ * A szelektív fadingnél a gyengébb hang időnként a zajszint közelébe esik: ezt az ATC
+ * (a mark és a space szintjének külön követése) hidalja át. A baud rögzített, így a mérés
+ * a bit döntést és a bit órát terheli, nem a baud felismerést.
+ */
+void test_rtty_fading() {
+    struct Case {
+        float baud;
+        const char *fadingName;
+        float periodMs;
+        float depthDb;
+        float spacePhase;
+        float snrDb;
+        float maxCerPercent;
+    };
+    // Mért: mind 0%, kivéve 45.45 baud sík és 75 baud szelektív fading SNR 10-nél: 1.3% (egy karakter)
+    const Case cases[] = {
+        {45.45f, "flat", 3000, 15, 0.0f, 20, 2},      {45.45f, "flat", 3000, 15, 0.0f, 10, 4},  {45.45f, "selective", 1700, 20, 0.5f, 20, 2},
+        {45.45f, "selective", 1700, 20, 0.5f, 10, 4}, {50, "selective", 1700, 20, 0.5f, 20, 2}, {75, "flat", 3000, 15, 0.0f, 20, 2},
+        {75, "selective", 1700, 20, 0.5f, 20, 2},     {75, "selective", 1700, 20, 0.5f, 10, 4}, {100, "flat", 3000, 15, 0.0f, 20, 2},
+        {100, "selective", 1700, 20, 0.5f, 20, 2},
+    };
+
+    for (const Case &c : cases) {
+        TestSignalGenerator generator(signalBuffer.data(), CAPACITY, BUS_RATE_HZ);
+        generator.setFading(c.periodMs, c.depthDb, c.spacePhase);
+        generator.addSilence(500);
+        const uint32_t signalStart = generator.getLength();
+        generator.addRtty(TEXT, 1100, 170, c.baud, AMPLITUDE);
+        generator.addSilence(500);
+        generator.mixNoise(AMPLITUDE, c.snrDb);
+
+        char caseName[64];
+        snprintf(caseName, sizeof(caseName), "rtty %.2fbd %s %.0fdB/%.1fs snr%.0f", c.baud, c.fadingName, c.depthDb, c.periodMs / 1000.0f, c.snrDb);
+        const DecoderRunResult result = runRtty(caseName, signalBuffer.data(), generator.getLength(), signalStart, c.baud < 46.0f ? 45 : static_cast<uint16_t>(c.baud));
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(c.maxCerPercent, result.cerPercent, caseName);
+    }
+}
+
+/**
+ * @brief WAV kiírás és visszaolvasás (más mintavételi frekvencián), majd dekódolás
+ *
+ * A felvételek 48kHz-esek szoktak lenni: a generált jelet 48kHz-en írjuk ki, a visszaolvasás
+ * a busz frekvenciájára mintavételez át, a dekódolt szövegnek ugyanannak kell maradnia.
+ */
+void test_wav_round_trip() {
+    constexpr float WAV_RATE_HZ = 48000.0f;
+    const uint32_t wavCapacity = static_cast<uint32_t>(WAV_RATE_HZ * 60);
+    std::vector<int16_t> wavSamples(wavCapacity);
+    const char *path = "test_decoder_regression.wav";
+
+    TestSignalGenerator cw(wavSamples.data(), wavCapacity, WAV_RATE_HZ);
+    cw.addSilence(500);
+    cw.addCw(TEXT, 800, 20, AMPLITUDE);
+    cw.addSilence(1500);
+    cw.mixNoise(AMPLITUDE, 20);
+    TEST_ASSERT_TRUE(WavFile::write(path, wavSamples.data(), cw.getLength(), WAV_RATE_HZ));
+
+    std::vector<int16_t> busSamples;
+    TEST_ASSERT_TRUE(WavFile::read(path, busSamples, BUS_RATE_HZ));
+    TEST_ASSERT_FLOAT_WITHIN(BUS_RATE_HZ * 0.01f, cw.getLength() * BUS_RATE_HZ / WAV_RATE_HZ, busSamples.size());
+    const DecoderRunResult cwResult = runCw("wav cw 20wpm snr20", busSamples.data(), busSamples.size(), static_cast<uint32_t>(BUS_RATE_HZ * 0.5f));
+    TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(3.0f, cwResult.cerPercent, "WAV CW");
+
+    TestSignalGenerator rtty(wavSamples.data(), wavCapacity, WAV_RATE_HZ);
+    rtty.addSilence(500);
+    rtty.addRtty(TEXT, 1100, 170, 45.45f, AMPLITUDE);
+    rtty.addSilence(500);
+    rtty.mixNoise(AMPLITUDE, 20);
+    TEST_ASSERT_TRUE(WavFile::write(path, wavSamples.data(), rtty.getLength(), WAV_RATE_HZ));
+    TEST_ASSERT_TRUE(WavFile::read(path, busSamples, BUS_RATE_HZ));
+    const DecoderRunResult rttyResult = runRtty("wav rtty 45.45bd snr20", busSamples.data(), busSamples.size(), static_cast<uint32_t>(BUS_RATE_HZ * 0.5f));
+    TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(2.0f, rttyResult.cerPercent, "WAV RTTY");
+
+    remove(path);
+}
+
+/**
+ * @brief A hibaarány számítás maga
+ */
+void test_character_error_rate() {
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, DecoderRun::characterErrorRate("CQ  de\r\nHA5XYZ ", "cq de ha5xyz"));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, DecoderRun::characterErrorRate("ABCDE", "ABXDE"));  // Csere
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, DecoderRun::characterErrorRate("ABCDE", "ABDE"));   // Kiesés
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, DecoderRun::characterErrorRate("ABCDE", "ABCDEF"));  // Betoldás
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, DecoderRun::characterErrorRate("ABCDE", ""));
+}
+
+/**
+ * @brief A minták időbélyege hosszú mintavétel után is a micros() módjára fordul körbe (2^32 us ~71.6 perc)
+ */
+void test_sample_time_wraps() {
+    constexpr float ADC_RATE_HZ = 67200.0f;
+    const int16_t silence[1] = {0};
+    ArraySampleSource source(silence, 1);
+    TEST_ASSERT_TRUE(source.start(0, ADC_RATE_HZ));
+
+    const uint32_t samplesPerWrap = static_cast<uint32_t>(4294967296.0 * ADC_RATE_HZ / 1000000.0);  // ~71.6 perc
+    TEST_ASSERT_EQUAL_UINT32(1000000, source.getElapsedUs(67200));
+    TEST_ASSERT_UINT32_WITHIN(15, 0, source.getElapsedUs(samplesPerWrap + 1));  // Egy mintaidőn (14.9us) belül a körbefordulás után
+    const uint32_t twoHours = static_cast<uint32_t>(ADC_RATE_HZ * 7200);
+    const uint32_t expected = static_cast<uint32_t>(7200ULL * 1000000ULL % 4294967296ULL);
+    TEST_ASSERT_UINT32_WITHIN(1, expected, source.getElapsedUs(twoHours));
+    TEST_ASSERT_UINT32_WITHIN(1, expected, source.getSampleTimeUs(twoHours) - source.getSampleTimeUs(0));
+    // A szomszédos minták közötti különbség a körbefordulásnál is egy mintaidő (a kivonás modulo 2^32)
+    TEST_ASSERT_UINT32_WITHIN(1, 15, source.getSampleTimeUs(samplesPerWrap + 1) - source.getSampleTimeUs(samplesPerWrap));
+}
+
+}  // namespace
+
+void setUp() { NativeHost::setMicros(0); }
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_character_error_rate);
+    RUN_TEST(test_cw_speed_and_snr);
+    RUN_TEST(test_cw_with_interfering_carriers);
+    RUN_TEST(test_rtty_baud_and_snr);
+    RUN_TEST(test_rtty_fading);
+    RUN_TEST(test_wav_round_trip);
+    RUN_TEST(test_sample_time_wraps);
+    return UNITY_END();
+}
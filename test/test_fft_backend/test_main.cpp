@@ -0,0 +1,294 @@
+/**
+ * @brief A fixpontos FFT backend pontossága és sebessége a double (ArduinoFFT) referenciához képest (env:native)
+ *
+ * A pontosság a két backend magnitúdó spektrumának eltéréséből számolt jel/hiba arány (dB),
+ * minden támogatott méretre és ablakra, nagy és kis (a blokk kitevőt próbáló) jellel. A sebesség
+ * csak tájékoztató: a hoston mért arány nem a Cortex-M0+ aránya (ott a double szoftveres),
+ * de egy lassulás itt is látszik.
+ */
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "ArduinoFftBackend.h"
+#include "FftTables.h"
+#include "FixedPointFftBackend.h"
+
+namespace {
+
+const uint16_t SIZES[] = {64, 128, 256, 512, 1024, 2048};
+// A flat top ablak itt nem szerepel: az ArduinoFFT 3 tagú változatot számol, a táblánk 5 tagú (lásd test_flat_top_amplitude)
+const FftWindowType WINDOWS[] = {FftWindowType::Hamming, FftWindowType::Hann, FftWindowType::BlackmanHarris};
+const char *const WINDOW_NAMES[] = {"Hamming", "Hann", "BlackmanHarris"};
+
+/**
+ * @brief Teszt jel: két hang (az egyik bin közötti), gyenge harmadik hang és determinisztikus zaj
+ * @param samples Ide kerül a jel
+ * @param size A minták száma
+ * @param amplitude A fő hang amplitúdója (a 12 bites skálán)
+ */
+void makeSignal(std::vector<int16_t> &samples, uint16_t size, float amplitude) {
+    samples.resize(size);
+    uint32_t noise = 0x2545F491;
+    for (uint16_t n = 0; n < size; n++) {
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+        const double value = amplitude * sin(2.0 * M_PI * 0.0732 * n) + 0.3 * amplitude * sin(2.0 * M_PI * (size / 8 + 0.5) / size * n) +
+                             0.01 * amplitude * sin(2.0 * M_PI * 0.377 * n) + 0.02 * amplitude * (static_cast<int32_t>(noise >> 16) - 32768) / 32768.0;
+        samples[n] = static_cast<int16_t>(lrint(value));
+    }
+}
+
+/**
+ * @brief Jel/hiba arány dB-ben: a referencia teljesítménye a két spektrum eltérésének teljesítményéhez
+ */
+double spectrumSnrDb(const std::vector<float> &reference, const std::vector<float> &measured) {
+    double signal = 0.0;
+    double error = 0.0;
+    for (size_t k = 0; k < reference.size(); k++) {
+        signal += static_cast<double>(reference[k]) * reference[k];
+        error += static_cast<double>(measured[k] - reference[k]) * (measured[k] - reference[k]);
+    }
+    return 10.0 * log10(signal / (error > 0.0 ? error : 1e-30));
+}
+
+/**
+ * @brief A legnagyobb bin indexe
+ */
+size_t peakBin(const std::vector<float> &magnitudes) {
+    size_t peak = 1;
+    for (size_t k = 1; k < magnitudes.size(); k++) {
+        if (magnitudes[k] > magnitudes[peak]) {
+            peak = k;
+        }
+    }
+    return peak;
+}
+
+/**
+ * @brief Pontosság minden méretre és ablakra, nagy (1500) és kis (12) amplitúdóval
+ *
+ * A kis jel a 12 bites skálán kb. 3.5 bit: a blokk kitevő nélkül a Q15 ablakozás és a
+ * fokozatonkénti skálázás elvinné a pontosságot.
+ */
+void test_accuracy_against_double() {
+    struct Level {
+        float amplitude;
+        double minSnrDb;
+    };
+    const Level levels[] = {{1500.0f, 52.0}, {12.0f, 50.0}};  // Jelenleg a legrosszabb eset 55 és 53 dB (N=2048)
+
+    for (uint16_t size : SIZES) {
+        for (uint8_t w = 0; w < sizeof(WINDOWS) / sizeof(WINDOWS[0]); w++) {
+            FixedPointFftBackend fixedPoint;
+            ArduinoFftBackend reference;
+            TEST_ASSERT_TRUE(fixedPoint.setSize(size));
+            TEST_ASSERT_TRUE(reference.setSize(size));
+            fixedPoint.setWindowType(WINDOWS[w]);
+            reference.setWindowType(WINDOWS[w]);
+
+            for (const Level &level : levels) {
+                std::vector<int16_t> samples;
+                makeSignal(samples, size, level.amplitude);
+                std::vector<float> expected(size / 2), measured(size / 2);
+                reference.computeMagnitudes(samples.data(), expected.data());
+                fixedPoint.computeMagnitudes(samples.data(), measured.data());
+
+                char caseName[64];
+                const double snrDb = spectrumSnrDb(expected, measured);
+                snprintf(caseName, sizeof(caseName), "N=%u %s A=%.0f: %.1f dB", size, WINDOW_NAMES[w], level.amplitude, snrDb);
+                TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(level.minSnrDb, snrDb, caseName);
+                TEST_ASSERT_EQUAL_UINT32_MESSAGE(peakBin(expected), peakBin(measured), caseName);
+                TEST_ASSERT_FLOAT_WITHIN_MESSAGE(expected[peakBin(expected)] * 0.01f, expected[peakBin(expected)], measured[peakBin(expected)], caseName);
+            }
+        }
+    }
+}
+
+/**
+ * @brief A csomagolt (N/2 pontos) és a teljes komplex transzformáció ugyanazt a spektrumot adja
+ *
+ * A komplex út nulla képzetes résszel is fut: a kimenet pozitív fele egyezik a valós
+ * bemenetű spektrummal, a negatív fele annak tükörképe.
+ */
+void test_packed_matches_complex() {
+    const float amplitudes[] = {1500.0f, 12.0f};
+
+    for (uint16_t size : SIZES) {
+        for (uint8_t w = 0; w < sizeof(WINDOWS) / sizeof(WINDOWS[0]); w++) {
+            FixedPointFftBackend packed(true);
+            FixedPointFftBackend complex(false);
+            TEST_ASSERT_TRUE(packed.setSize(size));
+            TEST_ASSERT_TRUE(complex.setSize(size));
+            packed.setWindowType(WINDOWS[w]);
+            complex.setWindowType(WINDOWS[w]);
+
+            for (float amplitude : amplitudes) {
+                std::vector<int16_t> samples;
+                makeSignal(samples, size, amplitude);
+                const std::vector<int16_t> zeros(size, 0);
+                std::vector<float> packedOut(size / 2), complexOut(size / 2), fullOut(size);
+                packed.computeMagnitudes(samples.data(), packedOut.data());
+                complex.computeMagnitudes(samples.data(), complexOut.data());
+                TEST_ASSERT_FALSE(packed.computeComplexMagnitudes(samples.data(), zeros.data(), fullOut.data()));
+                TEST_ASSERT_TRUE(complex.computeComplexMagnitudes(samples.data(), zeros.data(), fullOut.data()));
+
+                std::vector<float> positive(fullOut.begin(), fullOut.begin() + size / 2);
+                std::vector<float> mirrored(size / 2);
+                mirrored[0] = fullOut[0];
+                for (uint16_t k = 1; k < size / 2; k++) {
+                    mirrored[k] = fullOut[size - k];
+                }
+
+                char caseName[96];
+                const double packedSnrDb = spectrumSnrDb(complexOut, packedOut);
+                const double positiveSnrDb = spectrumSnrDb(complexOut, positive);
+                const double mirrorSnrDb = spectrumSnrDb(positive, mirrored);
+                snprintf(caseName, sizeof(caseName), "N=%u %s A=%.0f: %.1f / %.1f / %.1f dB", size, WINDOW_NAMES[w], amplitude, packedSnrDb, positiveSnrDb,
+                         mirrorSnrDb);
+                // Jelenleg a legrosszabb eset 52 és 50.5 dB (N=2048), a komplex út pozitív fele bitre azonos
+                TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(48.0, packedSnrDb, caseName);
+                TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(200.0, positiveSnrDb, caseName);
+                TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(47.0, mirrorSnrDb, caseName);
+                TEST_ASSERT_EQUAL_UINT32_MESSAGE(peakBin(complexOut), peakBin(packedOut), caseName);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Flat top ablak: a hang amplitúdója a bin-ek közé eső frekvencián is pontos
+ *
+ * A magnitúdók a Hamming ablak koherens erősítésére normáltak, így egy A amplitúdójú
+ * hang csúcsa A * N/2 * 0.54 (a szimmetrikus, N-1 nevezős ablak miatt kis N-nél kb. 1.5%-kal
+ * kevesebb), a flat top ablakkal a bin-hez képesti helyzettől függetlenül: a Hamming ablak
+ * 1.7dB-es bin közötti esése helyett 0.5%-on belül.
+ */
+void test_flat_top_amplitude() {
+    constexpr float AMPLITUDE = 1000.0f;
+    const float offsets[] = {0.0f, 0.25f, 0.5f};
+
+    for (uint16_t size : SIZES) {
+        FixedPointFftBackend fixedPoint;
+        TEST_ASSERT_TRUE(fixedPoint.setSize(size));
+        fixedPoint.setWindowType(FftWindowType::FlatTop);
+        const float expectedPeak = AMPLITUDE * size / 2 * 0.54f;
+        float lowest = expectedPeak * 2.0f;
+        float highest = 0.0f;
+
+        for (float offset : offsets) {
+            const float bin = size / 8 + offset;
+            std::vector<int16_t> samples(size);
+            for (uint16_t n = 0; n < size; n++) {
+                samples[n] = static_cast<int16_t>(lrint(AMPLITUDE * sin(2.0 * M_PI * bin / size * n)));
+            }
+            std::vector<float> magnitudes(size / 2);
+            fixedPoint.computeMagnitudes(samples.data(), magnitudes.data());
+
+            char caseName[64];
+            snprintf(caseName, sizeof(caseName), "N=%u bin+%.2f: %.1f", size, offset, magnitudes[peakBin(magnitudes)]);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(expectedPeak * 0.02f, expectedPeak, magnitudes[peakBin(magnitudes)], caseName);
+            lowest = std::min(lowest, magnitudes[peakBin(magnitudes)]);
+            highest = std::max(highest, magnitudes[peakBin(magnitudes)]);
+        }
+        TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(1.005f, highest / lowest, "a flat top csúcs a bin közötti frekvencián is ugyanaz");
+    }
+}
+
+/**
+ * @brief Csupa nulla és teljes skálás bemenet: nincs túlcsordulás, nincs NaN
+ */
+void test_extreme_inputs() {
+    for (uint16_t size : SIZES) {
+        FixedPointFftBackend fixedPoint;
+        ArduinoFftBackend reference;
+        TEST_ASSERT_TRUE(fixedPoint.setSize(size));
+        TEST_ASSERT_TRUE(reference.setSize(size));
+
+        std::vector<int16_t> samples(size, 0);
+        std::vector<float> expected(size / 2), measured(size / 2);
+        fixedPoint.computeMagnitudes(samples.data(), measured.data());
+        for (float m : measured) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, m);
+        }
+
+        // Teljes skálás négyszögjel (a legnagyobb pillangó növekedés) és egyenáram
+        for (uint16_t n = 0; n < size; n++) {
+            samples[n] = ((n / 4) & 1) ? 2047 : -2048;
+        }
+        reference.computeMagnitudes(samples.data(), expected.data());
+        fixedPoint.computeMagnitudes(samples.data(), measured.data());
+        for (float m : measured) {
+            TEST_ASSERT_FALSE(std::isnan(m));
+        }
+        TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(40.0, spectrumSnrDb(expected, measured), "teljes skálás négyszögjel");
+    }
+}
+
+/**
+ * @brief Nem támogatott méretek
+ */
+void test_unsupported_sizes() {
+    FixedPointFftBackend fixedPoint;
+    TEST_ASSERT_FALSE(fixedPoint.setSize(0));
+    TEST_ASSERT_FALSE(fixedPoint.setSize(FftTables::MIN_TABLE_FFT_SIZE / 2));
+    TEST_ASSERT_FALSE(fixedPoint.setSize(FftTables::MAX_TABLE_FFT_SIZE * 2));
+    TEST_ASSERT_FALSE(fixedPoint.setSize(100));
+    TEST_ASSERT_EQUAL_UINT16(0, fixedPoint.getSize());
+    TEST_ASSERT_TRUE(fixedPoint.setSize(256));
+    TEST_ASSERT_FALSE(fixedPoint.setSize(300));
+    TEST_ASSERT_EQUAL_UINT16(256, fixedPoint.getSize());
+}
+
+/**
+ * @brief Futási idő transzformációnként (tájékoztató, a hoston)
+ */
+void test_speed() {
+    for (uint16_t size : SIZES) {
+        FixedPointFftBackend fixedPoint;
+        ArduinoFftBackend reference;
+        fixedPoint.setSize(size);
+        reference.setSize(size);
+        std::vector<int16_t> samples;
+        makeSignal(samples, size, 1500.0f);
+        std::vector<float> magnitudes(size / 2);
+
+        const uint32_t iterations = 400000 / size;
+        auto measure = [&](IFftBackend &backend) {
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++) {
+                backend.computeMagnitudes(samples.data(), magnitudes.data());
+            }
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+        };
+        const double fixedUs = measure(fixedPoint);
+        const double referenceUs = measure(reference);
+
+        char line[128];
+        snprintf(line, sizeof(line), "{\"case\":\"fft N=%u\",\"fixed_us\":%.2f,\"double_us\":%.2f,\"ratio\":%.2f}", size, fixedUs, referenceUs, referenceUs / fixedUs);
+        TEST_MESSAGE(line);
+    }
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_accuracy_against_double);
+    RUN_TEST(test_packed_matches_complex);
+    RUN_TEST(test_flat_top_amplitude);
+    RUN_TEST(test_extreme_inputs);
+    RUN_TEST(test_unsupported_sizes);
+    RUN_TEST(test_speed);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+/**
+ * @brief A half-band decimátorok átviteli sáv hullámossága és záró sáv csillapítása (env:native)
+ *
+ * Minden fokozatot és a busz teljes kaszkádját szinuszos jelekkel mérjük: a kimenet amplitúdóját
+ * a bemenetihez viszonyítjuk, a záró sávban az átlapolt (a kimeneti sávba tükröződő) maradékot.
+ * A mért átvitelt a kerekített Q15 együtthatókból számolt tervezési görbével is összevetjük.
+ */
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <vector>
+
+#include "AudioSampleReader.h"
+#include "HalfBandDecimator.h"
+
+namespace {
+
+constexpr float AMPLITUDE = 8000.0f;       // A bemenet 2^14 alatt marad (int32 akkumulátor)
+constexpr uint16_t INPUT_SAMPLES = 8192;   // Bemeneti minták frekvenciánként
+constexpr uint16_t SETTLE_SAMPLES = 64;    // A kimenet elején eldobott minták (a szűrők feltöltődése)
+constexpr double FREQUENCY_STEP = 0.005;   // A sweep lépésköze a bemeneti mintavételi frekvencia arányában
+constexpr double STOPBAND_EDGE = 0.5 - HalfBandDesign::PASSBAND_EDGE;
+
+/**
+ * @brief Egy szinuszos bemenet és a decimált kimenet RMS aránya dB-ben
+ * @param decimator A decimátor (process(int16_t *, uint16_t) hívható objektum)
+ * @param frequency A frekvencia a bemeneti mintavételi frekvencia arányában
+ */
+template <typename Process>
+double measureGainDb(Process process, double frequency) {
+    std::vector<int16_t> samples(INPUT_SAMPLES);
+    for (uint16_t n = 0; n < INPUT_SAMPLES; n++) {
+        samples[n] = static_cast<int16_t>(lrint(AMPLITUDE * sin(2.0 * M_PI * frequency * n)));
+    }
+    const uint16_t produced = process(samples.data(), INPUT_SAMPLES);
+    double power = 0.0;
+    for (uint16_t n = SETTLE_SAMPLES; n < produced; n++) {
+        power += static_cast<double>(samples[n]) * samples[n];
+    }
+    const double rms = sqrt(power / (produced - SETTLE_SAMPLES));
+    return 20.0 * log10((rms > 1e-3 ? rms : 1e-3) / (AMPLITUDE / M_SQRT2));
+}
+
+/**
+ * @brief Egy fokozat mérése: hullámosság az átviteli sávban, csillapítás a záró sávban
+ * @param name A fokozat neve (hibaüzenethez)
+ * @param maxRippleDb A megengedett csúcstól csúcsig hullámosság
+ * @param minRejectionDb A megengedett legkisebb csillapítás
+ */
+template <uint8_t Taps, uint8_t KaiserBetaX10>
+void checkStage(const char *name, double maxRippleDb, double minRejectionDb) {
+    auto process = [](int16_t *samples, uint16_t count) {
+        HalfBandDecimator<Taps, KaiserBetaX10> decimator;
+        return decimator.process(samples, count, samples);
+    };
+
+    double minGainDb = 1e9;
+    double maxGainDb = -1e9;
+    for (double f = 0.0; f <= HalfBandDesign::PASSBAND_EDGE + 1e-9; f += FREQUENCY_STEP) {
+        const double gainDb = measureGainDb(process, f > 0.0 ? f : 0.001);
+        const double designDb = 20.0 * log10(HalfBandDesign::magnitude<Taps, KaiserBetaX10>(f));
+        char caseName[64];
+        snprintf(caseName, sizeof(caseName), "%s f=%.3f: %.3f dB (terv %.3f dB)", name, f, gainDb, designDb);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.02, designDb, gainDb, caseName);
+        minGainDb = gainDb < minGainDb ? gainDb : minGainDb;
+        maxGainDb = gainDb > maxGainDb ? gainDb : maxGainDb;
+    }
+
+    double worstRejectionDb = 1e9;
+    for (double f = STOPBAND_EDGE; f <= 0.5 + 1e-9; f += FREQUENCY_STEP) {
+        const double rejectionDb = -measureGainDb(process, f < 0.5 ? f : 0.499);
+        worstRejectionDb = rejectionDb < worstRejectionDb ? rejectionDb : worstRejectionDb;
+    }
+
+    char summary[96];
+    snprintf(summary, sizeof(summary), "%s: hullámosság %.3f dB, csillapítás %.1f dB", name, maxGainDb - minGainDb, worstRejectionDb);
+    TEST_MESSAGE(summary);
+    TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(maxRippleDb, maxGainDb - minGainDb, summary);
+    TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(minRejectionDb, worstRejectionDb, summary);
+}
+
+// A csillapítási határok az AudioSampleBusConstants-ban vállaltak; mért: 0.063/0.026/0.020 dB és 45.5/54.6/62.6 dB
+void test_stage_23_50() { checkStage<23, 50>("HalfBand<23,50>", 0.1, 45.0); }
+
+void test_stage_27_50() { checkStage<27, 50>("HalfBand<27,50>", 0.1, 54.0); }
+
+void test_stage_31_60() { checkStage<31, 60>("HalfBand<31,60>", 0.1, 60.0); }
+
+/**
+ * @brief A busz teljes kaszkádja 8-as osztással: 3kHz-ig sík, a kimeneti sávba átlapolódó jelek elnyomva
+ *
+ * A záró sáv a 8400Hz-es kimenetre vetítve az utolsó fokozaté: 16.8kHz * 0.32 = 5376Hz felett
+ * bármely frekvencia (a bemenet Nyquist frekvenciájáig) legalább ennyivel csillapodik.
+ */
+void test_bus_chain() {
+    constexpr double BUS_RATE_HZ = AudioSampleBusConstants::SAMPLE_RATE_HZ;
+    constexpr uint8_t STAGES = AudioSampleBusConstants::DecimatorChainType::STAGE_COUNT;
+    auto process = [](int16_t *samples, uint16_t count) {
+        AudioSampleBusConstants::DecimatorChainType chain;
+        return chain.process(samples, count, STAGES);
+    };
+
+    double minGainDb = 1e9;
+    double maxGainDb = -1e9;
+    for (double hz = 50.0; hz <= 3000.0; hz += 50.0) {
+        const double gainDb = measureGainDb(process, hz / BUS_RATE_HZ);
+        minGainDb = gainDb < minGainDb ? gainDb : minGainDb;
+        maxGainDb = gainDb > maxGainDb ? gainDb : maxGainDb;
+    }
+
+    double worstRejectionDb = 1e9;
+    double worstHz = 0.0;
+    for (double hz = 16800.0 * STOPBAND_EDGE; hz < BUS_RATE_HZ / 2; hz += 97.0) {
+        const double rejectionDb = -measureGainDb(process, hz / BUS_RATE_HZ);
+        if (rejectionDb < worstRejectionDb) {
+            worstRejectionDb = rejectionDb;
+            worstHz = hz;
+        }
+    }
+
+    char summary[128];
+    snprintf(summary, sizeof(summary), "Lánc /8: hullámosság %.3f dB (%.3f..%.3f), csillapítás %.1f dB (%.0f Hz)", maxGainDb - minGainDb, minGainDb, maxGainDb,
+             worstRejectionDb, worstHz);
+    TEST_MESSAGE(summary);
+    TEST_ASSERT_LESS_THAN_FLOAT_MESSAGE(0.15, maxGainDb - minGainDb, summary);  // Mért: 0.074 dB
+    TEST_ASSERT_GREATER_THAN_FLOAT_MESSAGE(60.0, worstRejectionDb, summary);    // Mért: 63.1 dB (5376Hz, az utolsó fokozat záró sáv széle)
+}
+
+/**
+ * @brief Darabolt és egyben feldolgozott bemenet ugyanazt adja, a kimenet hossza pontos
+ */
+void test_chunked_processing_matches() {
+    constexpr uint8_t STAGES = AudioSampleBusConstants::DecimatorChainType::STAGE_COUNT;
+    std::vector<int16_t> whole(4096);
+    uint32_t noise = 12345;
+    for (int16_t &sample : whole) {
+        noise = noise * 1103515245 + 12345;
+        sample = static_cast<int16_t>((noise >> 16) % 16000) - 8000;
+    }
+    std::vector<int16_t> chunked = whole;
+
+    AudioSampleBusConstants::DecimatorChainType wholeChain;
+    TEST_ASSERT_EQUAL_UINT16(whole.size() / 8, wholeChain.process(whole.data(), whole.size(), STAGES));
+
+    AudioSampleBusConstants::DecimatorChainType chunkedChain;
+    uint16_t produced = 0;
+    for (uint16_t offset = 0; offset < chunked.size(); offset += AudioSampleBusConstants::DECIMATION_CHUNK_SAMPLES) {
+        int16_t chunk[AudioSampleBusConstants::DECIMATION_CHUNK_SAMPLES];
+        memcpy(chunk, &chunked[offset], sizeof(chunk));
+        const uint16_t count = chunkedChain.process(chunk, AudioSampleBusConstants::DECIMATION_CHUNK_SAMPLES, STAGES);
+        memcpy(&chunked[produced], chunk, count * sizeof(int16_t));
+        produced += count;
+    }
+    TEST_ASSERT_EQUAL_UINT16(whole.size() / 8, produced);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(whole.data(), chunked.data(), produced);
+
+    // 0 aktív fokozat: a minták változatlanok
+    std::vector<int16_t> copy = chunked;
+    TEST_ASSERT_EQUAL_UINT16(copy.size(), chunkedChain.process(copy.data(), copy.size(), 0));
+    TEST_ASSERT_EQUAL_INT16_ARRAY(chunked.data(), copy.data(), copy.size());
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_stage_23_50);
+    RUN_TEST(test_stage_27_50);
+    RUN_TEST(test_stage_31_60);
+    RUN_TEST(test_bus_chain);
+    RUN_TEST(test_chunked_processing_matches);
+    return UNITY_END();
+}
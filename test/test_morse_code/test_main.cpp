@@ -0,0 +1,139 @@
+/**
+ * @brief A Morse kód tábla teljes ellenőrzése egy független referencia listával (env:native)
+ */
+#include <unity.h>
+
+#include <string.h>
+
+#include "MorseCode.h"
+
+namespace {
+
+/**
+ * @brief Referencia: ITU-R M.1677 betűk, számok, írásjelek, a prosignok és a HA ékezetes betűk
+ */
+struct Reference {
+    const char *pattern;
+    char symbol;
+};
+
+const Reference REFERENCE[] = {
+    {".-", 'A'},       {"-...", 'B'},    {"-.-.", 'C'},    {"-..", 'D'},     {".", 'E'},       {"..-.", 'F'},    {"--.", 'G'},     {"....", 'H'},
+    {"..", 'I'},       {".---", 'J'},    {"-.-", 'K'},     {".-..", 'L'},    {"--", 'M'},      {"-.", 'N'},      {"---", 'O'},     {".--.", 'P'},
+    {"--.-", 'Q'},     {".-.", 'R'},     {"...", 'S'},     {"-", 'T'},       {"..-", 'U'},     {"...-", 'V'},    {".--", 'W'},     {"-..-", 'X'},
+    {"-.--", 'Y'},     {"--..", 'Z'},    {"-----", '0'},   {".----", '1'},   {"..---", '2'},   {"...--", '3'},   {"....-", '4'},   {".....", '5'},
+    {"-....", '6'},    {"--...", '7'},   {"---..", '8'},   {"----.", '9'},   {".-.-.-", '.'},  {"--..--", ','},  {"..--..", '?'},  {".----.", '\''},
+    {"-.-.--", '!'},   {"-..-.", '/'},   {"-.--.-", ')'},  {".-...", '&'},   {"---...", ':'},  {"-.-.-.", ';'},  {"-....-", '-'},  {"..--.-", '_'},
+    {".-..-.", '"'},   {".--.-.", '@'},  {"...-..-", '$'},
+
+    {".-.-.", MorseCode::PROSIGN_AR},        {"...-.-", MorseCode::PROSIGN_SK},     {"-...-", MorseCode::PROSIGN_BT},
+    {"-.--.", MorseCode::PROSIGN_KN},        {"........", MorseCode::PROSIGN_ERROR},
+
+    {".--.-", MorseCode::LETTER_A_ACUTE},    {"..-..", MorseCode::LETTER_E_ACUTE},  {"---.", MorseCode::LETTER_O_UMLAUT},
+    {"..--", MorseCode::LETTER_U_UMLAUT},
+};
+constexpr uint8_t REFERENCE_COUNT = sizeof(REFERENCE) / sizeof(REFERENCE[0]);
+
+/**
+ * @brief Egy pont-vonás minta bitekre (az első elem a legmagasabb biten)
+ */
+void toBits(const char *pattern, uint8_t &codeBits, uint8_t &codeLength) {
+    codeBits = 0;
+    codeLength = static_cast<uint8_t>(strlen(pattern));
+    for (const char *p = pattern; *p != '\0'; p++) {
+        codeBits = static_cast<uint8_t>((codeBits << 1) | (*p == '-' ? 1 : 0));
+    }
+}
+
+/**
+ * @brief A referencia minden jele dekódolódik és kódolódik, oda-vissza
+ */
+void test_reference_symbols() {
+    for (const Reference &ref : REFERENCE) {
+        uint8_t bits, length;
+        toBits(ref.pattern, bits, length);
+        TEST_ASSERT_EQUAL_CHAR_MESSAGE(ref.symbol, MorseCode::decode(bits, length), ref.pattern);
+
+        uint8_t encodedBits = 0xFF, encodedLength = 0xFF;
+        TEST_ASSERT_TRUE_MESSAGE(MorseCode::encode(ref.symbol, encodedBits, encodedLength), ref.pattern);
+        TEST_ASSERT_EQUAL_UINT8(length, encodedLength);
+        TEST_ASSERT_EQUAL_UINT8(bits, encodedBits);
+    }
+}
+
+/**
+ * @brief Minden lehetséges 1..MAX_ELEMENTS hosszú sorozat: csak a referencia jelei dekódolódnak
+ *
+ * A tábla a vezető 1-es bittel indexel: ha a hossz és a minta összekeveredne (pl. "-" és ".-"),
+ * itt egy nem várt karakter jelenne meg.
+ */
+void test_every_sequence() {
+    uint16_t decodedCount = 0;
+    for (uint8_t length = 1; length <= MorseCode::MAX_ELEMENTS; length++) {
+        for (uint16_t bits = 0; bits < (1u << length); bits++) {
+            const char symbol = MorseCode::decode(static_cast<uint8_t>(bits), length);
+            if (symbol == '\0') {
+                continue;
+            }
+            decodedCount++;
+
+            char pattern[MorseCode::MAX_ELEMENTS + 1];
+            for (uint8_t i = 0; i < length; i++) {
+                pattern[i] = ((bits >> (length - 1 - i)) & 1) ? '-' : '.';
+            }
+            pattern[length] = '\0';
+
+            bool found = false;
+            for (const Reference &ref : REFERENCE) {
+                if (strcmp(ref.pattern, pattern) == 0) {
+                    TEST_ASSERT_EQUAL_CHAR_MESSAGE(ref.symbol, symbol, pattern);
+                    found = true;
+                }
+            }
+            TEST_ASSERT_TRUE_MESSAGE(found, pattern);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(REFERENCE_COUNT, decodedCount);
+
+    // A felső, nem használt bitek nem számítanak
+    TEST_ASSERT_EQUAL_CHAR_MESSAGE('A', MorseCode::decode(0xF1, 2), "0xF1/2");
+}
+
+/**
+ * @brief Érvénytelen hossz, ismeretlen és kisbetűs karakterek, prosign szövegek
+ */
+void test_edge_cases() {
+    TEST_ASSERT_EQUAL_CHAR_MESSAGE('\0', MorseCode::decode(0, 0), "0 hossz");
+    TEST_ASSERT_EQUAL_CHAR_MESSAGE('\0', MorseCode::decode(0, MorseCode::MAX_ELEMENTS + 1), "túl hosszú");
+
+    uint8_t bits, length;
+    TEST_ASSERT_TRUE(MorseCode::encode('q', bits, length));
+    TEST_ASSERT_EQUAL_UINT8(4, length);
+    TEST_ASSERT_EQUAL_UINT8(0b1101, bits);
+    TEST_ASSERT_FALSE(MorseCode::encode('#', bits, length));
+    TEST_ASSERT_FALSE(MorseCode::encode('\0', bits, length));
+    TEST_ASSERT_FALSE(MorseCode::encode('+', bits, length));  // Az AR kódja, prosignként dekódoljuk
+
+    TEST_ASSERT_EQUAL_STRING("<AR>", MorseCode::getProsignText(MorseCode::PROSIGN_AR));
+    TEST_ASSERT_EQUAL_STRING("<SK>", MorseCode::getProsignText(MorseCode::PROSIGN_SK));
+    TEST_ASSERT_EQUAL_STRING("<BT>", MorseCode::getProsignText(MorseCode::PROSIGN_BT));
+    TEST_ASSERT_EQUAL_STRING("<KN>", MorseCode::getProsignText(MorseCode::PROSIGN_KN));
+    TEST_ASSERT_EQUAL_STRING("<HH>", MorseCode::getProsignText(MorseCode::PROSIGN_ERROR));
+    TEST_ASSERT_TRUE(MorseCode::getProsignText('E') == nullptr);
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_reference_symbols);
+    RUN_TEST(test_every_sequence);
+    RUN_TEST(test_edge_cases);
+    return UNITY_END();
+}
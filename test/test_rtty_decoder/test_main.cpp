@@ -0,0 +1,198 @@
+/**
+ * @brief Az RTTY dekóder bit szintű tesztje ismert Baudot kód sorozatokkal (env:native)
+ *
+ * A kódokat a generátor közvetlenül (váltó kódok beszúrása nélkül) adja, így a LTRS/FIGS
+ * kezelés, a keretezési hibák és a bit szinkron a szöveg kódolásától függetlenül ellenőrizhető.
+ * A referencia ITA2 kódok itt, a dekóder táblájától függetlenül szerepelnek.
+ */
+#include <unity.h>
+
+#include <string>
+#include <vector>
+
+#include "ArraySampleSource.h"
+#include "AudioSampleReader.h"
+#include "DecoderRun.h"
+#include "NativeHost.h"
+#include "RttyDecoder.h"
+#include "TestSignalGenerator.h"
+
+namespace {
+
+using TestSignalGeneratorConstants::BAUDOT_FIGS;
+using TestSignalGeneratorConstants::BAUDOT_LTRS;
+using TestSignalGeneratorConstants::RTTY_FRAMING_ERROR;
+
+constexpr float BUS_RATE_HZ = AudioSampleBusConstants::SAMPLE_RATE_HZ;
+constexpr uint32_t CAPACITY = static_cast<uint32_t>(BUS_RATE_HZ * 60);
+constexpr float MARK_HZ = 1100.0f;
+constexpr float SHIFT_HZ = 170.0f;
+constexpr float AMPLITUDE = 300.0f;
+constexpr uint8_t LEAD_IN_CODES = 8;  // LTRS kódok a jel elején: ezalatt áll be a szintkövetés (nem adnak karaktert)
+
+// ITA2 betű kódok (bit 0 az első adat bit)
+constexpr uint8_t ITA2_LETTERS[26] = {3, 25, 14, 9, 1, 13, 26, 20, 6, 11, 15, 18, 28, 12, 24, 22, 23, 10, 5, 16, 7, 30, 19, 29, 21, 17};
+// ITA2 számjegy kódok a FIGS állásban ('0'..'9': P Q W E R T Y U I O)
+constexpr uint8_t ITA2_DIGITS[10] = {22, 23, 19, 1, 10, 16, 21, 7, 6, 24};
+constexpr uint8_t ITA2_SPACE = 4;
+
+std::vector<int16_t> signalBuffer(CAPACITY);
+
+uint8_t letter(char c) { return ITA2_LETTERS[c - 'A']; }
+uint8_t digit(char c) { return ITA2_DIGITS[c - '0']; }
+
+/**
+ * @brief Egy kód sorozat generálása (a LTRS bevezetővel), dekódolása rögzített baud mellett
+ * @param codes A kódok
+ * @param baud A baud
+ * @param snrDb A zaj (0: nincs zaj)
+ * @param framingErrors Ide kerül a dekóder keretezési hiba számlálója
+ * @return A dekódolt szöveg (nem normalizált)
+ */
+std::string decodeCodes(const std::vector<uint8_t> &codes, float baud, float snrDb, uint32_t &framingErrors) {
+    std::vector<uint8_t> stream(LEAD_IN_CODES, BAUDOT_LTRS);
+    stream.insert(stream.end(), codes.begin(), codes.end());
+    stream.insert(stream.end(), 2, BAUDOT_LTRS);  // Az utolsó karakter után is legyen jel
+
+    TestSignalGenerator generator(signalBuffer.data(), CAPACITY, BUS_RATE_HZ);
+    generator.addSilence(300);
+    generator.addRttyCodes(stream.data(), stream.size(), MARK_HZ, SHIFT_HZ, baud, AMPLITUDE);
+    generator.addSilence(300);
+    if (snrDb > 0.0f) {
+        generator.mixNoise(AMPLITUDE, snrDb);
+    }
+
+    ArraySampleSource source(signalBuffer.data(), generator.getLength(), false);
+    source.start(0, BUS_RATE_HZ);
+    RttyDecoder decoder(0, source);
+    decoder.setParameters(MARK_HZ, SHIFT_HZ, baud < 46.0f ? 45 : static_cast<uint16_t>(baud));
+    const DecoderRunResult result = DecoderRun::run(decoder, source, DecodedTextSource::Rtty, "", 0);
+    framingErrors = decoder.getFramingErrorCount();
+
+    std::string text;
+    for (const DecodedTextEntry &entry : result.entries) {
+        text += entry.character;
+    }
+    return text;
+}
+
+/**
+ * @brief LTRS/FIGS váltások: a FIGS állás a szóközön át megmarad, a LTRS visszavált
+ */
+void test_letters_and_figures_shift() {
+    const std::vector<uint8_t> codes = {letter('R'), letter('Y'), letter('R'), letter('Y'), ITA2_SPACE, BAUDOT_FIGS, digit('7'), digit('3'), ITA2_SPACE,
+                                        digit('8'),  digit('8'),  BAUDOT_LTRS, letter('D'), letter('E'), ITA2_SPACE, letter('K')};
+    const float bauds[] = {45.45f, 50.0f, 75.0f};
+    for (float baud : bauds) {
+        uint32_t framingErrors;
+        const std::string text = decodeCodes(codes, baud, 0.0f, framingErrors);
+        char caseName[32];
+        snprintf(caseName, sizeof(caseName), "%.2f baud", baud);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE("RYRY 73 88DE K", text.c_str(), caseName);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, framingErrors, caseName);
+    }
+}
+
+/**
+ * @brief Az összes betű és számjegy, és a váltó kódok ismétlése (nem ad karaktert, nem vált vissza)
+ */
+void test_every_letter_and_digit() {
+    std::vector<uint8_t> codes;
+    std::string expected;
+    for (char c = 'A'; c <= 'Z'; c++) {
+        codes.push_back(letter(c));
+        expected += c;
+    }
+    codes.push_back(BAUDOT_FIGS);
+    codes.push_back(BAUDOT_FIGS);
+    for (char c = '0'; c <= '9'; c++) {
+        codes.push_back(digit(c));
+        expected += c;
+    }
+    codes.push_back(BAUDOT_LTRS);
+    codes.push_back(BAUDOT_LTRS);
+    codes.push_back(letter('Q'));
+    expected += 'Q';
+
+    uint32_t framingErrors;
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), decodeCodes(codes, 45.45f, 0.0f, framingErrors).c_str());
+}
+
+/**
+ * @brief Keretezési hiba: a space stop bitű kód eldobódik és számolódik, a szinkron megmarad
+ */
+void test_framing_error_drops_character() {
+    const std::vector<uint8_t> codes = {letter('C'), letter('Q'), static_cast<uint8_t>(letter('X') | RTTY_FRAMING_ERROR), letter('D'), letter('E'),
+                                        static_cast<uint8_t>(BAUDOT_FIGS | RTTY_FRAMING_ERROR), digit('5'), letter('K')};
+    uint32_t framingErrors;
+    const std::string text = decodeCodes(codes, 45.45f, 0.0f, framingErrors);
+
+    // Az eldobott FIGS után az '5' kódja LTRS állásban 'T', a 'K' pedig 'K'
+    TEST_ASSERT_EQUAL_STRING("CQDETK", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(2, framingErrors);
+}
+
+/**
+ * @brief Egy hibás adat bit pontosan a várt másik karaktert adja (a bit sorrend és polaritás ellenőrzése)
+ */
+void test_bit_errors_map_to_expected_characters() {
+    std::vector<uint8_t> codes;
+    std::string expected;
+    for (uint8_t bit = 0; bit < 5; bit++) {
+        const uint8_t corrupted = letter('E') ^ (1 << bit);  // E = 00001
+        if (corrupted == BAUDOT_FIGS || corrupted == BAUDOT_LTRS || corrupted == 0) {
+            continue;
+        }
+        codes.push_back(corrupted);
+        for (char c = 'A'; c <= 'Z'; c++) {
+            if (letter(c) == corrupted) {
+                expected += c;
+            }
+        }
+        if (corrupted == ITA2_SPACE) {
+            expected += ' ';
+        }
+        if (corrupted == 2) {
+            expected += '\n';
+        }
+    }
+    uint32_t framingErrors;
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), decodeCodes(codes, 45.45f, 0.0f, framingErrors).c_str());
+}
+
+/**
+ * @brief Hosszú, véletlen betű sorozat zajjal: a bit óra nem csúszik el
+ */
+void test_long_random_stream() {
+    std::vector<uint8_t> codes;
+    std::string expected;
+    uint32_t state = 12345;
+    for (uint16_t i = 0; i < 250; i++) {  // ~41 s 45.45 baudon
+        state = state * 1103515245 + 12345;
+        const char c = 'A' + (state >> 16) % 26;
+        codes.push_back(letter(c));
+        expected += c;
+    }
+    uint32_t framingErrors;
+    const std::string text = decodeCodes(codes, 45.45f, 15.0f, framingErrors);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), text.size());
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, DecoderRun::characterErrorRate(expected, text));  // Mért: 0 %
+}
+
+}  // namespace
+
+void setUp() { NativeHost::setMicros(0); }
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_letters_and_figures_shift);
+    RUN_TEST(test_every_letter_and_digit);
+    RUN_TEST(test_framing_error_drops_character);
+    RUN_TEST(test_bit_errors_map_to_expected_characters);
+    RUN_TEST(test_long_random_stream);
+    return UNITY_END();
+}
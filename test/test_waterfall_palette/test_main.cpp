@@ -0,0 +1,173 @@
+/**
+ * @brief A vízesés paletta (LUT) egyezése a korábbi lebegőpontos színszámítással és a sor rajzolás ideje (env:native)
+ *
+ * A WaterfallPalette tábláját minden bájt értékre a korábbi valueToWaterfallColor() /
+ * valueToWaterfallColorAnalyzer() számításával (normalizálás float-ban, constrain) vetjük
+ * össze: a LUT-os rajzolás pixelre pontosan ugyanazt a képet adja. A sebesség csak
+ * tájékoztató (hoston): egy 480 pixeles sor színeinek kiszámítása a két úton. A kijelzőre
+ * írás (pixelenkénti drawPixel() kontra egy pushImage()) hardveren mérhető, itt nem.
+ */
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "WaterfallPalette.h"
+
+namespace {
+
+// A MiniAudioFftConstants vízesés színei és skálája (a fejléc a TFT_eSPI miatt hoston nem fordul)
+constexpr uint16_t MINI_FFT_COLORS[16] = {0x0000, 0x0000, 0x0000, 0x001F, 0x081F, 0x0810, 0x0800, 0x0C00, 0x1C00, 0xFC00, 0xFDE0, 0xFFE0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+constexpr int WF_GRADIENT = 100;
+constexpr int MAX_WATERFALL_COLOR_INPUT_VALUE = 20000;
+constexpr uint8_t MINI_FFT_FULL_SCALE = MAX_WATERFALL_COLOR_INPUT_VALUE / WF_GRADIENT;
+
+// Az AudioAnalyzerDisplay "Hot" profilja (teljes skála: 255)
+constexpr uint16_t ANALYZER_HOT_COLORS[16] = {0x0000, 0x1000, 0x2000, 0x4000, 0x8000, 0xC000, 0xF800, 0xF8A0, 0xF9C0, 0xFD20, 0xFFE0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+
+// Minden lépcső más színű (a szín = a lépcső indexe), így a rossz lépcső nem rejtőzhet el két egyforma szín mögött
+constexpr uint16_t INDEX_COLORS_2[2] = {0, 1};
+constexpr uint16_t INDEX_COLORS_5[5] = {0, 1, 2, 3, 4};
+constexpr uint16_t INDEX_COLORS_16[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+constexpr uint8_t FULL_SCALES[] = {1, 7, 100, MINI_FFT_FULL_SCALE, 254, 255};
+
+constexpr uint16_t LINE_PIXELS = 480;  // Az AudioAnalyzerDisplay egy sora
+
+// A tábla a fordításkor készül el
+constexpr WaterfallPalette<16> MINI_FFT_PALETTE(MINI_FFT_COLORS, MINI_FFT_FULL_SCALE);
+static_assert(MINI_FFT_PALETTE[0] == 0x0000, "A leggyengebb jel fekete");
+static_assert(MINI_FFT_PALETTE[MINI_FFT_FULL_SCALE] == 0xFFFF, "A telitesi szinten az utolso lepcso");
+static_assert(WaterfallPalette<5>(INDEX_COLORS_5, 8)[4] == 2, "4 / 8 * (5 - 1) = 2. lepcso");
+
+/**
+ * @brief A korábbi MiniAudioFft::valueToWaterfallColor() (a hívó WF_GRADIENT-tel szorozta a bájtot)
+ */
+uint16_t legacyMiniFftColor(int scaledValue) {
+    const int clipped = scaledValue < 0 ? 0 : (scaledValue > MAX_WATERFALL_COLOR_INPUT_VALUE ? MAX_WATERFALL_COLOR_INPUT_VALUE : scaledValue);
+    const float normalized = static_cast<float>(clipped) / static_cast<float>(MAX_WATERFALL_COLOR_INPUT_VALUE);
+    const uint8_t colorSize = sizeof(MINI_FFT_COLORS) / sizeof(MINI_FFT_COLORS[0]);
+    int index = static_cast<int>(normalized * (colorSize - 1));
+    index = index < 0 ? 0 : (index > colorSize - 1 ? colorSize - 1 : index);
+    return MINI_FFT_COLORS[index];
+}
+
+/**
+ * @brief A korábbi AudioAnalyzerDisplay::valueToWaterfallColorAnalyzer() tetszőleges színátmenettel (min_val = 0)
+ */
+uint16_t legacyAnalyzerColor(float value, float maxValue, const uint16_t *colors, uint8_t colorSize) {
+    if (value < 0.0f) value = 0.0f;
+    if (value > maxValue) value = maxValue;
+    int index = static_cast<int>(value * (colorSize - 1) / maxValue);
+    if (index < 0) index = 0;
+    if (index >= colorSize) index = colorSize - 1;
+    return colors[index];
+}
+
+/**
+ * @brief A tábla minden értéke a lebegőpontos számítás szerint, a telítés fölött az utolsó lépcső
+ */
+template <uint8_t GradientSize>
+void checkPalette(const uint16_t (&gradient)[GradientSize]) {
+    char caseName[64];
+    for (uint8_t fullScale : FULL_SCALES) {
+        const WaterfallPalette<GradientSize> palette(gradient, fullScale);
+        for (uint16_t value = 0; value < WaterfallPalette<GradientSize>::SIZE; value++) {
+            snprintf(caseName, sizeof(caseName), "lepcso=%u skala=%u ertek=%u", GradientSize, fullScale, value);
+            TEST_ASSERT_EQUAL_UINT16_MESSAGE(legacyAnalyzerColor(value, fullScale, gradient, GradientSize), palette[value], caseName);
+            if (value >= fullScale) {
+                TEST_ASSERT_EQUAL_UINT16_MESSAGE(gradient[GradientSize - 1], palette[value], caseName);
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT16(gradient[0], palette[0]);
+    }
+}
+
+void test_palette_matches_float_mapping() {
+    checkPalette(INDEX_COLORS_2);
+    checkPalette(INDEX_COLORS_5);
+    checkPalette(INDEX_COLORS_16);
+    checkPalette(ANALYZER_HOT_COLORS);
+}
+
+/**
+ * @brief A MiniAudioFft vízesése: a bájt * WF_GRADIENT a korábbi egész skálán
+ */
+void test_mini_fft_palette_matches_legacy() {
+    for (uint16_t value = 0; value < WaterfallPalette<16>::SIZE; value++) {
+        TEST_ASSERT_EQUAL_UINT16(legacyMiniFftColor(WF_GRADIENT * value), MINI_FFT_PALETTE[value]);
+    }
+}
+
+/**
+ * @brief A sor leképezés pixelenként az operator[] eredménye, a puffer vége érintetlen
+ */
+void test_map_line() {
+    const WaterfallPalette<16> palette(ANALYZER_HOT_COLORS, 255);
+    uint8_t values[LINE_PIXELS];
+    uint16_t pixels[LINE_PIXELS + 1];
+    for (uint16_t i = 0; i < LINE_PIXELS; i++) {
+        values[i] = static_cast<uint8_t>(i * 37 + (i >> 3));
+    }
+    pixels[LINE_PIXELS] = 0xA5A5;
+    palette.mapLine(values, pixels, LINE_PIXELS);
+    for (uint16_t i = 0; i < LINE_PIXELS; i++) {
+        TEST_ASSERT_EQUAL_UINT16(palette[values[i]], pixels[i]);
+    }
+    TEST_ASSERT_EQUAL_HEX16(0xA5A5, pixels[LINE_PIXELS]);
+
+    pixels[0] = 0xA5A5;
+    palette.mapLine(values, pixels, 0);
+    TEST_ASSERT_EQUAL_HEX16(0xA5A5, pixels[0]);
+}
+
+/**
+ * @brief Egy 480 pixeles sor színeinek ideje: LUT (mapLine) kontra pixelenkénti lebegőpontos számítás (tájékoztató, a hoston)
+ */
+void test_line_render_speed() {
+    const WaterfallPalette<16> palette(ANALYZER_HOT_COLORS, 255);
+    uint8_t values[LINE_PIXELS];
+    uint16_t pixels[LINE_PIXELS];
+    for (uint16_t i = 0; i < LINE_PIXELS; i++) {
+        values[i] = static_cast<uint8_t>(i * 37 + (i >> 3));
+    }
+
+    const uint32_t iterations = 20000;
+    volatile uint16_t sink = 0;  // Az eredmény "felhasználása", hogy a fordító ne dobja el a ciklust
+    auto measure = [&](auto &&renderLine) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t n = 0; n < iterations; n++) {
+            values[n % LINE_PIXELS] = static_cast<uint8_t>(n);
+            renderLine();
+            sink = sink + pixels[n % LINE_PIXELS];
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+    };
+    const double lutUs = measure([&]() { palette.mapLine(values, pixels, LINE_PIXELS); });
+    const double floatUs = measure([&]() {
+        for (uint16_t i = 0; i < LINE_PIXELS; i++) {
+            pixels[i] = legacyAnalyzerColor(values[i], 255.0f, ANALYZER_HOT_COLORS, 16);
+        }
+    });
+
+    char line[128];
+    snprintf(line, sizeof(line), "{\"case\":\"waterfall line %u px\",\"lut_us\":%.3f,\"float_us\":%.3f,\"ratio\":%.2f}", LINE_PIXELS, lutUs, floatUs, floatUs / lutUs);
+    TEST_MESSAGE(line);
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_palette_matches_float_mapping);
+    RUN_TEST(test_mini_fft_palette_matches_legacy);
+    RUN_TEST(test_map_line);
+    RUN_TEST(test_line_render_speed);
+    return UNITY_END();
+}
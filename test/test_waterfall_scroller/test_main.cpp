@@ -0,0 +1,369 @@
+/**
+ * @brief A vízesés görgető a kijelző memória modelljén (env:native)
+ *
+ * A MemoryPanel a vezérlő képmemóriája (GRAM) és a függőleges görgetés regiszterei: a
+ * VSCRDEF felső fix, görgetett és alsó fix sávja, a VSCRSADD a görgetett sáv tetején
+ * megjelenő memória sor (ILI9341/ILI9488 adatlap). A látható kép ebből számolódik, így a
+ * görgetés matematikája hardver nélkül ellenőrizhető: a sáv i. sorában az i. legújabb sor
+ * látszik, a fix sávok (státuszsor, skála, gombok) sosem mozdulnak.
+ *
+ * A sorok azonosíthatók: az n. sor első négy pixele n 4 bites darabjai (a tesztpaletta
+ * színe = a bájt, 0..15), így a látható képből visszaolvasható, melyik sor hol áll.
+ */
+#include <unity.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "WaterfallScroller.h"
+
+namespace {
+
+constexpr uint16_t INDEX_COLORS[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+constexpr WaterfallPalette<16> PALETTE(INDEX_COLORS, 15);  // A szín a bájt (15 fölött 15)
+constexpr uint16_t FIXED_MARKER = 0xABCD;                  // A fix sávok tartalma (a paletta nem ad ilyet)
+
+/**
+ * @brief A kijelző vezérlő memória modellje (GRAM és görgetés regiszterek)
+ */
+class MemoryPanel : public IWaterfallPanel {
+   public:
+    MemoryPanel(uint16_t width, uint16_t height, bool hardwareScroll)
+        : width_(width), height_(height), hardwareScroll_(hardwareScroll), gram_(static_cast<size_t>(width) * height, FIXED_MARKER), rowBuffer_(WaterfallScrollerConstants::MAX_WIDTH) {
+        resetScroll();
+    }
+
+    uint16_t getHeight() const override { return height_; }
+    bool hasHardwareScroll() const override { return hardwareScroll_; }
+
+    void setScrollArea(uint16_t topFixedRows, uint16_t scrollRows, uint16_t bottomFixedRows) override {
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(height_, topFixedRows + scrollRows + bottomFixedRows, "VSCRDEF: a sávok összege a panel magassága");
+        topFixed_ = topFixedRows;
+        scrollRows_ = scrollRows;
+        scrollDefinitions_++;
+    }
+
+    void setScrollStart(uint16_t memoryRow) override {
+        TEST_ASSERT_TRUE_MESSAGE(memoryRow >= topFixed_ && memoryRow < topFixed_ + scrollRows_, "VSCRSADD a görgetett sávon kívül");
+        scrollStart_ = memoryRow;
+        scrollStarts_++;
+    }
+
+    void resetScroll() override {
+        topFixed_ = 0;
+        scrollRows_ = height_;
+        scrollStart_ = 0;
+    }
+
+    uint16_t *getRowBuffer() override { return rowBuffer_.data(); }
+
+    void pushRow(uint16_t memoryRow, uint16_t width) override {
+        TEST_ASSERT_TRUE(memoryRow < height_);
+        TEST_ASSERT_TRUE(width <= width_);
+        for (uint16_t x = 0; x < width; x++) {
+            gram_[static_cast<size_t>(memoryRow) * width_ + x] = rowBuffer_[x];
+        }
+        rowWrites_++;
+    }
+
+    /**
+     * @brief A képernyő egy sorában látszó memória sor (a VSCRDEF/VSCRSADD szerint)
+     */
+    uint16_t memoryRowForScreenRow(uint16_t screenRow) const {
+        if (screenRow < topFixed_ || screenRow >= topFixed_ + scrollRows_) {
+            return screenRow;  // Fix sáv
+        }
+        return topFixed_ + (screenRow - topFixed_ + scrollStart_ - topFixed_) % scrollRows_;
+    }
+
+    /**
+     * @brief Egy látható pixel
+     */
+    uint16_t screenPixel(uint16_t x, uint16_t screenRow) const { return gram_[static_cast<size_t>(memoryRowForScreenRow(screenRow)) * width_ + x]; }
+
+    /**
+     * @brief A képernyő sorában látszó sor azonosítója (0: üres sor)
+     */
+    uint32_t screenLineId(uint16_t screenRow) const {
+        uint32_t id = 0;
+        for (uint8_t k = 0; k < 4; k++) {
+            id |= static_cast<uint32_t>(screenPixel(k, screenRow)) << (4 * k);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Egy sáv törlése (a képernyő drawScreen()-je, a paletta 0. színére)
+     */
+    void clearRows(uint16_t top, uint16_t rows) {
+        for (size_t i = static_cast<size_t>(top) * width_; i < static_cast<size_t>(top + rows) * width_; i++) {
+            gram_[i] = 0;
+        }
+    }
+
+    uint32_t rowWrites_ = 0;
+    uint32_t scrollDefinitions_ = 0;
+    uint32_t scrollStarts_ = 0;
+    uint16_t topFixed_ = 0;
+    uint16_t scrollRows_ = 0;
+    uint16_t scrollStart_ = 0;
+
+   private:
+    uint16_t width_;
+    uint16_t height_;
+    bool hardwareScroll_;
+    std::vector<uint16_t> gram_;
+    std::vector<uint16_t> rowBuffer_;
+};
+
+/**
+ * @brief Az n. sor bájtjai: az első négy elem n 4 bites darabjai, a többi n alsó 4 bitje
+ */
+void makeLine(uint32_t id, uint8_t *levels, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        levels[i] = i < 4 ? (id >> (4 * i)) & 0x0F : id & 0x0F;
+    }
+}
+
+/**
+ * @brief A sáv i. sorában az i. legújabb sor látszik, a sáv fölött és alatt a fix tartalom
+ * @param newestId A legújabb sor azonosítója (0: még nincs sor)
+ */
+void checkScreen(const MemoryPanel &panel, uint16_t panelHeight, uint16_t areaTop, uint16_t areaHeight, uint32_t newestId, const char *caseName) {
+    char message[96];
+    for (uint16_t row = 0; row < panelHeight; row++) {
+        snprintf(message, sizeof(message), "%s: sor %u, legújabb %u", caseName, row, static_cast<unsigned>(newestId));
+        if (row < areaTop || row >= areaTop + areaHeight) {
+            TEST_ASSERT_EQUAL_HEX16_MESSAGE(FIXED_MARKER, panel.screenPixel(0, row), message);
+            continue;
+        }
+        const uint16_t age = row - areaTop;
+        const uint32_t expected = newestId > age ? newestId - age : 0;
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected, panel.screenLineId(row), message);
+    }
+}
+
+/**
+ * @brief Hány helyen nem az eggyel régebbi sor jön a sávban lefelé (az üres sorok folytonosak)
+ */
+uint16_t countSeams(const MemoryPanel &panel, uint16_t areaTop, uint16_t areaHeight) {
+    uint16_t seams = 0;
+    for (uint16_t row = areaTop + 1; row < areaTop + areaHeight; row++) {
+        const uint32_t above = panel.screenLineId(row - 1);
+        const uint32_t id = panel.screenLineId(row);
+        if (!(id + 1 == above || (id == 0 && above == 0))) {
+            seams++;
+        }
+    }
+    return seams;
+}
+
+/**
+ * @brief Hardveres görgetés (álló, 0-s forgatás): három teljes körön át minden sor után a teljes kép
+ */
+void test_hardware_scroll_memory_model() {
+    constexpr uint16_t WIDTH = 320, HEIGHT = 480, AREA_TOP = 20, AREA_HEIGHT = 400;
+    MemoryPanel panel(WIDTH, HEIGHT, true);
+    panel.clearRows(AREA_TOP, AREA_HEIGHT);
+
+    WaterfallScroller scroller;
+    TEST_ASSERT_TRUE(scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH));
+    TEST_ASSERT_EQUAL(WaterfallScrollMode::Hardware, scroller.getMode());
+    TEST_ASSERT_EQUAL_UINT16(AREA_TOP, panel.topFixed_);
+    TEST_ASSERT_EQUAL_UINT16(AREA_HEIGHT, panel.scrollRows_);
+    checkScreen(panel, HEIGHT, AREA_TOP, AREA_HEIGHT, 0, "hw kezdet");
+
+    uint8_t levels[WIDTH];
+    for (uint32_t id = 1; id <= 3 * AREA_HEIGHT + 37; id++) {
+        const uint32_t writesBefore = panel.rowWrites_;
+        makeLine(id, levels, WIDTH);
+        scroller.addLine(levels, WIDTH);
+        scroller.update();  // Hardveres módban nincs újrarajzolás
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, panel.rowWrites_ - writesBefore, "Egy új sor pontosan egy sor írás");
+        checkScreen(panel, HEIGHT, AREA_TOP, AREA_HEIGHT, id, "hw");
+    }
+    TEST_ASSERT_FALSE(scroller.isRedrawPending());
+
+    scroller.end();
+    TEST_ASSERT_EQUAL_UINT16(0, panel.topFixed_);
+    TEST_ASSERT_EQUAL_UINT16(HEIGHT, panel.scrollRows_);
+    TEST_ASSERT_EQUAL_UINT16(0, panel.scrollStart_);
+}
+
+/**
+ * @brief Szoftveres görgetés (fekvő, 1-es forgatás): a kép az újrarajzolások után kor szerint áll
+ *
+ * Soronként egy UI kör (egy update()), mint az analizátorban: egy újrarajzolás
+ * AREA_HEIGHT / SOFTWARE_ROWS_PER_PASS körig tart, közben új sorok jönnek.
+ */
+void test_software_scroll_ring() {
+    using namespace WaterfallScrollerConstants;
+    constexpr uint16_t WIDTH = 480, HEIGHT = 320, AREA_TOP = 20, AREA_HEIGHT = 235;
+    MemoryPanel panel(WIDTH, HEIGHT, false);
+    panel.clearRows(AREA_TOP, AREA_HEIGHT);
+
+    WaterfallScroller scroller;
+    TEST_ASSERT_FALSE(scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH));
+    TEST_ASSERT_EQUAL(WaterfallScrollMode::Software, scroller.getMode());
+    TEST_ASSERT_EQUAL_UINT32(0, panel.scrollDefinitions_);
+
+    uint8_t levels[WIDTH];
+    uint32_t id = 0;
+    for (uint8_t round = 0; round < 3; round++) {
+        // Sorok minden körben, majd csend, amíg a kép utoléri magát
+        for (uint16_t n = 0; n < AREA_HEIGHT + 50; n++) {
+            makeLine(++id, levels, WIDTH);
+            scroller.addLine(levels, WIDTH);
+            const uint32_t writesBefore = panel.rowWrites_;
+            scroller.update();
+            TEST_ASSERT_TRUE_MESSAGE(panel.rowWrites_ - writesBefore <= SOFTWARE_ROWS_PER_PASS, "Egy UI kör legfeljebb SOFTWARE_ROWS_PER_PASS sort rajzol");
+            TEST_ASSERT_TRUE_MESSAGE(countSeams(panel, AREA_TOP, AREA_HEIGHT) <= 1, "Rajzolás közben csak az új és a régi kép határán lehet szakadás");
+        }
+        uint16_t passes = 0;
+        while (scroller.isRedrawPending()) {
+            scroller.update();
+            TEST_ASSERT_TRUE(++passes <= 2 * (AREA_HEIGHT / SOFTWARE_ROWS_PER_PASS + 1));
+        }
+        checkScreen(panel, HEIGHT, AREA_TOP, AREA_HEIGHT, id, "sw");
+        TEST_ASSERT_EQUAL_UINT16(0, panel.scrollStart_);  // A görgetés regisztereihez nem nyúl
+    }
+
+    // Egy újrarajzolás közben a sáv tetejétől a rajzolt soron át folytonos a kor (nincs szakadás a kép közepén)
+    makeLine(++id, levels, WIDTH);
+    scroller.addLine(levels, WIDTH);
+    scroller.update();
+    for (uint16_t row = 1; row < SOFTWARE_ROWS_PER_PASS; row++) {
+        TEST_ASSERT_EQUAL_UINT32(panel.screenLineId(AREA_TOP + row - 1) - 1, panel.screenLineId(AREA_TOP + row));
+    }
+}
+
+/**
+ * @brief Több sor egy újrarajzolás alatt, mint az előzmény tartaléka: a kép a végén mégis rendben
+ */
+void test_software_scroll_burst() {
+    using namespace WaterfallScrollerConstants;
+    constexpr uint16_t WIDTH = 200, HEIGHT = 320, AREA_TOP = 10, AREA_HEIGHT = 100;
+    MemoryPanel panel(WIDTH, HEIGHT, false);
+    panel.clearRows(AREA_TOP, AREA_HEIGHT);
+    WaterfallScroller scroller;
+    scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH);
+
+    uint8_t levels[WIDTH];
+    uint32_t id = 0;
+    for (uint16_t n = 0; n < 3 * SOFTWARE_SWEEP_SLACK; n++) {  // update() nélkül: a tartalék többször betelik
+        makeLine(++id, levels, WIDTH);
+        scroller.addLine(levels, WIDTH);
+    }
+    while (scroller.isRedrawPending()) {
+        scroller.update();
+    }
+    checkScreen(panel, HEIGHT, AREA_TOP, AREA_HEIGHT, id, "sw burst");
+}
+
+/**
+ * @brief A sornál szélesebb sáv: minden pixel a legközelebbi elem színe (mindkét módban)
+ */
+void test_line_stretch() {
+    constexpr uint16_t WIDTH = 480, HEIGHT = 320, AREA_TOP = 20, AREA_HEIGHT = 100, LENGTH = 10;
+    for (bool hardware : {true, false}) {
+        MemoryPanel panel(WIDTH, HEIGHT, hardware);
+        panel.clearRows(AREA_TOP, AREA_HEIGHT);
+        WaterfallScroller scroller;
+        scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH);
+
+        const uint8_t levels[LENGTH] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        scroller.addLine(levels, LENGTH);
+        while (scroller.isRedrawPending()) {
+            scroller.update();
+        }
+        for (uint16_t x = 0; x < WIDTH; x++) {
+            const uint16_t expected = static_cast<uint16_t>((x * (LENGTH - 1) + (WIDTH - 1) / 2) / (WIDTH - 1));
+            TEST_ASSERT_EQUAL_UINT16(expected, panel.screenPixel(x, AREA_TOP));
+        }
+        TEST_ASSERT_EQUAL_UINT16(9, panel.screenPixel(WIDTH - 1, AREA_TOP));
+        TEST_ASSERT_EQUAL_UINT16(0, panel.screenPixel(0, AREA_TOP + 1));  // A régebbi sorok még üresek
+    }
+}
+
+/**
+ * @brief A sor hosszának változása (pl. más FFT méret) törli az előzményt
+ */
+void test_line_length_change_clears_history() {
+    constexpr uint16_t WIDTH = 64, HEIGHT = 200, AREA_TOP = 0, AREA_HEIGHT = 50;
+    MemoryPanel panel(WIDTH, HEIGHT, false);
+    panel.clearRows(AREA_TOP, AREA_HEIGHT);
+    WaterfallScroller scroller;
+    scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH);
+
+    uint8_t levels[WIDTH];
+    for (uint32_t id = 1; id <= 20; id++) {
+        makeLine(id, levels, WIDTH);
+        scroller.addLine(levels, WIDTH);
+        scroller.update();
+    }
+    makeLine(0x4321, levels, 32);
+    scroller.addLine(levels, 32);
+    while (scroller.isRedrawPending()) {
+        scroller.update();
+    }
+    TEST_ASSERT_EQUAL_UINT16(1, panel.screenPixel(0, AREA_TOP));  // Az új sor 4 bites darabjai, kétszer nyújtva
+    TEST_ASSERT_EQUAL_UINT16(2, panel.screenPixel(2, AREA_TOP));
+    for (uint16_t row = AREA_TOP + 1; row < AREA_TOP + AREA_HEIGHT; row++) {
+        TEST_ASSERT_EQUAL_UINT32(0, panel.screenLineId(row));
+    }
+}
+
+/**
+ * @brief A képernyő újrarajzolása (pl. dialógus után) ugyanazzal a sávval: a szoftveres előzmény visszarajzolódik
+ */
+void test_begin_again_redraws_history() {
+    constexpr uint16_t WIDTH = 120, HEIGHT = 240, AREA_TOP = 16, AREA_HEIGHT = 150;
+    MemoryPanel panel(WIDTH, HEIGHT, false);
+    panel.clearRows(AREA_TOP, AREA_HEIGHT);
+    WaterfallScroller scroller;
+    scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH);
+
+    uint8_t levels[WIDTH];
+    uint32_t id = 0;
+    for (uint16_t n = 0; n < 200; n++) {
+        makeLine(++id, levels, WIDTH);
+        scroller.addLine(levels, WIDTH);
+        scroller.update();
+    }
+
+    panel.clearRows(AREA_TOP, AREA_HEIGHT);  // drawScreen(): fillScreen()
+    scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT, WIDTH);
+    while (scroller.isRedrawPending()) {
+        scroller.update();
+    }
+    checkScreen(panel, HEIGHT, AREA_TOP, AREA_HEIGHT, id, "sw begin again");
+
+    // Más sáv: üres előzmény
+    scroller.begin(panel, PALETTE, AREA_TOP, AREA_HEIGHT - 10, WIDTH);
+    makeLine(++id, levels, WIDTH);
+    scroller.addLine(levels, WIDTH);
+    while (scroller.isRedrawPending()) {
+        scroller.update();
+    }
+    TEST_ASSERT_EQUAL_UINT32(id, panel.screenLineId(AREA_TOP));
+    TEST_ASSERT_EQUAL_UINT32(0, panel.screenLineId(AREA_TOP + 1));
+}
+
+}  // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_hardware_scroll_memory_model);
+    RUN_TEST(test_software_scroll_ring);
+    RUN_TEST(test_software_scroll_burst);
+    RUN_TEST(test_line_stretch);
+    RUN_TEST(test_line_length_change_clears_history);
+    RUN_TEST(test_begin_again_redraws_history);
+    return UNITY_END();
+}